@@ -21,6 +21,7 @@
 
 // Example headers
 #include "BsExampleConfig.h"
+#include "BsBenchmarkScenario.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example demonstrates how to import audio clips and then play them back using a variety of settings.
@@ -234,6 +235,9 @@ int main()
 	// Custom example code goes here
 	setUpScene();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
@@ -0,0 +1,202 @@
+#include "BsBenchmarkSuites.h"
+#include "Animation/BsAnimationCurve.h"
+#include "Animation/BsAnimationClip.h"
+#include "Math/BsRandom.h"
+
+// Example includes
+#include "BsCurveEvaluator.h"
+
+namespace bs
+{
+	/** Number of keyframes in the long curve, sampled 30 times per second (over five minutes of animation). */
+	constexpr u32 NUM_CURVE_KEYS = 10000;
+
+	/** Number of curve evaluations performed by a single iteration of the curve benchmarks. */
+	constexpr u32 NUM_CURVE_EVALUATIONS = 1000;
+
+	/** Number of bones animated by the long clip. Each bone has a position and a rotation track. */
+	constexpr u32 NUM_CLIP_BONES = 64;
+
+	/** Number of keyframes in each track of the long clip, sampled 30 times per second. */
+	constexpr u32 NUM_CLIP_KEYS = 3000;
+
+	/** Time between keyframes of the long curve and clip, in seconds. */
+	constexpr float KEY_INTERVAL = 1.0f / 30.0f;
+
+	/** Time the playback advances by between two evaluations, as when playing back at 60 frames per second. */
+	constexpr float FRAME_INTERVAL = 1.0f / 60.0f;
+
+	/** Long curve evaluated by the curve benchmarks, along with the playback state. */
+	struct CurveState
+	{
+		CurveState()
+		{
+			Random random(1234);
+
+			Vector<TKeyframe<float>> keyframes(NUM_CURVE_KEYS);
+			for(u32 i = 0; i < NUM_CURVE_KEYS; i++)
+				keyframes[i] = TKeyframe<float>{ random.GetRange(-1.0f, 1.0f), 0.0f, 0.0f, i * KEY_INTERVAL };
+
+			Curve = TAnimationCurve<float>(keyframes);
+			Evaluator.SetCurve(Curve);
+
+			RandomTimes.resize(NUM_CURVE_EVALUATIONS);
+			for(auto& time : RandomTimes)
+				time = random.GetRange(0.0f, NUM_CURVE_KEYS * KEY_INTERVAL);
+		}
+
+		TAnimationCurve<float> Curve;
+		CurveEvaluator Evaluator;
+		Vector<float> RandomTimes;
+		float Time = 0.0f;
+	};
+
+	/** Long clip sampled by the clip benchmarks, along with the playback state. */
+	struct ClipState
+	{
+		HAnimationClip Clip;
+		SPtr<AnimationClipSampler> Sampler;
+		AnimationClipSample Sample;
+		float Time = 0.0f;
+	};
+
+	/** Creates a clip of NUM_CLIP_BONES bones with random position and rotation keys. */
+	static HAnimationClip createLongClip()
+	{
+		Random random(4321);
+
+		SPtr<AnimationCurves> curves = bs_shared_ptr_new<AnimationCurves>();
+		for(u32 i = 0; i < NUM_CLIP_BONES; i++)
+		{
+			Vector<TKeyframe<Vector3>> positionKeys(NUM_CLIP_KEYS);
+			Vector<TKeyframe<Quaternion>> rotationKeys(NUM_CLIP_KEYS);
+
+			for(u32 j = 0; j < NUM_CLIP_KEYS; j++)
+			{
+				const float time = j * KEY_INTERVAL;
+
+				Quaternion rotation;
+				rotation.FromAxisAngle(random.GetUnitVector(), Degree(random.GetRange(0.0f, 360.0f)));
+
+				positionKeys[j] = TKeyframe<Vector3>{ random.GetUnitVector(), Vector3::ZERO, Vector3::ZERO, time };
+				rotationKeys[j] = TKeyframe<Quaternion>{ rotation, Quaternion::ZERO, Quaternion::ZERO, time };
+			}
+
+			const String name = "Bone" + toString(i);
+			curves->AddPositionCurve(name, TAnimationCurve<Vector3>(positionKeys));
+			curves->AddRotationCurve(name, TAnimationCurve<Quaternion>(rotationKeys));
+		}
+
+		return AnimationClip::Create(curves);
+	}
+
+	/**
+	 * Registers a benchmark that plays back a long clip, calling 'sample' to evaluate all of its tracks at the current
+	 * time once per iteration.
+	 */
+	static void addClipBenchmark(BenchmarkRunner& runner, const String& name, std::function<void(ClipState&)> sample)
+	{
+		auto state = bs_shared_ptr_new<ClipState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_CLIP_BONES * 2;
+		desc.Setup = [state]()
+		{
+			state->Clip = createLongClip();
+			state->Sampler = bs_shared_ptr_new<AnimationClipSampler>(state->Clip);
+			state->Time = 0.0f;
+		};
+
+		desc.Run = [state, sample]()
+		{
+			sample(*state);
+			state->Time += FRAME_INTERVAL;
+
+			doNotOptimize(state->Sample.Positions[0]);
+		};
+
+		desc.Teardown = [state]()
+		{
+			state->Sampler = nullptr;
+			state->Clip = nullptr;
+		};
+
+		runner.Add(desc);
+	}
+
+	void registerAnimationBenchmarks(BenchmarkRunner& runner)
+	{
+		// Sequential playback of a long curve. The curve searches for the keyframe segment on every evaluation, while the
+		// evaluator steps forward from the segment it used last.
+		{
+			auto state = bs_shared_ptr_new<CurveState>();
+
+			runner.Add("Animation.Curve.Sequential.BinarySearch", [state]()
+			{
+				float sum = 0.0f;
+				for(u32 i = 0; i < NUM_CURVE_EVALUATIONS; i++)
+				{
+					sum += state->Curve.Evaluate(state->Time, true);
+					state->Time += FRAME_INTERVAL;
+				}
+
+				doNotOptimize(sum);
+			}, NUM_CURVE_EVALUATIONS);
+
+			runner.Add("Animation.Curve.Sequential.Cached", [state]()
+			{
+				float sum = 0.0f;
+				for(u32 i = 0; i < NUM_CURVE_EVALUATIONS; i++)
+				{
+					sum += state->Evaluator.Evaluate(state->Time, true);
+					state->Time += FRAME_INTERVAL;
+				}
+
+				doNotOptimize(sum);
+			}, NUM_CURVE_EVALUATIONS);
+
+			// Random access defeats the cache, so the evaluator falls back to a binary search after checking the cached
+			// segment. Shows the cost of a miss.
+			runner.Add("Animation.Curve.Random.BinarySearch", [state]()
+			{
+				float sum = 0.0f;
+				for(auto time : state->RandomTimes)
+					sum += state->Curve.Evaluate(time, true);
+
+				doNotOptimize(sum);
+			}, NUM_CURVE_EVALUATIONS);
+
+			runner.Add("Animation.Curve.Random.Cached", [state]()
+			{
+				float sum = 0.0f;
+				for(auto time : state->RandomTimes)
+					sum += state->Evaluator.Evaluate(time, true);
+
+				doNotOptimize(sum);
+			}, NUM_CURVE_EVALUATIONS);
+		}
+
+		// Sequential playback of a long clip, evaluating every track once per frame. The clip is evaluated by searching
+		// each curve directly, and by the sampler which keeps an evaluator per track.
+		addClipBenchmark(runner, "Animation.Clip.BinarySearch", [](ClipState& state)
+		{
+			const SPtr<AnimationCurves> curves = state.Clip->GetCurves();
+			AnimationClipSample& sample = state.Sample;
+
+			sample.Positions.resize(curves->Position.size());
+			sample.Rotations.resize(curves->Rotation.size());
+
+			for(u32 i = 0; i < (u32)curves->Position.size(); i++)
+				sample.Positions[i] = curves->Position[i].Curve.Evaluate(state.Time, true);
+
+			for(u32 i = 0; i < (u32)curves->Rotation.size(); i++)
+				sample.Rotations[i] = curves->Rotation[i].Curve.Evaluate(state.Time, true);
+		});
+
+		addClipBenchmark(runner, "Animation.Clip.Cached", [](ClipState& state)
+		{
+			state.Sampler->Sample(state.Time, state.Sample, true);
+		});
+	}
+} // namespace bs
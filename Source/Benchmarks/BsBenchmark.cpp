@@ -0,0 +1,258 @@
+#include "BsBenchmark.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace bs
+{
+	using BenchmarkClock = std::chrono::steady_clock;
+
+	/** Returns the value at the specified percentile of an already sorted array, interpolating between entries. */
+	static double percentile(const Vector<double>& sorted, double fraction)
+	{
+		if(sorted.empty())
+			return 0.0;
+
+		const double position = fraction * (double)(sorted.size() - 1);
+		const size_t lower = (size_t)position;
+		const size_t upper = std::min(lower + 1, sorted.size() - 1);
+		const double t = position - (double)lower;
+
+		return sorted[lower] * (1.0 - t) + sorted[upper] * t;
+	}
+
+	/** Runs the provided number of iterations of the benchmark and returns the elapsed time in nanoseconds. */
+	static double timeIterations(const BenchmarkDesc& desc, u64 numIterations)
+	{
+		const auto start = BenchmarkClock::now();
+
+		for(u64 i = 0; i < numIterations; i++)
+			desc.Run();
+
+		const auto end = BenchmarkClock::now();
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	}
+
+	/** Prints a single line of the results table to the console. */
+	static void printResult(const BenchmarkResult& result)
+	{
+		printf("%-48s %14.1f %12.1f %14.1f %14.3f", result.Name.c_str(), result.Median,
+			result.MedianAbsoluteDeviation, result.Percentile95, result.GetMedianPerItem());
+
+		if(result.HasCounters)
+		{
+			const double cycles = result.GetCounterPerIteration(PerfCounterType::Cycles);
+			const double instructions = result.GetCounterPerIteration(PerfCounterType::Instructions);
+			const double cacheMisses = result.GetCounterPerIteration(PerfCounterType::CacheMisses);
+			const double branchMisses = result.GetCounterPerIteration(PerfCounterType::BranchMisses);
+
+			printf(" %6.2f %12.2f %12.2f", cycles > 0.0 ? instructions / cycles : 0.0, cacheMisses, branchMisses);
+		}
+
+		printf("\n");
+		fflush(stdout);
+	}
+
+	double BenchmarkResult::GetCounterPerIteration(PerfCounterType type) const
+	{
+		const u64 numIterations = (u64)Samples.size() * IterationsPerSample;
+		if(!HasCounters || numIterations == 0)
+			return 0.0;
+
+		return (double)Counters.Get(type) / (double)numIterations;
+	}
+
+	void BenchmarkResult::ComputeStatistics()
+	{
+		Vector<double> sorted = Samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		Median = percentile(sorted, 0.5);
+		Percentile95 = percentile(sorted, 0.95);
+		Minimum = sorted.empty() ? 0.0 : sorted.front();
+
+		double sum = 0.0;
+		Vector<double> deviations;
+		deviations.reserve(sorted.size());
+		for(auto& entry : sorted)
+		{
+			sum += entry;
+			deviations.push_back(std::abs(entry - Median));
+		}
+
+		std::sort(deviations.begin(), deviations.end());
+		MedianAbsoluteDeviation = percentile(deviations, 0.5);
+		Mean = sorted.empty() ? 0.0 : sum / (double)sorted.size();
+	}
+
+	BenchmarkRunner::BenchmarkRunner(const BenchmarkSettings& settings)
+		: mSettings(settings)
+	{}
+
+	void BenchmarkRunner::Add(BenchmarkDesc desc)
+	{
+		mBenchmarks.push_back(std::move(desc));
+	}
+
+	void BenchmarkRunner::Add(const String& name, std::function<void()> run, u32 itemsPerIteration)
+	{
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.Run = std::move(run);
+		desc.ItemsPerIteration = itemsPerIteration;
+
+		Add(std::move(desc));
+	}
+
+	void BenchmarkRunner::AddResult(BenchmarkResult result)
+	{
+		printResult(result);
+		mResults.push_back(std::move(result));
+	}
+
+	void BenchmarkRunner::ReportFailure(const String& name, const String& message)
+	{
+		BS_LOG(Error, Uncategorized, "Benchmark {0} failed: {1}", name, message);
+		mFailures.push_back(name + ": " + message);
+	}
+
+	void BenchmarkRunner::Run()
+	{
+		mResults.clear();
+
+		printf("%-48s %14s %12s %14s %14s", "Benchmark", "Median (ns)", "MAD (ns)", "P95 (ns)", "Per item (ns)");
+
+		// Hardware counters are reported per iteration, when available
+		if(PerfCounters::IsAvailable())
+			printf(" %6s %12s %12s", "IPC", "Cache miss", "Branch miss");
+
+		printf("\n");
+
+		for(auto& desc : mBenchmarks)
+		{
+			if(!mSettings.Filter.empty() && desc.Name.find(mSettings.Filter) == String::npos)
+				continue;
+
+			if(desc.Setup)
+				desc.Setup();
+
+			BenchmarkResult result = Measure(desc);
+
+			if(desc.Teardown)
+				desc.Teardown();
+
+			printResult(result);
+			mResults.push_back(std::move(result));
+		}
+	}
+
+	BenchmarkResult BenchmarkRunner::Measure(const BenchmarkDesc& desc) const
+	{
+		BenchmarkResult result;
+		result.Name = desc.Name;
+		result.ItemsPerIteration = desc.ItemsPerIteration;
+
+		// Warm up caches, branch predictors and any lazily initialized state, while finding out roughly how long an
+		// iteration takes
+		const double warmupTime = mSettings.WarmupTime * 1.0e9;
+
+		u64 numIterations = 1;
+		double elapsed = 0.0;
+		u64 totalIterations = 0;
+		while(elapsed < warmupTime)
+		{
+			elapsed += timeIterations(desc, numIterations);
+			totalIterations += numIterations;
+
+			numIterations *= 2;
+		}
+
+		// Pick the number of iterations so a single sample takes at least the requested sample time
+		const double timePerIteration = std::max(elapsed / (double)totalIterations, 1.0);
+		result.IterationsPerSample = std::max((u64)std::ceil(mSettings.SampleTime * 1.0e9 / timePerIteration), (u64)1);
+
+		// Hardware counters are read around the whole sampling phase, rather than each sample, so reading them doesn't
+		// affect the timings
+		PerfCounterValues startCounters;
+		const bool hasCounters = PerfCounters::Read(startCounters);
+
+		result.Samples.reserve(mSettings.NumSamples);
+		for(u32 i = 0; i < mSettings.NumSamples; i++)
+		{
+			const double sampleTime = timeIterations(desc, result.IterationsPerSample);
+			result.Samples.push_back(sampleTime / (double)result.IterationsPerSample);
+		}
+
+		PerfCounterValues endCounters;
+		if(hasCounters && PerfCounters::Read(endCounters))
+		{
+			result.Counters = endCounters - startCounters;
+			result.HasCounters = true;
+		}
+
+		result.ComputeStatistics();
+		return result;
+	}
+
+	String BenchmarkRunner::GetJSON() const
+	{
+		StringStream output;
+		output.precision(9);
+
+		output << "{\n\t\"benchmarks\": [";
+		for(u32 i = 0; i < (u32)mResults.size(); i++)
+		{
+			const BenchmarkResult& result = mResults[i];
+
+			output << (i > 0 ? ",\n" : "\n");
+			output << "\t\t{\n";
+			output << "\t\t\t\"name\": \"" << result.Name << "\",\n";
+			output << "\t\t\t\"items_per_iteration\": " << result.ItemsPerIteration << ",\n";
+			output << "\t\t\t\"iterations_per_sample\": " << result.IterationsPerSample << ",\n";
+			output << "\t\t\t\"median_ns\": " << result.Median << ",\n";
+			output << "\t\t\t\"mad_ns\": " << result.MedianAbsoluteDeviation << ",\n";
+			output << "\t\t\t\"mean_ns\": " << result.Mean << ",\n";
+			output << "\t\t\t\"min_ns\": " << result.Minimum << ",\n";
+			output << "\t\t\t\"p95_ns\": " << result.Percentile95 << ",\n";
+			output << "\t\t\t\"median_per_item_ns\": " << result.GetMedianPerItem() << ",\n";
+
+			if(result.HasCounters)
+			{
+				output << "\t\t\t\"cycles_per_iteration\": " <<
+					result.GetCounterPerIteration(PerfCounterType::Cycles) << ",\n";
+				output << "\t\t\t\"instructions_per_iteration\": " <<
+					result.GetCounterPerIteration(PerfCounterType::Instructions) << ",\n";
+				output << "\t\t\t\"cache_misses_per_iteration\": " <<
+					result.GetCounterPerIteration(PerfCounterType::CacheMisses) << ",\n";
+				output << "\t\t\t\"branch_misses_per_iteration\": " <<
+					result.GetCounterPerIteration(PerfCounterType::BranchMisses) << ",\n";
+			}
+
+			output << "\t\t\t\"samples_ns\": [";
+
+			for(u32 j = 0; j < (u32)result.Samples.size(); j++)
+				output << (j > 0 ? ", " : "") << result.Samples[j];
+
+			output << "]\n\t\t}";
+		}
+
+		output << "\n\t]\n}\n";
+		return output.str();
+	}
+
+	void BenchmarkRunner::SaveJSON(const Path& path) const
+	{
+		SPtr<DataStream> stream = FileSystem::CreateAndOpenFile(path);
+		if(stream == nullptr)
+		{
+			BS_LOG(Error, Uncategorized, "Unable to save the benchmark results to: " + path.ToString());
+			return;
+		}
+
+		stream->WriteString(GetJSON());
+		stream->Close();
+	}
+} // namespace bs
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "BsPerfCounters.h"
+
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+namespace bs
+{
+	/**
+	 * Prevents the compiler from optimizing away the computation of 'value', without adding any overhead other than
+	 * keeping the value in a register or memory.
+	 */
+	template<class T>
+	void doNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	/** Information about a single benchmark. */
+	struct BenchmarkDesc
+	{
+		String Name; /**< Unique name of the benchmark, in "Group.Benchmark" form. */
+
+		/** Called once before the benchmark is measured. Used for creating the objects used by the benchmark. */
+		std::function<void()> Setup;
+
+		/** Performs a single iteration of the measured work. */
+		std::function<void()> Run;
+
+		/** Called once after the benchmark is measured. Used for destroying the objects created in Setup. */
+		std::function<void()> Teardown;
+
+		/**
+		 * Number of items (e.g. components, vertices, matrices) processed by a single iteration. Used for reporting the
+		 * time per item, which makes benchmarks with different batch sizes comparable.
+		 */
+		u32 ItemsPerIteration = 1;
+	};
+
+	/** Timing statistics of a single benchmark. All times are in nanoseconds per iteration. */
+	struct BenchmarkResult
+	{
+		String Name;
+		u32 ItemsPerIteration = 1;
+		u64 IterationsPerSample = 0;
+		Vector<double> Samples; /**< Time per iteration measured by each sample. */
+
+		double Median = 0.0;
+		double MedianAbsoluteDeviation = 0.0; /**< Median of absolute differences from the median. Robust to outliers. */
+		double Mean = 0.0;
+		double Minimum = 0.0;
+		double Percentile95 = 0.0;
+
+		/**
+		 * Hardware counters accumulated over all samples, if they are available (see PerfCounters). Divide by the total
+		 * number of measured iterations (samples * iterations per sample) for per-iteration values.
+		 */
+		PerfCounterValues Counters;
+		bool HasCounters = false;
+
+		/** Returns the average value of a hardware counter per iteration, or zero if counters are unavailable. */
+		double GetCounterPerIteration(PerfCounterType type) const;
+
+		/** Returns the median time per processed item, in nanoseconds. */
+		double GetMedianPerItem() const { return Median / std::max(ItemsPerIteration, 1U); }
+
+		/** Calculates the statistics (median, MAD, mean, minimum, 95th percentile) from the current samples. */
+		void ComputeStatistics();
+	};
+
+	/** Controls how benchmarks are measured. */
+	struct BenchmarkSettings
+	{
+		float WarmupTime = 0.1f; /**< Time to run each benchmark before measuring, in seconds. */
+		float SampleTime = 0.01f; /**< Minimum duration of a single sample, in seconds. */
+		u32 NumSamples = 30; /**< Number of samples to measure. Statistics are computed over the samples. */
+		String Filter; /**< If not empty, only benchmarks whose name contains this string are run. */
+	};
+
+	/**
+	 * Runs a set of benchmarks and computes statistics about their timings. Each benchmark is first warmed up, after which
+	 * the number of iterations is calibrated so that a single sample takes at least the requested sample time (keeping
+	 * the timer overhead and resolution negligible). A number of samples is then measured, and their median, median
+	 * absolute deviation and 95th percentile are reported, as those are much less sensitive to the noise caused by the OS
+	 * and other processes than the mean.
+	 */
+	class BenchmarkRunner
+	{
+	public:
+		BenchmarkRunner(const BenchmarkSettings& settings = BenchmarkSettings());
+
+		/** Registers a new benchmark. */
+		void Add(BenchmarkDesc desc);
+
+		/** Registers a benchmark without setup or teardown. */
+		void Add(const String& name, std::function<void()> run, u32 itemsPerIteration = 1);
+
+		/** Runs all registered benchmarks matching the filter, and logs their results. */
+		void Run();
+
+		/**
+		 * Adds a result of a benchmark measured outside of the runner (e.g. frame times of an example), so it is reported
+		 * together with the other results.
+		 */
+		void AddResult(BenchmarkResult result);
+
+		/** Returns the results of the benchmarks executed by the last call to Run(), followed by any added results. */
+		const Vector<BenchmarkResult>& GetResults() const { return mResults; }
+
+		/**
+		 * Records that a benchmark produced incorrect results, e.g. when an optimized code path is checked against a
+		 * reference implementation. The failure is logged, and causes bsfExamplesBench to exit with an error.
+		 */
+		void ReportFailure(const String& name, const String& message);
+
+		/** Returns the failures reported since the runner was created, each prefixed with the name of the benchmark. */
+		const Vector<String>& GetFailures() const { return mFailures; }
+
+		/** Returns the settings the benchmarks are measured with. */
+		const BenchmarkSettings& GetSettings() const { return mSettings; }
+
+		/** Returns the results of the last run in JSON format. */
+		String GetJSON() const;
+
+		/** Saves the results of the last run in JSON format to the provided file. */
+		void SaveJSON(const Path& path) const;
+
+	private:
+		/** Measures a single benchmark. */
+		BenchmarkResult Measure(const BenchmarkDesc& desc) const;
+
+		BenchmarkSettings mSettings;
+		Vector<BenchmarkDesc> mBenchmarks;
+		Vector<BenchmarkResult> mResults;
+		Vector<String> mFailures;
+	};
+} // namespace bs
@@ -0,0 +1,262 @@
+#include "BsBenchmarkBaseline.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace bs
+{
+	/** First line of the baseline database file, used for identifying the file and its format version. */
+	static const char* BASELINE_FILE_HEADER = "# bsfExamplesBench baseline v1";
+
+	MannWhitneyResult mannWhitneyU(const Vector<double>& first, const Vector<double>& second)
+	{
+		MannWhitneyResult result;
+
+		const size_t n1 = first.size();
+		const size_t n2 = second.size();
+		if(n1 == 0 || n2 == 0)
+			return result;
+
+		// Rank all samples together, with tied samples receiving the average of the ranks they span
+		struct RankedSample
+		{
+			double Value;
+			bool IsFirst;
+		};
+
+		Vector<RankedSample> samples;
+		samples.reserve(n1 + n2);
+
+		for(auto& entry : first)
+			samples.push_back({ entry, true });
+
+		for(auto& entry : second)
+			samples.push_back({ entry, false });
+
+		std::sort(samples.begin(), samples.end(),
+			[](const RankedSample& lhs, const RankedSample& rhs) { return lhs.Value < rhs.Value; });
+
+		const size_t n = n1 + n2;
+		double rankSumFirst = 0.0;
+		double tieCorrection = 0.0;
+
+		for(size_t i = 0; i < n;)
+		{
+			size_t end = i + 1;
+			while(end < n && samples[end].Value == samples[i].Value)
+				end++;
+
+			// Ranks are 1-based
+			const double averageRank = (double)(i + 1 + end) * 0.5;
+			for(size_t j = i; j < end; j++)
+			{
+				if(samples[j].IsFirst)
+					rankSumFirst += averageRank;
+			}
+
+			const double numTied = (double)(end - i);
+			tieCorrection += numTied * numTied * numTied - numTied;
+
+			i = end;
+		}
+
+		const double size1 = (double)n1;
+		const double size2 = (double)n2;
+		const double size = (double)n;
+
+		result.U = rankSumFirst - size1 * (size1 + 1.0) * 0.5;
+		result.ProbabilityGreater = result.U / (size1 * size2);
+
+		const double mean = size1 * size2 * 0.5;
+		const double variance = size1 * size2 / 12.0 * ((size + 1.0) - tieCorrection / (size * (size - 1.0)));
+		if(variance <= 0.0)
+			return result;
+
+		// Normal approximation with continuity correction, accurate enough for the sample counts used by benchmarks
+		const double difference = std::abs(result.U - mean);
+		const double z = std::max(difference - 0.5, 0.0) / std::sqrt(variance);
+		result.PValue = std::erfc(z / std::sqrt(2.0));
+
+		return result;
+	}
+
+	bool BenchmarkBaseline::Load(const Path& path)
+	{
+		mEntries.clear();
+
+		if(!FileSystem::Exists(path))
+			return false;
+
+		SPtr<DataStream> stream = FileSystem::OpenFile(path);
+		if(stream == nullptr)
+			return false;
+
+		StringStream input(stream->GetAsString());
+		stream->Close();
+
+		String line;
+		if(!std::getline(input, line) || line != BASELINE_FILE_HEADER)
+		{
+			BS_LOG(Warning, Uncategorized, "Ignoring benchmark baseline with an unknown format: " + path.ToString());
+			return false;
+		}
+
+		// Each line contains a single benchmark: name, items per iteration, iterations per sample, sample count, samples
+		while(std::getline(input, line))
+		{
+			if(line.empty() || line[0] == '#')
+				continue;
+
+			StringStream lineStream(line);
+
+			BenchmarkResult result;
+			u32 numSamples = 0;
+			if(!(lineStream >> result.Name >> result.ItemsPerIteration >> result.IterationsPerSample >> numSamples))
+				continue;
+
+			result.Samples.resize(numSamples);
+			for(auto& entry : result.Samples)
+				lineStream >> entry;
+
+			if(lineStream.fail())
+				continue;
+
+			result.ComputeStatistics();
+			mEntries[result.Name] = std::move(result);
+		}
+
+		return true;
+	}
+
+	void BenchmarkBaseline::Save(const Path& path) const
+	{
+		StringStream output;
+		output.precision(9);
+
+		output << BASELINE_FILE_HEADER << "\n";
+		for(auto& entry : mEntries)
+		{
+			const BenchmarkResult& result = entry.second;
+
+			output << result.Name << " " << result.ItemsPerIteration << " " << result.IterationsPerSample << " "
+				<< result.Samples.size();
+
+			for(auto& sample : result.Samples)
+				output << " " << sample;
+
+			output << "\n";
+		}
+
+		SPtr<DataStream> stream = FileSystem::CreateAndOpenFile(path);
+		if(stream == nullptr)
+		{
+			BS_LOG(Error, Uncategorized, "Unable to save the benchmark baseline to: " + path.ToString());
+			return;
+		}
+
+		stream->WriteString(output.str());
+		stream->Close();
+	}
+
+	void BenchmarkBaseline::Update(const Vector<BenchmarkResult>& results)
+	{
+		for(auto& entry : results)
+			mEntries[entry.Name] = entry;
+	}
+
+	Vector<BenchmarkComparison> BenchmarkBaseline::Compare(const Vector<BenchmarkResult>& results,
+		const BenchmarkComparisonSettings& settings) const
+	{
+		Vector<BenchmarkComparison> comparisons;
+		comparisons.reserve(results.size());
+
+		for(auto& result : results)
+		{
+			BenchmarkComparison comparison;
+			comparison.Name = result.Name;
+			comparison.CurrentMedian = result.Median;
+
+			auto iterFind = mEntries.find(result.Name);
+			if(iterFind == mEntries.end())
+			{
+				comparisons.push_back(comparison);
+				continue;
+			}
+
+			const BenchmarkResult& baseline = iterFind->second;
+			comparison.BaselineMedian = baseline.Median;
+			comparison.RelativeChange = baseline.Median > 0.0 ? (result.Median / baseline.Median - 1.0) : 0.0;
+			comparison.Test = mannWhitneyU(result.Samples, baseline.Samples);
+
+			// Require both a significant and a large enough change, since with many samples even tiny (and irrelevant)
+			// differences become statistically significant
+			const bool isSignificant = comparison.Test.PValue < settings.SignificanceLevel;
+			if(isSignificant && comparison.RelativeChange > settings.Threshold)
+				comparison.Verdict = BenchmarkVerdict::Regression;
+			else if(isSignificant && comparison.RelativeChange < -settings.Threshold)
+				comparison.Verdict = BenchmarkVerdict::Improvement;
+			else
+				comparison.Verdict = BenchmarkVerdict::Unchanged;
+
+			comparisons.push_back(comparison);
+		}
+
+		return comparisons;
+	}
+
+	String BenchmarkBaseline::GetReport(const Vector<BenchmarkComparison>& comparisons)
+	{
+		static const char* VERDICT_NAMES[] = { "unchanged", "REGRESSION", "improvement", "new" };
+
+		// Regressions first, followed by improvements, unchanged and new benchmarks
+		static const u32 VERDICT_ORDER[] = { 2, 0, 1, 3 };
+
+		Vector<const BenchmarkComparison*> sorted;
+		sorted.reserve(comparisons.size());
+		for(auto& entry : comparisons)
+			sorted.push_back(&entry);
+
+		std::stable_sort(sorted.begin(), sorted.end(),
+			[](const BenchmarkComparison* lhs, const BenchmarkComparison* rhs)
+			{
+				return VERDICT_ORDER[(u32)lhs->Verdict] < VERDICT_ORDER[(u32)rhs->Verdict];
+			});
+
+		u32 counts[4] = { 0, 0, 0, 0 };
+		for(auto& entry : comparisons)
+			counts[(u32)entry.Verdict]++;
+
+		StringStream output;
+
+		char line[256];
+		snprintf(line, sizeof(line), "%-48s %-12s %14s %14s %9s %10s %8s\n", "Benchmark", "Verdict", "Baseline (ns)",
+			"Current (ns)", "Change", "p-value", "P(slower)");
+		output << line;
+
+		for(auto& entry : sorted)
+		{
+			if(entry->Verdict == BenchmarkVerdict::New)
+			{
+				snprintf(line, sizeof(line), "%-48s %-12s %14s %14.1f\n", entry->Name.c_str(),
+					VERDICT_NAMES[(u32)entry->Verdict], "-", entry->CurrentMedian);
+			}
+			else
+			{
+				snprintf(line, sizeof(line), "%-48s %-12s %14.1f %14.1f %+8.1f%% %10.2g %8.2f\n", entry->Name.c_str(),
+					VERDICT_NAMES[(u32)entry->Verdict], entry->BaselineMedian, entry->CurrentMedian,
+					entry->RelativeChange * 100.0, entry->Test.PValue, entry->Test.ProbabilityGreater);
+			}
+
+			output << line;
+		}
+
+		output << "\n" << counts[(u32)BenchmarkVerdict::Regression] << " regression(s), "
+			<< counts[(u32)BenchmarkVerdict::Improvement] << " improvement(s), "
+			<< counts[(u32)BenchmarkVerdict::Unchanged] << " unchanged, "
+			<< counts[(u32)BenchmarkVerdict::New] << " without a baseline\n";
+
+		return output.str();
+	}
+} // namespace bs
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "BsBenchmark.h"
+
+namespace bs
+{
+	/** Result of a Mann-Whitney U test comparing two sets of samples. */
+	struct MannWhitneyResult
+	{
+		double U = 0.0; /**< U statistic of the first set of samples. */
+
+		/**
+		 * Two-sided p-value: probability of the observed difference (or a larger one) if both sets come from the same
+		 * distribution. Low values mean the difference is unlikely to be caused by noise.
+		 */
+		double PValue = 1.0;
+
+		/** Probability that a random sample from the first set is larger than a random sample from the second set. */
+		double ProbabilityGreater = 0.5;
+	};
+
+	/**
+	 * Performs the Mann-Whitney U test on two sets of samples, using the normal approximation with tie correction. Unlike
+	 * a t-test it makes no assumptions about the shape of the distributions, which makes it a good fit for timings (which
+	 * are skewed, with long tails caused by the OS scheduler, and often multi-modal).
+	 */
+	MannWhitneyResult mannWhitneyU(const Vector<double>& first, const Vector<double>& second);
+
+	/** Outcome of comparing a benchmark result against its baseline. */
+	enum class BenchmarkVerdict
+	{
+		Unchanged, /**< No significant change, or a change below the threshold. */
+		Regression, /**< Significantly slower than the baseline. */
+		Improvement, /**< Significantly faster than the baseline. */
+		New /**< No baseline exists for the benchmark. */
+	};
+
+	/** Comparison of a single benchmark result against its baseline. */
+	struct BenchmarkComparison
+	{
+		String Name;
+		BenchmarkVerdict Verdict = BenchmarkVerdict::New;
+
+		double BaselineMedian = 0.0; /**< Median time of the baseline, in nanoseconds. */
+		double CurrentMedian = 0.0; /**< Median time of the current result, in nanoseconds. */
+		double RelativeChange = 0.0; /**< Change of the median relative to the baseline (e.g. 0.1 for 10% slower). */
+
+		MannWhitneyResult Test; /**< Current samples compared against the baseline samples. */
+	};
+
+	/** Controls when a difference from the baseline is reported as a regression or an improvement. */
+	struct BenchmarkComparisonSettings
+	{
+		/** Minimum relative change of the median required to report a difference (e.g. 0.05 for 5%). */
+		double Threshold = 0.05;
+
+		/** Maximum p-value of the Mann-Whitney U test required to report a difference. */
+		double SignificanceLevel = 0.01;
+	};
+
+	/**
+	 * Database of baseline benchmark results, stored in a local file. Results of each run can be compared against the
+	 * baseline to find performance regressions, e.g. after updating the engine. Only the latest baseline of each benchmark
+	 * is kept, and it only changes when explicitly updated.
+	 */
+	class BenchmarkBaseline
+	{
+	public:
+		/** Loads the baseline from the provided file. Returns false if the file doesn't exist or isn't valid. */
+		bool Load(const Path& path);
+
+		/** Saves the baseline to the provided file. */
+		void Save(const Path& path) const;
+
+		/** Replaces the baselines of the provided benchmarks with their current results. */
+		void Update(const Vector<BenchmarkResult>& results);
+
+		/** Returns true if the baseline doesn't contain any results. */
+		bool IsEmpty() const { return mEntries.empty(); }
+
+		/**
+		 * Compares the results against the baseline. A result is reported as a regression or an improvement only if its
+		 * median changed by more than the threshold and the change is statistically significant.
+		 */
+		Vector<BenchmarkComparison> Compare(const Vector<BenchmarkResult>& results,
+			const BenchmarkComparisonSettings& settings = BenchmarkComparisonSettings()) const;
+
+		/** Generates a readable report of the comparisons, listing regressions first. */
+		static String GetReport(const Vector<BenchmarkComparison>& comparisons);
+
+	private:
+		Map<String, BenchmarkResult> mEntries;
+	};
+} // namespace bs
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "BsBenchmark.h"
+
+namespace bs
+{
+	/**
+	 * Registers benchmarks for the per-frame update of the example components (CameraFlyer, FPSCamera, ObjectRotator),
+	 * each running on many instances. CameraFlyer and ObjectRotator are measured both while idle and with their buttons
+	 * held. Also checks that the interpolation alpha of FPSWalker follows the engine's fixed update loop at frame rates
+	 * that don't match the fixed update rate, failing the run otherwise.
+	 */
+	void registerComponentBenchmarks(BenchmarkRunner& runner);
+
+	/** Registers benchmarks for the box geometry writers and the batched transform math, compared to the scalar math. */
+	void registerMathBenchmarks(BenchmarkRunner& runner);
+
+	/**
+	 * Registers benchmarks for sequential playback of a long curve and a long clip, comparing the cached keyframe search
+	 * of TCurveEvaluator and AnimationClipSampler to searching the curves directly.
+	 */
+	void registerAnimationBenchmarks(BenchmarkRunner& runner);
+
+	/** Registers benchmarks for scene transform propagation and resource handle lookups. */
+	void registerSceneBenchmarks(BenchmarkRunner& runner);
+
+	/**
+	 * Registers benchmarks for hit-testing pointer input against 50k GUI elements, comparing a linear search to the GUI
+	 * spatial grid, and for updating the grid after layout changes. Also registers benchmarks for laying out the labels of
+	 * a panel with and without the TextLayoutCache, logging the cache hit rate.
+	 */
+	void registerGUIBenchmarks(BenchmarkRunner& runner);
+
+	/**
+	 * Registers benchmarks for culling 20k objects against four views, comparing the renderer's per-camera culling to the
+	 * shared pass of MultiViewVisibility, both on its own and followed by the renderer culling the remaining objects.
+	 */
+	void registerCullingBenchmarks(BenchmarkRunner& runner);
+
+	/**
+	 * Registers benchmarks for churning allocations of a size-class GpuMemoryHeap and for per-frame allocations from a
+	 * linear one. The size-class heap is defragmented afterwards, logging its stats before and after, and failing the run
+	 * if any external fragmentation is left.
+	 */
+	void registerGpuHeapBenchmarks(BenchmarkRunner& runner);
+
+	/**
+	 * Runs each example as a non-interactive benchmark scenario (see BenchmarkScenario) and adds its frame times to the
+	 * runner results, one sample per frame. Examples are expected to be in 'examplesFolder', and are skipped otherwise.
+	 */
+	void runScenarioBenchmarks(BenchmarkRunner& runner, const Path& examplesFolder, u32 numFrames);
+} // namespace bs
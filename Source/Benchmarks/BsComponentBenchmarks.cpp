@@ -0,0 +1,227 @@
+#include "BsBenchmarkSuites.h"
+#include "Scene/BsSceneObject.h"
+#include "Input/BsInput.h"
+#include "Math/BsRandom.h"
+
+// Example includes
+#include "BsCameraFlyer.h"
+#include "BsFPSCamera.h"
+#include "BsObjectRotator.h"
+#include "BsFPSWalker.h"
+
+namespace bs
+{
+	/** Number of component instances updated by a single benchmark iteration. */
+	constexpr u32 NUM_COMPONENT_INSTANCES = 1000;
+
+	/** Number of frames simulated when checking the fixed step interpolation at each combination of rates. */
+	constexpr u32 NUM_INTERPOLATION_FRAMES = 3000;
+
+	/** Time given to FixedStepAccumulator to lock onto the phase of the emulated engine accumulator, in seconds. */
+	constexpr float INTERPOLATION_LOCK_TIME = 2.0f;
+
+	/** Largest difference allowed between the tracked and the emulated engine alpha once locked on, in steps. */
+	constexpr float INTERPOLATION_ALPHA_TOLERANCE = 0.1f;
+
+	/**
+	 * Reports a press or a release of each of the provided buttons through the input events, as if they came from the
+	 * platform. Virtual input listens to the same events, so the bound virtual buttons are held until released.
+	 */
+	static void sendButtonEvents(const Vector<ButtonCode>& buttons, bool pressed)
+	{
+		for(auto button : buttons)
+		{
+			ButtonEvent event;
+			event.ButtonCode = button;
+			event.DeviceIdx = 0;
+			event.Timestamp = 0;
+
+			if(pressed)
+				gInput().OnButtonDown(event);
+			else
+				gInput().OnButtonUp(event);
+		}
+	}
+
+	/**
+	 * Registers a benchmark that calls Update() on many instances of component 'T', each on its own scene object. The
+	 * provided buttons are held for the duration of the benchmark, so the components take the same paths as when
+	 * controlled by the user. If none are provided this measures the cost the components add to every frame while idle.
+	 *
+	 * Mouse movement can't be reported through the input events, so the axes read by the components stay at zero. The
+	 * rotation is still computed and applied to the scene objects every update while the rotation button is held.
+	 */
+	template<class T>
+	static void addComponentUpdateBenchmark(BenchmarkRunner& runner, const String& name,
+		const Vector<ButtonCode>& heldButtons = {})
+	{
+		struct State
+		{
+			HSceneObject Root;
+			Vector<GameObjectHandle<T>> Components;
+		};
+
+		auto state = bs_shared_ptr_new<State>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_COMPONENT_INSTANCES;
+		desc.Setup = [state, heldButtons]()
+		{
+			state->Root = SceneObject::Create("Benchmark");
+
+			state->Components.reserve(NUM_COMPONENT_INSTANCES);
+			for(u32 i = 0; i < NUM_COMPONENT_INSTANCES; i++)
+			{
+				HSceneObject so = SceneObject::Create("Object");
+				so->SetParent(state->Root);
+				so->SetPosition(Vector3((float)(i % 32), 0.0f, (float)(i / 32)));
+
+				state->Components.push_back(so->AddComponent<T>());
+			}
+
+			sendButtonEvents(heldButtons, true);
+		};
+
+		desc.Run = [state]()
+		{
+			for(auto& component : state->Components)
+				component->Update();
+		};
+
+		desc.Teardown = [state, heldButtons]()
+		{
+			sendButtonEvents(heldButtons, false);
+
+			state->Components.clear();
+			state->Root->Destroy();
+			state->Root = nullptr;
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	/**
+	 * Emulates the engine's fixed update loop at the provided rates, with frame times varying by up to 10%, and checks
+	 * FixedStepAccumulator (used by FPSWalker for interpolation) against it. The alpha must always be in [0, 1), match
+	 * the emulated engine accumulator once locked on, and span the whole range rather than sticking to either pose.
+	 * Reports a failure of the benchmark to the runner and returns false if any check fails.
+	 */
+	static bool checkFixedStepAlpha(float fixedRate, float frameRate, BenchmarkRunner& runner, const String& name)
+	{
+		const float stepSize = 1.0f / fixedRate;
+		const String rates = toString(frameRate) + " FPS with " + toString(fixedRate) + " Hz fixed steps";
+
+		Random random(1234);
+
+		// Start out of phase with the engine, as when the component is created while the application is running
+		float engineAccumulated = stepSize * 0.37f;
+		FixedStepAccumulator accumulator;
+
+		float minAlpha = 1.0f;
+		float maxAlpha = 0.0f;
+		for(u32 i = 0; i < NUM_INTERPOLATION_FRAMES; i++)
+		{
+			const float frameDelta = random.GetRange(0.9f, 1.1f) / frameRate;
+
+			accumulator.BeginFrame(frameDelta, stepSize);
+			engineAccumulated += frameDelta;
+
+			while(engineAccumulated >= stepSize)
+			{
+				engineAccumulated -= stepSize;
+				accumulator.Step(stepSize);
+			}
+
+			const float alpha = accumulator.GetAlpha(stepSize);
+			if(alpha < 0.0f || alpha >= 1.0f)
+			{
+				runner.ReportFailure(name, "Interpolation alpha " + toString(alpha) + " out of range at " + rates);
+				return false;
+			}
+
+			if(i < (u32)(INTERPOLATION_LOCK_TIME * frameRate))
+				continue;
+
+			const float expectedAlpha = engineAccumulated / stepSize;
+			if(std::abs(alpha - expectedAlpha) > INTERPOLATION_ALPHA_TOLERANCE)
+			{
+				runner.ReportFailure(name, "Interpolation alpha " + toString(alpha) + " doesn't match the engine's " +
+					toString(expectedAlpha) + " at " + rates);
+				return false;
+			}
+
+			minAlpha = std::min(minAlpha, alpha);
+			maxAlpha = std::max(maxAlpha, alpha);
+		}
+
+		if(minAlpha > 0.1f || maxAlpha < 0.9f)
+		{
+			runner.ReportFailure(name, "Interpolation alpha only spans [" + toString(minAlpha) + ", " +
+				toString(maxAlpha) + "] at " + rates);
+			return false;
+		}
+
+		return true;
+	}
+
+	/**
+	 * Registers a benchmark that advances FixedStepAccumulator through a frame with two fixed steps, for many walkers. The
+	 * accumulator is checked against the engine's fixed update loop at frame rates that don't match the fixed update rate
+	 * before it is benchmarked.
+	 */
+	static void addFixedStepAlphaBenchmark(BenchmarkRunner& runner, const String& name)
+	{
+		auto accumulators = bs_shared_ptr_new<Vector<FixedStepAccumulator>>(NUM_COMPONENT_INSTANCES);
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_COMPONENT_INSTANCES;
+		desc.Setup = [&runner, name]()
+		{
+			const float fixedRates[] = { 60.0f, 50.0f };
+			const float frameRates[] = { 144.0f, 75.0f, 60.0f, 45.0f, 30.0f };
+
+			for(auto fixedRate : fixedRates)
+			{
+				for(auto frameRate : frameRates)
+					checkFixedStepAlpha(fixedRate, frameRate, runner, name);
+			}
+		};
+
+		desc.Run = [accumulators]()
+		{
+			const float stepSize = 1.0f / 60.0f;
+
+			float sum = 0.0f;
+			for(auto& accumulator : *accumulators)
+			{
+				accumulator.BeginFrame(1.0f / 30.0f, stepSize);
+				accumulator.Step(stepSize);
+				accumulator.Step(stepSize);
+
+				sum += accumulator.GetAlpha(stepSize);
+			}
+
+			doNotOptimize(sum);
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	void registerComponentBenchmarks(BenchmarkRunner& runner)
+	{
+		addComponentUpdateBenchmark<CameraFlyer>(runner, "Components.CameraFlyer.Update");
+		addComponentUpdateBenchmark<ObjectRotator>(runner, "Components.ObjectRotator.Update");
+
+		// Flying forward and to the side at the fast speed while rotating, and rotating the objects
+		addComponentUpdateBenchmark<CameraFlyer>(runner, "Components.CameraFlyer.Update.Input",
+			{ BC_W, BC_D, BC_LSHIFT, BC_MOUSE_RIGHT });
+		addComponentUpdateBenchmark<ObjectRotator>(runner, "Components.ObjectRotator.Update.Input", { BC_MOUSE_LEFT });
+
+		// FPSCamera::ApplyAngles() is private and runs as part of every Update()
+		addComponentUpdateBenchmark<FPSCamera>(runner, "Components.FPSCamera.ApplyAngles");
+
+		addFixedStepAlphaBenchmark(runner, "Components.FPSWalker.InterpolationAlpha");
+	}
+} // namespace bs
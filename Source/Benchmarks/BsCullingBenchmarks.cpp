@@ -0,0 +1,119 @@
+#include "BsBenchmarkSuites.h"
+#include "Math/BsConvexVolume.h"
+#include "Math/BsSphere.h"
+#include "Math/BsRandom.h"
+
+// Example includes
+#include "BsMultiViewCuller.h"
+
+namespace bs
+{
+	/** Number of objects culled by the culling benchmarks. */
+	constexpr u32 NUM_CULL_OBJECTS = 20000;
+
+	/** Number of views the objects are culled against. */
+	constexpr u32 NUM_CULL_VIEWS = 4;
+
+	/** Size of the area the objects are spread over, in meters. */
+	constexpr float CULL_AREA_SIZE = 400.0f;
+
+	/** Objects and views culled by the culling benchmarks. */
+	struct CullState
+	{
+		CullState()
+		{
+			Random random(1234);
+
+			Bounds.resize(NUM_CULL_OBJECTS);
+			Spheres.resize(NUM_CULL_OBJECTS);
+			for(u32 i = 0; i < NUM_CULL_OBJECTS; i++)
+			{
+				const Vector3 center(random.GetRange(-CULL_AREA_SIZE, CULL_AREA_SIZE) * 0.5f,
+					random.GetRange(0.0f, 20.0f), random.GetRange(-CULL_AREA_SIZE, CULL_AREA_SIZE) * 0.5f);
+				const Vector3 halfSize = Vector3::ONE * random.GetRange(0.25f, 2.0f);
+
+				Bounds[i] = AABox(center - halfSize, center + halfSize);
+				Spheres[i] = Sphere(center, halfSize.Length());
+			}
+
+			// Views spread around the area, looking towards its center, similar to split-screen players
+			const Matrix4 projection = Matrix4::ProjectionPerspective(Degree(75.0f), 16.0f / 9.0f, 0.05f, 500.0f);
+			for(u32 i = 0; i < NUM_CULL_VIEWS; i++)
+			{
+				const Degree angle(360.0f * i / NUM_CULL_VIEWS);
+				const Vector3 position(Math::Cos(angle) * 100.0f, 10.0f, Math::Sin(angle) * 100.0f);
+
+				Quaternion rotation;
+				rotation.LookRotation(-position);
+
+				Frustums.push_back(ConvexVolume(projection * Matrix4::View(position, rotation)));
+			}
+
+			Visibility.SetViews(Frustums);
+		}
+
+		Vector<AABox> Bounds;
+		Vector<Sphere> Spheres;
+		Vector<ConvexVolume> Frustums;
+
+		MultiViewVisibility Visibility;
+		Vector<u32> Masks;
+	};
+
+	/**
+	 * Culls the objects against each view the way the renderer does for every camera: objects whose layer doesn't match
+	 * the camera are skipped, and the rest are tested with their bounding sphere and then their box. 'masks' provides the
+	 * per-object view bits standing in for the layers. If null, all objects match every camera, as they do when the
+	 * layers aren't assigned by the MultiViewCuller. Returns the number of visible objects, summed over all views.
+	 */
+	static u32 cullLikeRenderer(const CullState& state, const Vector<u32>* masks)
+	{
+		u32 numVisible = 0;
+		for(u32 i = 0; i < NUM_CULL_VIEWS; i++)
+		{
+			const ConvexVolume& frustum = state.Frustums[i];
+			for(u32 j = 0; j < NUM_CULL_OBJECTS; j++)
+			{
+				if(masks != nullptr && ((*masks)[j] & (1 << i)) == 0)
+					continue;
+
+				if(frustum.Intersects(state.Spheres[j]) && frustum.Intersects(state.Bounds[j]))
+					numVisible++;
+			}
+		}
+
+		return numVisible;
+	}
+
+	void registerCullingBenchmarks(BenchmarkRunner& runner)
+	{
+		auto state = bs_shared_ptr_new<CullState>();
+
+		// What the renderer does on its own, with every camera culling every object
+		runner.Add("Culling.MultiView.Renderer", [state]()
+		{
+			doNotOptimize(cullLikeRenderer(*state, nullptr));
+		}, NUM_CULL_OBJECTS);
+
+		// The shared pass of the MultiViewCuller on its own, and the reference testing each view separately
+		runner.Add("Culling.MultiView.Shared", [state]()
+		{
+			state->Visibility.Compute(state->Bounds, state->Masks);
+			doNotOptimize(state->Masks[0]);
+		}, NUM_CULL_OBJECTS);
+
+		runner.Add("Culling.MultiView.SharedPerView", [state]()
+		{
+			state->Visibility.ComputePerView(state->Bounds, state->Masks);
+			doNotOptimize(state->Masks[0]);
+		}, NUM_CULL_OBJECTS);
+
+		// The full cost when using the MultiViewCuller: the shared pass, after which the renderer still culls each camera,
+		// but skips the objects outside of it by their layer
+		runner.Add("Culling.MultiView.SharedThenRenderer", [state]()
+		{
+			state->Visibility.Compute(state->Bounds, state->Masks);
+			doNotOptimize(cullLikeRenderer(*state, &state->Masks));
+		}, NUM_CULL_OBJECTS);
+	}
+} // namespace bs
@@ -0,0 +1,335 @@
+#include "BsBenchmarkSuites.h"
+#include "GUI/BsGUIButton.h"
+#include "GUI/BsGUILabel.h"
+#include "GUI/BsGUISkin.h"
+#include "Resources/BsBuiltinResources.h"
+#include "Math/BsRandom.h"
+#include "Math/BsMath.h"
+
+// Example includes
+#include "BsGUISpatialGrid.h"
+#include "BsTextLayoutCache.h"
+
+namespace bs
+{
+	/** Number of GUI elements hit-tested against by the GUI benchmarks. */
+	constexpr u32 NUM_GUI_ELEMENTS = 50000;
+
+	/** Number of pointer move events hit-tested by a single iteration of the hit-testing benchmarks. */
+	constexpr u32 NUM_POINTER_EVENTS = 256;
+
+	/** Number of elements moved by a single iteration of the layout update benchmark. */
+	constexpr u32 NUM_LAYOUT_UPDATES = 1000;
+
+	/** Size of the area the elements are spread over, in pixels. Similar to a large scrollable tool UI. */
+	constexpr i32 GUI_AREA_SIZE = 8192;
+
+	/** Number of depth levels the elements are spread over, representing overlapping panels. */
+	constexpr u32 NUM_GUI_DEPTHS = 16;
+
+	/** Number of labels laid out by a single iteration of the text layout benchmarks. */
+	constexpr u32 NUM_TEXT_LABELS = 200;
+
+	/** Number of the labels whose text changes every iteration, such as labels displaying live values. */
+	constexpr u32 NUM_CHANGING_TEXT_LABELS = 16;
+
+	/** Elements to hit-test against, along with the path of a pointer moving over them. */
+	struct GUIHitTestState
+	{
+		Vector<GUIElement*> Elements;
+		Vector<Rect2I> Bounds;
+		Vector<u32> Depths;
+		GUISpatialGrid Grid;
+
+		Vector<Vector2I> PointerPath;
+		u32 PointerPathIdx = 0;
+		u32 UpdateIdx = 0;
+	};
+
+	/**
+	 * Creates the elements and places them at random. Every 1000th element is a large panel covering a big part of the
+	 * area. The pointer path is a random walk with small steps, as generated by high-frequency mouse input.
+	 */
+	static void createHitTestState(GUIHitTestState& state)
+	{
+		Random random(1234);
+
+		HString label("Button");
+		state.Elements.reserve(NUM_GUI_ELEMENTS);
+		state.Bounds.reserve(NUM_GUI_ELEMENTS);
+		state.Depths.reserve(NUM_GUI_ELEMENTS);
+
+		for(u32 i = 0; i < NUM_GUI_ELEMENTS; i++)
+		{
+			Rect2I bounds;
+			if((i % 1000) == 0)
+			{
+				bounds.X = (i32)random.GetRange(0.0f, (float)GUI_AREA_SIZE / 2);
+				bounds.Y = (i32)random.GetRange(0.0f, (float)GUI_AREA_SIZE / 2);
+				bounds.Width = (u32)GUI_AREA_SIZE / 2;
+				bounds.Height = (u32)GUI_AREA_SIZE / 2;
+			}
+			else
+			{
+				bounds.X = (i32)random.GetRange(0.0f, (float)GUI_AREA_SIZE);
+				bounds.Y = (i32)random.GetRange(0.0f, (float)GUI_AREA_SIZE);
+				bounds.Width = (u32)random.GetRange(40.0f, 200.0f);
+				bounds.Height = (u32)random.GetRange(16.0f, 40.0f);
+			}
+
+			const u32 depth = (u32)random.GetRange(0.0f, (float)NUM_GUI_DEPTHS - 0.5f);
+
+			GUIElement* element = GUIButton::Create(label);
+			state.Elements.push_back(element);
+			state.Bounds.push_back(bounds);
+			state.Depths.push_back(depth);
+			state.Grid.Insert(element, bounds, depth);
+		}
+
+		Vector2I position(GUI_AREA_SIZE / 2, GUI_AREA_SIZE / 2);
+		state.PointerPath.reserve(NUM_POINTER_EVENTS * 16);
+		for(u32 i = 0; i < NUM_POINTER_EVENTS * 16; i++)
+		{
+			position.X = Math::Clamp(position.X + (i32)random.GetRange(-8.0f, 8.0f), 0, GUI_AREA_SIZE - 1);
+			position.Y = Math::Clamp(position.Y + (i32)random.GetRange(-8.0f, 8.0f), 0, GUI_AREA_SIZE - 1);
+			state.PointerPath.push_back(position);
+		}
+	}
+
+	/** Destroys the elements created by createHitTestState(). */
+	static void destroyHitTestState(GUIHitTestState& state)
+	{
+		for(auto& element : state.Elements)
+			GUIElement::Destroy(element);
+
+		state.Elements.clear();
+		state.Bounds.clear();
+		state.Depths.clear();
+		state.Grid.Clear();
+		state.PointerPath.clear();
+	}
+
+	/** Returns the pointer position of the next pointer move event. */
+	static Vector2I getNextPointerPosition(GUIHitTestState& state)
+	{
+		const Vector2I& position = state.PointerPath[state.PointerPathIdx];
+		state.PointerPathIdx = (state.PointerPathIdx + 1) % (u32)state.PointerPath.size();
+
+		return position;
+	}
+
+	/**
+	 * Returns the index of the front-most element under the pointer by testing the bounds of every element, or -1 if
+	 * there is none. Follows the same rules as the grid: lowest depth wins, and later elements win ties.
+	 */
+	static u32 findTopmostLinear(const GUIHitTestState& state, const Vector2I& position)
+	{
+		u32 topmostIdx = (u32)-1;
+		for(u32 i = 0; i < (u32)state.Elements.size(); i++)
+		{
+			if(!state.Bounds[i].Contains(position))
+				continue;
+
+			if(topmostIdx == (u32)-1 || state.Depths[i] <= state.Depths[topmostIdx])
+				topmostIdx = i;
+		}
+
+		return topmostIdx;
+	}
+
+	/**
+	 * Checks that the grid finds the same front-most element as testing every element, at every position of the pointer
+	 * path. Reports a failure of the benchmark to the runner and returns false on the first mismatch.
+	 */
+	static bool checkGridMatchesLinear(const GUIHitTestState& state, BenchmarkRunner& runner, const String& name)
+	{
+		for(auto& position : state.PointerPath)
+		{
+			const u32 expectedIdx = findTopmostLinear(state, position);
+			const GUIElement* expected = expectedIdx != (u32)-1 ? state.Elements[expectedIdx] : nullptr;
+
+			if(state.Grid.FindTopmost(position) != expected)
+			{
+				runner.ReportFailure(name, "GUI spatial grid returned the wrong element at (" + toString(position.X) +
+					", " + toString(position.Y) + ")");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/**
+	 * Registers a benchmark that finds the front-most element under the pointer for each pointer move event. If
+	 * 'useGrid' is false each event tests the bounds of every element, otherwise the spatial grid is used. The grid is
+	 * checked against testing every element before it is benchmarked.
+	 */
+	static void addHitTestBenchmark(BenchmarkRunner& runner, const String& name, bool useGrid)
+	{
+		auto state = bs_shared_ptr_new<GUIHitTestState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_POINTER_EVENTS;
+		desc.Setup = [state, useGrid, &runner, name]()
+		{
+			createHitTestState(*state);
+
+			if(useGrid)
+				checkGridMatchesLinear(*state, runner, name);
+		};
+
+		if(useGrid)
+		{
+			desc.Run = [state]()
+			{
+				for(u32 i = 0; i < NUM_POINTER_EVENTS; i++)
+					doNotOptimize(state->Grid.FindTopmost(getNextPointerPosition(*state)));
+			};
+		}
+		else
+		{
+			desc.Run = [state]()
+			{
+				for(u32 i = 0; i < NUM_POINTER_EVENTS; i++)
+					doNotOptimize(findTopmostLinear(*state, getNextPointerPosition(*state)));
+			};
+		}
+
+		desc.Teardown = [state]() { destroyHitTestState(*state); };
+
+		runner.Add(std::move(desc));
+	}
+
+	/**
+	 * Registers a benchmark that moves elements around, as a layout update would, and updates them in the grid. Once done
+	 * the grid is checked against testing every element, to catch elements left behind in the cells they moved out of.
+	 */
+	static void addLayoutUpdateBenchmark(BenchmarkRunner& runner, const String& name)
+	{
+		auto state = bs_shared_ptr_new<GUIHitTestState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_LAYOUT_UPDATES;
+		desc.Setup = [state]() { createHitTestState(*state); };
+		desc.Run = [state]()
+		{
+			for(u32 i = 0; i < NUM_LAYOUT_UPDATES; i++)
+			{
+				const u32 elementIdx = state->UpdateIdx;
+				state->UpdateIdx = (state->UpdateIdx + 7919) % NUM_GUI_ELEMENTS;
+
+				// Alternate between moving the element down and back up. Half a cell, so it often moves to different cells.
+				Rect2I& bounds = state->Bounds[elementIdx];
+				bounds.Y += (bounds.Y % 2) == 0 ? 33 : -33;
+
+				state->Grid.Update(state->Elements[elementIdx], bounds, state->Depths[elementIdx]);
+			}
+		};
+
+		desc.Teardown = [state, &runner, name]()
+		{
+			checkGridMatchesLinear(*state, runner, name);
+			destroyHitTestState(*state);
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	/** Labels of a property panel laid out by the text layout benchmarks, along with the cache serving them. */
+	struct TextLayoutState
+	{
+		HFont Font;
+		u32 FontSize = 0;
+		Vector<String> Labels;
+		u32 Frame = 0;
+
+		TextLayoutCache Cache;
+	};
+
+	/**
+	 * Prepares the next frame of the property panel. Most labels keep their text, while the last few display a value that
+	 * changes every frame.
+	 */
+	static void updateTextLabels(TextLayoutState& state)
+	{
+		state.Frame++;
+
+		for(u32 i = NUM_TEXT_LABELS - NUM_CHANGING_TEXT_LABELS; i < NUM_TEXT_LABELS; i++)
+			state.Labels[i] = "Value " + toString(i) + ": " + toString(state.Frame * 31 + i);
+	}
+
+	/**
+	 * Registers a benchmark that lays out the text of every label of a property panel, as a layout pass does each time the
+	 * panel is laid out. If 'useCache' is true the layouts are looked up in a TextLayoutCache, and its hit rate is logged
+	 * once the benchmark is done.
+	 */
+	static void addTextLayoutBenchmark(BenchmarkRunner& runner, const String& name, bool useCache)
+	{
+		auto state = bs_shared_ptr_new<TextLayoutState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_TEXT_LABELS;
+		desc.Setup = [state]()
+		{
+			// Lay out the labels using the same font as the GUI labels
+			const GUIElementStyle* labelStyle = gBuiltinResources().GetGuiSkin()->GetStyle(GUILabel::GetGUITypeName());
+			state->Font = labelStyle->Font;
+			state->FontSize = labelStyle->FontSize;
+
+			state->Labels.resize(NUM_TEXT_LABELS);
+			for(u32 i = 0; i < NUM_TEXT_LABELS; i++)
+				state->Labels[i] = "Property " + toString(i);
+		};
+
+		if(useCache)
+		{
+			desc.Run = [state]()
+			{
+				updateTextLabels(*state);
+
+				for(auto& label : state->Labels)
+					doNotOptimize(state->Cache.Get(label, state->Font, state->FontSize).Width);
+			};
+		}
+		else
+		{
+			desc.Run = [state]()
+			{
+				updateTextLabels(*state);
+
+				for(auto& label : state->Labels)
+					doNotOptimize(TextLayoutCache::CreateLayout(label, state->Font, state->FontSize).Width);
+			};
+		}
+
+		desc.Teardown = [state, name, useCache]()
+		{
+			if(useCache)
+			{
+				const TextLayoutCacheStats& stats = state->Cache.GetStats();
+				BS_LOG(Info, Uncategorized, "{0}: text layout cache hit rate {1}% ({2} hits, {3} misses, {4} evictions)",
+					name, stats.GetHitRate() * 100.0f, stats.NumHits, stats.NumMisses, stats.NumEvictions);
+			}
+
+			state->Cache.Clear();
+			state->Labels.clear();
+			state->Font = nullptr;
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	void registerGUIBenchmarks(BenchmarkRunner& runner)
+	{
+		addHitTestBenchmark(runner, "GUI.HitTest.Linear", false);
+		addHitTestBenchmark(runner, "GUI.HitTest.SpatialGrid", true);
+		addLayoutUpdateBenchmark(runner, "GUI.SpatialGrid.LayoutUpdate");
+
+		// Laying out all the labels of a panel, where most of the labels are unchanged from the last layout
+		addTextLayoutBenchmark(runner, "GUI.TextLayout.Uncached", false);
+		addTextLayoutBenchmark(runner, "GUI.TextLayout.Cached", true);
+	}
+} // namespace bs
@@ -0,0 +1,177 @@
+#include "BsBenchmarkSuites.h"
+#include "CoreThread/BsCoreThread.h"
+#include "Math/BsRandom.h"
+#include <cmath>
+
+// Example includes
+#include "BsGpuMemoryHeap.h"
+
+namespace bs
+{
+	/** Number of live allocations kept in the size-class heap by the churn benchmark. */
+	constexpr u32 NUM_HEAP_ALLOCATIONS = 4096;
+
+	/** Number of allocations freed and replaced by a single iteration of the size-class churn benchmark. */
+	constexpr u32 NUM_HEAP_CHURN_ALLOCATIONS = 256;
+
+	/** Number of transient allocations made by a single iteration (frame) of the linear benchmark. */
+	constexpr u32 NUM_HEAP_LINEAR_ALLOCATIONS = 1024;
+
+	/** Heap and live allocations used by the GPU heap benchmarks. Only accessed on the core thread. */
+	struct GpuHeapState
+	{
+		SPtr<ct::GpuMemoryHeap> Heap;
+		Vector<ct::GpuHeapAllocation> Allocations;
+		Random Rng = Random(1234);
+	};
+
+	/**
+	 * Queues a command on the core thread and waits for it to complete. The heap must only be used on the core thread,
+	 * so the measured time includes the round trip to it.
+	 */
+	static void runOnCoreThread(std::function<void()> command)
+	{
+		gCoreThread().QueueCommand(std::move(command));
+		gCoreThread().SubmitAll(true);
+	}
+
+	/** Returns a random allocation size between 256 bytes and 16 KB, with smaller sizes being more common. */
+	static u32 getRandomAllocationSize(Random& random)
+	{
+		return (u32)(256.0f * std::pow(2.0f, random.GetRange(0.0f, 6.0f)));
+	}
+
+	/** Logs the usage and fragmentation of a heap. */
+	static void logHeapStats(const String& name, const char* label, const ct::GpuHeapStats& stats)
+	{
+		BS_LOG(Info, Uncategorized, "{0}: {1}: {2} allocations, {3} KB used of {4} KB reserved in {5} blocks, "
+			"{6}% internal and {7}% external fragmentation, {8} allocations moved", name, label, stats.NumAllocations,
+			stats.UsedBytes / 1024, stats.ReservedBytes / 1024, stats.NumBlocks,
+			stats.GetInternalFragmentation() * 100.0f, stats.GetExternalFragmentation() * 100.0f,
+			stats.NumDefragMoves);
+	}
+
+	/**
+	 * Registers a benchmark that frees random allocations of a size-class heap and replaces them with allocations of
+	 * random sizes, as resources are streamed in and out. Once done the heap is defragmented, and its stats are logged
+	 * before and after. Reports a failure if defragmentation doesn't keep all the allocations or leaves any external
+	 * fragmentation.
+	 */
+	static void addSizeClassChurnBenchmark(BenchmarkRunner& runner, const String& name)
+	{
+		auto state = bs_shared_ptr_new<GpuHeapState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_HEAP_CHURN_ALLOCATIONS;
+		desc.Setup = [state]()
+		{
+			runOnCoreThread([state]()
+			{
+				state->Heap = bs_shared_ptr_new<ct::GpuMemoryHeap>(ct::GpuHeapStrategy::SizeClass);
+
+				state->Allocations.resize(NUM_HEAP_ALLOCATIONS);
+				for(auto& allocation : state->Allocations)
+					allocation = state->Heap->Allocate(getRandomAllocationSize(state->Rng));
+			});
+		};
+
+		desc.Run = [state]()
+		{
+			runOnCoreThread([state]()
+			{
+				for(u32 i = 0; i < NUM_HEAP_CHURN_ALLOCATIONS; i++)
+				{
+					const u32 idx = (u32)(state->Rng.GetRange(0.0f, 1.0f) * (NUM_HEAP_ALLOCATIONS - 1));
+					ct::GpuHeapAllocation& allocation = state->Allocations[idx];
+
+					state->Heap->Free(allocation);
+					allocation = state->Heap->Allocate(getRandomAllocationSize(state->Rng));
+				}
+			});
+		};
+
+		desc.Teardown = [state, &runner, name]()
+		{
+			ct::GpuHeapStats statsBefore, statsAfter;
+			runOnCoreThread([state, &statsBefore, &statsAfter]()
+			{
+				statsBefore = state->Heap->GetStats();
+				state->Heap->Defragment();
+				statsAfter = state->Heap->GetStats();
+
+				state->Allocations.clear();
+				state->Heap = nullptr;
+			});
+
+			logHeapStats(name, "before defragmentation", statsBefore);
+			logHeapStats(name, "after defragmentation", statsAfter);
+
+			if(statsAfter.NumAllocations != statsBefore.NumAllocations || statsAfter.UsedBytes != statsBefore.UsedBytes)
+				runner.ReportFailure(name, "Defragmentation changed the allocations kept by the heap");
+			else if(statsAfter.NumDefragMoves != statsBefore.NumAllocations)
+				runner.ReportFailure(name, "Defragmentation didn't move all the allocations");
+			else if(statsAfter.LargestFreeRange != statsAfter.FreeBytes)
+			{
+				runner.ReportFailure(name, "Defragmentation left " + toString(statsAfter.FreeBytes / 1024) +
+					" KB of free memory split into ranges of at most " + toString(statsAfter.LargestFreeRange / 1024) +
+					" KB");
+			}
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	/**
+	 * Registers a benchmark that makes transient allocations of random sizes from a linear heap, and frees them all at
+	 * once, as per-frame data is. The heap stats are logged once done, showing the blocks are reused between frames.
+	 */
+	static void addLinearFrameBenchmark(BenchmarkRunner& runner, const String& name)
+	{
+		auto state = bs_shared_ptr_new<GpuHeapState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_HEAP_LINEAR_ALLOCATIONS;
+		desc.Setup = [state]()
+		{
+			runOnCoreThread([state]()
+			{
+				state->Heap = bs_shared_ptr_new<ct::GpuMemoryHeap>(ct::GpuHeapStrategy::Linear);
+			});
+		};
+
+		desc.Run = [state]()
+		{
+			runOnCoreThread([state]()
+			{
+				state->Heap->Reset();
+
+				for(u32 i = 0; i < NUM_HEAP_LINEAR_ALLOCATIONS; i++)
+					doNotOptimize(state->Heap->Allocate(getRandomAllocationSize(state->Rng)).Id);
+			});
+		};
+
+		desc.Teardown = [state, name]()
+		{
+			ct::GpuHeapStats stats;
+			runOnCoreThread([state, &stats]()
+			{
+				stats = state->Heap->GetStats();
+				state->Heap = nullptr;
+			});
+
+			logHeapStats(name, "last frame", stats);
+			BS_LOG(Info, Uncategorized, "{0}: {1} KB peak use, {2} blocks allocated from the driver in total", name,
+				stats.PeakUsedBytes / 1024, stats.NumBlockAllocations);
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	void registerGpuHeapBenchmarks(BenchmarkRunner& runner)
+	{
+		addSizeClassChurnBenchmark(runner, "GpuHeap.SizeClass.Churn");
+		addLinearFrameBenchmark(runner, "GpuHeap.Linear.Frame");
+	}
+} // namespace bs
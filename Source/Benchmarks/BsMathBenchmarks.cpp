@@ -0,0 +1,190 @@
+#include "BsBenchmarkSuites.h"
+#include "Math/BsAABox.h"
+#include "Math/BsRandom.h"
+#include "Math/BsVector2.h"
+
+// Example includes
+#include "BsBoxGeometry.h"
+#include "BsTransformKernels.h"
+
+namespace bs
+{
+	/** Number of transforms processed by a single iteration of the transform math benchmarks. */
+	constexpr u32 NUM_TRANSFORMS = 4096;
+
+	/** Number of boxes written by a single iteration of the box geometry benchmarks. */
+	constexpr u32 NUM_BOXES = 256;
+
+	/** Transform data shared by the batched and scalar transform benchmarks, in both layouts. */
+	struct TransformData
+	{
+		TransformData()
+		{
+			Random random(1234);
+
+			Translations.resize(NUM_TRANSFORMS);
+			Rotations.resize(NUM_TRANSFORMS);
+			Scales.resize(NUM_TRANSFORMS);
+			Matrices.resize(NUM_TRANSFORMS);
+			Bounds.resize(NUM_TRANSFORMS);
+			Output.resize(NUM_TRANSFORMS);
+			OutputBounds.resize(NUM_TRANSFORMS);
+			OutputPoints.resize(NUM_TRANSFORMS);
+
+			TranslationsSoA.Resize(NUM_TRANSFORMS);
+			RotationsSoA.Resize(NUM_TRANSFORMS);
+			ScalesSoA.Resize(NUM_TRANSFORMS);
+			MatricesSoA.Resize(NUM_TRANSFORMS);
+			MinimumsSoA.Resize(NUM_TRANSFORMS);
+			MaximumsSoA.Resize(NUM_TRANSFORMS);
+			OutputSoA.Resize(NUM_TRANSFORMS);
+			OutputMinimumsSoA.Resize(NUM_TRANSFORMS);
+			OutputMaximumsSoA.Resize(NUM_TRANSFORMS);
+
+			for(u32 i = 0; i < NUM_TRANSFORMS; i++)
+			{
+				Translations[i] = Vector3(random.GetRange(-100.0f, 100.0f), random.GetRange(-100.0f, 100.0f),
+					random.GetRange(-100.0f, 100.0f));
+
+				Vector3 axis = random.GetUnitVector();
+				Rotations[i].FromAxisAngle(axis, Degree(random.GetRange(0.0f, 360.0f)));
+
+				Scales[i] = Vector3::ONE * random.GetRange(0.5f, 2.0f);
+				Matrices[i] = Matrix4::TRS(Translations[i], Rotations[i], Scales[i]);
+				Bounds[i] = AABox(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f));
+
+				TranslationsSoA.Set(i, Translations[i]);
+				RotationsSoA.Set(i, Rotations[i]);
+				ScalesSoA.Set(i, Scales[i]);
+				MatricesSoA.Set(i, Matrices[i]);
+				MinimumsSoA.Set(i, Bounds[i].GetMin());
+				MaximumsSoA.Set(i, Bounds[i].GetMax());
+			}
+
+			ViewProjection = Matrix4::ProjectionPerspective(Degree(75.0f), 16.0f / 9.0f, 0.05f, 1000.0f) *
+				Matrix4::View(Vector3(0.0f, 10.0f, -50.0f), Quaternion::IDENTITY);
+		}
+
+		Vector<Vector3> Translations;
+		Vector<Quaternion> Rotations;
+		Vector<Vector3> Scales;
+		Vector<Matrix4> Matrices;
+		Vector<AABox> Bounds;
+		Vector<Matrix4> Output;
+		Vector<AABox> OutputBounds;
+		Vector<Vector3> OutputPoints;
+
+		Vector3SoA TranslationsSoA;
+		QuaternionSoA RotationsSoA;
+		Vector3SoA ScalesSoA;
+		Matrix4SoA MatricesSoA;
+		Vector3SoA MinimumsSoA;
+		Vector3SoA MaximumsSoA;
+		Matrix4SoA OutputSoA;
+		Vector3SoA OutputMinimumsSoA;
+		Vector3SoA OutputMaximumsSoA;
+
+		Matrix4 ViewProjection;
+	};
+
+	void registerMathBenchmarks(BenchmarkRunner& runner)
+	{
+		// Box geometry, as used for building the mesh in the low-level rendering example
+		{
+			constexpr u32 stride = sizeof(Vector3) + sizeof(Vector2);
+			auto vertices = bs_shared_ptr_new<Vector<u8>>(NUM_BOXES * BOX_NUM_VERTICES * stride);
+			auto indices = bs_shared_ptr_new<Vector<u32>>(NUM_BOXES * BOX_NUM_INDICES);
+
+			runner.Add("Math.BoxGeometry.WriteVertices", [vertices]()
+			{
+				u8* data = vertices->data();
+				for(u32 i = 0; i < NUM_BOXES; i++)
+				{
+					AABox box(Vector3(-0.5f, -0.5f, -0.5f) * (float)i, Vector3(0.5f, 0.5f, 0.5f) * (float)i);
+
+					u8* positions = data + i * BOX_NUM_VERTICES * stride;
+					writeBoxVertices(box, positions, positions + sizeof(Vector3), stride);
+				}
+
+				doNotOptimize(data[0]);
+			}, NUM_BOXES);
+
+			runner.Add("Math.BoxGeometry.WriteIndices", [indices]()
+			{
+				u32* data = indices->data();
+				for(u32 i = 0; i < NUM_BOXES; i++)
+					writeBoxIndices(data + i * BOX_NUM_INDICES);
+
+				doNotOptimize(data[0]);
+			}, NUM_BOXES);
+		}
+
+		// Batched transform math, each paired with the equivalent scalar loop so the speed-up can be compared directly
+		auto data = bs_shared_ptr_new<TransformData>();
+
+		runner.Add("Math.ComposeTRS.Scalar", [data]()
+		{
+			for(u32 i = 0; i < NUM_TRANSFORMS; i++)
+				data->Output[i] = Matrix4::TRS(data->Translations[i], data->Rotations[i], data->Scales[i]);
+
+			doNotOptimize(data->Output[0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.ComposeTRS.Batched", [data]()
+		{
+			TransformKernels::ComposeTRS(data->TranslationsSoA, data->RotationsSoA, data->ScalesSoA, data->OutputSoA,
+				NUM_TRANSFORMS);
+
+			doNotOptimize(data->OutputSoA.Elements[0][0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.MultiplyViewProjection.Scalar", [data]()
+		{
+			for(u32 i = 0; i < NUM_TRANSFORMS; i++)
+				data->Output[i] = data->ViewProjection * data->Matrices[i];
+
+			doNotOptimize(data->Output[0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.MultiplyViewProjection.Batched", [data]()
+		{
+			TransformKernels::Multiply(data->ViewProjection, data->MatricesSoA, data->OutputSoA, NUM_TRANSFORMS);
+
+			doNotOptimize(data->OutputSoA.Elements[0][0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.RotateVectors.Scalar", [data]()
+		{
+			for(u32 i = 0; i < NUM_TRANSFORMS; i++)
+				data->OutputPoints[i] = data->Rotations[i].Rotate(data->Translations[i]);
+
+			doNotOptimize(data->OutputPoints[0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.RotateVectors.Batched", [data]()
+		{
+			TransformKernels::Rotate(data->RotationsSoA, data->TranslationsSoA, data->OutputMinimumsSoA, NUM_TRANSFORMS);
+
+			doNotOptimize(data->OutputMinimumsSoA.X[0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.TransformAABB.Scalar", [data]()
+		{
+			for(u32 i = 0; i < NUM_TRANSFORMS; i++)
+			{
+				data->OutputBounds[i] = data->Bounds[i];
+				data->OutputBounds[i].TransformAffine(data->Matrices[i]);
+			}
+
+			doNotOptimize(data->OutputBounds[0]);
+		}, NUM_TRANSFORMS);
+
+		runner.Add("Math.TransformAABB.Batched", [data]()
+		{
+			TransformKernels::TransformAABB(data->MatricesSoA, data->MinimumsSoA, data->MaximumsSoA,
+				data->OutputMinimumsSoA, data->OutputMaximumsSoA, NUM_TRANSFORMS);
+
+			doNotOptimize(data->OutputMinimumsSoA.X[0]);
+		}, NUM_TRANSFORMS);
+	}
+} // namespace bs
@@ -0,0 +1,124 @@
+#include "BsBenchmarkSuites.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "BsBenchmarkScenario.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace bs
+{
+	/** Names of the example executables that are run as benchmark scenarios. */
+	static const char* EXAMPLE_NAMES[] =
+	{
+		"LowLevelRendering",
+		"LowLevelRenderingGpuCulling",
+		"PhysicallyBasedShading",
+		"CustomMaterials",
+		"GUI",
+		"Audio",
+		"SkeletalAnimation",
+		"Physics",
+		"PhysicsSplitScreen",
+		"Particles",
+		"Decals"
+	};
+
+	/** Sets an environment variable inherited by the processes started afterwards. */
+	static void setEnvironmentVariable(const char* name, const String& value)
+	{
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+		_putenv_s(name, value.c_str());
+#else
+		setenv(name, value.c_str(), 1);
+#endif
+	}
+
+	/** Reads the frame times (one per line, in nanoseconds) saved by the BenchmarkScenario component. */
+	static Vector<double> readFrameTimes(const Path& path)
+	{
+		Vector<double> frameTimes;
+
+		SPtr<DataStream> stream = FileSystem::OpenFile(path);
+		if(stream == nullptr)
+			return frameTimes;
+
+		StringStream input(stream->GetAsString());
+		stream->Close();
+
+		u64 frameTime;
+		while(input >> frameTime)
+			frameTimes.push_back((double)frameTime);
+
+		return frameTimes;
+	}
+
+	void runScenarioBenchmarks(BenchmarkRunner& runner, const Path& examplesFolder, u32 numFrames)
+	{
+		const String& filter = runner.GetSettings().Filter;
+
+		setEnvironmentVariable(BenchmarkScenario::FRAMES_ENV_VAR, toString(numFrames));
+
+		for(auto& exampleName : EXAMPLE_NAMES)
+		{
+			const String name = String("Scenario.") + exampleName;
+			if(!filter.empty() && name.find(filter) == String::npos)
+				continue;
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+			const Path executablePath = examplesFolder + Path(String(exampleName) + ".exe");
+#else
+			const Path executablePath = examplesFolder + Path(exampleName);
+#endif
+
+			if(!FileSystem::Exists(executablePath))
+			{
+				BS_LOG(Warning, Uncategorized, "Skipping benchmark scenario, example not found: " +
+					executablePath.ToString());
+				continue;
+			}
+
+			const Path outputPath = examplesFolder + Path(String(exampleName) + "FrameTimes.txt");
+			if(FileSystem::Exists(outputPath))
+				FileSystem::Remove(outputPath);
+
+			// The example records its frame times and quits on its own once the environment variable is set
+			setEnvironmentVariable(BenchmarkScenario::OUTPUT_ENV_VAR, outputPath.ToString());
+
+			const String command = "\"" + executablePath.ToString() + "\"";
+			const int exitCode = std::system(command.c_str());
+
+			BenchmarkResult result;
+			result.Name = name;
+			result.IterationsPerSample = 1;
+			result.Samples = readFrameTimes(outputPath);
+
+			if(exitCode != 0 || result.Samples.empty())
+			{
+				BS_LOG(Warning, Uncategorized, "Benchmark scenario " + String(exampleName) + " failed, exit code: " +
+					toString(exitCode));
+				continue;
+			}
+
+			FileSystem::Remove(outputPath);
+
+			result.ComputeStatistics();
+			runner.AddResult(std::move(result));
+
+			// Per-phase timings and hardware counters captured by the example, if it measures any
+			const Path countersPath = BenchmarkScenario::GetCountersPath(outputPath);
+			if(FileSystem::Exists(countersPath))
+			{
+				SPtr<DataStream> stream = FileSystem::OpenFile(countersPath);
+				if(stream != nullptr)
+				{
+					printf("\n%s", stream->GetAsString().c_str());
+					stream->Close();
+				}
+
+				FileSystem::Remove(countersPath);
+			}
+		}
+
+		setEnvironmentVariable(BenchmarkScenario::OUTPUT_ENV_VAR, "");
+	}
+} // namespace bs
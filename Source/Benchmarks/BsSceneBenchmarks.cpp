@@ -0,0 +1,127 @@
+#include "BsBenchmarkSuites.h"
+#include "Scene/BsSceneObject.h"
+#include "Resources/BsResources.h"
+#include "Resources/BsBuiltinResources.h"
+#include "Mesh/BsMesh.h"
+
+namespace bs
+{
+	/** Number of scene objects in the hierarchies used by the transform propagation benchmarks. */
+	constexpr u32 NUM_HIERARCHY_OBJECTS = 1000;
+
+	/** Number of handle lookups performed by a single iteration of the resource benchmarks. */
+	constexpr u32 NUM_HANDLE_LOOKUPS = 1000;
+
+	/** Scene hierarchy used by the transform propagation benchmarks. */
+	struct HierarchyState
+	{
+		HSceneObject Root;
+		Vector<HSceneObject> Leaves;
+		float Offset = 0.0f;
+	};
+
+	/**
+	 * Registers a benchmark that moves the root of a hierarchy and then reads the world transform of every leaf, forcing
+	 * the change to propagate. 'depth' determines the length of each chain of objects below the root.
+	 */
+	void addTransformPropagationBenchmark(BenchmarkRunner& runner, const String& name, u32 depth)
+	{
+		auto state = bs_shared_ptr_new<HierarchyState>();
+
+		BenchmarkDesc desc;
+		desc.Name = name;
+		desc.ItemsPerIteration = NUM_HIERARCHY_OBJECTS;
+		desc.Setup = [state, depth]()
+		{
+			state->Root = SceneObject::Create("Benchmark");
+
+			const u32 numChains = NUM_HIERARCHY_OBJECTS / depth;
+			for(u32 i = 0; i < numChains; i++)
+			{
+				HSceneObject parent = state->Root;
+				for(u32 j = 0; j < depth; j++)
+				{
+					HSceneObject so = SceneObject::Create("Object");
+					so->SetParent(parent);
+					so->SetPosition(Vector3(1.0f, 0.0f, 0.0f));
+					so->SetRotation(Quaternion(Vector3::UNIT_Y, Degree(10.0f)));
+
+					parent = so;
+				}
+
+				state->Leaves.push_back(parent);
+			}
+		};
+
+		desc.Run = [state]()
+		{
+			state->Offset += 0.01f;
+			state->Root->SetPosition(Vector3(state->Offset, 0.0f, 0.0f));
+
+			Vector3 sum = Vector3::ZERO;
+			for(auto& leaf : state->Leaves)
+				sum += leaf->GetTransform().GetPosition();
+
+			doNotOptimize(sum);
+		};
+
+		desc.Teardown = [state]()
+		{
+			state->Leaves.clear();
+			state->Root->Destroy();
+			state->Root = nullptr;
+		};
+
+		runner.Add(std::move(desc));
+	}
+
+	void registerSceneBenchmarks(BenchmarkRunner& runner)
+	{
+		addTransformPropagationBenchmark(runner, "Scene.TransformPropagation.Wide", 1);
+		addTransformPropagationBenchmark(runner, "Scene.TransformPropagation.Deep", 50);
+
+		// Resource benchmarks, looking up the built-in box mesh. The handle is only acquired once the engine is running,
+		// and released before it shuts down.
+		auto mesh = bs_shared_ptr_new<HMesh>();
+		auto acquireMesh = [mesh]() { *mesh = gBuiltinResources().GetMesh(BuiltinMesh::Box); };
+		auto releaseMesh = [mesh]() { *mesh = nullptr; };
+
+		// Looking up an already loaded resource by its UUID, as done when deserializing resource references
+		BenchmarkDesc loadFromUUID;
+		loadFromUUID.Name = "Resources.LoadFromUUID";
+		loadFromUUID.ItemsPerIteration = NUM_HANDLE_LOOKUPS;
+		loadFromUUID.Setup = acquireMesh;
+		loadFromUUID.Teardown = releaseMesh;
+		loadFromUUID.Run = [mesh]()
+		{
+			const UUID& uuid = mesh->GetUUID();
+			for(u32 i = 0; i < NUM_HANDLE_LOOKUPS; i++)
+			{
+				HResource handle = gResources().LoadFromUUID(uuid);
+				doNotOptimize(handle);
+			}
+		};
+
+		runner.Add(std::move(loadFromUUID));
+
+		// Copying and dereferencing handles, as done whenever a component accesses its resources
+		BenchmarkDesc handleDereference;
+		handleDereference.Name = "Resources.HandleDereference";
+		handleDereference.ItemsPerIteration = NUM_HANDLE_LOOKUPS;
+		handleDereference.Setup = acquireMesh;
+		handleDereference.Teardown = releaseMesh;
+		handleDereference.Run = [mesh]()
+		{
+			u32 numVertices = 0;
+			for(u32 i = 0; i < NUM_HANDLE_LOOKUPS; i++)
+			{
+				HMesh copy = *mesh;
+				numVertices += copy->GetProperties().GetNumVertices();
+			}
+
+			doNotOptimize(numVertices);
+		};
+
+		runner.Add(std::move(handleDereference));
+	}
+} // namespace bs
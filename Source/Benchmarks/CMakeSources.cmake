@@ -0,0 +1,24 @@
+set(BS_BENCHMARKS_INC_NOFILTER
+	"BsBenchmark.h"
+	"BsBenchmarkSuites.h"
+	"BsBenchmarkBaseline.h"
+)
+
+set(BS_BENCHMARKS_SRC_NOFILTER
+	"BsBenchmark.cpp"
+	"BsBenchmarkBaseline.cpp"
+	"BsComponentBenchmarks.cpp"
+	"BsMathBenchmarks.cpp"
+	"BsAnimationBenchmarks.cpp"
+	"BsSceneBenchmarks.cpp"
+	"BsGUIBenchmarks.cpp"
+	"BsCullingBenchmarks.cpp"
+	"BsGpuHeapBenchmarks.cpp"
+	"BsScenarioBenchmarks.cpp"
+	"Main.cpp"
+)
+
+set(BS_BENCHMARKS_SRC
+	${BS_BENCHMARKS_INC_NOFILTER}
+	${BS_BENCHMARKS_SRC_NOFILTER}
+)
@@ -0,0 +1,172 @@
+#include "BsApplication.h"
+#include "RenderAPI/BsRenderWindow.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+
+// Example includes
+#include "BsExampleFramework.h"
+#include "BsBenchmarkSuites.h"
+#include "BsBenchmarkBaseline.h"
+#include "BsBenchmarkScenario.h"
+#include "BsCpuFeatures.h"
+
+#include <cstdlib>
+#include <cstring>
+
+// This target runs microbenchmarks of the code shared by the examples, such as the per-frame update of the example
+// components, box geometry generation, transform math, transform propagation, resource handle lookups and GPU memory
+// heap allocation. Afterwards it runs each example as a benchmark scenario, recording its frame times.
+//
+// The engine is started with a hidden window, and the main loop never runs, so no frames are rendered while the
+// microbenchmarks run. This is not a headless mode: the window and the render API are still created, so the machine
+// running the benchmarks needs a display and a GPU supported by the render API. The example scenarios render normally.
+// Results are printed to the console and saved in JSON format.
+//
+// Results are then compared against the baseline stored in a local database file, and any statistically significant
+// regressions are reported (and cause a non-zero exit code). The baseline is created on the first run, and only updated
+// afterwards when requested, e.g. after verifying a slowdown is expected.
+//
+// Some benchmarks also check the results of the optimized code against a reference implementation. Any mismatch is
+// reported as a failure, which causes a non-zero exit code even if the baseline is being updated.
+//
+// Command line options:
+//  --filter <text>       Only run benchmarks whose name contains <text>
+//  --output <path>       Path to save the JSON results to (bsfExamplesBench.json by default)
+//  --samples <count>     Number of samples to measure for each microbenchmark (30 by default)
+//  --frames <count>      Number of frames to record for each example scenario (600 by default)
+//  --no-scenarios        Only run the microbenchmarks
+//  --baseline <path>     Path to the baseline database (bsfExamplesBench.baseline by default)
+//  --update-baseline     Replace the baseline with the results of this run
+//  --threshold <pct>     Minimum change of the median reported as a regression, in percent (5 by default)
+//  --report <path>       Path to save the comparison report to
+
+/** Main entry point into the application. */
+int main(int argc, char* argv[])
+{
+	using namespace bs;
+
+	BenchmarkSettings settings;
+	BenchmarkComparisonSettings comparisonSettings;
+	Path outputPath = "bsfExamplesBench.json";
+	Path baselinePath = "bsfExamplesBench.baseline";
+	Path reportPath;
+	u32 numFrames = BenchmarkScenario::DEFAULT_NUM_FRAMES;
+	bool runScenarios = true;
+	bool updateBaseline = false;
+
+	for(int i = 1; i < argc; i++)
+	{
+		const bool hasValue = (i + 1) < argc;
+
+		if(strcmp(argv[i], "--filter") == 0 && hasValue)
+			settings.Filter = argv[++i];
+		else if(strcmp(argv[i], "--output") == 0 && hasValue)
+			outputPath = argv[++i];
+		else if(strcmp(argv[i], "--samples") == 0 && hasValue)
+			settings.NumSamples = std::max(atoi(argv[++i]), 1);
+		else if(strcmp(argv[i], "--frames") == 0 && hasValue)
+			numFrames = std::max(atoi(argv[++i]), 1);
+		else if(strcmp(argv[i], "--no-scenarios") == 0)
+			runScenarios = false;
+		else if(strcmp(argv[i], "--baseline") == 0 && hasValue)
+			baselinePath = argv[++i];
+		else if(strcmp(argv[i], "--update-baseline") == 0)
+			updateBaseline = true;
+		else if(strcmp(argv[i], "--threshold") == 0 && hasValue)
+			comparisonSettings.Threshold = atof(argv[++i]) / 100.0;
+		else if(strcmp(argv[i], "--report") == 0 && hasValue)
+			reportPath = argv[++i];
+		else
+		{
+			printf("Unknown argument: %s\n", argv[i]);
+			printf("Usage: bsfExamplesBench [--filter <text>] [--output <path>] [--samples <count>] [--frames <count>]\n"
+				"                        [--no-scenarios] [--baseline <path>] [--update-baseline] [--threshold <pct>]\n"
+				"                        [--report <path>]\n");
+			return 1;
+		}
+	}
+
+	// Start the engine without showing its window, since the microbenchmarks don't render anything. The window and the
+	// render API are still created.
+	VideoMode videoMode(640, 480);
+	START_UP_DESC desc = Application::BuildStartUpDesc(videoMode, "bsfExamplesBench", false);
+	desc.PrimaryWindowDesc.Hidden = true;
+
+	Application::StartUp(desc);
+
+	// Register the input bindings used by the example components
+	ExampleFramework::SetupInputConfig();
+
+	// Batched benchmarks use AVX2 only if the CPU supports it, so note which code paths the results were measured with
+	printf("AVX2 code paths: %s\n", CpuFeatures::HasAVX2() ? "enabled" : "not available");
+
+	BenchmarkRunner runner(settings);
+	registerComponentBenchmarks(runner);
+	registerMathBenchmarks(runner);
+	registerAnimationBenchmarks(runner);
+	registerSceneBenchmarks(runner);
+	registerGUIBenchmarks(runner);
+	registerCullingBenchmarks(runner);
+	registerGpuHeapBenchmarks(runner);
+
+	runner.Run();
+
+	// Examples are built next to this executable
+	if(runScenarios)
+		runScenarioBenchmarks(runner, Path(argv[0]).GetParent(), numFrames);
+
+	runner.SaveJSON(outputPath);
+
+	// Compare against the baseline from a previous run
+	BenchmarkBaseline baseline;
+	const bool hasBaseline = baseline.Load(baselinePath);
+
+	u32 numRegressions = 0;
+	if(hasBaseline)
+	{
+		Vector<BenchmarkComparison> comparisons = baseline.Compare(runner.GetResults(), comparisonSettings);
+		for(auto& entry : comparisons)
+		{
+			if(entry.Verdict == BenchmarkVerdict::Regression)
+				numRegressions++;
+		}
+
+		const String report = BenchmarkBaseline::GetReport(comparisons);
+		printf("\nComparison against the baseline (%s):\n%s", baselinePath.ToString().c_str(), report.c_str());
+
+		if(!reportPath.IsEmpty())
+		{
+			SPtr<DataStream> stream = FileSystem::CreateAndOpenFile(reportPath);
+			if(stream != nullptr)
+			{
+				stream->WriteString(report);
+				stream->Close();
+			}
+		}
+	}
+
+	if(!hasBaseline || updateBaseline)
+	{
+		baseline.Update(runner.GetResults());
+		baseline.Save(baselinePath);
+
+		printf("\nBaseline saved to %s\n", baselinePath.ToString().c_str());
+	}
+
+	// Benchmarks that check their results against a reference report any mismatches, which fail the run regardless of
+	// the timings
+	const Vector<String>& failures = runner.GetFailures();
+	if(!failures.empty())
+	{
+		printf("\n%u benchmark(s) failed:\n", (u32)failures.size());
+		for(auto& failure : failures)
+			printf("  %s\n", failure.c_str());
+	}
+
+	Application::ShutDown();
+
+	if(!failures.empty())
+		return 3;
+
+	return (numRegressions > 0 && !updateBaseline) ? 2 : 0;
+}
@@ -0,0 +1,385 @@
+#include "BsAsyncLog.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+
+namespace bs
+{
+	/** Argument of a message, as stored in a thread buffer. */
+	struct AsyncLogSlotArg
+	{
+		AsyncLogArg::Type ArgType;
+		u32 Length; /**< Length of a string argument. */
+		union
+		{
+			i64 Int;
+			u64 UInt; /**< For string arguments, the offset of the text from the start of the string data. */
+			double Float;
+		};
+	};
+
+	/**
+	 * Header of a message slot in a thread buffer. The text of string arguments follows the header, in the same slot.
+	 * The message is formatted only once it reaches the flush thread.
+	 */
+	struct AsyncLogSlot
+	{
+		u64 Timestamp;
+		const char* Format;
+		LogVerbosity Verbosity;
+		u32 Category;
+		u32 NumArgs;
+		AsyncLogSlotArg Args[AsyncLog::MAX_ARGS];
+	};
+
+	/**
+	 * Single-producer, single-consumer ring of fixed-size message slots, owned by a single logging thread. The owning
+	 * thread only advances the head, and the flush thread only advances the tail.
+	 */
+	struct AsyncLogThreadBuffer
+	{
+		AsyncLogThreadBuffer(u32 capacity, u32 stride, u32 threadIdx)
+			: Capacity(capacity), Stride(stride), ThreadIdx(threadIdx), Data(capacity * (size_t)stride)
+		{}
+
+		const u32 Capacity;
+		const u32 Stride;
+		const u32 ThreadIdx;
+		Vector<u8> Data;
+
+		// Kept on separate cache lines, since they are written by different threads
+		alignas(64) std::atomic<u64> Head{0};
+		alignas(64) std::atomic<u64> Tail{0};
+
+		alignas(64) std::atomic<u64> NumWritten{0};
+		std::atomic<u64> NumDropped{0};
+		std::atomic<u64> NumTruncated{0};
+		u64 NumDroppedReported = 0; /**< Only accessed by the flush thread. */
+
+		std::atomic<bool> IsThreadDone{false};
+	};
+
+	/** Message moved out of a thread buffer, waiting to be forwarded to the log. */
+	struct AsyncLogMessage
+	{
+		u64 Timestamp;
+		LogVerbosity Verbosity;
+		u32 Category;
+		String Text;
+	};
+
+	/** Reference from a thread to its buffer. Marks the buffer as done when the thread exits, so it can be released. */
+	struct AsyncLogThreadRef
+	{
+		~AsyncLogThreadRef() { Release(); }
+
+		void Release()
+		{
+			if(Buffer != nullptr)
+				Buffer->IsThreadDone.store(true, std::memory_order_release);
+
+			Buffer = nullptr;
+		}
+
+		SPtr<AsyncLogThreadBuffer> Buffer;
+		u64 InstanceId = 0; /**< AsyncLog instance the buffer belongs to. */
+	};
+
+	static thread_local AsyncLogThreadRef gThreadRef;
+	static std::atomic<u64> gNextInstanceId{1};
+
+	/** Returns the smallest power of two larger or equal to 'value'. */
+	static u32 nextPow2(u32 value)
+	{
+		u32 output = 1;
+		while(output < value)
+			output <<= 1;
+
+		return output;
+	}
+
+	/** Returns a monotonic timestamp used for ordering messages from different threads. */
+	static u64 getTimestamp()
+	{
+		return (u64)std::chrono::steady_clock::now().time_since_epoch().count();
+	}
+
+	/** Converts a buffered argument to text. 'stringData' points to the string data of the slot. */
+	static String argToString(const AsyncLogSlotArg& arg, const char* stringData)
+	{
+		switch(arg.ArgType)
+		{
+		case AsyncLogArg::Type::Int:
+			return toString(arg.Int);
+		case AsyncLogArg::Type::UInt:
+			return toString(arg.UInt);
+		case AsyncLogArg::Type::Float:
+			return toString(arg.Float);
+		case AsyncLogArg::Type::Bool:
+			return toString(arg.UInt != 0);
+		default:
+			return String(stringData + arg.UInt, arg.Length);
+		}
+	}
+
+	/** Formats a buffered message, replacing {N} with the Nth argument the same way as StringUtil::Format(). */
+	static String formatMessage(const AsyncLogSlot& slot, const char* stringData)
+	{
+		String output;
+		for(const char* ch = slot.Format; *ch != '\0'; ch++)
+		{
+			if(ch[0] == '{' && isdigit((u8)ch[1]))
+			{
+				u32 argIdx = 0;
+				const char* end = ch + 1;
+				while(isdigit((u8)*end))
+					argIdx = argIdx * 10 + (u32)(*end++ - '0');
+
+				if(*end == '}' && argIdx < slot.NumArgs)
+				{
+					output += argToString(slot.Args[argIdx], stringData);
+					ch = end;
+					continue;
+				}
+			}
+
+			output += *ch;
+		}
+
+		return output;
+	}
+
+	AsyncLog::AsyncLog(const AsyncLogSettings& settings)
+		: mSettings(settings), mInstanceId(gNextInstanceId.fetch_add(1))
+	{
+		mSettings.MessagesPerThread = nextPow2(std::max(settings.MessagesPerThread, 2U));
+
+		// Round slots up so headers stay aligned
+		mMessageStride = (u32)(sizeof(AsyncLogSlot) + mSettings.MaxStringLength + 7) & ~7U;
+
+		const u64 bufferSize = (u64)mMessageStride * mSettings.MessagesPerThread;
+		mMaxBuffers = (u32)std::max(mSettings.MaxMemory / bufferSize, (u64)1);
+
+		mFlushThread = Thread(std::bind(&AsyncLog::FlushThreadMain, this));
+	}
+
+	AsyncLog::~AsyncLog()
+	{
+		{
+			Lock lock(mWakeMutex);
+			mShutDown = true;
+		}
+
+		mWakeSignal.notify_one();
+		mFlushThread.join();
+
+		// Forward anything logged while the flush thread was stopping
+		Drain();
+	}
+
+	AsyncLogThreadBuffer* AsyncLog::GetThreadBuffer()
+	{
+		AsyncLogThreadRef& ref = gThreadRef;
+		if(ref.InstanceId == mInstanceId)
+			return ref.Buffer.get();
+
+		// First message from this thread (to this instance of the log). Any buffer from a previous instance is released.
+		ref.Release();
+		ref.InstanceId = mInstanceId;
+
+		Lock lock(mBuffersMutex);
+		if((u32)mBuffers.size() >= mMaxBuffers)
+			return nullptr;
+
+		ref.Buffer = bs_shared_ptr_new<AsyncLogThreadBuffer>(mSettings.MessagesPerThread, mMessageStride, mNextThreadIdx++);
+		mBuffers.push_back(ref.Buffer);
+
+		return ref.Buffer.get();
+	}
+
+	bool AsyncLog::WriteArgs(LogVerbosity verbosity, u32 category, const char* format, const AsyncLogArg* args,
+		u32 numArgs)
+	{
+		AsyncLogThreadBuffer* buffer = GetThreadBuffer();
+		if(buffer == nullptr)
+		{
+			mNumDroppedUnbuffered.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		const u64 head = buffer->Head.load(std::memory_order_relaxed);
+		const u64 tail = buffer->Tail.load(std::memory_order_acquire);
+		if(head - tail >= buffer->Capacity)
+		{
+			buffer->NumDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		u8* slotData = &buffer->Data[(head & (buffer->Capacity - 1)) * (size_t)buffer->Stride];
+
+		u8* stringData = slotData + sizeof(AsyncLogSlot);
+
+		AsyncLogSlot slot;
+		slot.Timestamp = getTimestamp();
+		slot.Format = format;
+		slot.Verbosity = verbosity;
+		slot.Category = category;
+		slot.NumArgs = numArgs;
+
+		// Only the strings need copying, everything else is stored as is
+		u32 stringLength = 0;
+		bool truncated = false;
+		for(u32 i = 0; i < numArgs; i++)
+		{
+			const AsyncLogArg& arg = args[i];
+			AsyncLogSlotArg& slotArg = slot.Args[i];
+
+			slotArg.ArgType = arg.ArgType;
+			slotArg.Length = 0;
+
+			if(arg.ArgType == AsyncLogArg::Type::String)
+			{
+				const u32 length = std::min(arg.Length, mSettings.MaxStringLength - stringLength);
+				memcpy(stringData + stringLength, arg.Str, length);
+
+				slotArg.UInt = stringLength;
+				slotArg.Length = length;
+
+				stringLength += length;
+				truncated |= length < arg.Length;
+			}
+			else
+				memcpy(&slotArg.UInt, &arg.UInt, sizeof(slotArg.UInt));
+		}
+
+		memcpy(slotData, &slot, sizeof(slot));
+
+		if(truncated)
+			buffer->NumTruncated.fetch_add(1, std::memory_order_relaxed);
+
+		buffer->NumWritten.fetch_add(1, std::memory_order_relaxed);
+
+		// Publish the message to the flush thread
+		buffer->Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	void AsyncLog::Drain()
+	{
+		Lock flushLock(mFlushMutex);
+
+		// Copy the buffer list so threads starting to log aren't blocked while messages are forwarded
+		Vector<SPtr<AsyncLogThreadBuffer>> buffers;
+		{
+			Lock lock(mBuffersMutex);
+			buffers = mBuffers;
+		}
+
+		Vector<AsyncLogMessage> messages;
+		for(auto& buffer : buffers)
+		{
+			const u64 head = buffer->Head.load(std::memory_order_acquire);
+			u64 tail = buffer->Tail.load(std::memory_order_relaxed);
+
+			for(; tail != head; tail++)
+			{
+				const u8* slotData = &buffer->Data[(tail & (buffer->Capacity - 1)) * (size_t)buffer->Stride];
+
+				AsyncLogSlot slot;
+				memcpy(&slot, slotData, sizeof(slot));
+
+				AsyncLogMessage message;
+				message.Timestamp = slot.Timestamp;
+				message.Verbosity = slot.Verbosity;
+				message.Category = slot.Category;
+				message.Text = formatMessage(slot, (const char*)slotData + sizeof(slot));
+
+				messages.push_back(std::move(message));
+			}
+
+			// Release the slots back to the logging thread
+			buffer->Tail.store(tail, std::memory_order_release);
+
+			const u64 numDropped = buffer->NumDropped.load(std::memory_order_relaxed);
+			if(numDropped != buffer->NumDroppedReported)
+			{
+				AsyncLogMessage message;
+				message.Timestamp = getTimestamp();
+				message.Verbosity = LogVerbosity::Warning;
+				message.Category = 0;
+				message.Text = "Async log buffer of thread " + toString(buffer->ThreadIdx) + " was full, " +
+					toString(numDropped - buffer->NumDroppedReported) + " message(s) dropped.";
+
+				messages.push_back(std::move(message));
+				buffer->NumDroppedReported = numDropped;
+			}
+		}
+
+		// Release buffers of threads that exited, once they have been drained
+		{
+			Lock lock(mBuffersMutex);
+			mBuffers.erase(std::remove_if(mBuffers.begin(), mBuffers.end(),
+				[this](const SPtr<AsyncLogThreadBuffer>& buffer)
+				{
+					if(!buffer->IsThreadDone.load(std::memory_order_acquire) ||
+						buffer->Tail.load(std::memory_order_relaxed) != buffer->Head.load(std::memory_order_acquire))
+						return false;
+
+					mRetiredStats.NumWritten += buffer->NumWritten.load(std::memory_order_relaxed);
+					mRetiredStats.NumDropped += buffer->NumDropped.load(std::memory_order_relaxed);
+					mRetiredStats.NumTruncated += buffer->NumTruncated.load(std::memory_order_relaxed);
+					return true;
+				}), mBuffers.end());
+		}
+
+		// Messages are forwarded in the order they were logged, regardless of the thread
+		std::stable_sort(messages.begin(), messages.end(),
+			[](const AsyncLogMessage& lhs, const AsyncLogMessage& rhs) { return lhs.Timestamp < rhs.Timestamp; });
+
+		for(auto& entry : messages)
+			gDebug().Log(entry.Text, entry.Verbosity, entry.Category);
+
+		mNumFlushed.fetch_add(messages.size(), std::memory_order_relaxed);
+	}
+
+	void AsyncLog::Flush()
+	{
+		Drain();
+	}
+
+	void AsyncLog::FlushThreadMain()
+	{
+		while(true)
+		{
+			{
+				Lock lock(mWakeMutex);
+				mWakeSignal.wait_for(lock, std::chrono::milliseconds(mSettings.FlushInterval),
+					[this]() { return mShutDown; });
+
+				if(mShutDown)
+					return;
+			}
+
+			Drain();
+		}
+	}
+
+	AsyncLogStats AsyncLog::GetStats() const
+	{
+		Lock lock(mBuffersMutex);
+
+		AsyncLogStats stats = mRetiredStats;
+		stats.NumDropped += mNumDroppedUnbuffered.load(std::memory_order_relaxed);
+		stats.NumFlushed = mNumFlushed.load(std::memory_order_relaxed);
+
+		for(auto& buffer : mBuffers)
+		{
+			stats.NumWritten += buffer->NumWritten.load(std::memory_order_relaxed);
+			stats.NumDropped += buffer->NumDropped.load(std::memory_order_relaxed);
+			stats.NumTruncated += buffer->NumTruncated.load(std::memory_order_relaxed);
+		}
+
+		return stats;
+	}
+} // namespace bs
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Utility/BsModule.h"
+#include "Debug/BsDebug.h"
+#include <atomic>
+#include <type_traits>
+
+namespace bs
+{
+	struct AsyncLogThreadBuffer;
+
+	/** Controls the memory used by AsyncLog and how often it is flushed. */
+	struct AsyncLogSettings
+	{
+		/** Number of messages each thread can buffer before new messages are dropped. Rounded up to a power of two. */
+		u32 MessagesPerThread = 1024;
+
+		/**
+		 * Maximum combined length of the string arguments of a single message, in bytes. Strings past the limit are
+		 * truncated.
+		 */
+		u32 MaxStringLength = 256;
+
+		/**
+		 * Maximum amount of memory used by the buffers of all threads, in bytes. Once reached, threads that haven't logged
+		 * before get no buffer, and their messages are dropped.
+		 */
+		u64 MaxMemory = 16 * 1024 * 1024;
+
+		/** Time between two flushes of the buffered messages to the engine log, in milliseconds. */
+		u32 FlushInterval = 10;
+	};
+
+	/** Counters describing the messages that went through AsyncLog. */
+	struct AsyncLogStats
+	{
+		u64 NumWritten = 0; /**< Messages buffered successfully. */
+		u64 NumDropped = 0; /**< Messages dropped because a buffer was full, or no buffer could be allocated. */
+		u64 NumTruncated = 0; /**< Messages whose string arguments were cut down to the maximum length. */
+		u64 NumFlushed = 0; /**< Messages forwarded to the engine log. */
+	};
+
+	/**
+	 * Argument of a message logged through AsyncLog. Numbers are stored by value. Strings are only referenced, and get
+	 * copied into the message buffer by AsyncLog::Write().
+	 */
+	struct AsyncLogArg
+	{
+		enum class Type : u8 { Int, UInt, Float, Bool, String };
+
+		AsyncLogArg() = default;
+		AsyncLogArg(bool value) : ArgType(Type::Bool) { UInt = value ? 1 : 0; }
+		AsyncLogArg(float value) : ArgType(Type::Float) { Float = value; }
+		AsyncLogArg(double value) : ArgType(Type::Float) { Float = value; }
+		AsyncLogArg(const char* value) : ArgType(Type::String), Str(value), Length((u32)strlen(value)) {}
+		AsyncLogArg(const String& value) : ArgType(Type::String), Str(value.data()), Length((u32)value.size()) {}
+
+		template<class T, std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, int> = 0>
+		AsyncLogArg(T value) : ArgType(Type::Int) { Int = value; }
+
+		template<class T, std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, int> = 0>
+		AsyncLogArg(T value) : ArgType(Type::UInt) { UInt = value; }
+
+		Type ArgType = Type::Int;
+		union
+		{
+			i64 Int = 0;
+			u64 UInt;
+			double Float;
+		};
+
+		const char* Str = nullptr;
+		u32 Length = 0;
+	};
+
+	/**
+	 * Logging sink that never blocks the logging thread. Each thread writes messages into its own fixed-size ring buffer,
+	 * without locks or memory allocation. A message is stored unformatted: as a pointer to its format string, its
+	 * numeric arguments by value and copies of its string arguments. A background thread periodically drains the
+	 * buffers, formats the messages, orders them by time and forwards them to the engine log.
+	 *
+	 * If a thread logs faster than the messages are flushed, its buffer fills up and further messages are dropped rather
+	 * than waiting. Dropped messages are counted, and reported in the log once the buffer has space again.
+	 *
+	 * Use the BS_ASYNC_LOG macro, which falls back to regular logging if the module isn't started.
+	 */
+	class AsyncLog : public Module<AsyncLog>
+	{
+	public:
+		AsyncLog(const AsyncLogSettings& settings = AsyncLogSettings());
+		~AsyncLog();
+
+		/**
+		 * Buffers a message for logging. Returns false if the message was dropped. Only the first time a thread logs does
+		 * this allocate the buffer for the thread, which briefly takes a lock.
+		 *
+		 * @param	verbosity	Verbosity of the message.
+		 * @param	category	Category of the message.
+		 * @param	format		Message, with {0}, {1}, ... replaced by the arguments, same as StringUtil::Format(). The
+		 *						string is read on the flush thread, so it must stay valid for the lifetime of the
+		 *						module. A string literal is expected.
+		 * @param	args		Numbers, booleans or strings. Strings are copied, so they may be temporary.
+		 */
+		template<class... Args>
+		bool Write(LogVerbosity verbosity, u32 category, const char* format, const Args&... args)
+		{
+			static_assert(sizeof...(Args) <= MAX_ARGS, "Too many arguments for an asynchronous log message.");
+
+			// Extra element so the array isn't empty if there are no arguments
+			const AsyncLogArg packedArgs[] = { AsyncLogArg(args)..., AsyncLogArg() };
+			return WriteArgs(verbosity, category, format, packedArgs, (u32)sizeof...(Args));
+		}
+
+		/** Forwards all messages buffered so far to the engine log, and waits until done. */
+		void Flush();
+
+		/** Returns the current message counters. */
+		AsyncLogStats GetStats() const;
+
+		/** Maximum number of arguments of a single message. */
+		static constexpr u32 MAX_ARGS = 8;
+
+	private:
+		/** Buffers a message with arguments already converted by Write(). */
+		bool WriteArgs(LogVerbosity verbosity, u32 category, const char* format, const AsyncLogArg* args, u32 numArgs);
+
+		/** Returns the buffer of the calling thread, creating it if needed. Null if the memory limit was reached. */
+		AsyncLogThreadBuffer* GetThreadBuffer();
+
+		/** Moves all messages out of the thread buffers and forwards them to the engine log. */
+		void Drain();
+
+		/** Runs on the flush thread, draining the buffers periodically until shut down. */
+		void FlushThreadMain();
+
+		AsyncLogSettings mSettings;
+		u32 mMessageStride = 0;
+		u32 mMaxBuffers = 0;
+		u64 mInstanceId = 0;
+
+		mutable Mutex mBuffersMutex;
+		Vector<SPtr<AsyncLogThreadBuffer>> mBuffers;
+		AsyncLogStats mRetiredStats; /**< Counters of buffers released after their thread exited. */
+		u32 mNextThreadIdx = 0;
+
+		Mutex mFlushMutex; /**< Held while draining, so explicit flushes don't overlap with the flush thread. */
+		Mutex mWakeMutex;
+		Signal mWakeSignal;
+		bool mShutDown = false;
+		Thread mFlushThread;
+
+		std::atomic<u64> mNumDroppedUnbuffered{0};
+		std::atomic<u64> mNumFlushed{0};
+	};
+
+	/**
+	 * Logs a message through AsyncLog, with the same arguments as BS_LOG, except the message must be a string literal.
+	 * Insert variable parts using {0}, {1}, ... and pass them as arguments. The message is formatted and written to the
+	 * log on a background thread. Logs synchronously if the AsyncLog module isn't started.
+	 */
+#define BS_ASYNC_LOG(verbosity, category, message, ...)															\
+	do																												\
+	{																												\
+		if(::bs::AsyncLog::IsStarted())																				\
+		{																											\
+			::bs::AsyncLog::Instance().Write(::bs::LogVerbosity::verbosity, (::bs::u32)LogCategory##category::_id,	\
+				"" message, ##__VA_ARGS__);																			\
+		}																											\
+		else																										\
+			BS_LOG(verbosity, category, message, ##__VA_ARGS__);													\
+	} while(0)
+} // namespace bs
@@ -0,0 +1,80 @@
+#include "BsBatchedRandom.h"
+#include "BsCpuFeatures.h"
+
+#if defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
+namespace bs
+{
+#if BS_COMMON_AVX2
+	/**
+	 * Writes numbers of the sequence identified by 'key', starting at 'counter', using AVX2. Only fills whole groups of 8
+	 * numbers and returns how many were written. Defined in BsBatchedRandomAVX2.cpp. Must only be called if
+	 * CpuFeatures::HasAVX2() is true.
+	 */
+	u32 fillBatchedRandomAVX2(u32* output, u32 count, u32 key, u32 counter);
+#endif
+
+	void BatchedRandom::Fill(u32* output, u32 count)
+	{
+		u32 i = 0;
+
+#if BS_COMMON_AVX2
+		if(CpuFeatures::HasAVX2())
+			i = fillBatchedRandomAVX2(output, count, mKey, mCounter);
+#elif defined(__ARM_NEON)
+		const uint32x4_t key = vdupq_n_u32(mKey);
+		const uint32x4_t golden = vdupq_n_u32(0x9E3779B9U);
+		const uint32x4_t mul0 = vdupq_n_u32(0x7FEB352DU);
+		const uint32x4_t mul1 = vdupq_n_u32(0x846CA68BU);
+		const u32 laneOffsetData[] = { 0, 1, 2, 3 };
+		const uint32x4_t laneOffsets = vld1q_u32(laneOffsetData);
+
+		for(; i + 4 <= count; i += 4)
+		{
+			uint32x4_t x = vaddq_u32(vdupq_n_u32(mCounter + i), laneOffsets);
+			x = vaddq_u32(vmulq_u32(x, golden), key);
+
+			x = veorq_u32(x, vshrq_n_u32(x, 16));
+			x = vmulq_u32(x, mul0);
+			x = veorq_u32(x, vshrq_n_u32(x, 15));
+			x = vmulq_u32(x, mul1);
+			x = veorq_u32(x, vshrq_n_u32(x, 16));
+
+			vst1q_u32(output + i, x);
+		}
+#endif
+
+		// Remainder, or everything if no SIMD instruction set is available
+		for(; i < count; i++)
+			output[i] = Generate(mKey, mCounter + i);
+
+		mCounter += count;
+	}
+
+	void BatchedRandom::FillUNorm(float* output, u32 count)
+	{
+		// Generate integers in fixed size chunks on the stack, then convert them. Both loops are trivially vectorizable.
+		static constexpr u32 CHUNK_SIZE = 256;
+		u32 integers[CHUNK_SIZE];
+
+		for(u32 offset = 0; offset < count; offset += CHUNK_SIZE)
+		{
+			const u32 chunkCount = std::min(CHUNK_SIZE, count - offset);
+			Fill(integers, chunkCount);
+
+			for(u32 i = 0; i < chunkCount; i++)
+				output[offset + i] = ToUNorm(integers[i]);
+		}
+	}
+
+	void BatchedRandom::FillRange(float* output, u32 count, float min, float max)
+	{
+		FillUNorm(output, count);
+
+		const float range = max - min;
+		for(u32 i = 0; i < count; i++)
+			output[i] = min + output[i] * range;
+	}
+} // namespace bs
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	/**
+	 * Counter-based random number generator. Every number is computed by hashing a (key, counter) pair, meaning there is
+	 * no serial dependency between consecutive numbers. This allows large blocks of numbers to be generated in parallel
+	 * using SIMD, and any range of the sequence to be reproduced without generating the numbers preceding it.
+	 */
+	class BatchedRandom
+	{
+	public:
+		BatchedRandom(u32 seed = 0)
+			: mKey(Hash(seed ^ 0x9E3779B9U))
+		{}
+
+		/** Generates a single random unsigned integer and advances the counter. */
+		u32 Get() { return Generate(mKey, mCounter++); }
+
+		/** Generates a single random number in [0, 1) range and advances the counter. */
+		float GetUNorm() { return ToUNorm(Get()); }
+
+		/** Fills 'output' with 'count' random unsigned integers and advances the counter by the same amount. */
+		void Fill(u32* output, u32 count);
+
+		/** Fills 'output' with 'count' random numbers in [0, 1) range and advances the counter by the same amount. */
+		void FillUNorm(float* output, u32 count);
+
+		/** Fills 'output' with 'count' random numbers in ['min', 'max') range and advances the counter. */
+		void FillRange(float* output, u32 count, float min, float max);
+
+		/** Changes the seed and resets the counter. */
+		void SetSeed(u32 seed)
+		{
+			mKey = Hash(seed ^ 0x9E3779B9U);
+			mCounter = 0;
+		}
+
+		/** Returns the counter that will be used for generating the next number. */
+		u32 GetCounter() const { return mCounter; }
+
+		/** Sets the counter that will be used for generating the next number. */
+		void SetCounter(u32 counter) { mCounter = counter; }
+
+		/** Generates the number at position 'counter' of the sequence identified by 'key'. */
+		static u32 Generate(u32 key, u32 counter) { return Hash(counter * 0x9E3779B9U + key); }
+
+		/** Converts a random integer into a number in [0, 1) range by using its upper 24 bits. */
+		static float ToUNorm(u32 value) { return (float)(value >> 8) * (1.0f / 16777216.0f); }
+
+	private:
+		/** Integer hash with good avalanche properties, consisting only of operations available on all SIMD sets. */
+		static u32 Hash(u32 x)
+		{
+			x ^= x >> 16;
+			x *= 0x7FEB352DU;
+			x ^= x >> 15;
+			x *= 0x846CA68BU;
+			x ^= x >> 16;
+
+			return x;
+		}
+
+		u32 mKey;
+		u32 mCounter = 0;
+	};
+} // namespace bs
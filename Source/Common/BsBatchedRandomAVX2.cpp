@@ -0,0 +1,35 @@
+#include "BsPrerequisites.h"
+
+// Only compiled with AVX2 enabled on x86 targets, see Common/CMakeLists.txt
+#if BS_COMMON_AVX2
+#include <immintrin.h>
+
+namespace bs
+{
+	u32 fillBatchedRandomAVX2(u32* output, u32 count, u32 key, u32 counter)
+	{
+		const __m256i keys = _mm256_set1_epi32((i32)key);
+		const __m256i golden = _mm256_set1_epi32((i32)0x9E3779B9U);
+		const __m256i mul0 = _mm256_set1_epi32((i32)0x7FEB352DU);
+		const __m256i mul1 = _mm256_set1_epi32((i32)0x846CA68BU);
+		const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+		u32 i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256i x = _mm256_add_epi32(_mm256_set1_epi32((i32)(counter + i)), laneOffsets);
+			x = _mm256_add_epi32(_mm256_mullo_epi32(x, golden), keys);
+
+			x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+			x = _mm256_mullo_epi32(x, mul0);
+			x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+			x = _mm256_mullo_epi32(x, mul1);
+			x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+
+			_mm256_storeu_si256((__m256i*)(output + i), x);
+		}
+
+		return i;
+	}
+} // namespace bs
+#endif
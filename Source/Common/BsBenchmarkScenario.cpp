@@ -0,0 +1,111 @@
+#include "BsBenchmarkScenario.h"
+#include "Scene/BsSceneObject.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "BsApplication.h"
+#include "BsPerfCounters.h"
+#include <cstdlib>
+
+namespace bs
+{
+	const char* BenchmarkScenario::OUTPUT_ENV_VAR = "BS_EXAMPLE_BENCHMARK";
+	const char* BenchmarkScenario::FRAMES_ENV_VAR = "BS_EXAMPLE_BENCHMARK_FRAMES";
+
+	BenchmarkScenario::BenchmarkScenario(const HSceneObject& parent, const Path& outputPath, u32 numWarmupFrames,
+		u32 numFrames)
+		: Component(parent), mOutputPath(outputPath), mNumWarmupFrames(numWarmupFrames), mNumFrames(numFrames)
+	{
+		SetName("BenchmarkScenario");
+
+		mFrameTimes.reserve(numFrames);
+	}
+
+	void BenchmarkScenario::Update()
+	{
+		if(mDone)
+			return;
+
+		const auto now = std::chrono::steady_clock::now();
+
+		// Only count the recorded frames in the performance counter report
+		if(mFrameIdx == mNumWarmupFrames)
+			PerfProfiler::Instance().Reset();
+
+		// The first update has no previous frame to measure against, so it only starts the timer
+		if(mFrameIdx > mNumWarmupFrames)
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mLastFrameTime);
+			mFrameTimes.push_back((u64)elapsed.count());
+		}
+
+		mLastFrameTime = now;
+		mFrameIdx++;
+
+		if(mFrameTimes.size() >= mNumFrames)
+		{
+			Save();
+
+			mDone = true;
+			gApplication().QuitRequested();
+		}
+	}
+
+	void BenchmarkScenario::Save() const
+	{
+		SPtr<DataStream> stream = FileSystem::CreateAndOpenFile(mOutputPath);
+		if(stream == nullptr)
+		{
+			BS_LOG(Error, Uncategorized, "Unable to save the benchmark frame times to: " + mOutputPath.ToString());
+			return;
+		}
+
+		StringStream output;
+		for(auto& entry : mFrameTimes)
+			output << entry << "\n";
+
+		stream->WriteString(output.str());
+		stream->Close();
+
+		// Save the per-scope timings and hardware counters of the recorded frames next to the frame times
+		const Vector<PerfScopeStats> scopeStats = PerfProfiler::Instance().GetStats();
+		if(!scopeStats.empty())
+		{
+			SPtr<DataStream> countersStream = FileSystem::CreateAndOpenFile(GetCountersPath(mOutputPath));
+			if(countersStream != nullptr)
+			{
+				countersStream->WriteString(PerfProfiler::Instance().GetReport());
+				countersStream->Close();
+			}
+		}
+	}
+
+	Path BenchmarkScenario::GetCountersPath(const Path& outputPath)
+	{
+		return Path(outputPath.ToString() + ".counters");
+	}
+
+	bool BenchmarkScenario::IsRequested()
+	{
+		const char* outputPath = getenv(OUTPUT_ENV_VAR);
+		return outputPath != nullptr && outputPath[0] != '\0';
+	}
+
+	void BenchmarkScenario::StartFromEnvironment()
+	{
+		if(!IsRequested())
+			return;
+
+		const char* outputPath = getenv(OUTPUT_ENV_VAR);
+
+		u32 numFrames = DEFAULT_NUM_FRAMES;
+		if(const char* numFramesStr = getenv(FRAMES_ENV_VAR))
+		{
+			const int value = atoi(numFramesStr);
+			if(value > 0)
+				numFrames = (u32)value;
+		}
+
+		HSceneObject scenarioSO = SceneObject::Create("BenchmarkScenario");
+		scenarioSO->AddComponent<BenchmarkScenario>(Path(outputPath), DEFAULT_NUM_WARMUP_FRAMES, numFrames);
+	}
+} // namespace bs
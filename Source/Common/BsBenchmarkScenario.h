@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include <chrono>
+
+namespace bs
+{
+	/**
+	 * Component that turns an example into a non-interactive benchmark. It lets the example run for a number of warm-up
+	 * frames, then records the duration of a fixed number of frames, saves them to a file and closes the application.
+	 *
+	 * Examples start the scenario through StartFromEnvironment(), which only does so when the BS_EXAMPLE_BENCHMARK
+	 * environment variable is set. This allows bsfExamplesBench to run every example and track its frame times. Any scopes
+	 * measured by PerfProfiler during the recorded frames are saved as well.
+	 */
+	class BenchmarkScenario : public Component
+	{
+	public:
+		/**
+		 * Constructs the scenario.
+		 *
+		 * @param	parent				Scene object the component is attached to.
+		 * @param	outputPath			File to save the recorded frame times to, one per line, in nanoseconds.
+		 * @param	numWarmupFrames		Number of frames to run before recording, so the results aren't affected by
+		 *								asset loading and caches warming up.
+		 * @param	numFrames			Number of frames to record.
+		 */
+		BenchmarkScenario(const HSceneObject& parent, const Path& outputPath, u32 numWarmupFrames, u32 numFrames);
+
+		/** Triggered once per frame. Records the time since the last frame. */
+		void Update() override;
+
+		/**
+		 * Starts a benchmark scenario if the BS_EXAMPLE_BENCHMARK environment variable is set to the output path. The
+		 * number of recorded frames can be overridden through BS_EXAMPLE_BENCHMARK_FRAMES. Should be called after the
+		 * application is started, and before the main loop runs.
+		 */
+		static void StartFromEnvironment();
+
+		/**
+		 * Checks if the application was launched as a benchmark scenario, i.e. if StartFromEnvironment() will start one.
+		 * Examples can use this to disable behaviour that would make the frame times unrepresentative.
+		 */
+		static bool IsRequested();
+
+		/**
+		 * Returns the path of the file the per-scope timings and hardware counters (see PerfProfiler) of the recorded
+		 * frames are saved to, for a scenario saving its frame times to 'outputPath'.
+		 */
+		static Path GetCountersPath(const Path& outputPath);
+
+		/** Name of the environment variable containing the path to save the frame times to. */
+		static const char* OUTPUT_ENV_VAR;
+
+		/** Name of the environment variable containing the number of frames to record. */
+		static const char* FRAMES_ENV_VAR;
+
+		static constexpr u32 DEFAULT_NUM_WARMUP_FRAMES = 120;
+		static constexpr u32 DEFAULT_NUM_FRAMES = 600;
+
+	private:
+		/** Saves the recorded frame times to the output file. */
+		void Save() const;
+
+		Path mOutputPath;
+		u32 mNumWarmupFrames;
+		u32 mNumFrames;
+
+		u32 mFrameIdx = 0;
+		bool mDone = false;
+		std::chrono::steady_clock::time_point mLastFrameTime;
+		Vector<u64> mFrameTimes; /**< Recorded frame durations, in nanoseconds. */
+	};
+
+	using HBenchmarkScenario = GameObjectHandle<BenchmarkScenario>;
+} // namespace bs
@@ -0,0 +1,61 @@
+#include "BsBoxGeometry.h"
+#include "Math/BsVector2.h"
+
+namespace bs
+{
+	void writeBoxVertices(const AABox& box, u8* positions, u8* uvs, u32 stride)
+	{
+		AABox::Corner vertOrder[] = {
+			AABox::NEAR_LEFT_BOTTOM, AABox::NEAR_RIGHT_BOTTOM, AABox::NEAR_RIGHT_TOP, AABox::NEAR_LEFT_TOP,
+			AABox::FAR_RIGHT_BOTTOM, AABox::FAR_LEFT_BOTTOM, AABox::FAR_LEFT_TOP, AABox::FAR_RIGHT_TOP,
+			AABox::FAR_LEFT_BOTTOM, AABox::NEAR_LEFT_BOTTOM, AABox::NEAR_LEFT_TOP, AABox::FAR_LEFT_TOP,
+			AABox::NEAR_RIGHT_BOTTOM, AABox::FAR_RIGHT_BOTTOM, AABox::FAR_RIGHT_TOP, AABox::NEAR_RIGHT_TOP,
+			AABox::FAR_LEFT_TOP, AABox::NEAR_LEFT_TOP, AABox::NEAR_RIGHT_TOP, AABox::FAR_RIGHT_TOP,
+			AABox::FAR_LEFT_BOTTOM, AABox::FAR_RIGHT_BOTTOM, AABox::NEAR_RIGHT_BOTTOM, AABox::NEAR_LEFT_BOTTOM
+		};
+
+		for(auto& entry : vertOrder)
+		{
+			Vector3 pos = box.GetCorner(entry);
+			memcpy(positions, &pos, sizeof(pos));
+
+			positions += stride;
+		}
+
+		for(u32 i = 0; i < 6; i++)
+		{
+			Vector2 uv;
+
+			uv = Vector2(0.0f, 1.0f);
+			memcpy(uvs, &uv, sizeof(uv));
+			uvs += stride;
+
+			uv = Vector2(1.0f, 1.0f);
+			memcpy(uvs, &uv, sizeof(uv));
+			uvs += stride;
+
+			uv = Vector2(1.0f, 0.0f);
+			memcpy(uvs, &uv, sizeof(uv));
+			uvs += stride;
+
+			uv = Vector2(0.0f, 0.0f);
+			memcpy(uvs, &uv, sizeof(uv));
+			uvs += stride;
+		}
+	}
+
+	void writeBoxIndices(u32* indices)
+	{
+		for(u32 face = 0; face < 6; face++)
+		{
+			u32 faceVertOffset = face * 4;
+
+			indices[face * 6 + 0] = faceVertOffset + 2;
+			indices[face * 6 + 1] = faceVertOffset + 1;
+			indices[face * 6 + 2] = faceVertOffset + 0;
+			indices[face * 6 + 3] = faceVertOffset + 0;
+			indices[face * 6 + 4] = faceVertOffset + 3;
+			indices[face * 6 + 5] = faceVertOffset + 2;
+		}
+	}
+} // namespace bs
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsAABox.h"
+
+namespace bs
+{
+	/** Number of vertices written by writeBoxVertices(). */
+	constexpr u32 BOX_NUM_VERTICES = 24;
+
+	/** Number of indices written by writeBoxIndices(). */
+	constexpr u32 BOX_NUM_INDICES = 36;
+
+	/**
+	 * Writes vertex positions and texture coordinates of a box mesh. Each face uses its own four vertices so it can be
+	 * textured separately.
+	 *
+	 * @param	box			Bounds of the box to write.
+	 * @param	positions	Location to write the positions to (3 floats per vertex).
+	 * @param	uvs			Location to write the texture coordinates to (2 floats per vertex).
+	 * @param	stride		Offset between two consecutive vertices, in bytes.
+	 */
+	void writeBoxVertices(const AABox& box, u8* positions, u8* uvs, u32 stride);
+
+	/** Writes indices of a box mesh whose vertices were written by writeBoxVertices(). */
+	void writeBoxIndices(u32* indices);
+} // namespace bs
@@ -0,0 +1,51 @@
+#include "BsCPUUsage.h"
+
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+#	define WIN32_LEAN_AND_MEAN
+#	include <windows.h>
+#else
+#	include <time.h>
+#endif
+
+namespace bs
+{
+	CPUUsageMeter::CPUUsageMeter(float samplePeriod)
+		: mSamplePeriod(samplePeriod), mSampleStart(std::chrono::steady_clock::now())
+		, mSampleStartProcessTime(GetProcessTime())
+	{}
+
+	bool CPUUsageMeter::Update()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		const double elapsed = std::chrono::duration<double>(now - mSampleStart).count();
+		if(elapsed < mSamplePeriod)
+			return false;
+
+		const double processTime = GetProcessTime();
+		mUsage = (float)((processTime - mSampleStartProcessTime) / elapsed * 100.0);
+
+		mSampleStart = now;
+		mSampleStartProcessTime = processTime;
+		return true;
+	}
+
+	double CPUUsageMeter::GetProcessTime()
+	{
+#if BS_PLATFORM == BS_PLATFORM_WIN32
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if(!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+			return 0.0;
+
+		// Times are reported in 100 nanosecond units
+		const u64 kernel = ((u64)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+		const u64 user = ((u64)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+		return (kernel + user) * 1e-7;
+#else
+		timespec time;
+		if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0)
+			return 0.0;
+
+		return time.tv_sec + time.tv_nsec * 1e-9;
+#endif
+	}
+} // namespace bs
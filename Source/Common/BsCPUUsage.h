@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include <chrono>
+
+namespace bs
+{
+	/**
+	 * Measures the CPU time used by the process, across all of its threads, relative to the elapsed wall time. The value
+	 * is averaged over a sampling period, so it can be displayed without flickering.
+	 */
+	class CPUUsageMeter
+	{
+	public:
+		/** @param	samplePeriod	Time over which the usage is averaged, in seconds. */
+		CPUUsageMeter(float samplePeriod = 0.5f);
+
+		/** Should be called once per frame. Returns true if a new value was measured this call. */
+		bool Update();
+
+		/**
+		 * Returns the CPU usage measured over the last sampling period, in percent of a single core. Can go over 100 if
+		 * the process uses multiple cores.
+		 */
+		float GetUsage() const { return mUsage; }
+
+		/** Returns the total CPU time used by the process so far, in seconds. */
+		static double GetProcessTime();
+
+	private:
+		float mSamplePeriod;
+		float mUsage = 0.0f;
+
+		std::chrono::steady_clock::time_point mSampleStart;
+		double mSampleStartProcessTime;
+	};
+} // namespace bs
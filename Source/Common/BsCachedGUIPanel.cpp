@@ -0,0 +1,116 @@
+#include "BsCachedGUIPanel.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCCamera.h"
+#include "GUI/BsCGUIWidget.h"
+#include "GUI/BsGUIPanel.h"
+#include "GUI/BsGUITexture.h"
+#include "GUI/BsGUIManager.h"
+#include "Image/BsSpriteTexture.h"
+#include "Image/BsTexture.h"
+#include "RenderAPI/BsRenderTexture.h"
+#include "RenderAPI/BsRenderWindow.h"
+#include "Renderer/BsRenderSettings.h"
+#include "Input/BsInput.h"
+#include "BsApplication.h"
+
+namespace bs
+{
+	CachedGUIPanel::CachedGUIPanel(const HSceneObject& parent, const HGUIWidget& host, const Rect2I& area,
+		const Color& background)
+		: Component(parent), mHost(host), mArea(area), mBackground(background)
+	{
+		SetName("CachedGUIPanel");
+	}
+
+	void CachedGUIPanel::OnInitialized()
+	{
+		// Texture the contents are cached in. GUI doesn't use depth, so there's no depth buffer.
+		TEXTURE_DESC colorDesc;
+		colorDesc.Type = TEX_TYPE_2D;
+		colorDesc.Width = (u32)mArea.Width;
+		colorDesc.Height = (u32)mArea.Height;
+		colorDesc.Format = PF_RGBA8;
+		colorDesc.Usage = TU_RENDERTARGET;
+
+		mRenderTexture = RenderTexture::Create(colorDesc, false);
+
+		// Camera that renders the cached widget. It only renders when explicitly asked to, and never renders the scene.
+		mCamera = SO()->AddComponent<CCamera>();
+		mCamera->GetViewport()->SetTarget(mRenderTexture);
+		mCamera->GetViewport()->SetClearColorValue(mBackground);
+		mCamera->SetLayers(0);
+		mCamera->SetFlag(CameraFlag::OnDemand, true);
+
+		const SPtr<RenderSettings>& renderSettings = mCamera->GetRenderSettings();
+		renderSettings->OverlayOnly = true;
+		mCamera->SetRenderSettings(renderSettings);
+
+		mWidget = SO()->AddComponent<CGUIWidget>(mCamera);
+
+		// Display the cached texture in the host widget
+		HSpriteTexture sprite = SpriteTexture::Create(mRenderTexture->GetColorTexture(0));
+		mCompositeElement = mHost->GetPanel()->AddNewElement<GUITexture>(sprite, TextureScaleMode::StretchToFit, true);
+		mCompositeElement->SetPosition(mArea.X, mArea.Y);
+		mCompositeElement->SetSize((u32)mArea.Width, (u32)mArea.Height);
+
+		// Input over the displayed quad is forwarded to the elements in the cached widget
+		GUIManager::Instance().SetInputBridge(mRenderTexture.get(), mCompositeElement);
+
+		Input& input = gInput();
+		mEventConnections.push_back(input.OnPointerMoved.Connect([this](const PointerEvent& ev) { OnPointerEvent(ev); }));
+		mEventConnections.push_back(input.OnPointerPressed.Connect([this](const PointerEvent& ev) { OnPointerEvent(ev); }));
+		mEventConnections.push_back(input.OnPointerReleased.Connect([this](const PointerEvent& ev) { OnPointerEvent(ev); }));
+		mEventConnections.push_back(input.OnPointerDoubleClick.Connect([this](const PointerEvent& ev) { OnPointerEvent(ev); }));
+
+		// Keyboard input can only change the contents if an element in them has focus, but that isn't cheap to track, and
+		// keyboard input is rare compared to pointer movement
+		mEventConnections.push_back(input.OnButtonDown.Connect([this](const ButtonEvent&) { MarkDirty(); }));
+		mEventConnections.push_back(input.OnCharInput.Connect([this](const TextInputEvent&) { MarkDirty(); }));
+	}
+
+	void CachedGUIPanel::Update()
+	{
+		if(mNumDirtyFrames == 0)
+			return;
+
+		mCamera->NotifyNeedsRedraw();
+
+		mNumDirtyFrames--;
+		mNumRedraws++;
+	}
+
+	void CachedGUIPanel::OnDestroyed()
+	{
+		for(auto& connection : mEventConnections)
+			connection.Disconnect();
+
+		mEventConnections.clear();
+
+		if(mRenderTexture != nullptr)
+			GUIManager::Instance().SetInputBridge(mRenderTexture.get(), nullptr);
+
+		if(mCompositeElement != nullptr)
+		{
+			GUIElement::Destroy(mCompositeElement);
+			mCompositeElement = nullptr;
+		}
+	}
+
+	GUIPanel* CachedGUIPanel::GetPanel() const
+	{
+		return mWidget->GetPanel();
+	}
+
+	void CachedGUIPanel::OnPointerEvent(const PointerEvent& event)
+	{
+		SPtr<RenderWindow> window = gApplication().GetPrimaryWindow();
+		const Vector2I windowPos = window->ScreenToWindowPos(event.ScreenPos);
+
+		// Re-render when the pointer leaves as well, so hover states get cleared
+		const bool inside = mArea.Contains(windowPos);
+		if(inside || mPointerInside)
+			MarkDirty();
+
+		mPointerInside = inside;
+	}
+} // namespace bs
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "Math/BsRect2I.h"
+#include "Image/BsColor.h"
+#include "Input/BsInputFwd.h"
+
+namespace bs
+{
+	/**
+	 * Component that renders a subtree of GUI elements into a cached texture, and displays it in another GUI widget as a
+	 * single textured quad. The texture is only re-rendered when the contents might have changed, so a large, mostly
+	 * static panel costs a single draw while idle, instead of re-batching and drawing all of its elements.
+	 *
+	 * Elements added to GetPanel() are positioned relative to the cached area. Input over the displayed quad is forwarded
+	 * to them, so they remain interactive. Pointer input over the quad and keyboard input trigger a re-render, as these
+	 * can change element states. Changes made to the contents from code must be reported through MarkDirty().
+	 *
+	 * The contents are rendered on top of the background color. Since elements are blended with the background before
+	 * being composited, an opaque background matching what is behind the quad gives the best looking text edges.
+	 */
+	class CachedGUIPanel : public Component
+	{
+	public:
+		/**
+		 * Constructs the panel.
+		 *
+		 * @param	parent		Scene object the component is attached to.
+		 * @param	host		Widget to display the cached contents in. Should render to the primary window.
+		 * @param	area		Area of the host widget to display the cached contents in, in pixels. Determines the
+		 *						size of the cached texture.
+		 * @param	background	Color the contents are rendered on top of.
+		 */
+		CachedGUIPanel(const HSceneObject& parent, const HGUIWidget& host, const Rect2I& area,
+			const Color& background = Color(0.0f, 0.0f, 0.0f, 0.0f));
+
+		/** Triggered when the component is added. Creates the cached texture and the widget rendering into it. */
+		void OnInitialized() override;
+
+		/** Triggered once per frame. Re-renders the cached texture if it was marked dirty. */
+		void Update() override;
+
+		/** Triggered when the component is destroyed. Removes the displayed quad and stops forwarding input. */
+		void OnDestroyed() override;
+
+		/** Returns the panel to add the cached elements to. Valid once the component was added to a scene object. */
+		GUIPanel* GetPanel() const;
+
+		/** Marks the contents as changed, so they are re-rendered on the next frame. */
+		void MarkDirty() { mNumDirtyFrames = NUM_REDRAW_FRAMES; }
+
+		/** Returns the number of frames the cached texture was re-rendered on. */
+		u64 GetNumRedraws() const { return mNumRedraws; }
+
+		/**
+		 * Number of frames to keep re-rendering after a change. Some element state changes (e.g. an element becoming
+		 * active on press) are only applied on the frame after the input that caused them.
+		 */
+		static constexpr u32 NUM_REDRAW_FRAMES = 2;
+
+	private:
+		/** Handles pointer input, marking the contents dirty if the pointer is or was over the displayed quad. */
+		void OnPointerEvent(const PointerEvent& event);
+
+		HGUIWidget mHost;
+		Rect2I mArea;
+		Color mBackground;
+
+		SPtr<RenderTexture> mRenderTexture;
+		HCamera mCamera;
+		HGUIWidget mWidget;
+		GUITexture* mCompositeElement = nullptr;
+
+		Vector<HEvent> mEventConnections;
+		bool mPointerInside = false;
+		u32 mNumDirtyFrames = NUM_REDRAW_FRAMES;
+		u64 mNumRedraws = 0;
+	};
+
+	using HCachedGUIPanel = GameObjectHandle<CachedGUIPanel>;
+} // namespace bs
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "Resources/BsResources.h"
+#include "CoreThread/BsCoreThread.h"
+#include "Threading/BsAsyncOp.h"
+
+// Coroutines require C++20, targets including this header must enable it.
+#if !defined(__cpp_impl_coroutine)
+#error "C++20 coroutines required"
+#endif
+
+#include <coroutine>
+#include <optional>
+#include <utility>
+
+namespace bs
+{
+	/**
+	 * State shared by the promises of all coroutine tasks. Keeps track of what the coroutine is waiting on, so the
+	 * scheduler knows when to resume it.
+	 */
+	struct CoroutinePromiseBase
+	{
+		/** Condition that must be met before the coroutine is resumed. Null if it can be resumed right away. */
+		std::function<bool()> WaitCondition;
+
+		/** Another coroutine task this coroutine is waiting on. Resumed by the scheduler instead of this coroutine. */
+		std::coroutine_handle<> ChildHandle;
+		CoroutinePromiseBase* Child = nullptr;
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void unhandled_exception() { std::terminate(); }
+
+		/**
+		 * Advances the coroutine if whatever it is waiting on is done. Returns true once the coroutine has finished.
+		 * Meant to be called once per frame, by CoroutineScheduler.
+		 */
+		static bool Step(std::coroutine_handle<> handle, CoroutinePromiseBase& promise)
+		{
+			if(handle.done())
+				return true;
+
+			if(promise.Child != nullptr)
+			{
+				if(!Step(promise.ChildHandle, *promise.Child))
+					return false;
+
+				promise.Child = nullptr;
+				promise.ChildHandle = nullptr;
+			}
+			else if(promise.WaitCondition && !promise.WaitCondition())
+				return false;
+
+			promise.WaitCondition = nullptr;
+			handle.resume();
+
+			return handle.done();
+		}
+	};
+
+	/** Stores the value returned from a coroutine. */
+	template<class T>
+	struct CoroutinePromiseResult : CoroutinePromiseBase
+	{
+		std::optional<T> Result;
+
+		void return_value(T value) { Result = std::move(value); }
+		T TakeResult() { return std::move(*Result); }
+	};
+
+	template<>
+	struct CoroutinePromiseResult<void> : CoroutinePromiseBase
+	{
+		void return_void() {}
+		void TakeResult() {}
+	};
+
+	/**
+	 * Return type for coroutines that perform work across multiple frames, such as loading resources and setting up the
+	 * scene. The coroutine doesn't start until it is either started by a CoroutineScheduler, or awaited from another
+	 * coroutine task, in which case its return value is provided as the result of the co_await expression.
+	 *
+	 * Coroutines suspend with co_await on one of the awaitables below (e.g. WaitForLoad(), RunOnCoreThread(),
+	 * NextFrame()). While suspended, the main loop keeps running.
+	 */
+	template<class T = void>
+	class CoroutineTask
+	{
+	public:
+		struct promise_type : CoroutinePromiseResult<T>
+		{
+			CoroutineTask get_return_object()
+			{
+				return CoroutineTask(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+		};
+
+		CoroutineTask() = default;
+
+		CoroutineTask(CoroutineTask&& other) noexcept
+			: mHandle(std::exchange(other.mHandle, nullptr))
+		{}
+
+		CoroutineTask& operator=(CoroutineTask&& other) noexcept
+		{
+			if(this != &other)
+			{
+				if(mHandle)
+					mHandle.destroy();
+
+				mHandle = std::exchange(other.mHandle, nullptr);
+			}
+
+			return *this;
+		}
+
+		~CoroutineTask()
+		{
+			if(mHandle)
+				mHandle.destroy();
+		}
+
+		/** Advances the coroutine, if it's ready to continue. Returns true once the coroutine has finished. */
+		bool Step() { return !mHandle || CoroutinePromiseBase::Step(mHandle, mHandle.promise()); }
+
+		/** Returns true if the coroutine has finished. */
+		bool IsDone() const { return !mHandle || mHandle.done(); }
+
+		/** Awaiting a task from another coroutine starts it, and suspends the caller until it finishes. */
+		bool await_ready() const noexcept { return IsDone(); }
+
+		template<class P>
+		bool await_suspend(std::coroutine_handle<P> caller)
+		{
+			// Start the child right away, rather than waiting for the next frame. If it finishes without suspending, the
+			// caller continues right away as well.
+			mHandle.resume();
+			if(mHandle.done())
+				return false;
+
+			CoroutinePromiseBase& callerPromise = caller.promise();
+			callerPromise.ChildHandle = mHandle;
+			callerPromise.Child = &mHandle.promise();
+
+			return true;
+		}
+
+		T await_resume() { return mHandle.promise().TakeResult(); }
+
+	private:
+		explicit CoroutineTask(std::coroutine_handle<promise_type> handle)
+			: mHandle(handle)
+		{}
+
+		std::coroutine_handle<promise_type> mHandle;
+	};
+
+	/** Awaitable that suspends the coroutine until a condition is met. The condition is checked once per frame. */
+	struct WaitUntilAwaitable
+	{
+		std::function<bool()> Condition;
+
+		bool await_ready() const { return Condition(); }
+
+		template<class P>
+		void await_suspend(std::coroutine_handle<P> handle) { handle.promise().WaitCondition = Condition; }
+
+		void await_resume() const {}
+	};
+
+	/** Suspends the coroutine until 'condition' returns true. */
+	inline WaitUntilAwaitable WaitUntil(std::function<bool()> condition)
+	{
+		return WaitUntilAwaitable{ std::move(condition) };
+	}
+
+	/** Suspends the coroutine until the next frame. */
+	inline WaitUntilAwaitable NextFrame()
+	{
+		return WaitUntilAwaitable{ [waited = false]() mutable { return std::exchange(waited, true); } };
+	}
+
+	/** Awaitable that suspends the coroutine until a resource finishes loading, and then returns its handle. */
+	template<class T>
+	struct ResourceLoadAwaitable
+	{
+		ResourceHandle<T> Handle;
+
+		bool await_ready() const { return Handle == nullptr || Handle.IsLoaded(); }
+
+		template<class P>
+		void await_suspend(std::coroutine_handle<P> handle)
+		{
+			ResourceHandle<T> resource = Handle;
+			handle.promise().WaitCondition = [resource]() { return resource.IsLoaded(); };
+		}
+
+		ResourceHandle<T> await_resume() const { return Handle; }
+	};
+
+	/** Suspends the coroutine until the resource referenced by 'handle' (e.g. from Resources::LoadAsync) is loaded. */
+	template<class T>
+	ResourceLoadAwaitable<T> WaitForLoad(const ResourceHandle<T>& handle)
+	{
+		return ResourceLoadAwaitable<T>{ handle };
+	}
+
+	/**
+	 * Suspends the coroutine until all the provided resources are loaded. Start all the loads before awaiting so they
+	 * are processed in parallel.
+	 */
+	inline WaitUntilAwaitable WaitForLoadAll(Vector<HResource> handles)
+	{
+		return WaitUntilAwaitable{ [handles = std::move(handles)]()
+		{
+			for(auto& handle : handles)
+			{
+				if(handle != nullptr && !handle.IsLoaded())
+					return false;
+			}
+
+			return true;
+		}};
+	}
+
+	/** Starts an asynchronous load of the resource at 'path' and suspends the coroutine until it completes. */
+	template<class T>
+	ResourceLoadAwaitable<T> LoadAsync(const Path& path, ResourceLoadFlags loadFlags = ResourceLoadFlag::Default)
+	{
+		return ResourceLoadAwaitable<T>{ gResources().LoadAsync<T>(path, loadFlags) };
+	}
+
+	/** Awaitable that suspends the coroutine until an operation queued on the core thread completes. */
+	struct AsyncOpAwaitable
+	{
+		AsyncOp Op;
+
+		bool await_ready() const { return Op.HasCompleted(); }
+
+		template<class P>
+		void await_suspend(std::coroutine_handle<P> handle)
+		{
+			AsyncOp op = Op;
+			handle.promise().WaitCondition = [op]() { return op.HasCompleted(); };
+		}
+
+		AsyncOp await_resume() const { return Op; }
+	};
+
+	/** Suspends the coroutine until 'op' completes. The operation is provided as the result of the co_await expression. */
+	inline AsyncOpAwaitable WaitForAsyncOp(const AsyncOp& op)
+	{
+		return AsyncOpAwaitable{ op };
+	}
+
+	/**
+	 * Queues 'command' for execution on the core thread and suspends the coroutine until it completes. The command
+	 * signals completion and provides its return value through the AsyncOp it receives.
+	 */
+	inline AsyncOpAwaitable RunOnCoreThread(std::function<void(AsyncOp&)> command)
+	{
+		return AsyncOpAwaitable{ gCoreThread().QueueReturnCommand(std::move(command)) };
+	}
+
+	/**
+	 * Component that runs coroutine tasks. Each frame, every task whose awaited operation has completed is resumed,
+	 * until it suspends again or finishes. Tasks are destroyed once they finish, or when the component is destroyed.
+	 */
+	class CoroutineScheduler : public Component
+	{
+	public:
+		CoroutineScheduler(const HSceneObject& parent)
+			: Component(parent)
+		{
+			SetName("CoroutineScheduler");
+		}
+
+		/** Starts executing the task. The task runs until its first suspension point right away. */
+		void Start(CoroutineTask<> task)
+		{
+			if(!task.Step())
+				mTasks.push_back(std::move(task));
+		}
+
+		/** Returns the number of tasks that haven't yet finished. */
+		u32 GetNumRunning() const { return (u32)mTasks.size(); }
+
+		/** Triggered once per frame. Resumes tasks that are ready to continue. */
+		void Update() override
+		{
+			// Tasks can start other tasks while being resumed, so iterate over a separate list
+			Vector<CoroutineTask<>> tasks;
+			std::swap(tasks, mTasks);
+
+			for(auto& task : tasks)
+			{
+				if(!task.Step())
+					mTasks.push_back(std::move(task));
+			}
+		}
+
+	private:
+		Vector<CoroutineTask<>> mTasks;
+	};
+
+	using HCoroutineScheduler = GameObjectHandle<CoroutineScheduler>;
+} // namespace bs
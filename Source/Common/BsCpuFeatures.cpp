@@ -0,0 +1,45 @@
+#include "BsCpuFeatures.h"
+
+#if BS_COMMON_AVX2 && defined(_MSC_VER)
+#	include <intrin.h>
+#endif
+
+namespace bs
+{
+	/** Queries the CPU for AVX2 and FMA support. */
+	static bool detectAVX2()
+	{
+#if BS_COMMON_AVX2
+#	if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if(info[0] < 7)
+			return false;
+
+		// FMA, and OSXSAVE which is required for querying the OS state with xgetbv
+		__cpuid(info, 1);
+		if((info[2] & (1 << 12)) == 0 || (info[2] & (1 << 27)) == 0)
+			return false;
+
+		// The OS must preserve the full YMM registers when switching threads
+		if((_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#	else
+		// Also checks the OS preserves the YMM registers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#	endif
+#else
+		return false;
+#endif
+	}
+
+	bool CpuFeatures::HasAVX2()
+	{
+		static const bool supported = detectAVX2();
+		return supported;
+	}
+} // namespace bs
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	/**
+	 * Reports the instruction sets available on the CPU the application runs on. Code using instruction sets beyond the
+	 * baseline the examples are built for is kept in separate files, compiled with those instruction sets enabled (see
+	 * Common/CMakeLists.txt). It must only be called after checking for support here.
+	 */
+	class CpuFeatures
+	{
+	public:
+		/**
+		 * Returns true if the AVX2 code paths were compiled in, and both AVX2 and FMA are supported by the CPU and enabled
+		 * by the OS.
+		 */
+		static bool HasAVX2();
+	};
+} // namespace bs
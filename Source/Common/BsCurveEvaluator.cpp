@@ -0,0 +1,67 @@
+#include "BsCurveEvaluator.h"
+
+namespace bs
+{
+	AnimationClipSampler::AnimationClipSampler(const HAnimationClip& clip)
+	{
+		if(clip == nullptr)
+			return;
+
+		SPtr<AnimationCurves> curves = clip->GetCurves();
+		if(curves == nullptr)
+			return;
+
+		// Create an evaluator per track. Each of them copies the keyframes, so the clip can be modified or unloaded later.
+		for(auto& entry : curves->Position)
+			mPositionTracks.push_back(Vector3CurveEvaluator(entry.Curve));
+
+		for(auto& entry : curves->Rotation)
+			mRotationTracks.push_back(QuaternionCurveEvaluator(entry.Curve));
+
+		for(auto& entry : curves->Scale)
+			mScaleTracks.push_back(Vector3CurveEvaluator(entry.Curve));
+
+		for(auto& entry : curves->Generic)
+			mGenericTracks.push_back(CurveEvaluator(entry.Curve));
+	}
+
+	void AnimationClipSampler::Sample(float time, AnimationClipSample& output, bool loop)
+	{
+		output.Positions.resize(mPositionTracks.size());
+		output.Rotations.resize(mRotationTracks.size());
+		output.Scales.resize(mScaleTracks.size());
+		output.Generic.resize(mGenericTracks.size());
+
+		for(u32 i = 0; i < (u32)mPositionTracks.size(); i++)
+			output.Positions[i] = mPositionTracks[i].Evaluate(time, loop);
+
+		for(u32 i = 0; i < (u32)mRotationTracks.size(); i++)
+			output.Rotations[i] = mRotationTracks[i].Evaluate(time, loop);
+
+		for(u32 i = 0; i < (u32)mScaleTracks.size(); i++)
+			output.Scales[i] = mScaleTracks[i].Evaluate(time, loop);
+
+		for(u32 i = 0; i < (u32)mGenericTracks.size(); i++)
+			output.Generic[i] = mGenericTracks[i].Evaluate(time, loop);
+	}
+
+	void AnimationClipSampler::Reset()
+	{
+		for(auto& entry : mPositionTracks)
+			entry.Reset();
+
+		for(auto& entry : mRotationTracks)
+			entry.Reset();
+
+		for(auto& entry : mScaleTracks)
+			entry.Reset();
+
+		for(auto& entry : mGenericTracks)
+			entry.Reset();
+	}
+
+	u32 AnimationClipSampler::GetNumTracks() const
+	{
+		return (u32)(mPositionTracks.size() + mRotationTracks.size() + mScaleTracks.size() + mGenericTracks.size());
+	}
+} // namespace bs
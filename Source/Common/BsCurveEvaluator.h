@@ -0,0 +1,187 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Animation/BsAnimationCurve.h"
+#include "Animation/BsAnimationClip.h"
+#include "Math/BsQuaternion.h"
+
+namespace bs
+{
+	/**
+	 * Evaluates an animation curve while remembering the keyframe segment used by the previous evaluation. When the curve
+	 * is sampled with monotonically increasing time (which is the case during normal playback) the next segment is found
+	 * by stepping forward from the cached one, instead of searching through all the keyframes. This makes sequential
+	 * sampling amortized O(1). Random access falls back to a binary search.
+	 */
+	template <class T>
+	class TCurveEvaluator
+	{
+	public:
+		TCurveEvaluator() = default;
+
+		TCurveEvaluator(const TAnimationCurve<T>& curve)
+		{
+			SetCurve(curve);
+		}
+
+		/** Assigns the curve to evaluate. Keyframes are copied so the curve doesn't need to outlive the evaluator. */
+		void SetCurve(const TAnimationCurve<T>& curve)
+		{
+			mKeyframes = curve.GetKeyFrames();
+			mCachedKey = 0;
+		}
+
+		/**
+		 * Evaluates the curve at the specified time. If 'loop' is true the time is wrapped to the range of the curve,
+		 * otherwise it is clamped to it.
+		 */
+		T Evaluate(float time, bool loop = true)
+		{
+			const u32 numKeys = (u32)mKeyframes.size();
+			if(numKeys == 0)
+				return T();
+
+			const TKeyframe<T>& firstKey = mKeyframes[0];
+			const TKeyframe<T>& lastKey = mKeyframes[numKeys - 1];
+
+			if(loop)
+			{
+				const float length = lastKey.Time - firstKey.Time;
+				if(length > 0.0f && (time < firstKey.Time || time > lastKey.Time))
+				{
+					time = std::fmod(time - firstKey.Time, length);
+					if(time < 0.0f)
+						time += length;
+
+					time += firstKey.Time;
+				}
+			}
+
+			if(time <= firstKey.Time)
+			{
+				mCachedKey = 0;
+				return firstKey.Value;
+			}
+
+			if(time >= lastKey.Time)
+			{
+				mCachedKey = numKeys - 1;
+				return lastKey.Value;
+			}
+
+			const u32 key = FindKey(time);
+			mCachedKey = key;
+
+			return EvaluateSegment(mKeyframes[key], mKeyframes[key + 1], time);
+		}
+
+		/** Forgets the cached keyframe, causing the next evaluation to start its search from the first key. */
+		void Reset() { mCachedKey = 0; }
+
+		/** Returns the index of the keyframe that starts the segment used by the last evaluation. */
+		u32 GetCachedKey() const { return mCachedKey; }
+
+		/** Returns the number of keyframes in the evaluated curve. */
+		u32 GetNumKeyFrames() const { return (u32)mKeyframes.size(); }
+
+	private:
+		/**
+		 * Finds the keyframe starting the segment that contains 'time'. Time must be within the curve range. Checks the
+		 * cached segment and a few segments following it before resorting to a binary search.
+		 */
+		u32 FindKey(float time) const
+		{
+			const u32 numKeys = (u32)mKeyframes.size();
+
+			u32 key = std::min(mCachedKey, numKeys - 2);
+			if(mKeyframes[key].Time <= time)
+			{
+				const u32 lastStep = std::min(key + MAX_LINEAR_STEPS, numKeys - 1);
+				for(; key < lastStep; key++)
+				{
+					if(time < mKeyframes[key + 1].Time)
+						return key;
+				}
+			}
+
+			auto iterFind = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), time,
+				[](float value, const TKeyframe<T>& keyframe) { return value < keyframe.Time; });
+
+			return (u32)(iterFind - mKeyframes.begin()) - 1;
+		}
+
+		/** Evaluates a cubic Hermite segment between two keyframes. */
+		static T EvaluateSegment(const TKeyframe<T>& lhs, const TKeyframe<T>& rhs, float time)
+		{
+			const float length = rhs.Time - lhs.Time;
+			if(length <= 0.0f)
+				return lhs.Value;
+
+			const float t = (time - lhs.Time) / length;
+			const float t2 = t * t;
+			const float t3 = t2 * t;
+
+			const float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+			const float h10 = t3 - 2.0f * t2 + t;
+			const float h01 = -2.0f * t3 + 3.0f * t2;
+			const float h11 = t3 - t2;
+
+			T output = lhs.Value * h00 + (lhs.OutTangent * length) * h10 + rhs.Value * h01 + (rhs.InTangent * length) * h11;
+			NormalizeValue(output);
+
+			return output;
+		}
+
+		/** Ensures rotations remain unit length after interpolation. No-op for other types. */
+		template <class U>
+		static void NormalizeValue(U& value) {}
+		static void NormalizeValue(Quaternion& value) { value.Normalize(); }
+
+		/** Maximum number of segments to step through before falling back to a binary search. */
+		static constexpr u32 MAX_LINEAR_STEPS = 4;
+
+		Vector<TKeyframe<T>> mKeyframes;
+		u32 mCachedKey = 0;
+	};
+
+	using CurveEvaluator = TCurveEvaluator<float>;
+	using Vector3CurveEvaluator = TCurveEvaluator<Vector3>;
+	using QuaternionCurveEvaluator = TCurveEvaluator<Quaternion>;
+
+	/** Output of a single AnimationClipSampler::Sample() call. Contains one entry per track, in clip track order. */
+	struct AnimationClipSample
+	{
+		Vector<Vector3> Positions;
+		Vector<Quaternion> Rotations;
+		Vector<Vector3> Scales;
+		Vector<float> Generic;
+	};
+
+	/**
+	 * Samples all the tracks of an animation clip using a separate TCurveEvaluator per track. Each track remembers its
+	 * own keyframe cursor, so sampling a clip with monotonically increasing time doesn't need to search for keyframes.
+	 */
+	class AnimationClipSampler
+	{
+	public:
+		AnimationClipSampler(const HAnimationClip& clip);
+
+		/**
+		 * Evaluates every track in the clip at the provided time, and writes the results in 'output'. Time is wrapped
+		 * to the clip range if 'loop' is true.
+		 */
+		void Sample(float time, AnimationClipSample& output, bool loop = true);
+
+		/** Resets the keyframe cursors of all tracks. Should be called when playback jumps backwards. */
+		void Reset();
+
+		/** Returns the total number of tracks (curves) in the clip. */
+		u32 GetNumTracks() const;
+
+	private:
+		Vector<Vector3CurveEvaluator> mPositionTracks;
+		Vector<QuaternionCurveEvaluator> mRotationTracks;
+		Vector<Vector3CurveEvaluator> mScaleTracks;
+		Vector<CurveEvaluator> mGenericTracks;
+	};
+} // namespace bs
@@ -0,0 +1,90 @@
+#include "BsCurveLookupTable.h"
+#include "Image/BsPixelData.h"
+#include "Image/BsTexture.h"
+#include "BsCpuFeatures.h"
+
+namespace bs
+{
+#if BS_COMMON_AVX2
+	/**
+	 * Evaluates a lookup table of 'numValues' entries for whole groups of 8 time values using AVX2, and returns how many
+	 * were evaluated. See TCurveLookupTable for the parameters. Defined in BsCurveLookupTableAVX2.cpp. Must only be called
+	 * if CpuFeatures::HasAVX2() is true, and the table must have at least two entries.
+	 */
+	u32 evaluateCurveLookupTableAVX2(const float* values, u32 numValues, float start, float invStep, float maxIndex,
+		const float* times, float* output, u32 count);
+#endif
+
+	template <>
+	void TCurveLookupTable<float>::Evaluate(const float* times, float* output, u32 count) const
+	{
+		if(!IsBaked())
+		{
+			for(u32 i = 0; i < count; i++)
+				output[i] = 0.0f;
+
+			return;
+		}
+
+		u32 i = 0;
+
+#if BS_COMMON_AVX2
+		if(CpuFeatures::HasAVX2())
+		{
+			i = evaluateCurveLookupTableAVX2(mValues.data(), (u32)mValues.size(), mStart, mInvStep, mMaxIndex, times,
+				output, count);
+		}
+#endif
+
+		for(; i < count; i++)
+			output[i] = Evaluate(times[i]);
+	}
+
+	void ColorGradientLookupTable::Bake(const ColorGradient& gradient, u32 numSamples, float start, float end)
+	{
+		SetRange(numSamples, start, end);
+
+		for(u32 i = 0; i < (u32)mValues.size(); i++)
+			mValues[i] = Color::FromRGBA(gradient.Evaluate(GetSampleTime(i)));
+	}
+
+	HTexture CurveLookupTextures::Create(const CurveLookupTable* r, const CurveLookupTable* g, const CurveLookupTable* b,
+		const CurveLookupTable* a)
+	{
+		BS_ASSERT(r != nullptr && r->IsBaked());
+
+		const CurveLookupTable* channels[] = { r, g, b, a };
+		const u32 numSamples = r->GetNumSamples();
+
+		SPtr<PixelData> pixelData = PixelData::Create(numSamples, 1, 1, PF_RGBA32F);
+		for(u32 i = 0; i < numSamples; i++)
+		{
+			float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for(u32 j = 0; j < 4; j++)
+			{
+				if(channels[j] == nullptr)
+					continue;
+
+				BS_ASSERT(channels[j]->GetNumSamples() == numSamples);
+				values[j] = channels[j]->GetValues()[i];
+			}
+
+			pixelData->SetColorAt(Color(values[0], values[1], values[2], values[3]), i, 0);
+		}
+
+		return Texture::Create(pixelData);
+	}
+
+	HTexture CurveLookupTextures::Create(const ColorGradientLookupTable& colors)
+	{
+		BS_ASSERT(colors.IsBaked());
+
+		const u32 numSamples = colors.GetNumSamples();
+
+		SPtr<PixelData> pixelData = PixelData::Create(numSamples, 1, 1, PF_RGBA32F);
+		for(u32 i = 0; i < numSamples; i++)
+			pixelData->SetColorAt(colors.GetValues()[i], i, 0);
+
+		return Texture::Create(pixelData);
+	}
+} // namespace bs
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Animation/BsAnimationCurve.h"
+#include "Image/BsColor.h"
+#include "Image/BsColorGradient.h"
+#include "Math/BsVector2.h"
+#include "Math/BsVector3.h"
+
+namespace bs
+{
+	/**
+	 * Fixed-size table of values sampled from a curve at regular intervals. Evaluating the table is a single lookup and
+	 * a linear interpolation between two neighbouring entries, regardless of how many keyframes the original curve had.
+	 * Intended for curves evaluated many times per frame with a normalized time, such as particle evolver curves which
+	 * are evaluated using the particle's normalized lifetime.
+	 */
+	template <class T>
+	class TCurveLookupTable
+	{
+	public:
+		TCurveLookupTable() = default;
+
+		/**
+		 * Bakes the curve into a table of 'numSamples' entries, covering the time range ['start', 'end']. Times outside of
+		 * that range are clamped during evaluation.
+		 */
+		void Bake(const TAnimationCurve<T>& curve, u32 numSamples = DEFAULT_NUM_SAMPLES, float start = 0.0f,
+			float end = 1.0f)
+		{
+			SetRange(numSamples, start, end);
+
+			for(u32 i = 0; i < numSamples; i++)
+				mValues[i] = curve.Evaluate(GetSampleTime(i), false);
+		}
+
+		/** Evaluates the table at the provided time. Returns a default constructed value if the table isn't baked. */
+		T Evaluate(float time) const
+		{
+			if(!IsBaked())
+				return T();
+
+			float position = Math::Clamp((time - mStart) * mInvStep, 0.0f, mMaxIndex);
+
+			u32 index = std::min((u32)position, (u32)mValues.size() - 2);
+			float t = position - (float)index;
+
+			return mValues[index] + (mValues[index + 1] - mValues[index]) * t;
+		}
+
+		/**
+		 * Evaluates the table for 'count' different time values and writes the results in 'output'. Used for evaluating
+		 * a whole set of particles at once. Outputs default constructed values if the table isn't baked.
+		 */
+		void Evaluate(const float* times, T* output, u32 count) const
+		{
+			for(u32 i = 0; i < count; i++)
+				output[i] = Evaluate(times[i]);
+		}
+
+		/** Returns the baked values. */
+		const Vector<T>& GetValues() const { return mValues; }
+
+		/** Returns the number of entries in the table. */
+		u32 GetNumSamples() const { return (u32)mValues.size(); }
+
+		/** Returns true if the table has been baked. */
+		bool IsBaked() const { return mValues.size() >= 2; }
+
+		/** Default number of entries used when baking. */
+		static constexpr u32 DEFAULT_NUM_SAMPLES = 128;
+
+	protected:
+		/** Resizes the table and calculates the parameters required for mapping time to table entries. */
+		void SetRange(u32 numSamples, float start, float end)
+		{
+			numSamples = std::max(numSamples, 2U);
+
+			mValues.resize(numSamples);
+			mStart = start;
+			mStep = (end - start) / (float)(numSamples - 1);
+			mInvStep = mStep > 0.0f ? 1.0f / mStep : 0.0f;
+			mMaxIndex = (float)(numSamples - 1);
+		}
+
+		/** Returns the time the table entry at the specified index was sampled at. */
+		float GetSampleTime(u32 index) const { return mStart + mStep * (float)index; }
+
+		Vector<T> mValues;
+		float mStart = 0.0f;
+		float mStep = 0.0f;
+		float mInvStep = 0.0f;
+		float mMaxIndex = 0.0f;
+	};
+
+	/**
+	 * Evaluates eight entries at a time using AVX2 if the CPU supports it, looking up the neighbouring table entries with
+	 * a gather. Defined in BsCurveLookupTable.cpp.
+	 */
+	template <>
+	void TCurveLookupTable<float>::Evaluate(const float* times, float* output, u32 count) const;
+
+	using CurveLookupTable = TCurveLookupTable<float>;
+	using Vector2CurveLookupTable = TCurveLookupTable<Vector2>;
+	using Vector3CurveLookupTable = TCurveLookupTable<Vector3>;
+
+	/** Lookup table baked from a color gradient. Evaluation works the same as with TCurveLookupTable. */
+	class ColorGradientLookupTable : public TCurveLookupTable<Color>
+	{
+	public:
+		/** Bakes the gradient into a table of 'numSamples' entries, covering the time range ['start', 'end']. */
+		void Bake(const ColorGradient& gradient, u32 numSamples = DEFAULT_NUM_SAMPLES, float start = 0.0f,
+			float end = 1.0f);
+	};
+
+	/** Helpers for uploading baked lookup tables to the GPU. */
+	class CurveLookupTextures
+	{
+	public:
+		/**
+		 * Creates a texture of 'numSamples' x 1 size from a set of lookup tables. Each provided table is written to its
+		 * own channel (R, G, B and A, in that order), letting a GPU simulation fetch up to four curves with a single
+		 * sample. All tables must have the same number of entries. Unused channels are set to zero.
+		 */
+		static HTexture Create(const CurveLookupTable* r, const CurveLookupTable* g = nullptr,
+			const CurveLookupTable* b = nullptr, const CurveLookupTable* a = nullptr);
+
+		/** Creates a texture of 'numSamples' x 1 size containing the colors from the provided lookup table. */
+		static HTexture Create(const ColorGradientLookupTable& colors);
+	};
+} // namespace bs
@@ -0,0 +1,36 @@
+#include "BsPrerequisites.h"
+
+// Only compiled with AVX2 enabled on x86 targets, see Common/CMakeLists.txt
+#if BS_COMMON_AVX2
+#include <immintrin.h>
+
+namespace bs
+{
+	u32 evaluateCurveLookupTableAVX2(const float* values, u32 numValues, float start, float invStep, float maxIndex,
+		const float* times, float* output, u32 count)
+	{
+		const __m256 startValue = _mm256_set1_ps(start);
+		const __m256 invStepValue = _mm256_set1_ps(invStep);
+		const __m256 maxIndexValue = _mm256_set1_ps(maxIndex);
+		const __m256i maxBaseIndex = _mm256_set1_epi32((i32)numValues - 2);
+		const __m256i one = _mm256_set1_epi32(1);
+
+		u32 i = 0;
+		for(; i + 8 <= count; i += 8)
+		{
+			__m256 position = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(times + i), startValue), invStepValue);
+			position = _mm256_min_ps(_mm256_max_ps(position, _mm256_setzero_ps()), maxIndexValue);
+
+			__m256i index = _mm256_min_epi32(_mm256_cvttps_epi32(position), maxBaseIndex);
+			__m256 t = _mm256_sub_ps(position, _mm256_cvtepi32_ps(index));
+
+			__m256 left = _mm256_i32gather_ps(values, index, 4);
+			__m256 right = _mm256_i32gather_ps(values, _mm256_add_epi32(index, one), 4);
+
+			_mm256_storeu_ps(output + i, _mm256_add_ps(left, _mm256_mul_ps(_mm256_sub_ps(right, left), t)));
+		}
+
+		return i;
+	}
+} // namespace bs
+#endif
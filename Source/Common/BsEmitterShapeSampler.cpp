@@ -0,0 +1,210 @@
+#include "BsEmitterShapeSampler.h"
+#include "Math/BsMath.h"
+
+namespace bs
+{
+	/**
+	 * Approximates sine for values in [-PI, 2 * PI) range. Written using only arithmetic and selects, so loops calling it
+	 * can be vectorized (unlike calls to std::sin). Absolute error is below 4e-6.
+	 */
+	static float fastSin(float x)
+	{
+		x = x > Math::PI ? x - Math::TWO_PI : x;
+
+		// Reflect into [-PI/2, PI/2], where the polynomial is accurate
+		const float halfPi = Math::PI * 0.5f;
+		x = x > halfPi ? Math::PI - x : x;
+		x = x < -halfPi ? -Math::PI - x : x;
+
+		const float x2 = x * x;
+		return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+	}
+
+	/** Approximates cosine for values in [-PI, PI) range. See fastSin(). */
+	static float fastCos(float x)
+	{
+		return fastSin(x + Math::PI * 0.5f);
+	}
+
+	/**
+	 * Replaces the normalized positions along the arc of a shape in 'values' with the positions determined by the emission
+	 * mode. Random mode keeps the random positions, Spread distributes the particles evenly over the arc, and Loop and
+	 * PingPong move along the arc with time, at 'Speed' passes over the arc per second. Particle 'i' is assumed to spawn
+	 * at 'i + 1' / 'count' of the way through the time interval. If the mode has an interval set, the positions are
+	 * snapped to its multiples.
+	 */
+	static void applyEmissionMode(const ParticleEmissionMode& mode, float startTime, float endTime, float* values,
+		u32 count)
+	{
+		const float timeStep = (endTime - startTime) / (float)count;
+
+		switch(mode.Type)
+		{
+		case ParticleEmissionModeType::Spread:
+			for(u32 i = 0; i < count; i++)
+				values[i] = (float)i / (float)count;
+			break;
+		case ParticleEmissionModeType::Loop:
+			for(u32 i = 0; i < count; i++)
+			{
+				const float position = (startTime + timeStep * (float)(i + 1)) * mode.Speed;
+				values[i] = position - std::floor(position);
+			}
+			break;
+		case ParticleEmissionModeType::PingPong:
+			for(u32 i = 0; i < count; i++)
+			{
+				// Position over a full cycle there and back is in [0, 2), mirror the second half
+				const float position = (startTime + timeStep * (float)(i + 1)) * mode.Speed * 0.5f;
+				const float cycle = (position - std::floor(position)) * 2.0f;
+				values[i] = cycle < 1.0f ? cycle : 2.0f - cycle;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if(mode.Interval > 0.0f)
+		{
+			const float invInterval = 1.0f / mode.Interval;
+			for(u32 i = 0; i < count; i++)
+				values[i] = std::min(std::floor(values[i] * invInterval) * mode.Interval, 1.0f);
+		}
+	}
+
+	void ParticleSpawnBatch::Resize(u32 count)
+	{
+		PositionX.resize(count);
+		PositionY.resize(count);
+		PositionZ.resize(count);
+		DirectionX.resize(count);
+		DirectionY.resize(count);
+		DirectionZ.resize(count);
+	}
+
+	EmitterShapeSampler::EmitterShapeSampler(u32 seed)
+		: mRandom(seed)
+	{}
+
+	void EmitterShapeSampler::GenerateRandom(u32 count, u32 numChannels)
+	{
+		for(u32 i = 0; i < numChannels; i++)
+		{
+			if(mRandomValues[i].size() < count)
+				mRandomValues[i].resize(count);
+
+			mRandom.FillUNorm(mRandomValues[i].data(), count);
+		}
+	}
+
+	void EmitterShapeSampler::SampleCone(const PARTICLE_CONE_SHAPE_DESC& desc, u32 count, ParticleSpawnBatch& output,
+		float startTime, float endTime)
+	{
+		output.Resize(count);
+		if(count == 0)
+			return;
+
+		GenerateRandom(count, 3);
+		applyEmissionMode(desc.Mode, startTime, endTime, mRandomValues[0].data(), count);
+
+		const float* randArc = mRandomValues[0].data();
+		const float* randRadius = mRandomValues[1].data();
+		const float* randLength = mRandomValues[2].data();
+
+		const float arc = desc.Arc.ValueRadians();
+		const float angle = desc.Angle.ValueRadians();
+		const float radius = desc.Radius;
+
+		// Sample the radius so the points are uniformly distributed over the area of the ring defined by the thickness
+		const float innerRadius = Math::Clamp01(1.0f - desc.Thickness);
+		const float innerRadiusSqrd = innerRadius * innerRadius;
+		const float length = desc.Type == ParticleEmitterConeType::Volume ? desc.Length : 0.0f;
+
+		float* posX = output.PositionX.data();
+		float* posY = output.PositionY.data();
+		float* posZ = output.PositionZ.data();
+		float* dirX = output.DirectionX.data();
+		float* dirY = output.DirectionY.data();
+		float* dirZ = output.DirectionZ.data();
+
+		for(u32 i = 0; i < count; i++)
+		{
+			// Shift by PI to keep the argument in range of the approximations, and negate to undo the shift
+			const float theta = randArc[i] * arc - Math::PI;
+			const float cosTheta = -fastCos(theta);
+			const float sinTheta = -fastSin(theta);
+
+			// Normalized distance from the cone axis, also determines how much the direction tilts away from the axis
+			const float distance = std::sqrt(innerRadiusSqrd + randRadius[i] * (1.0f - innerRadiusSqrd));
+
+			const float tilt = distance * angle;
+			const float sinTilt = fastSin(tilt);
+			const float cosTilt = fastCos(tilt);
+
+			dirX[i] = cosTheta * sinTilt;
+			dirY[i] = sinTheta * sinTilt;
+			dirZ[i] = cosTilt;
+
+			// Base position on the cone's base, optionally pushed along the travel direction for volume emission
+			const float offset = randLength[i] * length;
+			posX[i] = cosTheta * distance * radius + dirX[i] * offset;
+			posY[i] = sinTheta * distance * radius + dirY[i] * offset;
+			posZ[i] = dirZ[i] * offset;
+		}
+	}
+
+	void EmitterShapeSampler::SampleSphere(const PARTICLE_SPHERE_SHAPE_DESC& desc, u32 count, ParticleSpawnBatch& output)
+	{
+		output.Resize(count);
+		GenerateRandom(count, desc.Thickness > 0.0f ? 3 : 2);
+
+		const float* randZ = mRandomValues[0].data();
+		const float* randPhi = mRandomValues[1].data();
+
+		float* posX = output.PositionX.data();
+		float* posY = output.PositionY.data();
+		float* posZ = output.PositionZ.data();
+		float* dirX = output.DirectionX.data();
+		float* dirY = output.DirectionY.data();
+		float* dirZ = output.DirectionZ.data();
+
+		// Uniformly distributed points on the unit sphere (Archimedes' hat-box theorem)
+		for(u32 i = 0; i < count; i++)
+		{
+			const float z = 1.0f - 2.0f * randZ[i];
+			const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+			const float phi = randPhi[i] * Math::TWO_PI - Math::PI;
+
+			dirX[i] = r * fastCos(phi);
+			dirY[i] = r * fastSin(phi);
+			dirZ[i] = z;
+		}
+
+		if(desc.Thickness > 0.0f)
+		{
+			// Distribute uniformly through the volume of the shell defined by the thickness
+			const float* randRadius = mRandomValues[2].data();
+
+			const float innerRadius = Math::Clamp01(1.0f - desc.Thickness);
+			const float innerRadiusCubed = innerRadius * innerRadius * innerRadius;
+
+			for(u32 i = 0; i < count; i++)
+			{
+				const float distance = std::cbrt(innerRadiusCubed + randRadius[i] * (1.0f - innerRadiusCubed)) * desc.Radius;
+
+				posX[i] = dirX[i] * distance;
+				posY[i] = dirY[i] * distance;
+				posZ[i] = dirZ[i] * distance;
+			}
+		}
+		else
+		{
+			for(u32 i = 0; i < count; i++)
+			{
+				posX[i] = dirX[i] * desc.Radius;
+				posY[i] = dirY[i] * desc.Radius;
+				posZ[i] = dirZ[i] * desc.Radius;
+			}
+		}
+	}
+} // namespace bs
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Particles/BsParticleEmitter.h"
+#include "Math/BsVector3.h"
+#include "BsBatchedRandom.h"
+
+namespace bs
+{
+	/** Positions and travel directions of a batch of newly spawned particles, stored as a structure of arrays. */
+	struct ParticleSpawnBatch
+	{
+		/** Resizes all the arrays so they can hold 'count' particles. */
+		void Resize(u32 count);
+
+		/** Returns the number of particles in the batch. */
+		u32 GetCount() const { return (u32)PositionX.size(); }
+
+		/** Returns the position of the particle at the specified index. */
+		Vector3 GetPosition(u32 idx) const { return Vector3(PositionX[idx], PositionY[idx], PositionZ[idx]); }
+
+		/** Returns the normalized travel direction of the particle at the specified index. */
+		Vector3 GetDirection(u32 idx) const { return Vector3(DirectionX[idx], DirectionY[idx], DirectionZ[idx]); }
+
+		Vector<float> PositionX;
+		Vector<float> PositionY;
+		Vector<float> PositionZ;
+		Vector<float> DirectionX;
+		Vector<float> DirectionY;
+		Vector<float> DirectionZ;
+	};
+
+	/**
+	 * Generates spawn positions and directions for all particles emitted during a frame in a single batch. Random numbers
+	 * are generated in blocks by a counter-based generator, and every shape is sampled using branch-free loops over
+	 * structure-of-arrays data, which the compiler turns into SIMD code. This keeps the cost of large bursts low compared
+	 * to sampling the shape one particle at a time. All outputs are in the local space of the emitter, with the cone
+	 * pointing along the positive Z axis.
+	 */
+	class EmitterShapeSampler
+	{
+	public:
+		EmitterShapeSampler(u32 seed = 0);
+
+		/**
+		 * Samples 'count' particles from a cone shape described by 'desc', and writes them to 'output'. Where the
+		 * particles spawn along the arc of the cone is determined by the emission mode of the shape.
+		 *
+		 * @param	desc		Shape to sample.
+		 * @param	count		Number of particles to sample.
+		 * @param	output		Batch to write the particles to.
+		 * @param	startTime	Time of the emitter at the start of the interval the particles are spawned over, in
+		 *						seconds. Used by the Loop and PingPong emission modes, which move along the arc over time.
+		 * @param	endTime		Time of the emitter at the end of the interval the particles are spawned over, in seconds.
+		 *						The particles are spread evenly over the interval.
+		 */
+		void SampleCone(const PARTICLE_CONE_SHAPE_DESC& desc, u32 count, ParticleSpawnBatch& output,
+			float startTime = 0.0f, float endTime = 0.0f);
+
+		/** Samples 'count' particles from a sphere shape described by 'desc', and writes them to 'output'. */
+		void SampleSphere(const PARTICLE_SPHERE_SHAPE_DESC& desc, u32 count, ParticleSpawnBatch& output);
+
+		/** Returns the random number generator used for sampling. */
+		BatchedRandom& GetRandom() { return mRandom; }
+
+	private:
+		/** Ensures the scratch buffers can hold 'count' random values per channel, and fills 'numChannels' of them. */
+		void GenerateRandom(u32 count, u32 numChannels);
+
+		BatchedRandom mRandom;
+		Vector<float> mRandomValues[3];
+	};
+} // namespace bs
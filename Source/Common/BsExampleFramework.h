@@ -138,17 +138,10 @@ namespace bs
 		 */
 		static HMesh LoadMesh(ExampleMesh type, float scale = 1.0f)
 		{
-			// Map from the enum to the actual file path
-			static Path assetPaths[] = {
-				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol01.fbx",
-				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus.FBX",
-			};
-
-			const Path& srcAssetPath = assetPaths[(u32)type];
+			const Path& srcAssetPath = GetSourcePath(type);
 
 			// Attempt to load the previously processed asset
-			Path assetPath = srcAssetPath;
-			assetPath.SetExtension(srcAssetPath.GetExtension() + ".asset");
+			const Path assetPath = GetProcessedAssetPath(srcAssetPath);
 
 			HMesh model = gResources().Load<Mesh>(assetPath);
 			if(model == nullptr) // Mesh file doesn't exist, import from the source file.
@@ -190,39 +183,10 @@ namespace bs
 		 */
 		static HTexture LoadTexture(ExampleTexture type, bool isSRGB = true, bool isCubemap = false, bool isHDR = false, bool mips = true)
 		{
-			// Map from the enum to the actual file path
-			static Path assetPaths[] = {
-				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_DFS.png",
-				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_NM.png",
-				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_RGH.png",
-				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_MTL.png",
-				Path(EXAMPLE_DATA_PATH) + "Environments/PaperMill_E_3k.hdr",
-				Path(EXAMPLE_DATA_PATH) + "GUI/BansheeIcon.png",
-				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonNormal.png",
-				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonHover.png",
-				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonActive.png",
-				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_diff.jpg",
-				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_normal.jpg",
-				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_rough.jpg",
-				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_metal.jpg",
-				Path(EXAMPLE_DATA_PATH) + "Grid/GridPattern.png",
-				Path(EXAMPLE_DATA_PATH) + "Grid/GridPattern2.png",
-				Path(EXAMPLE_DATA_PATH) + "Environments/daytime.hdr",
-				Path(EXAMPLE_DATA_PATH) + "Environments/rathaus.hdr",
-				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_A.tga",
-				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_N.tga",
-				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_R.tga",
-				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_M.tga",
-				Path(EXAMPLE_DATA_PATH) + "Particles/Smoke.png",
-				Path(EXAMPLE_DATA_PATH) + "Decal/DecalAlbedo.png",
-				Path(EXAMPLE_DATA_PATH) + "Decal/DecalNormal.png",
-			};
-
-			const Path& srcAssetPath = assetPaths[(u32)type];
+			const Path& srcAssetPath = GetSourcePath(type);
 
 			// Attempt to load the previously processed asset
-			Path assetPath = srcAssetPath;
-			assetPath.SetExtension(srcAssetPath.GetExtension() + ".asset");
+			const Path assetPath = GetProcessedAssetPath(srcAssetPath);
 
 			HTexture texture = gResources().Load<Texture>(assetPath);
 			if(texture == nullptr) // Texture file doesn't exist, import from the source file.
@@ -271,6 +235,35 @@ namespace bs
 			return texture;
 		}
 
+		/**
+		 * Starts loading one of the builtin mesh assets on a worker thread and returns its handle immediately. Use
+		 * ResourceHandle::IsLoaded() to check when loading finishes. If the asset doesn't exist yet, the mesh is imported
+		 * synchronously as with LoadMesh().
+		 */
+		static HMesh LoadMeshAsync(ExampleMesh type, float scale = 1.0f)
+		{
+			const Path assetPath = GetProcessedAssetPath(GetSourcePath(type));
+			if(!FileSystem::Exists(assetPath))
+				return LoadMesh(type, scale);
+
+			return gResources().LoadAsync<Mesh>(assetPath);
+		}
+
+		/**
+		 * Starts loading one of the builtin texture assets on a worker thread and returns its handle immediately. Use
+		 * ResourceHandle::IsLoaded() to check when loading finishes. If the asset doesn't exist yet, the texture is
+		 * imported synchronously as with LoadTexture().
+		 */
+		static HTexture LoadTextureAsync(ExampleTexture type, bool isSRGB = true, bool isCubemap = false, bool isHDR = false,
+			bool mips = true)
+		{
+			const Path assetPath = GetProcessedAssetPath(GetSourcePath(type));
+			if(!FileSystem::Exists(assetPath))
+				return LoadTexture(type, isSRGB, isCubemap, isHDR, mips);
+
+			return gResources().LoadAsync<Texture>(assetPath);
+		}
+
 		/**
 		 * Loads one of the builtin shader assets. If the asset doesn't exist, the shader will be re-imported from the
 		 * source file, and then saved so it can be loaded on the next call to this method.
@@ -408,6 +401,61 @@ namespace bs
 		}
 
 	private:
+		/** Returns the path to the source file of a builtin mesh asset. */
+		static const Path& GetSourcePath(ExampleMesh type)
+		{
+			// Map from the enum to the actual file path
+			static Path assetPaths[] = {
+				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol01.fbx",
+				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus.FBX",
+			};
+
+			return assetPaths[(u32)type];
+		}
+
+		/** Returns the path to the source file of a builtin texture asset. */
+		static const Path& GetSourcePath(ExampleTexture type)
+		{
+			// Map from the enum to the actual file path
+			static Path assetPaths[] = {
+				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_DFS.png",
+				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_NM.png",
+				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_RGH.png",
+				Path(EXAMPLE_DATA_PATH) + "Pistol/Pistol_MTL.png",
+				Path(EXAMPLE_DATA_PATH) + "Environments/PaperMill_E_3k.hdr",
+				Path(EXAMPLE_DATA_PATH) + "GUI/BansheeIcon.png",
+				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonNormal.png",
+				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonHover.png",
+				Path(EXAMPLE_DATA_PATH) + "GUI/ExampleButtonActive.png",
+				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_diff.jpg",
+				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_normal.jpg",
+				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_rough.jpg",
+				Path(EXAMPLE_DATA_PATH) + "MechDrone/Drone_metal.jpg",
+				Path(EXAMPLE_DATA_PATH) + "Grid/GridPattern.png",
+				Path(EXAMPLE_DATA_PATH) + "Grid/GridPattern2.png",
+				Path(EXAMPLE_DATA_PATH) + "Environments/daytime.hdr",
+				Path(EXAMPLE_DATA_PATH) + "Environments/rathaus.hdr",
+				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_A.tga",
+				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_N.tga",
+				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_R.tga",
+				Path(EXAMPLE_DATA_PATH) + "Cerberus/Cerberus_M.tga",
+				Path(EXAMPLE_DATA_PATH) + "Particles/Smoke.png",
+				Path(EXAMPLE_DATA_PATH) + "Decal/DecalAlbedo.png",
+				Path(EXAMPLE_DATA_PATH) + "Decal/DecalNormal.png",
+			};
+
+			return assetPaths[(u32)type];
+		}
+
+		/** Returns the path at which the processed version of an asset imported from 'srcAssetPath' is saved. */
+		static Path GetProcessedAssetPath(const Path& srcAssetPath)
+		{
+			Path assetPath = srcAssetPath;
+			assetPath.SetExtension(srcAssetPath.GetExtension() + ".asset");
+
+			return assetPath;
+		}
+
 		static SPtr<ResourceManifest> manifest;
 	};
 
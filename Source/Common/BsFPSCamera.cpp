@@ -34,6 +34,12 @@ namespace bs
 		ApplyAngles();
 	}
 
+	void FPSCamera::SetCharacter(const HSceneObject& characterSO)
+	{
+		mCharacterSO = characterSO;
+		mWalker = characterSO ? characterSO->GetComponent<FPSWalker>() : HFPSWalker();
+	}
+
 	void FPSCamera::Update()
 	{
 		// If camera is rotating, apply new pitch/yaw rotation values depending on the amount of rotation from the
@@ -42,6 +48,31 @@ namespace bs
 		mPitch += Degree(gVirtualInput().GetAxisValue(mVerticalAxis) * ROTATION_SPEED);
 
 		ApplyAngles();
+		ApplyInterpolation();
+	}
+
+	void FPSCamera::ApplyInterpolation()
+	{
+		if(!mCharacterSO || !mWalker)
+			return;
+
+		// The character only moves during fixed updates, while the camera is rendered every frame. Instead of displaying
+		// the camera at the character's position from the last fixed step, display it at the position interpolated
+		// between the last two steps, so it moves smoothly regardless of the fixed update rate.
+		Vector3 offset = Vector3::ZERO;
+		if(mInterpolate)
+		{
+			const Transform& characterTfrm = mCharacterSO->GetTransform();
+			const Vector3 worldOffset = mWalker->GetInterpolatedPosition() - characterTfrm.GetPosition();
+
+			// Camera is parented to the character, so transform the offset into its local space
+			offset = characterTfrm.GetRotation().Inverse().Rotate(worldOffset);
+		}
+
+		const Vector3 localPosition = SO()->GetLocalTransform().GetPosition();
+		SO()->SetPosition(localPosition - mInterpolationOffset + offset);
+
+		mInterpolationOffset = offset;
 	}
 
 	void FPSCamera::ApplyAngles()
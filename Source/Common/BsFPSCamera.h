@@ -4,6 +4,7 @@
 #include "Scene/BsComponent.h"
 #include "Math/BsDegree.h"
 #include "Input/BsVirtualInput.h"
+#include "BsFPSWalker.h"
 
 namespace bs
 {
@@ -18,9 +19,17 @@ namespace bs
 
 		/**
 		 * Sets the character scene object to manipulate during rotations. When set, all yaw rotations will be applied to
-		 * the provided scene object, otherwise they will be applied to the current object.
+		 * the provided scene object, otherwise they will be applied to the current object. If the character is moved by
+		 * an FPSWalker component, the camera is displayed at the character position interpolated between fixed steps.
 		 */
-		void SetCharacter(const HSceneObject& characterSO) { mCharacterSO = characterSO; }
+		void SetCharacter(const HSceneObject& characterSO);
+
+		/**
+		 * Determines should the camera position be interpolated between the character positions of the last two fixed
+		 * steps. This removes judder when the frame rate and the fixed update rate differ, at the cost of the camera
+		 * lagging up to a single fixed step behind. Enabled by default.
+		 */
+		void SetInterpolation(bool enabled) { mInterpolate = enabled; }
 
 		/** Triggered once per frame. Allows the component to handle input and move. */
 		void Update();
@@ -29,7 +38,14 @@ namespace bs
 		/** Applies the current yaw and pitch angles, rotating the object. Also wraps and clamps the angles as necessary. */
 		void ApplyAngles();
 
+		/** Offsets the camera from its parent character, so it's displayed at the interpolated character position. */
+		void ApplyInterpolation();
+
 		HSceneObject mCharacterSO; /**< Optional parent object to manipulate. */
+		HFPSWalker mWalker; /**< Component moving the character, if any. */
+
+		bool mInterpolate = true; /**< Should the character position be interpolated between fixed steps. */
+		Vector3 mInterpolationOffset = Vector3::ZERO; /**< Offset currently applied to the local camera position. */
 
 		Degree mPitch = Degree(0.0f); /**< Current pitch rotation of the camera (looking up or down). */
 		Degree mYaw = Degree(0.0f); /**< Current yaw rotation of the camera (looking left or right). */
@@ -8,6 +8,8 @@
 #include "Physics/BsPhysics.h"
 #include "Scene/BsSceneManager.h"
 #include "Utility/BsTime.h"
+#include "BsPerfCounters.h"
+#include <cmath>
 
 namespace bs
 {
@@ -23,6 +25,27 @@ namespace bs
 	/** Multiplier applied to the speed when the fast move button is held. */
 	constexpr float FAST_MODE_MULTIPLIER = 2.0f;
 
+	void FixedStepAccumulator::BeginFrame(float frameDelta, float stepSize)
+	{
+		// The engine stopped stepping the last frame with less than a step left
+		Accumulated = std::min(Accumulated, std::nextafter(stepSize, 0.0f));
+		Accumulated += frameDelta;
+	}
+
+	void FixedStepAccumulator::Step(float stepSize)
+	{
+		// The engine only steps with at least a step accumulated
+		Accumulated = std::max(Accumulated - stepSize, 0.0f);
+	}
+
+	float FixedStepAccumulator::GetAlpha(float stepSize) const
+	{
+		if(stepSize <= 0.0f)
+			return 0.0f;
+
+		return Math::Clamp(Accumulated / stepSize, 0.0f, std::nextafter(1.0f, 0.0f));
+	}
+
 	FPSWalker::FPSWalker(const HSceneObject& parent)
 		: Component(parent)
 	{
@@ -42,6 +65,10 @@ namespace bs
 
 	void FPSWalker::FixedUpdate()
 	{
+		BS_PERF_SCOPE("FPSWalker: character movement");
+
+		BeginFrame();
+
 		// Check if any movement keys are being held
 		bool goingForward = gVirtualInput().IsButtonHeld(mMoveForward);
 		bool goingBack = gVirtualInput().IsButtonHeld(mMoveBack);
@@ -96,6 +123,38 @@ namespace bs
 
 		// Note: Gravity is acceleration, but since the walker doesn't support falling, just apply it as a velocity
 		Vector3 gravity = physicsScene->GetGravity();
+
+		mPreviousPosition = tfrm.GetPosition();
 		mController->Move((velocity + gravity) * frameDelta);
+		mCurrentPosition = SO()->GetTransform().GetPosition();
+
+		mAccumulator.Step(frameDelta);
+		mHasSimulated = true;
+	}
+
+	void FPSWalker::BeginFrame()
+	{
+		const u64 frameIdx = gTime().GetFrameIdx();
+		if(frameIdx == mLastFrameIdx)
+			return;
+
+		mAccumulator.BeginFrame(gTime().GetFrameDelta(), gTime().GetFixedFrameDelta());
+		mLastFrameIdx = frameIdx;
+	}
+
+	float FPSWalker::GetInterpolationAlpha()
+	{
+		// Frames without any fixed steps still add their time
+		BeginFrame();
+
+		return mAccumulator.GetAlpha(gTime().GetFixedFrameDelta());
+	}
+
+	Vector3 FPSWalker::GetInterpolatedPosition()
+	{
+		if(!mHasSimulated)
+			return SO()->GetTransform().GetPosition();
+
+		return Math::Lerp(GetInterpolationAlpha(), mPreviousPosition, mCurrentPosition);
 	}
 } // namespace bs
@@ -3,9 +3,40 @@
 #include "BsPrerequisites.h"
 #include "Scene/BsComponent.h"
 #include "Input/BsVirtualInput.h"
+#include "Math/BsVector3.h"
 
 namespace bs
 {
+	/**
+	 * Mirrors the engine's fixed-step accumulator, to determine how far a frame is between the last two fixed steps. The
+	 * engine adds the time of each frame to its accumulator, and runs fixed steps until less than a step is left. The
+	 * accumulator itself isn't exposed, so it is tracked here from the same frame and step times.
+	 *
+	 * The value of the engine's accumulator when tracking starts is unknown. After the fixed steps of a frame it must be
+	 * in [0, step), so whenever the tracked value falls outside of that range it is moved back to its closest edge. With
+	 * the usual variation of frame times this locks onto the engine's phase within a few percent of a step after a couple
+	 * of seconds, and the two never drift apart since they add up the same times.
+	 */
+	struct FixedStepAccumulator
+	{
+		/**
+		 * Adds the time elapsed since the last frame. Must be called once per frame, before any of the frame's fixed
+		 * steps, all of which happen after the previous frame ended.
+		 */
+		void BeginFrame(float frameDelta, float stepSize);
+
+		/** Consumes the time simulated by a single fixed step. */
+		void Step(float stepSize);
+
+		/**
+		 * Returns the time not yet simulated as a fraction of a fixed step, in range [0, 1). Only valid after all the fixed
+		 * steps of the current frame were executed.
+		 */
+		float GetAlpha(float stepSize) const;
+
+		float Accumulated = 0.0f; /**< Time not yet simulated by the fixed steps, in seconds. */
+	};
+
 	/**
 	 * Component that controls movement through a character controller, used for first-person movement. The
 	 * CharacterController component must be attached to the same SceneObject this component is on.
@@ -18,9 +49,32 @@ namespace bs
 		/** Triggered once per frame. Allows the component to handle input and move. */
 		void FixedUpdate();
 
+		/**
+		 * Returns the factor in range [0, 1) used for interpolating between the positions of the previous and the current
+		 * fixed step, for the current frame. Movement happens in fixed steps which don't align with the frames, so this
+		 * represents how far the frame is between two steps. Must be called after the fixed updates of the frame.
+		 */
+		float GetInterpolationAlpha();
+
+		/**
+		 * Returns the character position interpolated between the last two fixed steps. Objects rendered as part of the
+		 * character (e.g. the camera) should be displayed at this position, to avoid judder when the frame rate doesn't
+		 * match the fixed update rate. Note this lags behind the simulated position by up to a single fixed step.
+		 */
+		Vector3 GetInterpolatedPosition();
+
 	private:
+		/** Adds the time of the current frame to the accumulator, if this is the first call during the frame. */
+		void BeginFrame();
+
 		HCharacterController mController;
 
+		Vector3 mPreviousPosition = Vector3::ZERO; /**< Character position before the last fixed step. */
+		Vector3 mCurrentPosition = Vector3::ZERO; /**< Character position after the last fixed step. */
+		FixedStepAccumulator mAccumulator;
+		u64 mLastFrameIdx = (u64)-1; /**< Frame whose time was last added to the accumulator. */
+		bool mHasSimulated = false; /**< True if at least one fixed step was executed. */
+
 		float mCurrentSpeed = 0.0f; /**< Current speed of the camera. */
 
 		VirtualButton mMoveForward; /**< Key binding for moving the camera forward. */
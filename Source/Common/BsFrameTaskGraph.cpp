@@ -0,0 +1,290 @@
+#include "BsFrameTaskGraph.h"
+#include "FileSystem/BsFileSystem.h"
+#include "FileSystem/BsDataStream.h"
+#include "Threading/BsTaskScheduler.h"
+
+namespace bs
+{
+	/** Source of the indices identifying threads in the trace. */
+	static std::atomic<u32> sNextThreadIdx{ 0 };
+
+	/** Returns an index identifying the calling thread in the trace, assigned the first time a thread runs a task. */
+	static u32 getThreadIdx()
+	{
+		static thread_local u32 threadIdx = sNextThreadIdx++;
+		return threadIdx;
+	}
+
+	/** Escapes characters that are not allowed to appear inside a JSON or DOT string. */
+	static String escapeString(const String& input)
+	{
+		String output;
+		output.reserve(input.size());
+
+		for(char ch : input)
+		{
+			if(ch == '"' || ch == '\\')
+				output += '\\';
+
+			output += ch;
+		}
+
+		return output;
+	}
+
+	FrameTaskGraph::FrameTaskGraph()
+		: mStartTime(std::chrono::steady_clock::now())
+	{}
+
+	FrameTaskGraph::TaskId FrameTaskGraph::AddTask(const String& name, std::function<void()> work,
+		const Vector<TaskId>& dependencies)
+	{
+		const TaskId taskId = (TaskId)mTasks.size();
+
+		mTasks.push_back(UPtr<TaskNode>(new TaskNode()));
+		mTasks.back()->Name = name;
+		mTasks.back()->Work = std::move(work);
+
+		for(auto& dependency : dependencies)
+			AddDependency(taskId, dependency);
+
+		mIsValidated = false;
+		return taskId;
+	}
+
+	void FrameTaskGraph::AddDependency(TaskId task, TaskId dependency)
+	{
+		BS_ASSERT(task < (TaskId)mTasks.size() && dependency < (TaskId)mTasks.size());
+
+		mTasks[task]->Dependencies.push_back(dependency);
+		mTasks[dependency]->Dependents.push_back(task);
+
+		mIsValidated = false;
+	}
+
+	void FrameTaskGraph::Clear()
+	{
+		mTasks.clear();
+		mRootTasks.clear();
+		ClearTrace();
+
+		mIsValidated = false;
+	}
+
+	bool FrameTaskGraph::Execute()
+	{
+		if(!Validate())
+			return false;
+
+		if(mTasks.empty())
+			return true;
+
+		for(auto& task : mTasks)
+			task->NumRemainingDependencies = (u32)task->Dependencies.size();
+
+		mNumRemainingTasks = (u32)mTasks.size();
+
+		for(auto& taskId : mRootTasks)
+			SubmitTask(taskId);
+
+		{
+			Lock lock(mCompleteMutex);
+			mCompleteSignal.wait(lock, [this]() { return mNumRemainingTasks == 0; });
+		}
+
+		if(mTraceEnabled && mNumTracedFrames < mMaxTraceFrames)
+		{
+			for(u32 i = 0; i < (u32)mTasks.size(); i++)
+			{
+				const TaskNode& task = *mTasks[i];
+				mTraceEvents.push_back({ i, mNumTracedFrames, task.ThreadIdx, task.StartTime, task.EndTime });
+			}
+
+			mNumTracedFrames++;
+		}
+
+		return true;
+	}
+
+	void FrameTaskGraph::SetTraceEnabled(bool enabled, u32 maxFrames)
+	{
+		mTraceEnabled = enabled;
+		mMaxTraceFrames = maxFrames;
+	}
+
+	void FrameTaskGraph::ClearTrace()
+	{
+		mTraceEvents.clear();
+		mNumTracedFrames = 0;
+	}
+
+	String FrameTaskGraph::GetTraceJSON() const
+	{
+		StringStream output;
+		output << "{\"traceEvents\":[\n";
+
+		// Name the threads that executed tasks, so the trace viewer shows a row per thread
+		u32 numThreads = 0;
+		for(auto& event : mTraceEvents)
+			numThreads = std::max(numThreads, event.ThreadIdx + 1);
+
+		for(u32 i = 0; i < numThreads; i++)
+		{
+			if(i > 0)
+				output << ",\n";
+
+			output << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << i
+				<< ",\"args\":{\"name\":\"Thread " << i << "\"}}";
+		}
+
+		u32 flowId = 0;
+		u32 frameStartIdx = 0;
+		for(u32 i = 0; i < (u32)mTraceEvents.size(); i++)
+		{
+			const TraceEvent& event = mTraceEvents[i];
+			if(i == 0 || event.Frame != mTraceEvents[i - 1].Frame)
+				frameStartIdx = i;
+
+			const TaskNode& task = *mTasks[event.Task];
+			output << ",\n{\"name\":\"" << escapeString(task.Name) << "\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":0"
+				<< ",\"tid\":" << event.ThreadIdx << ",\"ts\":" << event.StartTime
+				<< ",\"dur\":" << (event.EndTime - event.StartTime) << ",\"args\":{\"frame\":" << event.Frame << "}}";
+
+			// Draw an arrow from the end of each dependency to the start of this task. Events of a single frame are
+			// recorded in task order, so the dependency event can be found directly.
+			for(auto& dependency : task.Dependencies)
+			{
+				const u32 dependencyEventIdx = frameStartIdx + dependency;
+				if(dependencyEventIdx >= (u32)mTraceEvents.size())
+					continue;
+
+				const TraceEvent& dependencyEvent = mTraceEvents[dependencyEventIdx];
+				if(dependencyEvent.Frame != event.Frame || dependencyEvent.Task != dependency)
+					continue;
+
+				output << ",\n{\"name\":\"dependency\",\"cat\":\"dependency\",\"ph\":\"s\",\"pid\":0"
+					<< ",\"tid\":" << dependencyEvent.ThreadIdx << ",\"ts\":" << dependencyEvent.EndTime
+					<< ",\"id\":" << flowId << "}";
+				output << ",\n{\"name\":\"dependency\",\"cat\":\"dependency\",\"ph\":\"f\",\"bp\":\"e\",\"pid\":0"
+					<< ",\"tid\":" << event.ThreadIdx << ",\"ts\":" << event.StartTime
+					<< ",\"id\":" << flowId << "}";
+
+				flowId++;
+			}
+		}
+
+		output << "\n]}\n";
+		return output.str();
+	}
+
+	void FrameTaskGraph::SaveTrace(const Path& path) const
+	{
+		SPtr<DataStream> stream = FileSystem::CreateAndOpenFile(path);
+		if(stream == nullptr)
+		{
+			BS_LOG(Error, Uncategorized, "Unable to save the frame task trace to: " + path.ToString());
+			return;
+		}
+
+		stream->WriteString(GetTraceJSON());
+		stream->Close();
+	}
+
+	String FrameTaskGraph::GetDOTGraph() const
+	{
+		StringStream output;
+		output << "digraph FrameTaskGraph {\n";
+		output << "\tnode [shape=box];\n";
+
+		for(u32 i = 0; i < (u32)mTasks.size(); i++)
+			output << "\tt" << i << " [label=\"" << escapeString(mTasks[i]->Name) << "\"];\n";
+
+		for(u32 i = 0; i < (u32)mTasks.size(); i++)
+		{
+			for(auto& dependent : mTasks[i]->Dependents)
+				output << "\tt" << i << " -> t" << dependent << ";\n";
+		}
+
+		output << "}\n";
+		return output.str();
+	}
+
+	void FrameTaskGraph::SubmitTask(TaskId taskId)
+	{
+		TaskScheduler::Instance().AddTask(Task::Create(mTasks[taskId]->Name, [this, taskId]() { RunTask(taskId); }));
+	}
+
+	void FrameTaskGraph::RunTask(TaskId taskId)
+	{
+		TaskNode& task = *mTasks[taskId];
+
+		task.ThreadIdx = getThreadIdx();
+		task.StartTime = GetTime();
+
+		if(task.Work)
+			task.Work();
+
+		task.EndTime = GetTime();
+
+		for(auto& dependentId : task.Dependents)
+		{
+			// Last dependency to finish starts the dependent
+			if(--mTasks[dependentId]->NumRemainingDependencies == 0)
+				SubmitTask(dependentId);
+		}
+
+		// Notified under the lock, so Execute() can't return (and the graph can't be destroyed) before this is done
+		Lock lock(mCompleteMutex);
+		if(--mNumRemainingTasks == 0)
+			mCompleteSignal.notify_all();
+	}
+
+	bool FrameTaskGraph::Validate()
+	{
+		if(mIsValidated)
+			return mIsValid;
+
+		mRootTasks.clear();
+
+		// Kahn's algorithm, if not every task can be visited the graph has a cycle
+		Vector<u32> numRemainingDependencies(mTasks.size());
+		Vector<TaskId> openList;
+		for(u32 i = 0; i < (u32)mTasks.size(); i++)
+		{
+			numRemainingDependencies[i] = (u32)mTasks[i]->Dependencies.size();
+			if(numRemainingDependencies[i] == 0)
+			{
+				mRootTasks.push_back(i);
+				openList.push_back(i);
+			}
+		}
+
+		u32 numVisited = 0;
+		while(!openList.empty())
+		{
+			const TaskId taskId = openList.back();
+			openList.pop_back();
+			numVisited++;
+
+			for(auto& dependent : mTasks[taskId]->Dependents)
+			{
+				if(--numRemainingDependencies[dependent] == 0)
+					openList.push_back(dependent);
+			}
+		}
+
+		mIsValid = numVisited == (u32)mTasks.size();
+		mIsValidated = true;
+
+		if(!mIsValid)
+			BS_LOG(Error, Uncategorized, "Frame task graph contains a dependency cycle and cannot be executed.");
+
+		return mIsValid;
+	}
+
+	u64 FrameTaskGraph::GetTime() const
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - mStartTime;
+		return (u64)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	}
+} // namespace bs
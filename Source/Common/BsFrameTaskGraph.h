@@ -0,0 +1,118 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	/**
+	 * Graph of tasks executed once per frame. Each task declares the tasks it depends on, and is started as soon as all of
+	 * them have finished. Tasks without a path between them (e.g. animation, particle and audio updates) run concurrently
+	 * as tasks of the engine's TaskScheduler, while dependent ones (e.g. render submission after all simulation stages)
+	 * keep their order.
+	 *
+	 * The graph is built once and then executed every frame. Optionally the execution can be recorded into a trace in the
+	 * Chrome tracing format (open in chrome://tracing or Perfetto), with dependencies shown as flow arrows between tasks.
+	 * The graph structure itself can be exported in the DOT format.
+	 */
+	class FrameTaskGraph
+	{
+	public:
+		using TaskId = u32;
+
+		FrameTaskGraph();
+
+		/**
+		 * Registers a new task.
+		 *
+		 * @param	name			Name used for identifying the task in the trace and graph output.
+		 * @param	work			Function to execute every frame.
+		 * @param	dependencies	Tasks that must finish before this task can start. All must have been added before.
+		 * @return					Identifier that can be used for referencing the task as a dependency.
+		 */
+		TaskId AddTask(const String& name, std::function<void()> work, const Vector<TaskId>& dependencies = {});
+
+		/** Makes the task 'task' wait for the task 'dependency' to finish before starting. */
+		void AddDependency(TaskId task, TaskId dependency);
+
+		/** Removes all tasks from the graph. */
+		void Clear();
+
+		/**
+		 * Executes all tasks in the graph and blocks until they finish. Returns false if the graph contains a dependency
+		 * cycle, in which case nothing is executed.
+		 */
+		bool Execute();
+
+		/** Returns the number of tasks in the graph. */
+		u32 GetNumTasks() const { return (u32)mTasks.size(); }
+
+		/**
+		 * Enables or disables recording of task timings. When enabled, every call to Execute() appends its timings to the
+		 * trace, until 'maxFrames' frames are recorded.
+		 */
+		void SetTraceEnabled(bool enabled, u32 maxFrames = 300);
+
+		/** Discards all recorded trace events. */
+		void ClearTrace();
+
+		/** Returns the recorded trace in the Chrome tracing (JSON) format. */
+		String GetTraceJSON() const;
+
+		/** Saves the recorded trace in the Chrome tracing (JSON) format to the provided file. */
+		void SaveTrace(const Path& path) const;
+
+		/** Returns the structure of the graph in the DOT format, for visualization with Graphviz. */
+		String GetDOTGraph() const;
+
+	private:
+		/** Information about a single task in the graph. */
+		struct TaskNode
+		{
+			String Name;
+			std::function<void()> Work;
+			Vector<TaskId> Dependencies;
+			Vector<TaskId> Dependents;
+			std::atomic<u32> NumRemainingDependencies{ 0 };
+
+			u32 ThreadIdx = 0; /**< Thread the task executed on during the last frame. */
+			u64 StartTime = 0; /**< Time the task started during the last frame, in microseconds since graph creation. */
+			u64 EndTime = 0; /**< Time the task ended during the last frame, in microseconds since graph creation. */
+		};
+
+		/** Execution of a single task, as recorded in the trace. */
+		struct TraceEvent
+		{
+			TaskId Task;
+			u32 Frame;
+			u32 ThreadIdx;
+			u64 StartTime;
+			u64 EndTime;
+		};
+
+		/** Queues the task for execution on the task scheduler. */
+		void SubmitTask(TaskId taskId);
+
+		/** Runs the task and starts any dependents whose dependencies are now all finished. */
+		void RunTask(TaskId taskId);
+
+		/** Checks that the graph has no dependency cycles. */
+		bool Validate();
+
+		/** Returns the number of microseconds elapsed since the graph was created. */
+		u64 GetTime() const;
+
+		Vector<UPtr<TaskNode>> mTasks;
+		Vector<TaskId> mRootTasks;
+		u32 mNumRemainingTasks = 0;
+		Mutex mCompleteMutex;
+		Signal mCompleteSignal; /**< Notified under mCompleteMutex once all tasks of a frame are done. */
+		bool mIsValidated = false;
+		bool mIsValid = false;
+
+		std::chrono::steady_clock::time_point mStartTime;
+		bool mTraceEnabled = false;
+		u32 mMaxTraceFrames = 0;
+		u32 mNumTracedFrames = 0;
+		Vector<TraceEvent> mTraceEvents;
+	};
+} // namespace bs
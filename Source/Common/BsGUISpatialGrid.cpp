@@ -0,0 +1,223 @@
+#include "BsGUISpatialGrid.h"
+#include <algorithm>
+
+namespace bs
+{
+	/** Divides and rounds towards negative infinity, so negative coordinates map to the correct cells. */
+	static i32 floorDiv(i32 value, i32 divisor)
+	{
+		i32 output = value / divisor;
+		if((value % divisor != 0) && (value < 0))
+			output--;
+
+		return output;
+	}
+
+	GUISpatialGrid::GUISpatialGrid(u32 cellSize)
+		: mCellSize((i32)std::max(cellSize, 1U))
+	{}
+
+	void GUISpatialGrid::Insert(const GUIElement* element, const Rect2I& bounds, u32 depth)
+	{
+		u32 entryIdx;
+		if(!mFreeEntries.empty())
+		{
+			entryIdx = mFreeEntries.back();
+			mFreeEntries.pop_back();
+		}
+		else
+		{
+			entryIdx = (u32)mEntries.size();
+			mEntries.push_back(Entry());
+		}
+
+		Entry& entry = mEntries[entryIdx];
+		entry.Element = element;
+		entry.Bounds = bounds;
+		entry.Depth = depth;
+		entry.Order = mNextOrder++;
+
+		mElementLookup[element] = entryIdx;
+		AddToCells(entryIdx);
+	}
+
+	void GUISpatialGrid::Update(const GUIElement* element, const Rect2I& bounds, u32 depth)
+	{
+		auto iterFind = mElementLookup.find(element);
+		if(iterFind == mElementLookup.end())
+		{
+			Insert(element, bounds, depth);
+			return;
+		}
+
+		const u32 entryIdx = iterFind->second;
+		Entry& entry = mEntries[entryIdx];
+		entry.Depth = depth;
+
+		if(entry.Bounds == bounds)
+			return;
+
+		// Only touch the grid if the element moved to a different set of cells
+		const CellRange oldRange = GetCellRange(entry.Bounds);
+		const CellRange newRange = GetCellRange(bounds);
+		if(oldRange.MinX == newRange.MinX && oldRange.MinY == newRange.MinY &&
+			oldRange.MaxX == newRange.MaxX && oldRange.MaxY == newRange.MaxY)
+		{
+			entry.Bounds = bounds;
+			return;
+		}
+
+		RemoveFromCells(entryIdx);
+		entry.Bounds = bounds;
+		AddToCells(entryIdx);
+	}
+
+	void GUISpatialGrid::Remove(const GUIElement* element)
+	{
+		auto iterFind = mElementLookup.find(element);
+		if(iterFind == mElementLookup.end())
+			return;
+
+		const u32 entryIdx = iterFind->second;
+		RemoveFromCells(entryIdx);
+
+		mEntries[entryIdx] = Entry();
+		mFreeEntries.push_back(entryIdx);
+		mElementLookup.erase(iterFind);
+	}
+
+	void GUISpatialGrid::Clear()
+	{
+		mEntries.clear();
+		mFreeEntries.clear();
+		mElementLookup.clear();
+		mCells.clear();
+		mOversized.clear();
+	}
+
+	const GUIElement* GUISpatialGrid::FindTopmost(const Vector2I& position) const
+	{
+		const Entry* topmost = nullptr;
+		auto testEntries = [&](const Vector<u32>& entries)
+		{
+			for(auto& entryIdx : entries)
+			{
+				const Entry& entry = mEntries[entryIdx];
+				if(!entry.Bounds.Contains(position))
+					continue;
+
+				if(topmost == nullptr || IsInFront(entry, *topmost))
+					topmost = &entry;
+			}
+		};
+
+		auto iterFind = mCells.find(GetCellKey(floorDiv(position.X, mCellSize), floorDiv(position.Y, mCellSize)));
+		if(iterFind != mCells.end())
+			testEntries(iterFind->second);
+
+		testEntries(mOversized);
+
+		return topmost != nullptr ? topmost->Element : nullptr;
+	}
+
+	void GUISpatialGrid::FindAll(const Vector2I& position, Vector<const GUIElement*>& output) const
+	{
+		Vector<const Entry*> found;
+		auto testEntries = [&](const Vector<u32>& entries)
+		{
+			for(auto& entryIdx : entries)
+			{
+				const Entry& entry = mEntries[entryIdx];
+				if(entry.Bounds.Contains(position))
+					found.push_back(&entry);
+			}
+		};
+
+		auto iterFind = mCells.find(GetCellKey(floorDiv(position.X, mCellSize), floorDiv(position.Y, mCellSize)));
+		if(iterFind != mCells.end())
+			testEntries(iterFind->second);
+
+		testEntries(mOversized);
+
+		std::sort(found.begin(), found.end(), [this](const Entry* a, const Entry* b) { return IsInFront(*a, *b); });
+
+		for(auto& entry : found)
+			output.push_back(entry->Element);
+	}
+
+	GUISpatialGrid::CellRange GUISpatialGrid::GetCellRange(const Rect2I& bounds) const
+	{
+		CellRange range;
+		range.MinX = floorDiv(bounds.X, mCellSize);
+		range.MinY = floorDiv(bounds.Y, mCellSize);
+
+		// Empty bounds can never contain a point, so they don't cover any cells (the range ends before it starts)
+		if(bounds.Width == 0 || bounds.Height == 0)
+		{
+			range.MaxX = range.MinX - 1;
+			range.MaxY = range.MinY - 1;
+			return range;
+		}
+
+		range.MaxX = floorDiv(bounds.X + (i32)bounds.Width - 1, mCellSize);
+		range.MaxY = floorDiv(bounds.Y + (i32)bounds.Height - 1, mCellSize);
+		return range;
+	}
+
+	void GUISpatialGrid::AddToCells(u32 entryIdx)
+	{
+		Entry& entry = mEntries[entryIdx];
+		const CellRange range = GetCellRange(entry.Bounds);
+
+		const u64 numCells = (u64)std::max(range.MaxX - range.MinX + 1, 0) * (u64)std::max(range.MaxY - range.MinY + 1, 0);
+		entry.Oversized = numCells > MAX_CELLS_PER_ELEMENT;
+
+		if(entry.Oversized)
+		{
+			mOversized.push_back(entryIdx);
+			return;
+		}
+
+		for(i32 y = range.MinY; y <= range.MaxY; y++)
+		{
+			for(i32 x = range.MinX; x <= range.MaxX; x++)
+				mCells[GetCellKey(x, y)].push_back(entryIdx);
+		}
+	}
+
+	void GUISpatialGrid::RemoveFromCells(u32 entryIdx)
+	{
+		// Order within the lists doesn't matter, since the entries themselves are sorted by depth and insertion order
+		auto removeFromList = [entryIdx](Vector<u32>& entries)
+		{
+			auto iterFind = std::find(entries.begin(), entries.end(), entryIdx);
+			if(iterFind == entries.end())
+				return;
+
+			*iterFind = entries.back();
+			entries.pop_back();
+		};
+
+		const Entry& entry = mEntries[entryIdx];
+		if(entry.Oversized)
+		{
+			removeFromList(mOversized);
+			return;
+		}
+
+		const CellRange range = GetCellRange(entry.Bounds);
+		for(i32 y = range.MinY; y <= range.MaxY; y++)
+		{
+			for(i32 x = range.MinX; x <= range.MaxX; x++)
+			{
+				auto iterFind = mCells.find(GetCellKey(x, y));
+				if(iterFind == mCells.end())
+					continue;
+
+				removeFromList(iterFind->second);
+				if(iterFind->second.empty())
+					mCells.erase(iterFind);
+			}
+		}
+	}
+} // namespace bs
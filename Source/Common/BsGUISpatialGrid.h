@@ -0,0 +1,110 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsRect2I.h"
+#include "Math/BsVector2I.h"
+
+namespace bs
+{
+	/**
+	 * Spatial index over the bounds of GUI elements, used for finding the elements under the pointer without testing
+	 * every element. Space is split into a uniform grid of square cells, and each element is registered in all the cells
+	 * its bounds overlap. A point query only needs to test the elements registered in the single cell containing the
+	 * point, making hit-testing independent of the total number of elements, as long as they are reasonably spread out.
+	 *
+	 * Only cells containing elements use memory, so the indexed area is unbounded. Elements covering a large number of
+	 * cells (e.g. background panels) are kept in a separate list tested by every query instead, so they don't bloat the
+	 * grid.
+	 *
+	 * The index doesn't observe the elements. Bounds should be updated through Update() whenever layout changes them,
+	 * and should be the visible bounds of the element, after clipping by its parents.
+	 *
+	 * The engine's GUIManager does its own hit-testing internally and doesn't use this index, so it only speeds up hit
+	 * tests performed by the application itself (e.g. custom drag and drop targets, or tooltips over drawn content).
+	 */
+	class GUISpatialGrid
+	{
+	public:
+		/** @param	cellSize	Width and height of a single grid cell, in pixels. */
+		GUISpatialGrid(u32 cellSize = DEFAULT_CELL_SIZE);
+
+		/**
+		 * Adds an element to the index.
+		 *
+		 * @param	element		Element to add. Must not already be in the index.
+		 * @param	bounds		Visible bounds of the element, in pixels.
+		 * @param	depth		Depth of the element. Elements with lower depth are in front of elements with higher depth.
+		 *						Elements of equal depth added later are in front of elements added earlier.
+		 */
+		void Insert(const GUIElement* element, const Rect2I& bounds, u32 depth);
+
+		/** Updates the bounds and depth of an element in the index. Cheap if they didn't change. */
+		void Update(const GUIElement* element, const Rect2I& bounds, u32 depth);
+
+		/** Removes an element from the index. Does nothing if the element isn't in the index. */
+		void Remove(const GUIElement* element);
+
+		/** Removes all elements from the index. */
+		void Clear();
+
+		/** Returns the front-most element whose bounds contain the point, or null if there is none. */
+		const GUIElement* FindTopmost(const Vector2I& position) const;
+
+		/** Appends all elements whose bounds contain the point to 'output', ordered front to back. */
+		void FindAll(const Vector2I& position, Vector<const GUIElement*>& output) const;
+
+		/** Returns the number of elements in the index. */
+		u32 GetNumElements() const { return (u32)mElementLookup.size(); }
+
+		static constexpr u32 DEFAULT_CELL_SIZE = 64;
+
+		/** Elements covering more cells than this are not registered in the grid, and are tested by every query. */
+		static constexpr u32 MAX_CELLS_PER_ELEMENT = 256;
+
+	private:
+		/** Information about a single element in the index. */
+		struct Entry
+		{
+			const GUIElement* Element = nullptr;
+			Rect2I Bounds;
+			u32 Depth = 0;
+			u64 Order = 0; /**< Insertion order, used for sorting elements of the same depth. */
+			bool Oversized = false; /**< True if the entry is in the oversized list, rather than in the grid cells. */
+		};
+
+		/** Range of grid cells covered by some bounds, inclusive. */
+		struct CellRange
+		{
+			i32 MinX, MinY;
+			i32 MaxX, MaxY;
+		};
+
+		/** Returns the range of cells overlapped by the bounds. */
+		CellRange GetCellRange(const Rect2I& bounds) const;
+
+		/** Returns the key of the cell at the provided grid coordinates. */
+		static u64 GetCellKey(i32 x, i32 y) { return ((u64)(u32)x << 32) | (u32)y; }
+
+		/** Registers the entry in the cells it overlaps, or in the oversized list. */
+		void AddToCells(u32 entryIdx);
+
+		/** Unregisters the entry from the cells it overlaps, or from the oversized list. */
+		void RemoveFromCells(u32 entryIdx);
+
+		/** Checks if entry 'a' is in front of entry 'b'. */
+		bool IsInFront(const Entry& a, const Entry& b) const
+		{
+			return a.Depth < b.Depth || (a.Depth == b.Depth && a.Order > b.Order);
+		}
+
+		i32 mCellSize;
+		u64 mNextOrder = 0;
+
+		Vector<Entry> mEntries;
+		Vector<u32> mFreeEntries;
+		UnorderedMap<const GUIElement*, u32> mElementLookup;
+
+		UnorderedMap<u64, Vector<u32>> mCells;
+		Vector<u32> mOversized;
+	};
+} // namespace bs
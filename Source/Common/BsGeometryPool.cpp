@@ -0,0 +1,274 @@
+#include "BsGeometryPool.h"
+#include "RenderAPI/BsRenderAPI.h"
+#include "RenderAPI/BsVertexBuffer.h"
+#include "RenderAPI/BsVertexDataDesc.h"
+#include "RenderAPI/BsVertexDeclaration.h"
+#include <algorithm>
+
+namespace bs
+{
+	namespace ct
+	{
+		GeometryPool::RangeAllocator::RangeAllocator(u32 capacity)
+		{
+			if(capacity > 0)
+				mFreeRanges.push_back({ 0, capacity });
+		}
+
+		bool GeometryPool::RangeAllocator::Allocate(u32 count, u32& offset)
+		{
+			for(auto iter = mFreeRanges.begin(); iter != mFreeRanges.end(); ++iter)
+			{
+				if(iter->Count < count)
+					continue;
+
+				offset = iter->Offset;
+				iter->Offset += count;
+				iter->Count -= count;
+
+				if(iter->Count == 0)
+					mFreeRanges.erase(iter);
+
+				return true;
+			}
+
+			return false;
+		}
+
+		void GeometryPool::RangeAllocator::Free(u32 offset, u32 count)
+		{
+			auto iter = std::lower_bound(mFreeRanges.begin(), mFreeRanges.end(), offset,
+				[](const Range& range, u32 value) { return range.Offset < value; });
+
+			iter = mFreeRanges.insert(iter, { offset, count });
+
+			// Merge with the following range
+			auto next = iter + 1;
+			if(next != mFreeRanges.end() && iter->Offset + iter->Count == next->Offset)
+			{
+				iter->Count += next->Count;
+				mFreeRanges.erase(next);
+			}
+
+			// Merge with the preceding range
+			if(iter != mFreeRanges.begin())
+			{
+				auto prev = iter - 1;
+				if(prev->Offset + prev->Count == iter->Offset)
+				{
+					prev->Count += iter->Count;
+					mFreeRanges.erase(iter);
+				}
+			}
+		}
+
+		GeometryPool::GeometryPool(const SPtr<VertexDataDesc>& vertexDesc, u32 verticesPerPage, u32 indicesPerPage)
+			: mVertexDesc(vertexDesc), mVertexStride(vertexDesc->GetVertexStride()), mVerticesPerPage(verticesPerPage)
+			, mIndicesPerPage(indicesPerPage)
+		{
+			mVertexDecl = VertexDeclaration::Create(vertexDesc);
+		}
+
+		GeometryAllocation GeometryPool::Allocate(const u8* vertices, u32 numVertices, const u32* indices, u32 numIndices)
+		{
+			GeometryAllocation allocation;
+			if(numVertices == 0 || numIndices == 0)
+				return allocation;
+
+			// Indices are relative to the first vertex of the mesh, so the index type only depends on the mesh itself
+			u32 maxIndex = 0;
+			for(u32 i = 0; i < numIndices; i++)
+				maxIndex = std::max(maxIndex, indices[i]);
+
+			allocation.IndexFormat = maxIndex <= 0xFFFF ? IT_16BIT : IT_32BIT;
+			allocation.NumVertices = numVertices;
+			allocation.NumIndices = numIndices;
+
+			// Find the first page with room for both the vertices and the indices
+			for(u32 i = 0; i < (u32)mPages.size(); i++)
+			{
+				Page& page = mPages[i];
+				RangeAllocator& indexRanges = allocation.IndexFormat == IT_16BIT ? page.IndexRanges16 : page.IndexRanges32;
+
+				if(!page.VertexRanges.Allocate(numVertices, allocation.VertexOffset))
+					continue;
+
+				if(!indexRanges.Allocate(numIndices, allocation.IndexOffset))
+				{
+					page.VertexRanges.Free(allocation.VertexOffset, numVertices);
+					continue;
+				}
+
+				allocation.PageIdx = i;
+				break;
+			}
+
+			if(!allocation.IsValid())
+			{
+				allocation.PageIdx = CreatePage(numVertices, numIndices);
+
+				Page& page = mPages[allocation.PageIdx];
+				RangeAllocator& indexRanges = allocation.IndexFormat == IT_16BIT ? page.IndexRanges16 : page.IndexRanges32;
+
+				page.VertexRanges.Allocate(numVertices, allocation.VertexOffset);
+				indexRanges.Allocate(numIndices, allocation.IndexOffset);
+			}
+
+			Page& page = mPages[allocation.PageIdx];
+			page.Vertices->WriteData(allocation.VertexOffset * mVertexStride, numVertices * mVertexStride, vertices);
+
+			SPtr<IndexBuffer>& indexBuffer = allocation.IndexFormat == IT_16BIT ? page.Indices16 : page.Indices32;
+			if(!indexBuffer)
+			{
+				INDEX_BUFFER_DESC ibDesc;
+				ibDesc.IndexType = allocation.IndexFormat;
+				ibDesc.NumIndices = page.IndexCapacity;
+				ibDesc.Usage = GBU_STATIC;
+
+				indexBuffer = IndexBuffer::Create(ibDesc);
+			}
+
+			if(allocation.IndexFormat == IT_16BIT)
+			{
+				mScratchIndices16.resize(numIndices);
+				for(u32 i = 0; i < numIndices; i++)
+					mScratchIndices16[i] = (u16)indices[i];
+
+				indexBuffer->WriteData(allocation.IndexOffset * sizeof(u16), numIndices * sizeof(u16),
+					mScratchIndices16.data());
+
+				mStats.NumAllocations16++;
+			}
+			else
+				indexBuffer->WriteData(allocation.IndexOffset * sizeof(u32), numIndices * sizeof(u32), indices);
+
+			mStats.NumAllocations++;
+			mStats.NumUsedVertices += numVertices;
+			mStats.NumUsedIndices += numIndices;
+
+			return allocation;
+		}
+
+		void GeometryPool::Free(const GeometryAllocation& allocation)
+		{
+			if(!allocation.IsValid())
+				return;
+
+			Page& page = mPages[allocation.PageIdx];
+			page.VertexRanges.Free(allocation.VertexOffset, allocation.NumVertices);
+
+			if(allocation.IndexFormat == IT_16BIT)
+			{
+				page.IndexRanges16.Free(allocation.IndexOffset, allocation.NumIndices);
+				mStats.NumAllocations16--;
+			}
+			else
+				page.IndexRanges32.Free(allocation.IndexOffset, allocation.NumIndices);
+
+			mStats.NumAllocations--;
+			mStats.NumUsedVertices -= allocation.NumVertices;
+			mStats.NumUsedIndices -= allocation.NumIndices;
+		}
+
+		void GeometryPool::Draw(const GeometryAllocation& allocation, u32 numInstances,
+			const SPtr<CommandBuffer>& commandBuffer)
+		{
+			if(!allocation.IsValid())
+				return;
+
+			Bind(mPages[allocation.PageIdx], allocation.IndexFormat, commandBuffer);
+
+			RenderAPI::Instance().DrawIndexed(allocation.IndexOffset, allocation.NumIndices, allocation.VertexOffset,
+				allocation.NumVertices, numInstances, commandBuffer);
+
+			mStats.NumDraws++;
+		}
+
+		void GeometryPool::DrawMultiple(const Vector<GeometryAllocation>& allocations,
+			const SPtr<CommandBuffer>& commandBuffer)
+		{
+			// Group the draws by the buffers they use, in the order the meshes are stored in
+			mSortedAllocations.clear();
+			for(auto& allocation : allocations)
+			{
+				if(allocation.IsValid())
+					mSortedAllocations.push_back(allocation);
+			}
+
+			std::sort(mSortedAllocations.begin(), mSortedAllocations.end(),
+				[](const GeometryAllocation& a, const GeometryAllocation& b)
+				{
+					if(a.PageIdx != b.PageIdx)
+						return a.PageIdx < b.PageIdx;
+
+					if(a.IndexFormat != b.IndexFormat)
+						return a.IndexFormat < b.IndexFormat;
+
+					return a.IndexOffset < b.IndexOffset;
+				});
+
+			RenderAPI& rapi = RenderAPI::Instance();
+
+			u32 boundPageIdx = (u32)-1;
+			IndexType boundIndexFormat = IT_16BIT;
+			for(auto& allocation : mSortedAllocations)
+			{
+				if(allocation.PageIdx != boundPageIdx || allocation.IndexFormat != boundIndexFormat)
+				{
+					Bind(mPages[allocation.PageIdx], allocation.IndexFormat, commandBuffer);
+
+					boundPageIdx = allocation.PageIdx;
+					boundIndexFormat = allocation.IndexFormat;
+				}
+
+				rapi.DrawIndexed(allocation.IndexOffset, allocation.NumIndices, allocation.VertexOffset,
+					allocation.NumVertices, 1, commandBuffer);
+
+				mStats.NumDraws++;
+			}
+		}
+
+		void GeometryPool::ResetDrawStats()
+		{
+			mStats.NumBinds = 0;
+			mStats.NumDraws = 0;
+		}
+
+		u32 GeometryPool::CreatePage(u32 numVertices, u32 numIndices)
+		{
+			Page page;
+
+			const u32 vertexCapacity = std::max(numVertices, mVerticesPerPage);
+			page.IndexCapacity = std::max(numIndices, mIndicesPerPage);
+
+			page.VertexRanges = RangeAllocator(vertexCapacity);
+			page.IndexRanges16 = RangeAllocator(page.IndexCapacity);
+			page.IndexRanges32 = RangeAllocator(page.IndexCapacity);
+
+			VERTEX_BUFFER_DESC vbDesc;
+			vbDesc.VertexSize = mVertexStride;
+			vbDesc.NumVerts = vertexCapacity;
+			vbDesc.Usage = GBU_STATIC;
+
+			page.Vertices = VertexBuffer::Create(vbDesc);
+
+			mPages.push_back(page);
+			mStats.NumPages++;
+
+			return (u32)mPages.size() - 1;
+		}
+
+		void GeometryPool::Bind(const Page& page, IndexType indexFormat, const SPtr<CommandBuffer>& commandBuffer)
+		{
+			RenderAPI& rapi = RenderAPI::Instance();
+
+			SPtr<VertexBuffer> vertexBuffer = page.Vertices;
+			rapi.SetVertexBuffers(0, &vertexBuffer, 1, commandBuffer);
+			rapi.SetIndexBuffer(indexFormat == IT_16BIT ? page.Indices16 : page.Indices32, commandBuffer);
+			rapi.SetVertexDeclaration(mVertexDecl, commandBuffer);
+			rapi.SetDrawOperation(DOT_TRIANGLE_LIST, commandBuffer);
+
+			mStats.NumBinds++;
+		}
+	} // namespace ct
+} // namespace bs
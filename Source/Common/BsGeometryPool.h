@@ -0,0 +1,156 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "RenderAPI/BsIndexBuffer.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** Location of a mesh sub-allocated from a GeometryPool. */
+		struct GeometryAllocation
+		{
+			u32 PageIdx = (u32)-1;
+			IndexType IndexFormat = IT_16BIT; /**< Type of the index buffer the indices were written to. */
+			u32 VertexOffset = 0; /**< First vertex of the mesh in the page's vertex buffer. Indices are relative to it. */
+			u32 NumVertices = 0;
+			u32 IndexOffset = 0; /**< First index of the mesh in the page's index buffer of the matching type. */
+			u32 NumIndices = 0;
+
+			/** Checks if the allocation refers to a mesh stored in the pool. */
+			bool IsValid() const { return PageIdx != (u32)-1; }
+		};
+
+		/** Usage statistics reported by GeometryPool. */
+		struct GeometryPoolStats
+		{
+			u32 NumPages = 0;
+			u32 NumAllocations = 0; /**< Number of meshes currently stored in the pool. */
+			u32 NumAllocations16 = 0; /**< Meshes stored with 16-bit indices. */
+			u32 NumUsedVertices = 0;
+			u32 NumUsedIndices = 0;
+			u32 NumBinds = 0; /**< Vertex and index buffer binds performed by the draw calls, since the last reset. */
+			u32 NumDraws = 0; /**< Draw calls issued, since the last reset. */
+		};
+
+		/**
+		 * Stores many meshes sharing a vertex layout in a few large vertex and index buffers, instead of a pair of buffers
+		 * per mesh.
+		 *
+		 * Meshes are sub-allocated from pages, each owning one vertex buffer and an index buffer per index type. Indices
+		 * are stored relative to the first vertex of their mesh and offset by the draw call, so the 16-bit index buffer
+		 * is picked whenever the mesh has no more than 65536 vertices, halving the size of its indices. Freed ranges are
+		 * returned to per-page free lists and reused by later allocations.
+		 *
+		 * Meshes stored in the same page and using the same index type are drawn from the same buffers, so DrawMultiple()
+		 * binds the buffers once per page and issues all the draws in a row.
+		 *
+		 * Must only be used on the core thread.
+		 */
+		class GeometryPool
+		{
+		public:
+			/**
+			 * Creates an empty pool. Pages are created as needed.
+			 *
+			 * @param	vertexDesc			Layout of the vertices of all the meshes in the pool. Must use a single stream.
+			 * @param	verticesPerPage		Size of the vertex buffer of each page, in vertices. Meshes with more vertices
+			 *								get a page of their own.
+			 * @param	indicesPerPage		Size of the index buffers of each page, in indices. Meshes with more indices get
+			 *								a page of their own.
+			 */
+			GeometryPool(const SPtr<VertexDataDesc>& vertexDesc, u32 verticesPerPage = DEFAULT_VERTICES_PER_PAGE,
+				u32 indicesPerPage = DEFAULT_INDICES_PER_PAGE);
+
+			/**
+			 * Stores a mesh in the pool.
+			 *
+			 * @param	vertices		Vertex data, laid out according to the pool's vertex description.
+			 * @param	numVertices		Number of vertices to store.
+			 * @param	indices			Triangle list indices, relative to the first vertex of the mesh.
+			 * @param	numIndices		Number of indices to store.
+			 * @return					Location of the mesh, used for drawing and freeing it.
+			 */
+			GeometryAllocation Allocate(const u8* vertices, u32 numVertices, const u32* indices, u32 numIndices);
+
+			/** Releases a mesh stored with Allocate(), so its space can be reused. */
+			void Free(const GeometryAllocation& allocation);
+
+			/** Binds the buffers holding the mesh and draws it. */
+			void Draw(const GeometryAllocation& allocation, u32 numInstances, const SPtr<CommandBuffer>& commandBuffer);
+
+			/**
+			 * Draws multiple meshes, one instance each. The meshes are drawn grouped by the buffers holding them, and the
+			 * buffers are only bound when they change.
+			 */
+			void DrawMultiple(const Vector<GeometryAllocation>& allocations, const SPtr<CommandBuffer>& commandBuffer);
+
+			/** Returns the vertex declaration matching the layout of the stored vertices. */
+			const SPtr<VertexDeclaration>& GetVertexDeclaration() const { return mVertexDecl; }
+
+			/** Returns the current usage statistics. */
+			const GeometryPoolStats& GetStats() const { return mStats; }
+
+			/** Resets the bind and draw counters. */
+			void ResetDrawStats();
+
+			static constexpr u32 DEFAULT_VERTICES_PER_PAGE = 64 * 1024;
+			static constexpr u32 DEFAULT_INDICES_PER_PAGE = 256 * 1024;
+
+		private:
+			/** First-fit allocator of ranges of elements from a buffer of fixed capacity. */
+			class RangeAllocator
+			{
+			public:
+				RangeAllocator(u32 capacity = 0);
+
+				/** Finds a free range of the requested size. Returns false if the buffer is too full. */
+				bool Allocate(u32 count, u32& offset);
+
+				/** Returns a range to the free list, merging it with its neighbours. */
+				void Free(u32 offset, u32 count);
+
+			private:
+				/** Range of free elements. */
+				struct Range
+				{
+					u32 Offset;
+					u32 Count;
+				};
+
+				Vector<Range> mFreeRanges; /**< Sorted by offset. */
+			};
+
+			/** Vertex buffer and the index buffers referencing it. */
+			struct Page
+			{
+				SPtr<VertexBuffer> Vertices;
+				SPtr<IndexBuffer> Indices16; /**< Created the first time a mesh needs 16-bit indices. */
+				SPtr<IndexBuffer> Indices32; /**< Created the first time a mesh needs 32-bit indices. */
+
+				RangeAllocator VertexRanges;
+				RangeAllocator IndexRanges16;
+				RangeAllocator IndexRanges32;
+
+				u32 IndexCapacity;
+			};
+
+			/** Creates a new page large enough for the provided number of vertices and indices. */
+			u32 CreatePage(u32 numVertices, u32 numIndices);
+
+			/** Binds the vertex buffer of the page and its index buffer of the provided type. */
+			void Bind(const Page& page, IndexType indexFormat, const SPtr<CommandBuffer>& commandBuffer);
+
+			SPtr<VertexDataDesc> mVertexDesc;
+			SPtr<VertexDeclaration> mVertexDecl;
+			u32 mVertexStride;
+			u32 mVerticesPerPage;
+			u32 mIndicesPerPage;
+
+			Vector<Page> mPages;
+			Vector<u16> mScratchIndices16;
+			Vector<GeometryAllocation> mSortedAllocations;
+			GeometryPoolStats mStats;
+		};
+	} // namespace ct
+} // namespace bs
@@ -0,0 +1,799 @@
+#include "BsGpuInstanceCuller.h"
+#include "RenderAPI/BsRenderAPI.h"
+#include "RenderAPI/BsGpuProgram.h"
+#include "RenderAPI/BsGpuPipelineState.h"
+#include "RenderAPI/BsGpuParams.h"
+#include "RenderAPI/BsGpuParamBlockBuffer.h"
+#include "RenderAPI/BsGpuBuffer.h"
+#include "RenderAPI/BsSamplerState.h"
+#include "Image/BsTexture.h"
+#include "BsEngineConfig.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** Shading language the programs are written in, depending on the render API. */
+		enum class CullShaderLanguage
+		{
+			HLSL,
+			VKSL,
+			GLSL
+		};
+
+		/** Returns the language of the programs for the render API the engine was built with. */
+		static CullShaderLanguage getShaderLanguage()
+		{
+			if(strcmp(BS_RENDER_API_MODULE, "bsfD3D11RenderAPI") == 0)
+				return CullShaderLanguage::HLSL;
+
+			if(strcmp(BS_RENDER_API_MODULE, "bsfVulkanRenderAPI") == 0)
+				return CullShaderLanguage::VKSL;
+
+			return CullShaderLanguage::GLSL;
+		}
+
+		/** Returns the source of the program culling the instances. */
+		static const char* getCullProgramSource(CullShaderLanguage language)
+		{
+			if(language == CullShaderLanguage::HLSL)
+			{
+				static const char* src = R"(
+cbuffer Params
+{
+	float4x4 gViewProj;
+	float4x4 gHiZViewProj;
+	float4 gNDCToUV;
+	float2 gNDCToDepth;
+	uint gNumInstances;
+	uint gNumHiZMips;
+	uint2 gHiZSize;
+	uint gIndexCount;
+	uint gReset;
+}
+
+struct InstanceBounds
+{
+	float4 center;
+	float4 extents;
+};
+
+StructuredBuffer<InstanceBounds> gBounds;
+Texture2D<float> gHiZ;
+RWStructuredBuffer<uint> gVisibleInstances;
+RWStructuredBuffer<uint> gDrawArgs;
+
+float3 getCorner(InstanceBounds bounds, uint idx)
+{
+	float3 signs = float3((idx & 1) ? 1.0f : -1.0f, (idx & 2) ? 1.0f : -1.0f, (idx & 4) ? 1.0f : -1.0f);
+	return bounds.center.xyz + bounds.extents.xyz * signs;
+}
+
+bool isInFrustum(InstanceBounds bounds)
+{
+	// Outside if all the corners are outside of the same clip plane
+	uint outside = 0x1F;
+	for(uint i = 0; i < 8; i++)
+	{
+		float4 clipPos = mul(gViewProj, float4(getCorner(bounds, i), 1.0f));
+
+		uint mask = 0;
+		mask |= clipPos.x < -clipPos.w ? 0x01 : 0;
+		mask |= clipPos.x > clipPos.w ? 0x02 : 0;
+		mask |= clipPos.y < -clipPos.w ? 0x04 : 0;
+		mask |= clipPos.y > clipPos.w ? 0x08 : 0;
+		mask |= clipPos.z > clipPos.w ? 0x10 : 0;
+		outside &= mask;
+	}
+
+	return outside == 0;
+}
+
+bool isOccluded(InstanceBounds bounds)
+{
+	float2 minUV = 1.0f;
+	float2 maxUV = 0.0f;
+	float closestDepth = 1.0f;
+	for(uint i = 0; i < 8; i++)
+	{
+		float4 clipPos = mul(gHiZViewProj, float4(getCorner(bounds, i), 1.0f));
+
+		// Bounds crossing the near plane are too close to the viewer to be occluded
+		if(clipPos.w <= 0.0f)
+			return false;
+
+		float3 ndcPos = clipPos.xyz / clipPos.w;
+		float2 uv = ndcPos.xy * gNDCToUV.xy + gNDCToUV.zw;
+
+		minUV = min(minUV, uv);
+		maxUV = max(maxUV, uv);
+		closestDepth = min(closestDepth, ndcPos.z * gNDCToDepth.x + gNDCToDepth.y);
+	}
+
+	// Parts outside of the screen can't be visible, so only test the on-screen area
+	float2 minTexel = saturate(minUV) * gHiZSize;
+	float2 maxTexel = saturate(maxUV) * gHiZSize;
+
+	// Pick the level at which the bounds cover at most 2x2 texels
+	float2 size = maxTexel - minTexel;
+	uint mip = min((uint)ceil(log2(max(max(size.x, size.y), 1.0f))), gNumHiZMips - 1);
+
+	// Levels round their size down, with the last row and column covering the leftover texels
+	int2 lastTexel = (int2)max(gHiZSize >> mip, 1) - 1;
+	int2 minCoord = min((int2)minTexel >> mip, lastTexel);
+	int2 maxCoord = min((int2)maxTexel >> mip, lastTexel);
+
+	float farthestDepth = max(
+		max(gHiZ.Load(int3(minCoord.x, minCoord.y, mip)), gHiZ.Load(int3(maxCoord.x, minCoord.y, mip))),
+		max(gHiZ.Load(int3(minCoord.x, maxCoord.y, mip)), gHiZ.Load(int3(maxCoord.x, maxCoord.y, mip))));
+
+	return closestDepth > farthestDepth;
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint idx = dispatchThreadId.x;
+	if(gReset != 0)
+	{
+		if(idx == 0)
+		{
+			gDrawArgs[0] = gIndexCount;
+			gDrawArgs[1] = 0;
+			gDrawArgs[2] = 0;
+			gDrawArgs[3] = 0;
+			gDrawArgs[4] = 0;
+		}
+
+		return;
+	}
+
+	if(idx >= gNumInstances)
+		return;
+
+	InstanceBounds bounds = gBounds[idx];
+	if(!isInFrustum(bounds))
+		return;
+
+	if(gNumHiZMips > 0 && isOccluded(bounds))
+		return;
+
+	uint slot;
+	InterlockedAdd(gDrawArgs[1], 1, slot);
+	gVisibleInstances[slot] = idx;
+}
+)";
+
+				return src;
+			}
+			else if(language == CullShaderLanguage::VKSL)
+			{
+				static const char* src = R"(
+layout (local_size_x = 64) in;
+
+layout (binding = 0, std140) uniform Params
+{
+	mat4 gViewProj;
+	mat4 gHiZViewProj;
+	vec4 gNDCToUV;
+	vec2 gNDCToDepth;
+	uint gNumInstances;
+	uint gNumHiZMips;
+	uvec2 gHiZSize;
+	uint gIndexCount;
+	uint gReset;
+};
+
+struct InstanceBounds
+{
+	vec4 center;
+	vec4 extents;
+};
+
+layout (binding = 1, std430) readonly buffer gBounds
+{
+	InstanceBounds gBoundsData[];
+};
+
+layout (binding = 2) uniform sampler2D gHiZ;
+
+layout (binding = 3, std430) buffer gVisibleInstances
+{
+	uint gVisibleInstancesData[];
+};
+
+layout (binding = 4, std430) buffer gDrawArgs
+{
+	uint gDrawArgsData[];
+};
+
+vec3 getCorner(InstanceBounds bounds, uint idx)
+{
+	vec3 signs = vec3((idx & 1u) != 0u ? 1.0f : -1.0f, (idx & 2u) != 0u ? 1.0f : -1.0f, (idx & 4u) != 0u ? 1.0f : -1.0f);
+	return bounds.center.xyz + bounds.extents.xyz * signs;
+}
+
+bool isInFrustum(InstanceBounds bounds)
+{
+	// Outside if all the corners are outside of the same clip plane
+	uint outside = 0x1Fu;
+	for(uint i = 0u; i < 8u; i++)
+	{
+		vec4 clipPos = gViewProj * vec4(getCorner(bounds, i), 1.0f);
+
+		uint mask = 0u;
+		mask |= clipPos.x < -clipPos.w ? 0x01u : 0u;
+		mask |= clipPos.x > clipPos.w ? 0x02u : 0u;
+		mask |= clipPos.y < -clipPos.w ? 0x04u : 0u;
+		mask |= clipPos.y > clipPos.w ? 0x08u : 0u;
+		mask |= clipPos.z > clipPos.w ? 0x10u : 0u;
+		outside &= mask;
+	}
+
+	return outside == 0u;
+}
+
+bool isOccluded(InstanceBounds bounds)
+{
+	vec2 minUV = vec2(1.0f);
+	vec2 maxUV = vec2(0.0f);
+	float closestDepth = 1.0f;
+	for(uint i = 0u; i < 8u; i++)
+	{
+		vec4 clipPos = gHiZViewProj * vec4(getCorner(bounds, i), 1.0f);
+
+		// Bounds crossing the near plane are too close to the viewer to be occluded
+		if(clipPos.w <= 0.0f)
+			return false;
+
+		vec3 ndcPos = clipPos.xyz / clipPos.w;
+		vec2 uv = ndcPos.xy * gNDCToUV.xy + gNDCToUV.zw;
+
+		minUV = min(minUV, uv);
+		maxUV = max(maxUV, uv);
+		closestDepth = min(closestDepth, ndcPos.z * gNDCToDepth.x + gNDCToDepth.y);
+	}
+
+	// Parts outside of the screen can't be visible, so only test the on-screen area
+	vec2 minTexel = clamp(minUV, 0.0f, 1.0f) * vec2(gHiZSize);
+	vec2 maxTexel = clamp(maxUV, 0.0f, 1.0f) * vec2(gHiZSize);
+
+	// Pick the level at which the bounds cover at most 2x2 texels
+	vec2 size = maxTexel - minTexel;
+	uint mip = min(uint(ceil(log2(max(max(size.x, size.y), 1.0f)))), gNumHiZMips - 1u);
+
+	// Levels round their size down, with the last row and column covering the leftover texels
+	ivec2 lastTexel = ivec2(max(gHiZSize >> mip, uvec2(1u))) - 1;
+	ivec2 minCoord = min(ivec2(minTexel) >> int(mip), lastTexel);
+	ivec2 maxCoord = min(ivec2(maxTexel) >> int(mip), lastTexel);
+
+	float farthestDepth = max(
+		max(texelFetch(gHiZ, ivec2(minCoord.x, minCoord.y), int(mip)).r, texelFetch(gHiZ, ivec2(maxCoord.x, minCoord.y), int(mip)).r),
+		max(texelFetch(gHiZ, ivec2(minCoord.x, maxCoord.y), int(mip)).r, texelFetch(gHiZ, ivec2(maxCoord.x, maxCoord.y), int(mip)).r));
+
+	return closestDepth > farthestDepth;
+}
+
+void main()
+{
+	uint idx = gl_GlobalInvocationID.x;
+	if(gReset != 0u)
+	{
+		if(idx == 0u)
+		{
+			gDrawArgsData[0] = gIndexCount;
+			gDrawArgsData[1] = 0u;
+			gDrawArgsData[2] = 0u;
+			gDrawArgsData[3] = 0u;
+			gDrawArgsData[4] = 0u;
+		}
+
+		return;
+	}
+
+	if(idx >= gNumInstances)
+		return;
+
+	InstanceBounds bounds = gBoundsData[idx];
+	if(!isInFrustum(bounds))
+		return;
+
+	if(gNumHiZMips > 0u && isOccluded(bounds))
+		return;
+
+	uint slot = atomicAdd(gDrawArgsData[1], 1u);
+	gVisibleInstancesData[slot] = idx;
+}
+)";
+
+				return src;
+			}
+			else
+			{
+				static const char* src = R"(
+layout (local_size_x = 64) in;
+
+layout (std140) uniform Params
+{
+	mat4 gViewProj;
+	mat4 gHiZViewProj;
+	vec4 gNDCToUV;
+	vec2 gNDCToDepth;
+	uint gNumInstances;
+	uint gNumHiZMips;
+	uvec2 gHiZSize;
+	uint gIndexCount;
+	uint gReset;
+};
+
+struct InstanceBounds
+{
+	vec4 center;
+	vec4 extents;
+};
+
+layout (std430) readonly buffer gBounds
+{
+	InstanceBounds gBoundsData[];
+};
+
+uniform sampler2D gHiZ;
+
+layout (std430) buffer gVisibleInstances
+{
+	uint gVisibleInstancesData[];
+};
+
+layout (std430) buffer gDrawArgs
+{
+	uint gDrawArgsData[];
+};
+
+vec3 getCorner(InstanceBounds bounds, uint idx)
+{
+	vec3 signs = vec3((idx & 1u) != 0u ? 1.0f : -1.0f, (idx & 2u) != 0u ? 1.0f : -1.0f, (idx & 4u) != 0u ? 1.0f : -1.0f);
+	return bounds.center.xyz + bounds.extents.xyz * signs;
+}
+
+bool isInFrustum(InstanceBounds bounds)
+{
+	// Outside if all the corners are outside of the same clip plane
+	uint outside = 0x1Fu;
+	for(uint i = 0u; i < 8u; i++)
+	{
+		vec4 clipPos = gViewProj * vec4(getCorner(bounds, i), 1.0f);
+
+		uint mask = 0u;
+		mask |= clipPos.x < -clipPos.w ? 0x01u : 0u;
+		mask |= clipPos.x > clipPos.w ? 0x02u : 0u;
+		mask |= clipPos.y < -clipPos.w ? 0x04u : 0u;
+		mask |= clipPos.y > clipPos.w ? 0x08u : 0u;
+		mask |= clipPos.z > clipPos.w ? 0x10u : 0u;
+		outside &= mask;
+	}
+
+	return outside == 0u;
+}
+
+bool isOccluded(InstanceBounds bounds)
+{
+	vec2 minUV = vec2(1.0f);
+	vec2 maxUV = vec2(0.0f);
+	float closestDepth = 1.0f;
+	for(uint i = 0u; i < 8u; i++)
+	{
+		vec4 clipPos = gHiZViewProj * vec4(getCorner(bounds, i), 1.0f);
+
+		// Bounds crossing the near plane are too close to the viewer to be occluded
+		if(clipPos.w <= 0.0f)
+			return false;
+
+		vec3 ndcPos = clipPos.xyz / clipPos.w;
+		vec2 uv = ndcPos.xy * gNDCToUV.xy + gNDCToUV.zw;
+
+		minUV = min(minUV, uv);
+		maxUV = max(maxUV, uv);
+		closestDepth = min(closestDepth, ndcPos.z * gNDCToDepth.x + gNDCToDepth.y);
+	}
+
+	// Parts outside of the screen can't be visible, so only test the on-screen area
+	vec2 minTexel = clamp(minUV, 0.0f, 1.0f) * vec2(gHiZSize);
+	vec2 maxTexel = clamp(maxUV, 0.0f, 1.0f) * vec2(gHiZSize);
+
+	// Pick the level at which the bounds cover at most 2x2 texels
+	vec2 size = maxTexel - minTexel;
+	uint mip = min(uint(ceil(log2(max(max(size.x, size.y), 1.0f)))), gNumHiZMips - 1u);
+
+	// Levels round their size down, with the last row and column covering the leftover texels
+	ivec2 lastTexel = ivec2(max(gHiZSize >> mip, uvec2(1u))) - 1;
+	ivec2 minCoord = min(ivec2(minTexel) >> int(mip), lastTexel);
+	ivec2 maxCoord = min(ivec2(maxTexel) >> int(mip), lastTexel);
+
+	float farthestDepth = max(
+		max(texelFetch(gHiZ, ivec2(minCoord.x, minCoord.y), int(mip)).r, texelFetch(gHiZ, ivec2(maxCoord.x, minCoord.y), int(mip)).r),
+		max(texelFetch(gHiZ, ivec2(minCoord.x, maxCoord.y), int(mip)).r, texelFetch(gHiZ, ivec2(maxCoord.x, maxCoord.y), int(mip)).r));
+
+	return closestDepth > farthestDepth;
+}
+
+void main()
+{
+	uint idx = gl_GlobalInvocationID.x;
+	if(gReset != 0u)
+	{
+		if(idx == 0u)
+		{
+			gDrawArgsData[0] = gIndexCount;
+			gDrawArgsData[1] = 0u;
+			gDrawArgsData[2] = 0u;
+			gDrawArgsData[3] = 0u;
+			gDrawArgsData[4] = 0u;
+		}
+
+		return;
+	}
+
+	if(idx >= gNumInstances)
+		return;
+
+	InstanceBounds bounds = gBoundsData[idx];
+	if(!isInFrustum(bounds))
+		return;
+
+	if(gNumHiZMips > 0u && isOccluded(bounds))
+		return;
+
+	uint slot = atomicAdd(gDrawArgsData[1], 1u);
+	gVisibleInstancesData[slot] = idx;
+}
+)";
+
+				return src;
+			}
+		}
+
+		/** Returns the source of the program building a level of the hierarchical depth from the level above it. */
+		static const char* getHiZProgramSource(CullShaderLanguage language)
+		{
+			if(language == CullShaderLanguage::HLSL)
+			{
+				static const char* src = R"(
+cbuffer Params
+{
+	uint2 gInputSize;
+	uint2 gOutputSize;
+}
+
+Texture2D<float> gInput;
+RWTexture2D<float> gOutput;
+
+[numthreads(8, 8, 1)]
+void main(uint3 dispatchThreadId : SV_DispatchThreadID)
+{
+	uint2 pos = dispatchThreadId.xy;
+	if(any(pos >= gOutputSize))
+		return;
+
+	// Each texel keeps the farthest depth of the 2x2 input texels it covers. Texels in the last row and column also
+	// cover the input texels left over when the input size is odd.
+	uint2 start = pos * 2;
+	uint2 end = min(start + 2, gInputSize);
+	if(pos.x == gOutputSize.x - 1)
+		end.x = gInputSize.x;
+
+	if(pos.y == gOutputSize.y - 1)
+		end.y = gInputSize.y;
+
+	float farthestDepth = 0.0f;
+	for(uint y = start.y; y < end.y; y++)
+	{
+		for(uint x = start.x; x < end.x; x++)
+			farthestDepth = max(farthestDepth, gInput.Load(int3(x, y, 0)));
+	}
+
+	gOutput[pos] = farthestDepth;
+}
+)";
+
+				return src;
+			}
+			else if(language == CullShaderLanguage::VKSL)
+			{
+				static const char* src = R"(
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0, std140) uniform Params
+{
+	uvec2 gInputSize;
+	uvec2 gOutputSize;
+};
+
+layout (binding = 1) uniform sampler2D gInput;
+layout (binding = 2, r32f) uniform writeonly image2D gOutput;
+
+void main()
+{
+	uvec2 pos = gl_GlobalInvocationID.xy;
+	if(any(greaterThanEqual(pos, gOutputSize)))
+		return;
+
+	// Each texel keeps the farthest depth of the 2x2 input texels it covers. Texels in the last row and column also
+	// cover the input texels left over when the input size is odd.
+	uvec2 start = pos * 2u;
+	uvec2 end = min(start + 2u, gInputSize);
+	if(pos.x == gOutputSize.x - 1u)
+		end.x = gInputSize.x;
+
+	if(pos.y == gOutputSize.y - 1u)
+		end.y = gInputSize.y;
+
+	float farthestDepth = 0.0f;
+	for(uint y = start.y; y < end.y; y++)
+	{
+		for(uint x = start.x; x < end.x; x++)
+			farthestDepth = max(farthestDepth, texelFetch(gInput, ivec2(x, y), 0).r);
+	}
+
+	imageStore(gOutput, ivec2(pos), vec4(farthestDepth));
+}
+)";
+
+				return src;
+			}
+			else
+			{
+				static const char* src = R"(
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (std140) uniform Params
+{
+	uvec2 gInputSize;
+	uvec2 gOutputSize;
+};
+
+uniform sampler2D gInput;
+layout (r32f) uniform writeonly image2D gOutput;
+
+void main()
+{
+	uvec2 pos = gl_GlobalInvocationID.xy;
+	if(any(greaterThanEqual(pos, gOutputSize)))
+		return;
+
+	// Each texel keeps the farthest depth of the 2x2 input texels it covers. Texels in the last row and column also
+	// cover the input texels left over when the input size is odd.
+	uvec2 start = pos * 2u;
+	uvec2 end = min(start + 2u, gInputSize);
+	if(pos.x == gOutputSize.x - 1u)
+		end.x = gInputSize.x;
+
+	if(pos.y == gOutputSize.y - 1u)
+		end.y = gInputSize.y;
+
+	float farthestDepth = 0.0f;
+	for(uint y = start.y; y < end.y; y++)
+	{
+		for(uint x = start.x; x < end.x; x++)
+			farthestDepth = max(farthestDepth, texelFetch(gInput, ivec2(x, y), 0).r);
+	}
+
+	imageStore(gOutput, ivec2(pos), vec4(farthestDepth));
+}
+)";
+
+				return src;
+			}
+		}
+
+		/** Compiles a compute program and creates a pipeline for it. */
+		static SPtr<ComputePipelineState> createComputePipeline(const char* source, CullShaderLanguage language)
+		{
+			GPU_PROGRAM_DESC programDesc;
+			programDesc.Type = GPT_COMPUTE_PROGRAM;
+			programDesc.EntryPoint = "main";
+			programDesc.Language = language == CullShaderLanguage::HLSL ? "hlsl" : language == CullShaderLanguage::VKSL ? "vksl"
+				: "glsl";
+			programDesc.Source = source;
+
+			return ComputePipelineState::Create(GpuProgram::Create(programDesc));
+		}
+
+		GpuInstanceCuller::GpuInstanceCuller(u32 maxInstances, u32 indexCount, u32 depthWidth, u32 depthHeight)
+			: mMaxInstances(maxInstances), mIndexCount(indexCount)
+		{
+			const CullShaderLanguage language = getShaderLanguage();
+			mIsHLSL = language == CullShaderLanguage::HLSL;
+
+			// Persistent buffers, written by the CPU only when the instances change, or only ever written by the GPU
+			GPU_BUFFER_DESC boundsDesc;
+			boundsDesc.Type = GBT_STRUCTURED;
+			boundsDesc.ElementCount = maxInstances;
+			boundsDesc.ElementSize = sizeof(GpuInstanceBounds);
+			boundsDesc.Usage = GBU_STATIC;
+
+			mBounds = GpuBuffer::Create(boundsDesc);
+
+			GPU_BUFFER_DESC visibleDesc;
+			visibleDesc.Type = GBT_STRUCTURED;
+			visibleDesc.ElementCount = maxInstances;
+			visibleDesc.ElementSize = sizeof(u32);
+			visibleDesc.Usage = GBU_LOADSTORE;
+
+			mVisibleInstances = GpuBuffer::Create(visibleDesc);
+
+			GPU_BUFFER_DESC drawArgsDesc;
+			drawArgsDesc.Type = GBT_STRUCTURED;
+			drawArgsDesc.ElementCount = DRAW_ARGUMENTS_SIZE;
+			drawArgsDesc.ElementSize = sizeof(u32);
+			drawArgsDesc.Usage = GBU_LOADSTORE;
+
+			mDrawArguments = GpuBuffer::Create(drawArgsDesc);
+
+			// Hierarchical depth, at half the resolution of the depth buffer, with mip levels down to a single texel. Sizes
+			// round down, and the downsampling program covers the leftover texels.
+			const u32 hiZWidth = std::max(depthWidth / 2, 1U);
+			const u32 hiZHeight = std::max(depthHeight / 2, 1U);
+
+			Vector<std::pair<u32, u32>> mipSizes;
+			mipSizes.push_back(std::make_pair(hiZWidth, hiZHeight));
+			while(mipSizes.back().first > 1 || mipSizes.back().second > 1)
+			{
+				mipSizes.push_back(std::make_pair(std::max(mipSizes.back().first / 2, 1U),
+					std::max(mipSizes.back().second / 2, 1U)));
+			}
+
+			TEXTURE_DESC hiZDesc;
+			hiZDesc.Width = hiZWidth;
+			hiZDesc.Height = hiZHeight;
+			hiZDesc.Format = PF_R32F;
+			hiZDesc.Usage = TU_LOADSTORE;
+			hiZDesc.NumMips = (u32)mipSizes.size() - 1;
+
+			mHiZ = Texture::Create(hiZDesc);
+
+			SAMPLER_STATE_DESC samplerDesc;
+			samplerDesc.MinFilter = FO_POINT;
+			samplerDesc.MagFilter = FO_POINT;
+			samplerDesc.MipFilter = FO_POINT;
+
+			mPointSampler = SamplerState::Create(samplerDesc);
+
+			// Culling. The draw arguments are cleared by a single thread dispatch of the same program, with its own
+			// parameters.
+			mCullPipeline = createComputePipeline(getCullProgramSource(language), language);
+			mResetParamBuffer = GpuParamBlockBuffer::Create(sizeof(CullParams));
+			mCullParamBuffer = GpuParamBlockBuffer::Create(sizeof(CullParams));
+
+			CullParams resetParams = {};
+			resetParams.IndexCount = mIndexCount;
+			resetParams.Reset = 1;
+
+			mResetParamBuffer->Write(0, &resetParams, sizeof(resetParams));
+
+			mResetParams = GpuParams::Create(mCullPipeline);
+			mCullParams = GpuParams::Create(mCullPipeline);
+			for(const auto& params : { mResetParams, mCullParams })
+			{
+				params->SetBuffer(GPT_COMPUTE_PROGRAM, "gBounds", mBounds);
+				params->SetBuffer(GPT_COMPUTE_PROGRAM, "gVisibleInstances", mVisibleInstances);
+				params->SetBuffer(GPT_COMPUTE_PROGRAM, "gDrawArgs", mDrawArguments);
+				params->SetTexture(GPT_COMPUTE_PROGRAM, "gHiZ", mHiZ);
+
+				if(!mIsHLSL)
+					params->SetSamplerState(GPT_COMPUTE_PROGRAM, "gHiZ", mPointSampler);
+			}
+
+			mResetParams->SetParamBlockBuffer(GPT_COMPUTE_PROGRAM, "Params", mResetParamBuffer);
+			mCullParams->SetParamBlockBuffer(GPT_COMPUTE_PROGRAM, "Params", mCullParamBuffer);
+
+			// Downsampling, with a set of parameters per level. The depth buffer input of the first level is only known
+			// once BuildHiZ() is called.
+			mHiZPipeline = createComputePipeline(getHiZProgramSource(language), language);
+			for(u32 i = 0; i < (u32)mipSizes.size(); i++)
+			{
+				HiZParams hiZParams;
+				hiZParams.InputSize[0] = i == 0 ? depthWidth : mipSizes[i - 1].first;
+				hiZParams.InputSize[1] = i == 0 ? depthHeight : mipSizes[i - 1].second;
+				hiZParams.OutputSize[0] = mipSizes[i].first;
+				hiZParams.OutputSize[1] = mipSizes[i].second;
+
+				SPtr<GpuParamBlockBuffer> paramBuffer = GpuParamBlockBuffer::Create(sizeof(HiZParams));
+				paramBuffer->Write(0, &hiZParams, sizeof(hiZParams));
+
+				SPtr<GpuParams> params = GpuParams::Create(mHiZPipeline);
+				params->SetParamBlockBuffer(GPT_COMPUTE_PROGRAM, "Params", paramBuffer);
+				params->SetLoadStoreTexture(GPT_COMPUTE_PROGRAM, "gOutput", mHiZ, TextureSurface(i, 1, 0, 1));
+
+				if(i > 0)
+					params->SetTexture(GPT_COMPUTE_PROGRAM, "gInput", mHiZ, TextureSurface(i - 1, 1, 0, 1));
+
+				if(!mIsHLSL)
+					params->SetSamplerState(GPT_COMPUTE_PROGRAM, "gInput", mPointSampler);
+
+				mHiZParams.push_back(params);
+				mHiZParamBuffers.push_back(paramBuffer);
+			}
+		}
+
+		void GpuInstanceCuller::SetBounds(const Vector<GpuInstanceBounds>& bounds)
+		{
+			mNumInstances = std::min((u32)bounds.size(), mMaxInstances);
+			if(mNumInstances > 0)
+				mBounds->WriteData(0, mNumInstances * sizeof(GpuInstanceBounds), bounds.data(), BWT_DISCARD);
+		}
+
+		void GpuInstanceCuller::Cull(const Matrix4& viewProj, const SPtr<CommandBuffer>& commandBuffer)
+		{
+			const RenderAPIInfo& apiInfo = RenderAPI::Instance().GetAPIInfo();
+
+			CullParams params;
+			params.ViewProj = mIsHLSL ? viewProj : viewProj.Transpose();
+			params.HiZViewProj = mIsHLSL ? mHiZViewProj : mHiZViewProj.Transpose();
+
+			// Row zero of the depth buffer is the top of the screen, unless the NDC Y axis points down, or the texture
+			// coordinate Y axis points up (both flip it)
+			const bool flipY = apiInfo.IsFlagSet(RenderAPIFeatureFlag::NDCYAxisDown) ==
+				apiInfo.IsFlagSet(RenderAPIFeatureFlag::UVYAxisUp);
+			params.NDCToUV = Vector4(0.5f, flipY ? -0.5f : 0.5f, 0.5f, 0.5f);
+
+			const float minDepth = apiInfo.GetMinimumDepthInputValue();
+			const float maxDepth = apiInfo.GetMaximumDepthInputValue();
+			params.NDCToDepth = Vector2(1.0f / (maxDepth - minDepth), -minDepth / (maxDepth - minDepth));
+
+			params.NumInstances = mNumInstances;
+			params.NumHiZMips = mIsHiZValid ? (u32)mHiZParams.size() : 0;
+			params.HiZSize[0] = mHiZ->GetProperties().GetWidth();
+			params.HiZSize[1] = mHiZ->GetProperties().GetHeight();
+			params.IndexCount = mIndexCount;
+			params.Reset = 0;
+
+			mCullParamBuffer->Write(0, &params, sizeof(params));
+
+			// Remembered for the HiZ built from the depth of this frame
+			mLastViewProj = viewProj;
+
+			RenderAPI& rapi = RenderAPI::Instance();
+			rapi.SetComputePipeline(mCullPipeline, commandBuffer);
+
+			rapi.SetGpuParams(mResetParams, commandBuffer);
+			rapi.DispatchCompute(1, 1, 1, commandBuffer);
+
+			if(mNumInstances == 0)
+				return;
+
+			rapi.SetGpuParams(mCullParams, commandBuffer);
+			rapi.DispatchCompute((mNumInstances + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1, commandBuffer);
+		}
+
+		void GpuInstanceCuller::BuildHiZ(const SPtr<Texture>& depth, const SPtr<CommandBuffer>& commandBuffer)
+		{
+			mHiZParams[0]->SetTexture(GPT_COMPUTE_PROGRAM, "gInput", depth);
+
+			RenderAPI& rapi = RenderAPI::Instance();
+			rapi.SetComputePipeline(mHiZPipeline, commandBuffer);
+
+			u32 width = mHiZ->GetProperties().GetWidth();
+			u32 height = mHiZ->GetProperties().GetHeight();
+			for(auto& params : mHiZParams)
+			{
+				rapi.SetGpuParams(params, commandBuffer);
+				rapi.DispatchCompute((width + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (height + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE,
+					1, commandBuffer);
+
+				width = std::max(width / 2, 1U);
+				height = std::max(height / 2, 1U);
+			}
+
+			mHiZViewProj = mLastViewProj;
+			mIsHiZValid = true;
+		}
+
+		u32 GpuInstanceCuller::ReadVisibleCount() const
+		{
+			u32 drawArguments[DRAW_ARGUMENTS_SIZE];
+			mDrawArguments->ReadData(0, sizeof(drawArguments), drawArguments);
+
+			return drawArguments[1];
+		}
+	} // namespace ct
+} // namespace bs
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsVector2.h"
+#include "Math/BsVector4.h"
+#include "Math/BsMatrix4.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** World space bounds of a single instance, in the layout used by the bounds buffer of GpuInstanceCuller. */
+		struct GpuInstanceBounds
+		{
+			Vector4 Center; /**< Center of the bounds. W is unused. */
+			Vector4 Extents; /**< Half-size of the bounds along each axis. W is unused. */
+		};
+
+		/**
+		 * Determines visibility of a large number of instances entirely on the GPU, using compute programs.
+		 *
+		 * Instance bounds live in a persistent GPU buffer, uploaded once through SetBounds(). Every frame Cull() tests
+		 * each instance against the view frustum, and against a hierarchical depth buffer built from the depth of the
+		 * previous frame by BuildHiZ(). Visible instances are appended to a compacted list of instance indices, and their
+		 * number is written into a draw arguments buffer, in the layout of an indexed indirect draw (index count, instance
+		 * count, first index, vertex offset, first instance).
+		 *
+		 * The RenderAPI doesn't expose indirect draws, so the draw call is issued with the total number of instances. The
+		 * vertex program reads the instance index from the visible list, and the visible count from the draw arguments,
+		 * and collapses the instances past the count to a point outside of the screen. Culled instances then never reach
+		 * the rasterizer, and the arguments can be passed directly to an indirect draw once one is available.
+		 *
+		 * Occlusion is tested against the depth and the view of the previous frame, so instances that become visible
+		 * from behind an occluder may appear a frame late.
+		 *
+		 * Must only be used on the core thread.
+		 */
+		class GpuInstanceCuller
+		{
+		public:
+			/**
+			 * Creates the culler and the GPU resources it needs.
+			 *
+			 * @param	maxInstances	Maximum number of instances that can be culled.
+			 * @param	indexCount		Number of indices drawn per instance, written into the draw arguments.
+			 * @param	depthWidth		Width of the depth buffer the hierarchical depth is built from, in pixels.
+			 * @param	depthHeight		Height of the depth buffer the hierarchical depth is built from, in pixels.
+			 */
+			GpuInstanceCuller(u32 maxInstances, u32 indexCount, u32 depthWidth, u32 depthHeight);
+
+			/** Uploads the bounds of all instances to cull. Only needs to be called again when the instances change. */
+			void SetBounds(const Vector<GpuInstanceBounds>& bounds);
+
+			/**
+			 * Queues the culling of all instances as seen through the provided view-projection matrix. Must be followed by
+			 * the draw of the instances, and then by BuildHiZ() with the depth output by the draw.
+			 */
+			void Cull(const Matrix4& viewProj, const SPtr<CommandBuffer>& commandBuffer);
+
+			/**
+			 * Queues the build of the hierarchical depth buffer from the depth of the current frame, used for occlusion
+			 * culling in the next Cull() call. The depth texture must not be bound as a render target.
+			 */
+			void BuildHiZ(const SPtr<Texture>& depth, const SPtr<CommandBuffer>& commandBuffer);
+
+			/** Returns the buffer holding the indices of the visible instances, one 32-bit unsigned integer each. */
+			const SPtr<GpuBuffer>& GetVisibleInstances() const { return mVisibleInstances; }
+
+			/** Returns the buffer holding the draw arguments, DRAW_ARGUMENTS_SIZE 32-bit unsigned integers. */
+			const SPtr<GpuBuffer>& GetDrawArguments() const { return mDrawArguments; }
+
+			/** Returns the number of instances whose bounds were provided. */
+			u32 GetNumInstances() const { return mNumInstances; }
+
+			/**
+			 * Reads the number of instances found visible by the last culling pass back from the GPU. Waits until the GPU
+			 * finishes all queued work, so it should only be used occasionally (e.g. for displaying statistics).
+			 */
+			u32 ReadVisibleCount() const;
+
+			/** Number of values in the draw arguments buffer. */
+			static constexpr u32 DRAW_ARGUMENTS_SIZE = 5;
+
+			/** Number of threads in a single group of the culling and HiZ programs. */
+			static constexpr u32 CULL_GROUP_SIZE = 64;
+			static constexpr u32 HIZ_GROUP_SIZE = 8;
+
+		private:
+			/** Uniform block of the culling program. */
+			struct CullParams
+			{
+				Matrix4 ViewProj;
+				Matrix4 HiZViewProj; /**< View-projection of the frame the hierarchical depth was built from. */
+				Vector4 NDCToUV; /**< Scale (XY) and offset (ZW) converting NDC coordinates to HiZ texture coordinates. */
+				Vector2 NDCToDepth; /**< Scale (X) and offset (Y) converting NDC depth to depth buffer values. */
+				u32 NumInstances;
+				u32 NumHiZMips; /**< Number of mip levels of the HiZ texture, or 0 if it hasn't been built yet. */
+				u32 HiZSize[2]; /**< Size of the top level of the HiZ texture, in texels. */
+				u32 IndexCount;
+				u32 Reset; /**< If non-zero the program only clears the draw arguments. */
+			};
+
+			/** Uniform block of the HiZ downsampling program. */
+			struct HiZParams
+			{
+				u32 InputSize[2];
+				u32 OutputSize[2];
+			};
+
+			u32 mMaxInstances;
+			u32 mIndexCount;
+			u32 mNumInstances = 0;
+			bool mIsHiZValid = false;
+			bool mIsHLSL = true;
+
+			SPtr<GpuBuffer> mBounds;
+			SPtr<GpuBuffer> mVisibleInstances;
+			SPtr<GpuBuffer> mDrawArguments;
+
+			SPtr<ComputePipelineState> mCullPipeline;
+			SPtr<GpuParams> mResetParams;
+			SPtr<GpuParams> mCullParams;
+			SPtr<GpuParamBlockBuffer> mResetParamBuffer;
+			SPtr<GpuParamBlockBuffer> mCullParamBuffer;
+
+			SPtr<ComputePipelineState> mHiZPipeline;
+			SPtr<Texture> mHiZ;
+			SPtr<SamplerState> mPointSampler;
+			Vector<SPtr<GpuParams>> mHiZParams; /**< One per mip level of the HiZ texture. */
+			Vector<SPtr<GpuParamBlockBuffer>> mHiZParamBuffers;
+
+			Matrix4 mHiZViewProj;
+			Matrix4 mLastViewProj;
+		};
+	} // namespace ct
+} // namespace bs
@@ -0,0 +1,407 @@
+#include "BsGpuMemoryHeap.h"
+#include "RenderAPI/BsGpuBuffer.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** Returns the base-two logarithm of the smallest power of two larger or equal to 'value'. */
+		static u32 ceilLog2(u32 value)
+		{
+			u32 output = 0;
+			while((1U << output) < value)
+				output++;
+
+			return output;
+		}
+
+		/** Rounds 'value' up to a multiple of GpuMemoryHeap::ALIGNMENT. */
+		static u32 alignSize(u32 value)
+		{
+			return (value + GpuMemoryHeap::ALIGNMENT - 1) & ~(GpuMemoryHeap::ALIGNMENT - 1);
+		}
+
+		GpuMemoryHeap::GpuMemoryHeap(GpuHeapStrategy strategy, u32 blockSize, u32 minAllocationSize)
+			: mStrategy(strategy), mBlockSize(1U << ceilLog2(std::max(blockSize, ALIGNMENT)))
+			, mMinAllocationSizeLog2(ceilLog2(std::max(minAllocationSize, ALIGNMENT)))
+		{
+			// Classes up to the block size, larger allocations get a block of their own
+			mMinAllocationSizeLog2 = std::min(mMinAllocationSizeLog2, ceilLog2(mBlockSize));
+			mFreeChunks.resize(ceilLog2(mBlockSize) - mMinAllocationSizeLog2 + 1);
+		}
+
+		GpuHeapAllocation GpuMemoryHeap::Allocate(u32 size)
+		{
+			if(size == 0)
+				return GpuHeapAllocation();
+
+			u32 reservedSize = alignSize(size);
+			if(mStrategy == GpuHeapStrategy::SizeClass && reservedSize <= mBlockSize)
+				reservedSize = std::max(1U << ceilLog2(reservedSize), 1U << mMinAllocationSizeLog2);
+
+			u32 blockIdx, offset;
+			Place(reservedSize, blockIdx, offset);
+
+			return AddAllocation(blockIdx, offset, reservedSize, size);
+		}
+
+		void GpuMemoryHeap::Free(const GpuHeapAllocation& allocation)
+		{
+			if(!IsLiveHandle(allocation))
+				return;
+
+			Allocation& entry = mAllocations[allocation.Id];
+			entry.IsLive = false;
+			entry.Generation++;
+			mFreeIds.push_back(allocation.Id);
+
+			mStats.NumAllocations--;
+			mStats.UsedBytes -= entry.Size;
+			mStats.RequestedBytes -= entry.RequestedSize;
+
+			// Linear heaps reclaim their memory all at once, in Reset()
+			if(mStrategy == GpuHeapStrategy::Linear)
+				return;
+
+			Block& block = mBlocks[entry.BlockIdx];
+			block.NumAllocations--;
+
+			// Blocks holding a single oversized allocation are returned to the driver right away, instead of keeping a
+			// large chunk around that only an equally large allocation could reuse
+			if(block.Size > mBlockSize)
+			{
+				if(block.NumAllocations == 0)
+					ReleaseBlock(entry.BlockIdx);
+
+				return;
+			}
+
+			mFreeChunks[GetSizeClassIdx(entry.Size)].push_back({ entry.BlockIdx, entry.Offset });
+		}
+
+		void GpuMemoryHeap::Reset()
+		{
+			for(auto& block : mBlocks)
+			{
+				block.Top = 0;
+				block.NumAllocations = 0;
+			}
+
+			for(auto& freeChunks : mFreeChunks)
+				freeChunks.clear();
+
+			// Keep the entries so handles to the freed allocations are rejected once their IDs are reused. Entries that
+			// were already freed are in the free list.
+			for(u32 i = 0; i < (u32)mAllocations.size(); i++)
+			{
+				Allocation& entry = mAllocations[i];
+				if(!entry.IsLive)
+					continue;
+
+				entry.IsLive = false;
+				entry.Generation++;
+				mFreeIds.push_back(i);
+			}
+
+			mCurrentBlockIdx = 0;
+
+			mStats.NumAllocations = 0;
+			mStats.UsedBytes = 0;
+			mStats.RequestedBytes = 0;
+		}
+
+		GpuHeapLocation GpuMemoryHeap::GetLocation(const GpuHeapAllocation& allocation) const
+		{
+			GpuHeapLocation location;
+			if(!IsLiveHandle(allocation))
+				return location;
+
+			const Allocation& entry = mAllocations[allocation.Id];
+			location.Buffer = mBlocks[entry.BlockIdx].Buffer;
+			location.Offset = entry.Offset;
+			location.Size = entry.RequestedSize;
+
+			return location;
+		}
+
+		void GpuMemoryHeap::Write(const GpuHeapAllocation& allocation, const void* data, u32 size, u32 offset)
+		{
+			const GpuHeapLocation location = GetLocation(allocation);
+			if(!location.Buffer || offset + size > location.Size)
+				return;
+
+			// Other allocations in a linear block may still be read by the GPU from the previous frames, while the
+			// range written to is guaranteed not to be
+			const BufferWriteType writeType = mStrategy == GpuHeapStrategy::Linear ? BWT_NO_OVERWRITE : BWT_NORMAL;
+			location.Buffer->WriteData(location.Offset + offset, size, data, writeType);
+		}
+
+		u32 GpuMemoryHeap::Defragment(const SPtr<CommandBuffer>& commandBuffer)
+		{
+			mStats.NumDefragMoves = 0;
+
+			// Linear heaps never leave holes, their memory is reclaimed in one go by Reset()
+			if(mStrategy == GpuHeapStrategy::Linear || mStats.NumAllocations == 0)
+				return 0;
+
+			// Place the largest allocations first. Size classes are powers of two, so packing them in decreasing order
+			// leaves no gaps between them.
+			Vector<u32> liveIds;
+			liveIds.reserve(mStats.NumAllocations);
+			for(u32 i = 0; i < (u32)mAllocations.size(); i++)
+			{
+				if(mAllocations[i].IsLive)
+					liveIds.push_back(i);
+			}
+
+			std::sort(liveIds.begin(), liveIds.end(),
+				[this](u32 a, u32 b)
+				{
+					if(mAllocations[a].Size != mAllocations[b].Size)
+						return mAllocations[a].Size > mAllocations[b].Size;
+
+					return a < b;
+				});
+
+			// The old blocks stay alive until all the copies out of them are queued. Render API backends keep the
+			// buffers alive until the GPU is done with the queued copies.
+			Vector<Block> oldBlocks = std::move(mBlocks);
+			mBlocks.clear();
+
+			for(auto& freeChunks : mFreeChunks)
+				freeChunks.clear();
+
+			mStats.ReservedBytes = 0;
+			mStats.NumBlocks = 0;
+
+			for(auto id : liveIds)
+			{
+				Allocation& entry = mAllocations[id];
+
+				u32 blockIdx, offset;
+				Place(entry.Size, blockIdx, offset);
+
+				Block& dstBlock = mBlocks[blockIdx];
+				const Block& srcBlock = oldBlocks[entry.BlockIdx];
+				dstBlock.Buffer->CopyData(*srcBlock.Buffer, entry.Offset, offset, alignSize(entry.RequestedSize), false,
+					commandBuffer);
+
+				entry.BlockIdx = blockIdx;
+				entry.Offset = offset;
+			}
+
+			mStats.NumDefragMoves = (u32)liveIds.size();
+			return mStats.NumDefragMoves;
+		}
+
+		void GpuMemoryHeap::Trim()
+		{
+			for(u32 i = 0; i < (u32)mBlocks.size(); i++)
+			{
+				if(mBlocks[i].Buffer && mBlocks[i].NumAllocations == 0)
+					ReleaseBlock(i);
+			}
+
+			mCurrentBlockIdx = 0;
+		}
+
+		GpuHeapStats GpuMemoryHeap::GetStats() const
+		{
+			GpuHeapStats stats = mStats;
+
+			// Free chunks are never merged, so an allocation can only be placed in a single chunk, or at the unused end
+			// of a block. Linear heaps only allocate from the current block onwards until reset.
+			const u32 firstBlockIdx = mStrategy == GpuHeapStrategy::Linear ? mCurrentBlockIdx : 0;
+			for(u32 i = firstBlockIdx; i < (u32)mBlocks.size(); i++)
+			{
+				const Block& block = mBlocks[i];
+				if(!block.Buffer)
+					continue;
+
+				const u64 unusedBytes = block.Size - block.Top;
+				stats.FreeBytes += unusedBytes;
+				stats.LargestFreeRange = std::max(stats.LargestFreeRange, unusedBytes);
+			}
+
+			for(u32 i = 0; i < (u32)mFreeChunks.size(); i++)
+			{
+				if(mFreeChunks[i].empty())
+					continue;
+
+				const u64 chunkSize = 1ULL << (i + mMinAllocationSizeLog2);
+				stats.FreeBytes += chunkSize * mFreeChunks[i].size();
+				stats.LargestFreeRange = std::max(stats.LargestFreeRange, chunkSize);
+			}
+
+			return stats;
+		}
+
+		u32 GpuMemoryHeap::GetSizeClassIdx(u32 size) const
+		{
+			return std::max(ceilLog2(size), mMinAllocationSizeLog2) - mMinAllocationSizeLog2;
+		}
+
+		void GpuMemoryHeap::Place(u32 size, u32& blockIdx, u32& offset)
+		{
+			if(mStrategy == GpuHeapStrategy::Linear)
+			{
+				for(u32 i = mCurrentBlockIdx; i < (u32)mBlocks.size(); i++)
+				{
+					Block& block = mBlocks[i];
+					if(!block.Buffer || block.Top + size > block.Size)
+						continue;
+
+					mCurrentBlockIdx = i;
+					blockIdx = i;
+					offset = block.Top;
+
+					block.Top += size;
+					block.NumAllocations++;
+					return;
+				}
+
+				blockIdx = CreateBlock(std::max(size, mBlockSize));
+				offset = 0;
+
+				mCurrentBlockIdx = blockIdx;
+				mBlocks[blockIdx].Top = size;
+				mBlocks[blockIdx].NumAllocations++;
+				return;
+			}
+
+			if(size > mBlockSize)
+			{
+				blockIdx = CreateBlock(size);
+				offset = 0;
+
+				mBlocks[blockIdx].Top = size;
+				mBlocks[blockIdx].NumAllocations++;
+				return;
+			}
+
+			// Reuse a freed chunk of the same class first, then carve a new chunk from the unused end of a block
+			Vector<FreeChunk>& freeChunks = mFreeChunks[GetSizeClassIdx(size)];
+			if(!freeChunks.empty())
+			{
+				const FreeChunk chunk = freeChunks.back();
+				freeChunks.pop_back();
+
+				blockIdx = chunk.BlockIdx;
+				offset = chunk.Offset;
+				mBlocks[blockIdx].NumAllocations++;
+				return;
+			}
+
+			for(u32 i = 0; i < (u32)mBlocks.size(); i++)
+			{
+				Block& block = mBlocks[i];
+				if(!block.Buffer || block.Size > mBlockSize || block.Top + size > block.Size)
+					continue;
+
+				blockIdx = i;
+				offset = block.Top;
+
+				block.Top += size;
+				block.NumAllocations++;
+				return;
+			}
+
+			blockIdx = CreateBlock(mBlockSize);
+			offset = 0;
+
+			mBlocks[blockIdx].Top = size;
+			mBlocks[blockIdx].NumAllocations++;
+		}
+
+		u32 GpuMemoryHeap::CreateBlock(u32 size)
+		{
+			u32 blockIdx = (u32)mBlocks.size();
+			for(u32 i = 0; i < (u32)mBlocks.size(); i++)
+			{
+				if(!mBlocks[i].Buffer)
+				{
+					blockIdx = i;
+					break;
+				}
+			}
+
+			if(blockIdx == (u32)mBlocks.size())
+				mBlocks.push_back(Block());
+
+			GPU_BUFFER_DESC desc;
+			desc.Type = GBT_STRUCTURED;
+			desc.ElementCount = size / ALIGNMENT;
+			desc.ElementSize = ALIGNMENT;
+			desc.Usage = mStrategy == GpuHeapStrategy::Linear ? GBU_DYNAMIC : GBU_STATIC;
+
+			Block& block = mBlocks[blockIdx];
+			block.Buffer = GpuBuffer::Create(desc);
+			block.Size = size;
+			block.Top = 0;
+			block.NumAllocations = 0;
+
+			mStats.ReservedBytes += size;
+			mStats.NumBlocks++;
+			mStats.NumBlockAllocations++;
+
+			return blockIdx;
+		}
+
+		void GpuMemoryHeap::ReleaseBlock(u32 blockIdx)
+		{
+			Block& block = mBlocks[blockIdx];
+
+			mStats.ReservedBytes -= block.Size;
+			mStats.NumBlocks--;
+
+			block = Block();
+
+			for(auto& freeChunks : mFreeChunks)
+			{
+				freeChunks.erase(std::remove_if(freeChunks.begin(), freeChunks.end(),
+					[blockIdx](const FreeChunk& chunk) { return chunk.BlockIdx == blockIdx; }), freeChunks.end());
+			}
+		}
+
+		bool GpuMemoryHeap::IsLiveHandle(const GpuHeapAllocation& allocation) const
+		{
+			if(!allocation.IsValid() || allocation.Id >= (u32)mAllocations.size())
+				return false;
+
+			const Allocation& entry = mAllocations[allocation.Id];
+			return entry.IsLive && entry.Generation == allocation.Generation;
+		}
+
+		GpuHeapAllocation GpuMemoryHeap::AddAllocation(u32 blockIdx, u32 offset, u32 size, u32 requestedSize)
+		{
+			GpuHeapAllocation allocation;
+			if(!mFreeIds.empty())
+			{
+				allocation.Id = mFreeIds.back();
+				mFreeIds.pop_back();
+			}
+			else
+			{
+				allocation.Id = (u32)mAllocations.size();
+				mAllocations.push_back(Allocation());
+			}
+
+			// Reused IDs keep the generation they were freed with
+			Allocation& entry = mAllocations[allocation.Id];
+			entry.BlockIdx = blockIdx;
+			entry.Offset = offset;
+			entry.Size = size;
+			entry.RequestedSize = requestedSize;
+			entry.IsLive = true;
+
+			allocation.Generation = entry.Generation;
+
+			mStats.NumAllocations++;
+			mStats.UsedBytes += size;
+			mStats.RequestedBytes += requestedSize;
+			mStats.PeakUsedBytes = std::max(mStats.PeakUsedBytes, mStats.UsedBytes);
+
+			return allocation;
+		}
+	} // namespace ct
+} // namespace bs
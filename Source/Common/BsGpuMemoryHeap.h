@@ -0,0 +1,207 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** Determines how a GpuMemoryHeap hands out memory. */
+		enum class GpuHeapStrategy
+		{
+			/**
+			 * Allocations are rounded up to a power-of-two size class. Freed allocations are kept in per-class free lists
+			 * and reused by later allocations of the same class. Suited for long-lived data of varying lifetimes, such as
+			 * streamed resources.
+			 */
+			SizeClass,
+
+			/**
+			 * Allocations are placed one after another, and are all freed at once by Reset(). Suited for transient data
+			 * written every frame.
+			 */
+			Linear
+		};
+
+		/**
+		 * Handle to an allocation made by a GpuMemoryHeap. Stays valid when the allocation is moved by defragmentation.
+		 * Once the allocation is freed, either by Free() or Reset(), the heap ignores the handle, even after its ID is
+		 * reused by a new allocation.
+		 */
+		struct GpuHeapAllocation
+		{
+			u32 Id = (u32)-1;
+			u32 Generation = 0; /**< Number of times the ID was freed before this allocation was made. */
+
+			/** Checks if the handle refers to an allocation. */
+			bool IsValid() const { return Id != (u32)-1; }
+		};
+
+		/** Buffer and range of bytes holding an allocation. */
+		struct GpuHeapLocation
+		{
+			SPtr<GpuBuffer> Buffer;
+			u32 Offset = 0; /**< Offset of the allocation in the buffer, in bytes. Multiple of GpuMemoryHeap::ALIGNMENT. */
+			u32 Size = 0; /**< Size of the allocation as requested, in bytes. */
+		};
+
+		/** Usage statistics reported by GpuMemoryHeap. */
+		struct GpuHeapStats
+		{
+			u64 ReservedBytes = 0; /**< Total size of the blocks allocated from the driver. */
+			u64 UsedBytes = 0; /**< Size of all live allocations, rounded up to their size class. */
+			u64 RequestedBytes = 0; /**< Size of all live allocations, as requested by the callers. */
+			u64 PeakUsedBytes = 0; /**< Highest value of UsedBytes since the heap was created. */
+			u64 FreeBytes = 0; /**< Reserved memory that new allocations can be placed in. */
+			u64 LargestFreeRange = 0; /**< Size of the largest free range a single allocation can be placed in. */
+			u32 NumBlocks = 0;
+			u32 NumAllocations = 0; /**< Number of live allocations. */
+			u32 NumBlockAllocations = 0; /**< Number of blocks allocated from the driver since the heap was created. */
+			u32 NumDefragMoves = 0; /**< Number of allocations moved by the last Defragment() call. */
+
+			/** Fraction of used memory lost to rounding allocations up to their size class. */
+			float GetInternalFragmentation() const
+			{
+				return UsedBytes > 0 ? 1.0f - (float)RequestedBytes / (float)UsedBytes : 0.0f;
+			}
+
+			/**
+			 * Fraction of free memory that can't be handed out as a single allocation, i.e. 1 - largest free range / free
+			 * memory. Zero when all free memory is in one range, approaching one as it is split into many small ranges.
+			 */
+			float GetExternalFragmentation() const
+			{
+				return FreeBytes > 0 ? 1.0f - (float)LargestFreeRange / (float)FreeBytes : 0.0f;
+			}
+		};
+
+		/**
+		 * Sub-allocates GPU buffer memory from a few large blocks, rather than creating a buffer per allocation. Creating
+		 * buffers goes through the driver and may stall, which shows up as hitches when many resources are streamed in
+		 * at once. The heap only allocates a new block when the existing ones are full.
+		 *
+		 * Blocks are structured buffers with ALIGNMENT byte elements, so allocations can be bound as a whole block and
+		 * addressed by their offset in shaders, or copied from on the GPU. Allocations are referred to by handles,
+		 * because Defragment() may move them to a different block, and their location must be looked up again with
+		 * GetLocation() afterwards.
+		 *
+		 * Must only be used on the core thread.
+		 */
+		class GpuMemoryHeap
+		{
+		public:
+			/**
+			 * Creates an empty heap. Blocks are allocated as needed.
+			 *
+			 * @param	strategy			Determines how memory is handed out.
+			 * @param	blockSize			Size of the blocks allocated from the driver, in bytes. Rounded up to a power
+			 *								of two. Larger allocations get a block of their own.
+			 * @param	minAllocationSize	Size of the smallest size class, in bytes. Rounded up to a power of two. Only
+			 *								used by the size-class strategy.
+			 */
+			GpuMemoryHeap(GpuHeapStrategy strategy, u32 blockSize = DEFAULT_BLOCK_SIZE, u32 minAllocationSize = 256);
+
+			GpuMemoryHeap(const GpuMemoryHeap&) = delete;
+			GpuMemoryHeap& operator=(const GpuMemoryHeap&) = delete;
+
+			/** Allocates 'size' bytes. The contents are undefined until written. */
+			GpuHeapAllocation Allocate(u32 size);
+
+			/**
+			 * Frees an allocation. With the linear strategy the memory is only reclaimed once Reset() is called, along
+			 * with all the other allocations.
+			 */
+			void Free(const GpuHeapAllocation& allocation);
+
+			/** Frees all the allocations at once, keeping the blocks for the next allocations. */
+			void Reset();
+
+			/** Returns the buffer and range holding an allocation. */
+			GpuHeapLocation GetLocation(const GpuHeapAllocation& allocation) const;
+
+			/** Writes data into an allocation, starting 'offset' bytes into it. */
+			void Write(const GpuHeapAllocation& allocation, const void* data, u32 size, u32 offset = 0);
+
+			/**
+			 * Moves all the allocations of a size-class heap into as few blocks as possible, one after another, and
+			 * releases the blocks they were stored in. Removes all external fragmentation left by freed allocations,
+			 * at the cost of a GPU copy of all the live data, so it is best done rarely (e.g. after streaming in a new
+			 * area). Locations returned by GetLocation() must be looked up again afterwards.
+			 *
+			 * @param	commandBuffer	Command buffer to queue the copies on. If null the copies are queued on the main
+			 *							command buffer.
+			 * @return					Number of allocations moved.
+			 */
+			u32 Defragment(const SPtr<CommandBuffer>& commandBuffer = nullptr);
+
+			/** Releases the blocks without any live allocations back to the driver. */
+			void Trim();
+
+			/** Returns the current usage statistics. */
+			GpuHeapStats GetStats() const;
+
+			/** Alignment of all allocations, in bytes. Also the element size of the block buffers. */
+			static constexpr u32 ALIGNMENT = 16;
+
+			static constexpr u32 DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+		private:
+			/** Buffer allocated from the driver, split into allocations. */
+			struct Block
+			{
+				SPtr<GpuBuffer> Buffer;
+				u32 Size = 0;
+				u32 Top = 0; /**< Offset of the first byte never handed out, or the next byte for the linear strategy. */
+				u32 NumAllocations = 0;
+			};
+
+			/** Allocation placed in a block. */
+			struct Allocation
+			{
+				u32 BlockIdx;
+				u32 Offset;
+				u32 Size; /**< Size reserved for the allocation, in bytes. */
+				u32 RequestedSize;
+				u32 Generation; /**< Incremented when the allocation is freed, invalidating its handles. */
+				bool IsLive;
+			};
+
+			/** Free range a size-class allocation can be reused from. */
+			struct FreeChunk
+			{
+				u32 BlockIdx;
+				u32 Offset;
+			};
+
+			/** Returns the index of the size class serving allocations of the provided size. */
+			u32 GetSizeClassIdx(u32 size) const;
+
+			/** Finds room for 'size' bytes in the existing blocks, or allocates a new block. */
+			void Place(u32 size, u32& blockIdx, u32& offset);
+
+			/** Allocates a new block of at least the provided size, reusing a released slot if possible. */
+			u32 CreateBlock(u32 size);
+
+			/** Releases the buffer of a block, and forgets the free chunks it contained. */
+			void ReleaseBlock(u32 blockIdx);
+
+			/** Checks if the handle refers to a live allocation, rather than one that was freed. */
+			bool IsLiveHandle(const GpuHeapAllocation& allocation) const;
+
+			/** Registers an allocation and returns its handle. */
+			GpuHeapAllocation AddAllocation(u32 blockIdx, u32 offset, u32 size, u32 requestedSize);
+
+			GpuHeapStrategy mStrategy;
+			u32 mBlockSize;
+			u32 mMinAllocationSizeLog2;
+
+			Vector<Block> mBlocks; /**< Released blocks have no buffer, and their slots are reused by new blocks. */
+			Vector<Vector<FreeChunk>> mFreeChunks; /**< Per size class. */
+			Vector<Allocation> mAllocations; /**< Indexed by allocation ID. */
+			Vector<u32> mFreeIds;
+			u32 mCurrentBlockIdx = 0; /**< Block the linear strategy is currently allocating from. */
+
+			GpuHeapStats mStats;
+		};
+	} // namespace ct
+} // namespace bs
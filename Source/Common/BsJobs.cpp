@@ -0,0 +1,205 @@
+#include "BsJobs.h"
+#include "Threading/BsTaskScheduler.h"
+
+namespace bs
+{
+	/** Index of the calling thread within the ParallelFor() loop it is executing. See Jobs::GetThreadIdx(). */
+	static thread_local u32 sThreadIdx = 0;
+
+	/** Shared state of a job scheduled through Jobs. */
+	struct JobState
+	{
+		std::function<void()> Work;
+
+		/** Number of unfinished dependencies, plus one while the job is still being set up. */
+		std::atomic<u32> NumPendingDependencies{ 1 };
+		std::atomic<bool> IsComplete{ false };
+
+		Mutex DependentsMutex;
+		Signal CompleteSignal; /**< Notified under DependentsMutex once the job completes. */
+		Vector<SPtr<JobState>> Dependents; /**< Jobs waiting for this job to complete. */
+	};
+
+	bool JobHandle::IsComplete() const
+	{
+		return mState == nullptr || mState->IsComplete;
+	}
+
+	void JobHandle::Wait() const
+	{
+		if(mState == nullptr || mState->IsComplete)
+			return;
+
+		// Lets the scheduler start another task in place of the blocked one, same as Task::Wait(). Otherwise waiting from
+		// inside jobs could occupy all the scheduler slots, leaving none for the jobs being waited on.
+		TaskScheduler& scheduler = TaskScheduler::Instance();
+		scheduler.AddWorker();
+
+		{
+			Lock lock(mState->DependentsMutex);
+			mState->CompleteSignal.wait(lock, [this]() { return mState->IsComplete.load(); });
+		}
+
+		scheduler.RemoveWorker();
+	}
+
+	JobHandle Jobs::Schedule(std::function<void()> work, const Vector<JobHandle>& dependencies)
+	{
+		SPtr<JobState> state = bs_shared_ptr_new<JobState>();
+		state->Work = std::move(work);
+
+		for(auto& dependency : dependencies)
+		{
+			if(dependency.mState == nullptr)
+				continue;
+
+			JobState& dependencyState = *dependency.mState;
+
+			// Checked under the lock, so the dependency can't complete between the check and registration
+			Lock lock(dependencyState.DependentsMutex);
+			if(dependencyState.IsComplete)
+				continue;
+
+			state->NumPendingDependencies++;
+			dependencyState.Dependents.push_back(state);
+		}
+
+		Release(state);
+		return JobHandle(state);
+	}
+
+	JobHandle Jobs::Combine(const Vector<JobHandle>& jobs)
+	{
+		return Schedule(nullptr, jobs);
+	}
+
+	void Jobs::ParallelFor(u32 begin, u32 end, u32 grainSize, const RangeFunc& func)
+	{
+		if(begin >= end)
+			return;
+
+		grainSize = std::max(grainSize, 1U);
+
+		const u32 numChunks = (end - begin + grainSize - 1) / grainSize;
+		if(numChunks == 1)
+		{
+			func(begin, end);
+			return;
+		}
+
+		// Rather than submitting a task per chunk, submit a task per thread, with each one grabbing chunks until there
+		// are none left. This keeps the scheduling cost independent of the number of chunks, while still balancing the
+		// load if some chunks take longer than others.
+		struct LoopState
+		{
+			std::atomic<u32> NextChunk{ 0 };
+			std::atomic<u32> NextHelperIdx{ 1 };
+			u32 NumFinishedChunks = 0;
+
+			Mutex FinishedMutex;
+			Signal FinishedSignal;
+		};
+
+		auto loopState = bs_shared_ptr_new<LoopState>();
+		auto processChunks = [loopState, begin, end, grainSize, numChunks, &func](u32 threadIdx)
+		{
+			const u32 prevThreadIdx = sThreadIdx;
+			sThreadIdx = threadIdx;
+
+			// Helpers that start after all chunks were taken exit without touching 'func', which may be gone by then
+			u32 numProcessed = 0;
+			for(u32 chunkIdx = loopState->NextChunk++; chunkIdx < numChunks; chunkIdx = loopState->NextChunk++)
+			{
+				const u32 chunkBegin = begin + chunkIdx * grainSize;
+				func(chunkBegin, std::min(chunkBegin + grainSize, end));
+
+				numProcessed++;
+			}
+
+			sThreadIdx = prevThreadIdx;
+
+			if(numProcessed == 0)
+				return;
+
+			Lock lock(loopState->FinishedMutex);
+			loopState->NumFinishedChunks += numProcessed;
+			if(loopState->NumFinishedChunks == numChunks)
+				loopState->FinishedSignal.notify_all();
+		};
+
+		// The calling thread processes chunks too (as thread zero), so one less helper is needed
+		const u32 numHelpers = std::min(numChunks, GetNumThreads()) - 1;
+
+		TaskScheduler& scheduler = TaskScheduler::Instance();
+		for(u32 i = 0; i < numHelpers; i++)
+		{
+			scheduler.AddTask(Task::Create("ParallelFor", [loopState, processChunks]()
+			{
+				processChunks(loopState->NextHelperIdx++);
+			}));
+		}
+
+		processChunks(0);
+
+		// Only the chunks taken by running helpers can be left at this point, so there's no need to let the scheduler
+		// start another task while blocked. Waiting on the chunks rather than the helpers ensures 'func' is no longer
+		// referenced once the wait finishes.
+		Lock lock(loopState->FinishedMutex);
+		loopState->FinishedSignal.wait(lock, [&loopState, numChunks]()
+			{ return loopState->NumFinishedChunks == numChunks; });
+	}
+
+	JobHandle Jobs::ScheduleParallelFor(u32 begin, u32 end, u32 grainSize, RangeFunc func,
+		const Vector<JobHandle>& dependencies)
+	{
+		return Schedule([begin, end, grainSize, func = std::move(func)]()
+		{
+			ParallelFor(begin, end, grainSize, func);
+		}, dependencies);
+	}
+
+	u8* Jobs::GetScratch(u32 size)
+	{
+		static thread_local Vector<u8> scratch;
+		if(scratch.size() < size)
+			scratch.resize(size);
+
+		return scratch.data();
+	}
+
+	u32 Jobs::GetNumThreads()
+	{
+		// The scheduler runs up to one task per hardware thread at once
+		return std::max((u32)BS_THREAD_HARDWARE_CONCURRENCY, 1U);
+	}
+
+	u32 Jobs::GetThreadIdx()
+	{
+		return sThreadIdx;
+	}
+
+	void Jobs::Release(const SPtr<JobState>& state)
+	{
+		if(--state->NumPendingDependencies != 0)
+			return;
+
+		TaskScheduler::Instance().AddTask(Task::Create("Job", [state]() { Run(state); }));
+	}
+
+	void Jobs::Run(const SPtr<JobState>& state)
+	{
+		if(state->Work)
+			state->Work();
+
+		Vector<SPtr<JobState>> dependents;
+		{
+			Lock lock(state->DependentsMutex);
+			state->IsComplete = true;
+			std::swap(dependents, state->Dependents);
+			state->CompleteSignal.notify_all();
+		}
+
+		for(auto& dependent : dependents)
+			Release(dependent);
+	}
+} // namespace bs
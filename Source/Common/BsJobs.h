@@ -0,0 +1,125 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	struct JobState;
+
+	/** Handle to a job scheduled through Jobs. Can be used for waiting on the job, or as a dependency of other jobs. */
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+
+		/** Returns true if the job has finished executing. Handles that don't reference a job are always complete. */
+		bool IsComplete() const;
+
+		/**
+		 * Blocks until the job finishes. If called from inside a job, the task scheduler is allowed to start another task
+		 * while this one is blocked, so the job being waited on can't be starved.
+		 */
+		void Wait() const;
+
+		/** Returns true if the handle references a job. */
+		bool IsValid() const { return mState != nullptr; }
+
+	private:
+		friend class Jobs;
+
+		JobHandle(SPtr<JobState> state)
+			: mState(std::move(state))
+		{}
+
+		SPtr<JobState> mState;
+	};
+
+	/**
+	 * Simple interface for splitting work across the threads of the engine's TaskScheduler. Allows game code to
+	 * parallelize bulk work (e.g. updating a large number of objects) without managing threads directly. Jobs run on the
+	 * same threads as the engine's own tasks, and the scheduler limits how many run at once, so using jobs doesn't
+	 * oversubscribe the CPU.
+	 *
+	 * Jobs must not access scene objects or components, as those may only be modified from the main thread. Instead, read
+	 * the required data beforehand, process it in jobs, and apply the results on the main thread.
+	 */
+	class Jobs
+	{
+	public:
+		/** Function processing the elements in range ['begin', 'end'). */
+		using RangeFunc = std::function<void(u32 begin, u32 end)>;
+
+		/**
+		 * Schedules a job for execution. The job starts as soon as all jobs in 'dependencies' have finished and a worker
+		 * is available.
+		 */
+		static JobHandle Schedule(std::function<void()> work, const Vector<JobHandle>& dependencies = {});
+
+		/** Returns a handle that completes once all the provided jobs complete. */
+		static JobHandle Combine(const Vector<JobHandle>& jobs);
+
+		/**
+		 * Calls 'func' for all elements in range ['begin', 'end') and waits until it finishes. The range is split into
+		 * chunks of 'grainSize' elements, which are distributed dynamically between the workers and the calling thread.
+		 * The grain size should be large enough for a chunk to take at least a few microseconds, or the scheduling
+		 * overhead will outweigh the gains. Ranges not larger than a single chunk are executed on the calling thread.
+		 */
+		static void ParallelFor(u32 begin, u32 end, u32 grainSize, const RangeFunc& func);
+
+		/**
+		 * Same as ParallelFor(), except the work is performed asynchronously once all jobs in 'dependencies' finish.
+		 * The returned handle completes once the whole range has been processed.
+		 */
+		static JobHandle ScheduleParallelFor(u32 begin, u32 end, u32 grainSize, RangeFunc func,
+			const Vector<JobHandle>& dependencies = {});
+
+		/**
+		 * Returns a buffer of at least 'size' bytes owned by the calling thread, for temporary storage inside a job. The
+		 * buffer is reused by the next call on the same thread, and must not be held across ParallelFor() calls, as the
+		 * calling thread executes chunks of the loop which may use the buffer.
+		 */
+		static u8* GetScratch(u32 size);
+
+		/** Returns the largest number of threads that take part in a ParallelFor() loop, including the calling thread. */
+		static u32 GetNumThreads();
+
+		/**
+		 * Returns the index of the calling thread within the ParallelFor() loop it is currently executing, in range [0,
+		 * GetNumThreads()). The thread that started the loop has index zero, as do threads outside of any loop.
+		 */
+		static u32 GetThreadIdx();
+
+	private:
+		/** Submits the job to the scheduler, or releases it to be submitted once its last dependency finishes. */
+		static void Release(const SPtr<JobState>& state);
+
+		/** Executes the job and releases any jobs waiting on it. */
+		static void Run(const SPtr<JobState>& state);
+	};
+
+	/**
+	 * Storage with a separate copy of an object for each thread taking part in a Jobs::ParallelFor() loop. Useful for
+	 * accumulating results inside parallel loops without synchronization, after which the per-thread values can be
+	 * combined.
+	 *
+	 * @note	Threads are identified by their index within the loop they're executing (see Jobs::GetThreadIdx()), so only
+	 *			one loop should use the storage at a time.
+	 */
+	template<class T>
+	class PerWorker
+	{
+	public:
+		PerWorker(const T& initialValue = T())
+			: mValues(Jobs::GetNumThreads(), initialValue)
+		{}
+
+		/** Returns the copy belonging to the calling thread. */
+		T& Get() { return mValues[Jobs::GetThreadIdx()]; }
+
+		/** Returns copies of all threads. */
+		Vector<T>& GetAll() { return mValues; }
+
+	private:
+		Vector<T> mValues;
+	};
+} // namespace bs
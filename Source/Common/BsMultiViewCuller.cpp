@@ -0,0 +1,293 @@
+#include "BsMultiViewCuller.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCCamera.h"
+#include "Components/BsCRenderable.h"
+#include "Math/BsMath.h"
+#include <algorithm>
+#include <limits>
+
+namespace bs
+{
+	/** Spreads the lower 21 bits of the value so there are two zero bits between each of them. */
+	static u64 spreadBits(u64 value)
+	{
+		value &= 0x1FFFFF;
+		value = (value | (value << 32)) & 0x1F00000000FFFFULL;
+		value = (value | (value << 16)) & 0x1F0000FF0000FFULL;
+		value = (value | (value << 8)) & 0x100F00F00F00F00FULL;
+		value = (value | (value << 4)) & 0x10C30C30C30C30C3ULL;
+		value = (value | (value << 2)) & 0x1249249249249249ULL;
+		return value;
+	}
+
+	void MultiViewVisibility::SetViews(const Vector<ConvexVolume>& frustums)
+	{
+		mNumViews = std::min((u32)frustums.size(), MAX_VIEWS);
+
+		mPlanes.clear();
+		mPlaneOffsets.clear();
+		for(u32 i = 0; i < mNumViews; i++)
+		{
+			mPlaneOffsets.push_back((u32)mPlanes.size());
+
+			for(auto& plane : frustums[i].GetPlanes())
+				mPlanes.push_back({ plane.Normal, plane.D });
+		}
+
+		mPlaneOffsets.push_back((u32)mPlanes.size());
+	}
+
+	MultiViewVisibility::CullResult MultiViewVisibility::Classify(u32 viewIdx, const Vector3& center,
+		const Vector3& halfSize) const
+	{
+		CullResult result = CullResult::Inside;
+		for(u32 i = mPlaneOffsets[viewIdx]; i < mPlaneOffsets[viewIdx + 1]; i++)
+		{
+			const CullPlane& plane = mPlanes[i];
+
+			// Distance of the box center from the plane, and the largest distance of a box corner from its center along
+			// the plane normal
+			const float distance = plane.Normal.Dot(center) - plane.D;
+			const float radius = Math::Abs(plane.Normal.X) * halfSize.X + Math::Abs(plane.Normal.Y) * halfSize.Y +
+				Math::Abs(plane.Normal.Z) * halfSize.Z;
+
+			if(distance < -radius)
+				return CullResult::Outside;
+
+			if(distance < radius)
+				result = CullResult::Intersecting;
+		}
+
+		return result;
+	}
+
+	void MultiViewVisibility::BuildClusters(const Vector<AABox>& bounds)
+	{
+		const u32 numObjects = (u32)bounds.size();
+
+		// Sorting is the most expensive part of culling, so the order is kept between calls, and only re-sorted when the
+		// number of objects changes, or periodically as moving objects slowly make the clusters less coherent
+		if(numObjects != (u32)mSortedObjects.size() || mNumCallsSinceSort >= RESORT_INTERVAL)
+		{
+			SortObjects(bounds);
+			mNumCallsSinceSort = 0;
+		}
+		else
+			mNumCallsSinceSort++;
+
+		// Fixed size runs of consecutive objects form the clusters
+		const u32 numClusters = (numObjects + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+		mClusterBounds.resize(numClusters);
+		for(u32 i = 0; i < numClusters; i++)
+		{
+			const u32 start = i * CLUSTER_SIZE;
+			const u32 end = std::min(start + CLUSTER_SIZE, numObjects);
+
+			AABox clusterBounds = bounds[mSortedObjects[start]];
+			for(u32 j = start + 1; j < end; j++)
+				clusterBounds.Merge(bounds[mSortedObjects[j]]);
+
+			mClusterBounds[i] = clusterBounds;
+		}
+	}
+
+	void MultiViewVisibility::SortObjects(const Vector<AABox>& bounds)
+	{
+		const u32 numObjects = (u32)bounds.size();
+
+		// Order the objects along a Morton curve over the area they cover, so consecutive objects are close in space
+		Vector3 sceneMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+			std::numeric_limits<float>::max());
+		Vector3 sceneMax = -sceneMin;
+		for(auto& entry : bounds)
+		{
+			sceneMin = Vector3::Min(sceneMin, entry.GetCenter());
+			sceneMax = Vector3::Max(sceneMax, entry.GetCenter());
+		}
+
+		const Vector3 sceneSize = sceneMax - sceneMin;
+		const float maxSize = std::max(std::max(sceneSize.X, sceneSize.Y), std::max(sceneSize.Z, 0.001f));
+		const float scale = 1023.0f / maxSize;
+
+		mSortKeys.resize(numObjects);
+		for(u32 i = 0; i < numObjects; i++)
+		{
+			const Vector3 cell = (bounds[i].GetCenter() - sceneMin) * scale;
+			const u64 key = spreadBits((u64)cell.X) | (spreadBits((u64)cell.Y) << 1) | (spreadBits((u64)cell.Z) << 2);
+
+			mSortKeys[i] = std::make_pair(key, i);
+		}
+
+		std::sort(mSortKeys.begin(), mSortKeys.end());
+
+		mSortedObjects.resize(numObjects);
+		for(u32 i = 0; i < numObjects; i++)
+			mSortedObjects[i] = mSortKeys[i].second;
+	}
+
+	void MultiViewVisibility::Compute(const Vector<AABox>& bounds, Vector<u32>& masks)
+	{
+		const u32 numObjects = (u32)bounds.size();
+
+		mStats = MultiViewCullStats();
+		mStats.NumObjects = numObjects;
+		mStats.NumViews = mNumViews;
+
+		masks.assign(numObjects, 0);
+		if(numObjects == 0 || mNumViews == 0)
+			return;
+
+		BuildClusters(bounds);
+		mStats.NumClusters = (u32)mClusterBounds.size();
+
+		for(u32 i = 0; i < (u32)mClusterBounds.size(); i++)
+		{
+			const Vector3 clusterCenter = mClusterBounds[i].GetCenter();
+			const Vector3 clusterHalfSize = mClusterBounds[i].GetHalfSize();
+
+			// Views that fully contain the cluster, and views that partially intersect it
+			u32 insideMask = 0;
+			u32 intersectMask = 0;
+			for(u32 j = 0; j < mNumViews; j++)
+			{
+				const CullResult result = Classify(j, clusterCenter, clusterHalfSize);
+				if(result == CullResult::Inside)
+					insideMask |= 1 << j;
+				else if(result == CullResult::Intersecting)
+					intersectMask |= 1 << j;
+			}
+
+			mStats.NumClusterTests += mNumViews;
+
+			// Nothing in the cluster is visible in any of the views
+			if(insideMask == 0 && intersectMask == 0)
+				continue;
+
+			const u32 start = i * CLUSTER_SIZE;
+			const u32 end = std::min(start + CLUSTER_SIZE, numObjects);
+			for(u32 j = start; j < end; j++)
+			{
+				const u32 objectIdx = mSortedObjects[j];
+				const Vector3 center = bounds[objectIdx].GetCenter();
+				const Vector3 halfSize = bounds[objectIdx].GetHalfSize();
+
+				// Objects are visible in all views containing the whole cluster, and only need to be tested against the
+				// views intersecting it
+				u32 mask = insideMask;
+				for(u32 k = 0; k < mNumViews; k++)
+				{
+					if((intersectMask & (1 << k)) == 0)
+						continue;
+
+					if(Classify(k, center, halfSize) != CullResult::Outside)
+						mask |= 1 << k;
+
+					mStats.NumObjectTests++;
+				}
+
+				masks[objectIdx] = mask;
+			}
+		}
+
+		for(auto& mask : masks)
+		{
+			for(u32 i = 0; i < mNumViews; i++)
+				mStats.NumVisible[i] += (mask >> i) & 1;
+		}
+	}
+
+	void MultiViewVisibility::ComputePerView(const Vector<AABox>& bounds, Vector<u32>& masks)
+	{
+		const u32 numObjects = (u32)bounds.size();
+
+		mStats = MultiViewCullStats();
+		mStats.NumObjects = numObjects;
+		mStats.NumViews = mNumViews;
+
+		masks.assign(numObjects, 0);
+		for(u32 i = 0; i < mNumViews; i++)
+		{
+			for(u32 j = 0; j < numObjects; j++)
+			{
+				if(Classify(i, bounds[j].GetCenter(), bounds[j].GetHalfSize()) != CullResult::Outside)
+				{
+					masks[j] |= 1 << i;
+					mStats.NumVisible[i]++;
+				}
+			}
+
+			mStats.NumObjectTests += numObjects;
+		}
+	}
+
+	MultiViewCuller::MultiViewCuller(const HSceneObject& parent)
+		: Component(parent)
+	{
+		SetName("MultiViewCuller");
+	}
+
+	i32 MultiViewCuller::AddView(const HCamera& camera)
+	{
+		if((u32)mViews.size() >= MultiViewVisibility::MAX_VIEWS)
+			return -1;
+
+		const u32 viewIdx = (u32)mViews.size();
+		camera->SetLayers(GetViewLayers(viewIdx));
+
+		mViews.push_back(camera);
+		return (i32)viewIdx;
+	}
+
+	void MultiViewCuller::AddRenderable(const HRenderable& renderable)
+	{
+		mRenderables.push_back(renderable);
+
+		// Start with no views applied, so the layer is set on the first update
+		mAppliedMasks.push_back((u32)-1);
+	}
+
+	u64 MultiViewCuller::GetViewLayers(u32 viewIdx)
+	{
+		return (1ULL << (FIRST_VIEW_LAYER_BIT + viewIdx)) | ALWAYS_VISIBLE_LAYERS;
+	}
+
+	void MultiViewCuller::Update()
+	{
+		// Drop renderables that were destroyed since the last update
+		for(u32 i = 0; i < (u32)mRenderables.size();)
+		{
+			if(mRenderables[i].IsDestroyed())
+			{
+				mRenderables[i] = mRenderables.back();
+				mRenderables.pop_back();
+
+				mAppliedMasks[i] = mAppliedMasks.back();
+				mAppliedMasks.pop_back();
+			}
+			else
+				i++;
+		}
+
+		mFrustums.clear();
+		for(auto& camera : mViews)
+			mFrustums.push_back(camera->GetWorldFrustum());
+
+		mBounds.resize(mRenderables.size());
+		for(u32 i = 0; i < (u32)mRenderables.size(); i++)
+			mBounds[i] = mRenderables[i]->GetBounds().GetBox();
+
+		mVisibility.SetViews(mFrustums);
+		mVisibility.Compute(mBounds, mMasks);
+
+		// Changing the layer requires the renderable to be synced with the renderer, so only do it when visibility changed
+		for(u32 i = 0; i < (u32)mRenderables.size(); i++)
+		{
+			if(mMasks[i] == mAppliedMasks[i])
+				continue;
+
+			const u64 otherLayers = mRenderables[i]->GetLayer() & ~(ALWAYS_VISIBLE_LAYERS | VIEW_LAYERS);
+			mRenderables[i]->SetLayer(otherLayers | ((u64)mMasks[i] << FIRST_VIEW_LAYER_BIT));
+			mAppliedMasks[i] = mMasks[i];
+		}
+	}
+} // namespace bs
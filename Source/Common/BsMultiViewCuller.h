@@ -0,0 +1,150 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "Math/BsAABox.h"
+#include "Math/BsConvexVolume.h"
+
+namespace bs
+{
+	/** Counters describing the work done by a single MultiViewVisibility::Compute() call. */
+	struct MultiViewCullStats
+	{
+		u32 NumObjects = 0;
+		u32 NumViews = 0;
+		u32 NumClusters = 0;
+		u32 NumClusterTests = 0; /**< Cluster bounds tested against a view frustum. */
+		u32 NumObjectTests = 0; /**< Object bounds tested against a view frustum. */
+		u32 NumVisible[8] = {}; /**< Number of objects visible in each view, up to MultiViewVisibility::MAX_VIEWS. */
+	};
+
+	/**
+	 * Determines the visibility of a set of bounding boxes in multiple views at once. Instead of each view testing every
+	 * object, the objects are grouped into spatially coherent clusters, and the traversal over them is shared by all views.
+	 * Each cluster is classified against all view frustums. Its objects are only tested against views that partially
+	 * intersect it, and clusters outside of all views are skipped entirely.
+	 *
+	 * The output is a visibility bitmask per object, with a bit set for each view the object is visible in.
+	 */
+	class MultiViewVisibility
+	{
+	public:
+		/** Sets the frustums of the views to test visibility against, in world space. At most MAX_VIEWS are used. */
+		void SetViews(const Vector<ConvexVolume>& frustums);
+
+		/**
+		 * Computes the visibility of each of the provided world space bounds, writing the bitmask of views each one is
+		 * visible in into 'masks'. Consecutive calls are expected to provide the same objects in the same order, as long
+		 * as their number doesn't change.
+		 */
+		void Compute(const Vector<AABox>& bounds, Vector<u32>& masks);
+
+		/**
+		 * Computes the same result as Compute(), but by testing every object against every view separately. Used as a
+		 * reference for comparing the cost of the shared traversal against.
+		 */
+		void ComputePerView(const Vector<AABox>& bounds, Vector<u32>& masks);
+
+		/** Returns the counters of the last Compute() or ComputePerView() call. */
+		const MultiViewCullStats& GetStats() const { return mStats; }
+
+		/** Maximum number of views visibility can be computed for. */
+		static constexpr u32 MAX_VIEWS = 8;
+
+		/** Number of objects grouped in a single cluster. */
+		static constexpr u32 CLUSTER_SIZE = 32;
+
+		/** Number of Compute() calls after which the objects are re-sorted into new clusters. */
+		static constexpr u32 RESORT_INTERVAL = 30;
+
+	private:
+		/** Groups the objects into clusters of spatially close objects, and computes the cluster bounds. */
+		void BuildClusters(const Vector<AABox>& bounds);
+
+		/** Orders the objects so that consecutive objects are close in space. */
+		void SortObjects(const Vector<AABox>& bounds);
+
+		/** Single view frustum plane. The normal points towards the inside of the frustum. */
+		struct CullPlane
+		{
+			Vector3 Normal;
+			float D;
+		};
+
+		/** Result of classifying bounds against a frustum. */
+		enum class CullResult { Outside, Intersecting, Inside };
+
+		/** Classifies a box with the provided center and half-size against the frustum of the specified view. */
+		CullResult Classify(u32 viewIdx, const Vector3& center, const Vector3& halfSize) const;
+
+		Vector<CullPlane> mPlanes; /**< Planes of all views, stored consecutively. */
+		Vector<u32> mPlaneOffsets; /**< Index of the first plane of each view in mPlanes, followed by the total count. */
+		u32 mNumViews = 0;
+
+		Vector<u32> mSortedObjects; /**< Object indices, ordered so that objects in the same cluster are consecutive. */
+		Vector<AABox> mClusterBounds;
+		Vector<std::pair<u64, u32>> mSortKeys;
+		u32 mNumCallsSinceSort = 0;
+
+		MultiViewCullStats mStats;
+	};
+
+	/**
+	 * Component that culls a set of renderables against multiple cameras in a single pass (see MultiViewVisibility), such as
+	 * the cameras of a split-screen or picture-in-picture setup. The results are handed to the renderer through layers:
+	 * each camera gets its own layer bit, and each renderable's layer bits in the VIEW_LAYERS range are set to the bits of
+	 * the cameras it is visible in. The renderer still frustum culls every camera, but it rejects renderables whose layer
+	 * doesn't match the camera before testing their bounds, so each camera only tests the renderables in its view.
+	 *
+	 * The culler clears the ALWAYS_VISIBLE_LAYERS bits of registered renderables, since those would keep them visible in
+	 * all cameras. Layer bits above VIEW_LAYERS are preserved. Renderables that aren't registered with the culler, and
+	 * keep a layer within the ALWAYS_VISIBLE_LAYERS bits, remain visible in all the cameras.
+	 *
+	 * The component should be created after the components that move the cameras, so it updates after them and culls
+	 * against the camera transforms of the current frame.
+	 */
+	class MultiViewCuller : public Component
+	{
+	public:
+		MultiViewCuller(const HSceneObject& parent);
+
+		/** Triggered once per frame. Culls the renderables against all cameras and updates the renderable layers. */
+		void Update() override;
+
+		/**
+		 * Registers a camera to cull against, and assigns it its layers. Returns the index of the camera, or -1 if the
+		 * maximum number of cameras was reached.
+		 */
+		i32 AddView(const HCamera& camera);
+
+		/** Registers a renderable to cull. Destroyed renderables are unregistered automatically. */
+		void AddRenderable(const HRenderable& renderable);
+
+		/** Returns the layer mask assigned to the camera with the provided index. */
+		static u64 GetViewLayers(u32 viewIdx);
+
+		/** Returns the counters of the last culling pass. */
+		const MultiViewCullStats& GetStats() const { return mVisibility.GetStats(); }
+
+		/** First layer bit used for per-camera visibility. Lower bits are left for layers visible in all cameras. */
+		static constexpr u32 FIRST_VIEW_LAYER_BIT = 8;
+
+		/** Layers of renderables visible in all cameras, regardless of culling. */
+		static constexpr u64 ALWAYS_VISIBLE_LAYERS = (1ULL << FIRST_VIEW_LAYER_BIT) - 1;
+
+		/** Layers assigned by the culler, one bit per camera. */
+		static constexpr u64 VIEW_LAYERS = ((1ULL << MultiViewVisibility::MAX_VIEWS) - 1) << FIRST_VIEW_LAYER_BIT;
+
+	private:
+		Vector<HCamera> mViews;
+		Vector<HRenderable> mRenderables;
+		Vector<u32> mAppliedMasks; /**< Masks last applied to the renderable layers, to avoid redundant updates. */
+
+		MultiViewVisibility mVisibility;
+		Vector<ConvexVolume> mFrustums;
+		Vector<AABox> mBounds;
+		Vector<u32> mMasks;
+	};
+
+	using HMultiViewCuller = GameObjectHandle<MultiViewCuller>;
+} // namespace bs
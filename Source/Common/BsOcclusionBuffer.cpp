@@ -0,0 +1,476 @@
+#include "BsOcclusionBuffer.h"
+#include "BsOcclusionBufferImpl.h"
+#include "BsCpuFeatures.h"
+#include "Math/BsMath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define BS_OCCLUSION_BUFFER_NEON 1
+#else
+#	define BS_OCCLUSION_BUFFER_NEON 0
+#endif
+
+namespace bs
+{
+namespace
+{
+	/** Smallest view space depth of a rasterized vertex. Triangles are clipped against the plane at this depth. */
+	constexpr float NEAR_DEPTH = 0.001f;
+
+	/**
+	 * Relative amount an object must be behind the occluders to be considered hidden. Keeps occluders that are also
+	 * tested as occludees from hiding themselves due to rounding errors.
+	 */
+	constexpr float DEPTH_BIAS = 0.001f;
+
+#if BS_OCCLUSION_BUFFER_NEON
+	/** Group of 4 pixels processed together. */
+	struct RasterFloat4 { float32x4_t Value; };
+
+	inline RasterFloat4 operator+(RasterFloat4 lhs, RasterFloat4 rhs) { return { vaddq_f32(lhs.Value, rhs.Value) }; }
+	inline RasterFloat4 operator*(RasterFloat4 lhs, RasterFloat4 rhs) { return { vmulq_f32(lhs.Value, rhs.Value) }; }
+#endif
+
+	/** Returns the time passed since 'start', in milliseconds. */
+	float getElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+} // namespace
+
+#if BS_OCCLUSION_BUFFER_NEON
+	template<>
+	struct RasterLanes<RasterFloat4>
+	{
+		static constexpr u32 WIDTH = 4;
+
+		static RasterFloat4 Load(const float* data) { return { vld1q_f32(data) }; }
+		static void Store(float* data, RasterFloat4 value) { vst1q_f32(data, value.Value); }
+		static RasterFloat4 Set(float value) { return { vdupq_n_f32(value) }; }
+
+		static RasterFloat4 Offsets()
+		{
+			static const float offsets[] = { 0.0f, 1.0f, 2.0f, 3.0f };
+			return { vld1q_f32(offsets) };
+		}
+
+		static RasterFloat4 MaxIfInside(RasterFloat4 edge0, RasterFloat4 edge1, RasterFloat4 edge2, RasterFloat4 depth,
+			RasterFloat4 current)
+		{
+			const float32x4_t minEdge = vminq_f32(vminq_f32(edge0.Value, edge1.Value), edge2.Value);
+			const uint32x4_t inside = vcgeq_f32(minEdge, vdupq_n_f32(0.0f));
+			const float32x4_t closest = vmaxq_f32(depth.Value, current.Value);
+
+			return { vbslq_f32(inside, closest, current.Value) };
+		}
+	};
+#endif
+
+	SPtr<OccluderMesh> OccluderMesh::CreateBox(const AABox& box)
+	{
+		auto mesh = bs_shared_ptr_new<OccluderMesh>();
+
+		// Corner index bits 0, 1 and 2 select the maximum X, Y and Z coordinate, respectively
+		const Vector3& min = box.GetMin();
+		const Vector3& max = box.GetMax();
+		for(u32 i = 0; i < 8; i++)
+		{
+			mesh->Positions.push_back(Vector3(
+				(i & 1) ? max.X : min.X,
+				(i & 2) ? max.Y : min.Y,
+				(i & 4) ? max.Z : min.Z));
+		}
+
+		// Winding doesn't matter, as both sides of occluder triangles are rasterized
+		static const u32 faces[6][4] =
+		{
+			{ 0, 2, 6, 4 }, { 1, 5, 7, 3 }, // -X, +X
+			{ 0, 4, 5, 1 }, { 2, 3, 7, 6 }, // -Y, +Y
+			{ 0, 1, 3, 2 }, { 4, 6, 7, 5 } // -Z, +Z
+		};
+
+		for(auto& face : faces)
+		{
+			const u32 indices[] = { face[0], face[1], face[2], face[0], face[2], face[3] };
+			mesh->Indices.insert(mesh->Indices.end(), std::begin(indices), std::end(indices));
+		}
+
+		return mesh;
+	}
+
+	OcclusionBuffer::OcclusionBuffer(u32 width, u32 height)
+	{
+		mNumTilesX = std::max((width + TILE_WIDTH - 1) / TILE_WIDTH, 1U);
+		mNumTilesY = std::max((height + TILE_HEIGHT - 1) / TILE_HEIGHT, 1U);
+		mWidth = mNumTilesX * TILE_WIDTH;
+		mHeight = std::max(height, 1U);
+		mBins.resize(mNumTilesX * mNumTilesY);
+
+		// Each level halves the size of the previous one, down to a single pixel
+		u32 levelWidth = mWidth;
+		u32 levelHeight = mHeight;
+		while(true)
+		{
+			DepthLevel level;
+			level.Width = levelWidth;
+			level.Height = levelHeight;
+			level.Depth.resize(levelWidth * levelHeight, 0.0f);
+			mLevels.push_back(std::move(level));
+
+			if(levelWidth == 1 && levelHeight == 1)
+				break;
+
+			levelWidth = (levelWidth + 1) / 2;
+			levelHeight = (levelHeight + 1) / 2;
+		}
+	}
+
+	void OcclusionBuffer::Render(const Matrix4& viewProj, const Vector<OccluderInstance>& occluders)
+	{
+		mStats = OcclusionBufferStats();
+		mStats.NumOccluders = (u32)occluders.size();
+		mViewProj = viewProj;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for(auto& entry : occluders)
+			mStats.NumTriangles += (u32)entry.Mesh->Indices.size() / 3;
+
+		std::fill(mLevels[0].Depth.begin(), mLevels[0].Depth.end(), 0.0f);
+
+		for(auto& entry : mTriangles.GetAll())
+			entry.clear();
+
+		Jobs::ParallelFor(0, (u32)occluders.size(), 16, [this, &occluders](u32 begin, u32 end)
+		{
+			Vector<ScreenTriangle>& output = mTriangles.Get();
+			for(u32 i = begin; i < end; i++)
+				SetupTriangles(occluders[i], output);
+		});
+
+		// Bin the triangles into all the tiles their bounds overlap
+		for(auto& entry : mBins)
+			entry.clear();
+
+		for(auto& triangles : mTriangles.GetAll())
+		{
+			for(auto& triangle : triangles)
+			{
+				const u32 minTileX = (u32)triangle.MinX / TILE_WIDTH;
+				const u32 maxTileX = (u32)triangle.MaxX / TILE_WIDTH;
+				const u32 minTileY = (u32)triangle.MinY / TILE_HEIGHT;
+				const u32 maxTileY = (u32)triangle.MaxY / TILE_HEIGHT;
+
+				for(u32 y = minTileY; y <= maxTileY; y++)
+				{
+					for(u32 x = minTileX; x <= maxTileX; x++)
+						mBins[y * mNumTilesX + x].push_back(&triangle);
+				}
+			}
+
+			mStats.NumRasterizedTriangles += (u32)triangles.size();
+		}
+
+		mStats.SetupTime = getElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+
+		Jobs::ParallelFor(0, (u32)mBins.size(), 4, [this](u32 begin, u32 end)
+		{
+			for(u32 i = begin; i < end; i++)
+				RasterizeTile(i);
+		});
+
+		mStats.RasterTime = getElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+
+		BuildPyramid();
+
+		mStats.HiZTime = getElapsedMs(start);
+	}
+
+	void OcclusionBuffer::SetupTriangles(const OccluderInstance& occluder, Vector<ScreenTriangle>& output) const
+	{
+		const OccluderMesh& mesh = *occluder.Mesh;
+		const Matrix4 worldViewProj = mViewProj * occluder.Transform;
+
+		const u32 numVertices = (u32)mesh.Positions.size();
+		Vector4* clipPositions = (Vector4*)Jobs::GetScratch(numVertices * sizeof(Vector4));
+		for(u32 i = 0; i < numVertices; i++)
+		{
+			const Vector3& position = mesh.Positions[i];
+			clipPositions[i] = worldViewProj.Multiply(Vector4(position.X, position.Y, position.Z, 1.0f));
+		}
+
+		const u32 numIndices = (u32)mesh.Indices.size() / 3 * 3;
+		for(u32 i = 0; i < numIndices; i += 3)
+		{
+			const Vector4 vertices[] =
+			{
+				clipPositions[mesh.Indices[i + 0]],
+				clipPositions[mesh.Indices[i + 1]],
+				clipPositions[mesh.Indices[i + 2]]
+			};
+
+			u32 numInFront = 0;
+			for(auto& vertex : vertices)
+				numInFront += vertex.W >= NEAR_DEPTH ? 1 : 0;
+
+			if(numInFront == 0)
+				continue;
+
+			if(numInFront == 3)
+			{
+				SetupTriangle(vertices[0], vertices[1], vertices[2], output);
+				continue;
+			}
+
+			// Clip against the near plane. Clipping a triangle against a single plane results in at most four vertices.
+			Vector4 clipped[4];
+			u32 numClipped = 0;
+			for(u32 j = 0; j < 3; j++)
+			{
+				const Vector4& current = vertices[j];
+				const Vector4& next = vertices[(j + 1) % 3];
+
+				const bool currentInFront = current.W >= NEAR_DEPTH;
+				const bool nextInFront = next.W >= NEAR_DEPTH;
+
+				if(currentInFront)
+					clipped[numClipped++] = current;
+
+				if(currentInFront != nextInFront)
+				{
+					const float t = (NEAR_DEPTH - current.W) / (next.W - current.W);
+					clipped[numClipped++] = current + (next - current) * t;
+				}
+			}
+
+			for(u32 j = 2; j < numClipped; j++)
+				SetupTriangle(clipped[0], clipped[j - 1], clipped[j], output);
+		}
+	}
+
+	void OcclusionBuffer::SetupTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2,
+		Vector<ScreenTriangle>& output) const
+	{
+		// Project to pixel coordinates, with Y going down the screen
+		float x[3], y[3], depth[3];
+		const Vector4* vertices[] = { &v0, &v1, &v2 };
+		for(u32 i = 0; i < 3; i++)
+		{
+			const float invW = 1.0f / vertices[i]->W;
+
+			x[i] = (vertices[i]->X * invW * 0.5f + 0.5f) * mWidth;
+			y[i] = (0.5f - vertices[i]->Y * invW * 0.5f) * mHeight;
+			depth[i] = invW;
+		}
+
+		// Both sides are rasterized, so flip triangles facing away to keep the edge functions positive on the inside
+		float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+		if(area < 0.0f)
+		{
+			std::swap(x[1], x[2]);
+			std::swap(y[1], y[2]);
+			std::swap(depth[1], depth[2]);
+			area = -area;
+		}
+
+		if(area < 1e-6f)
+			return;
+
+		// Clamp before converting to integers, as vertices close to the near plane project far outside of the screen
+		const float minX = Math::Clamp(std::min(std::min(x[0], x[1]), x[2]), -1.0f, (float)mWidth);
+		const float maxX = Math::Clamp(std::max(std::max(x[0], x[1]), x[2]), -1.0f, (float)mWidth);
+		const float minY = Math::Clamp(std::min(std::min(y[0], y[1]), y[2]), -1.0f, (float)mHeight);
+		const float maxY = Math::Clamp(std::max(std::max(y[0], y[1]), y[2]), -1.0f, (float)mHeight);
+
+		ScreenTriangle triangle;
+		triangle.MinX = std::max((i32)std::floor(minX), 0);
+		triangle.MaxX = std::min((i32)std::floor(maxX), (i32)mWidth - 1);
+		triangle.MinY = std::max((i32)std::floor(minY), 0);
+		triangle.MaxY = std::min((i32)std::floor(maxY), (i32)mHeight - 1);
+
+		if(triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+			return;
+
+		// Edge opposite to each vertex, positive on the side of the vertex
+		for(u32 i = 0; i < 3; i++)
+		{
+			const u32 a = (i + 1) % 3;
+			const u32 b = (i + 2) % 3;
+
+			triangle.EdgeA[i] = y[a] - y[b];
+			triangle.EdgeB[i] = x[b] - x[a];
+			triangle.EdgeC[i] = -(triangle.EdgeA[i] * x[a] + triangle.EdgeB[i] * y[a]);
+		}
+
+		// Reciprocal depth is linear in screen space, so it can be interpolated using a plane equation
+		triangle.DepthA = ((depth[1] - depth[0]) * (y[2] - y[0]) - (depth[2] - depth[0]) * (y[1] - y[0])) / area;
+		triangle.DepthB = ((depth[2] - depth[0]) * (x[1] - x[0]) - (depth[1] - depth[0]) * (x[2] - x[0])) / area;
+		triangle.DepthC = depth[0] - triangle.DepthA * x[0] - triangle.DepthB * y[0];
+
+		output.push_back(triangle);
+	}
+
+	void OcclusionBuffer::RasterizeTile(u32 tileIdx)
+	{
+		const i32 tileMinX = (i32)((tileIdx % mNumTilesX) * TILE_WIDTH);
+		const i32 tileMinY = (i32)((tileIdx / mNumTilesX) * TILE_HEIGHT);
+		const i32 tileMaxX = tileMinX + (i32)TILE_WIDTH - 1;
+		const i32 tileMaxY = std::min(tileMinY + (i32)TILE_HEIGHT - 1, (i32)mHeight - 1);
+
+		// Pick the widest row rasterizer available
+#if BS_COMMON_AVX2
+		const bool useAVX2 = CpuFeatures::HasAVX2();
+		const i32 groupWidth = useAVX2 ? (i32)RASTER_AVX2_WIDTH : 1;
+#elif BS_OCCLUSION_BUFFER_NEON
+		const i32 groupWidth = (i32)RasterLanes<RasterFloat4>::WIDTH;
+#else
+		const i32 groupWidth = 1;
+#endif
+
+		float* depth = mLevels[0].Depth.data();
+		for(auto& triangle : mBins[tileIdx])
+		{
+			const i32 minX = std::max(triangle->MinX, tileMinX);
+			const i32 maxX = std::min(triangle->MaxX, tileMaxX);
+			const i32 minY = std::max(triangle->MinY, tileMinY);
+			const i32 maxY = std::min(triangle->MaxY, tileMaxY);
+
+			// Start at a whole group of pixels. Tiles are a multiple of the group size, so groups never leave the tile,
+			// and pixels outside the triangle are rejected by the edge functions.
+			const i32 startX = minX - minX % groupWidth;
+
+			RasterTriangle rasterTriangle;
+			rasterTriangle.EdgeA = triangle->EdgeA;
+			rasterTriangle.EdgeB = triangle->EdgeB;
+			rasterTriangle.EdgeC = triangle->EdgeC;
+			rasterTriangle.DepthA = triangle->DepthA;
+			rasterTriangle.DepthB = triangle->DepthB;
+			rasterTriangle.DepthC = triangle->DepthC;
+
+#if BS_COMMON_AVX2
+			if(useAVX2)
+				rasterizeRowsAVX2(depth, mWidth, startX, maxX, minY, maxY, rasterTriangle);
+			else
+				rasterizeRows<float>(depth, mWidth, startX, maxX, minY, maxY, rasterTriangle);
+#elif BS_OCCLUSION_BUFFER_NEON
+			rasterizeRows<RasterFloat4>(depth, mWidth, startX, maxX, minY, maxY, rasterTriangle);
+#else
+			rasterizeRows<float>(depth, mWidth, startX, maxX, minY, maxY, rasterTriangle);
+#endif
+		}
+	}
+
+	void OcclusionBuffer::BuildPyramid()
+	{
+		// Each pixel keeps the farthest (smallest) depth of the up to four pixels it covers in the previous level
+		for(u32 i = 1; i < (u32)mLevels.size(); i++)
+		{
+			const DepthLevel& source = mLevels[i - 1];
+			DepthLevel& destination = mLevels[i];
+
+			Jobs::ParallelFor(0, destination.Height, 16, [&source, &destination](u32 begin, u32 end)
+			{
+				for(u32 y = begin; y < end; y++)
+				{
+					const u32 sourceY0 = y * 2;
+					const u32 sourceY1 = std::min(sourceY0 + 1, source.Height - 1);
+
+					for(u32 x = 0; x < destination.Width; x++)
+					{
+						const u32 sourceX0 = x * 2;
+						const u32 sourceX1 = std::min(sourceX0 + 1, source.Width - 1);
+
+						const float depth = std::min(
+							std::min(source.Depth[sourceY0 * source.Width + sourceX0], source.Depth[sourceY0 * source.Width + sourceX1]),
+							std::min(source.Depth[sourceY1 * source.Width + sourceX0], source.Depth[sourceY1 * source.Width + sourceX1]));
+
+						destination.Depth[y * destination.Width + x] = depth;
+					}
+				}
+			});
+		}
+	}
+
+	bool OcclusionBuffer::IsVisible(const AABox& bounds) const
+	{
+		const Vector3& min = bounds.GetMin();
+		const Vector3& max = bounds.GetMax();
+
+		float minX = std::numeric_limits<float>::max();
+		float minY = std::numeric_limits<float>::max();
+		float maxX = -std::numeric_limits<float>::max();
+		float maxY = -std::numeric_limits<float>::max();
+		float closestDepth = 0.0f;
+
+		for(u32 i = 0; i < 8; i++)
+		{
+			const Vector4 corner(
+				(i & 1) ? max.X : min.X,
+				(i & 2) ? max.Y : min.Y,
+				(i & 4) ? max.Z : min.Z,
+				1.0f);
+
+			const Vector4 clipPosition = mViewProj.Multiply(corner);
+
+			// Bounds crossing the near plane are too close to the viewer to be reliably tested
+			if(clipPosition.W < NEAR_DEPTH)
+				return true;
+
+			const float invW = 1.0f / clipPosition.W;
+			const float x = (clipPosition.X * invW * 0.5f + 0.5f) * mWidth;
+			const float y = (0.5f - clipPosition.Y * invW * 0.5f) * mHeight;
+
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+			minY = std::min(minY, y);
+			maxY = std::max(maxY, y);
+			closestDepth = std::max(closestDepth, invW);
+		}
+
+		// Bounds outside of the screen are left to frustum culling
+		if(maxX < 0.0f || maxY < 0.0f || minX >= (float)mWidth || minY >= (float)mHeight)
+			return true;
+
+		const i32 pixelMinX = std::max((i32)std::floor(minX), 0);
+		const i32 pixelMinY = std::max((i32)std::floor(minY), 0);
+		const i32 pixelMaxX = std::min((i32)std::floor(maxX), (i32)mWidth - 1);
+		const i32 pixelMaxY = std::min((i32)std::floor(maxY), (i32)mHeight - 1);
+
+		// Pick the level at which the bounds cover at most a few pixels in each direction
+		const i32 size = std::max(pixelMaxX - pixelMinX, pixelMaxY - pixelMinY);
+		u32 levelIdx = 0;
+		while((size >> levelIdx) > 1 && levelIdx + 1 < (u32)mLevels.size())
+			levelIdx++;
+
+		const DepthLevel& level = mLevels[levelIdx];
+		const float biasedDepth = closestDepth * (1.0f + DEPTH_BIAS);
+		for(i32 y = pixelMinY >> levelIdx; y <= (pixelMaxY >> levelIdx); y++)
+		{
+			for(i32 x = pixelMinX >> levelIdx; x <= (pixelMaxX >> levelIdx); x++)
+			{
+				// Visible if the closest point of the bounds is in front of the farthest occluder in the area
+				if(biasedDepth >= level.Depth[y * level.Width + x])
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	void OcclusionBuffer::TestVisibility(const Vector<AABox>& bounds, Vector<u8>& visible) const
+	{
+		visible.resize(bounds.size());
+
+		Jobs::ParallelFor(0, (u32)bounds.size(), 256, [this, &bounds, &visible](u32 begin, u32 end)
+		{
+			for(u32 i = begin; i < end; i++)
+				visible[i] = IsVisible(bounds[i]) ? 1 : 0;
+		});
+	}
+} // namespace bs
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsVector3.h"
+#include "Math/BsVector4.h"
+#include "Math/BsMatrix4.h"
+#include "Math/BsAABox.h"
+#include "BsJobs.h"
+
+namespace bs
+{
+	/**
+	 * Simplified geometry of an object, rasterized into an OcclusionBuffer. Should be a closed mesh lying fully inside the
+	 * object it represents, or the object will hide things that should be visible around its edges.
+	 */
+	struct OccluderMesh
+	{
+		Vector<Vector3> Positions; /**< Vertex positions, in the local space of the object. */
+		Vector<u32> Indices; /**< Three indices per triangle. */
+
+		/** Creates a box occluder, matching the provided local space bounds. */
+		static SPtr<OccluderMesh> CreateBox(const AABox& box);
+	};
+
+	/** Occluder mesh placed in the world. */
+	struct OccluderInstance
+	{
+		const OccluderMesh* Mesh = nullptr;
+		Matrix4 Transform; /**< Local to world transform of the mesh. */
+	};
+
+	/** Counters and timings describing the last OcclusionBuffer::Render() call. */
+	struct OcclusionBufferStats
+	{
+		u32 NumOccluders = 0;
+		u32 NumTriangles = 0; /**< Triangles of all occluder meshes. */
+		u32 NumRasterizedTriangles = 0; /**< Triangles remaining after clipping and culling of off-screen triangles. */
+		float SetupTime = 0.0f; /**< Time spent transforming, clipping and binning triangles, in milliseconds. */
+		float RasterTime = 0.0f; /**< Time spent rasterizing the triangles into the depth buffer, in milliseconds. */
+		float HiZTime = 0.0f; /**< Time spent building the hierarchical depth pyramid, in milliseconds. */
+	};
+
+	/**
+	 * Low resolution depth buffer rendered on the CPU, used for determining whether objects are hidden behind occluders
+	 * before they are submitted for rendering.
+	 *
+	 * Occluder triangles are transformed and clipped, then binned into screen tiles. The tiles are rasterized in parallel
+	 * on the job system, each touching only its own part of the buffer, so no synchronization is needed. Rows of pixels
+	 * are rasterized several at a time using AVX2 (if the CPU supports it) or NEON, with scalar code used otherwise.
+	 *
+	 * The buffer stores the reciprocal of the view space depth, so larger values are closer to the viewer and the empty
+	 * buffer is zero. Once rasterized, the buffer is reduced into a hierarchical depth pyramid storing the farthest depth
+	 * of each area. Testing bounds then only needs to read a few texels of the level matching their size on screen.
+	 */
+	class OcclusionBuffer
+	{
+	public:
+		/** Creates a buffer of the specified size, in pixels. The width is rounded up to a multiple of TILE_WIDTH. */
+		OcclusionBuffer(u32 width = DEFAULT_WIDTH, u32 height = DEFAULT_HEIGHT);
+
+		/**
+		 * Clears the buffer and rasterizes the provided occluders into it, as seen through the view-projection matrix.
+		 * Then builds the depth pyramid used by IsVisible().
+		 */
+		void Render(const Matrix4& viewProj, const Vector<OccluderInstance>& occluders);
+
+		/**
+		 * Returns false if the world space bounds are fully hidden behind the occluders of the last Render() call. Bounds
+		 * intersecting the near plane or outside of the screen are reported as visible. Can be called from multiple
+		 * threads at once.
+		 */
+		bool IsVisible(const AABox& bounds) const;
+
+		/** Tests the visibility of all the provided bounds, splitting the work across the job system. */
+		void TestVisibility(const Vector<AABox>& bounds, Vector<u8>& visible) const;
+
+		/** Returns the counters of the last Render() call. */
+		const OcclusionBufferStats& GetStats() const { return mStats; }
+
+		/** Returns the width of the buffer, in pixels. */
+		u32 GetWidth() const { return mWidth; }
+
+		/** Returns the height of the buffer, in pixels. */
+		u32 GetHeight() const { return mHeight; }
+
+		/** Returns the depth value of a pixel in the specified level of the depth pyramid (0 being the full resolution). */
+		float GetDepth(u32 level, u32 x, u32 y) const { return mLevels[level].Depth[y * mLevels[level].Width + x]; }
+
+		/** Returns the number of levels in the depth pyramid. */
+		u32 GetNumLevels() const { return (u32)mLevels.size(); }
+
+		static constexpr u32 DEFAULT_WIDTH = 320;
+		static constexpr u32 DEFAULT_HEIGHT = 192;
+
+		/** Size of the screen tiles triangles are binned into, in pixels. */
+		static constexpr u32 TILE_WIDTH = 32;
+		static constexpr u32 TILE_HEIGHT = 16;
+
+	private:
+		/** Triangle in screen space, ready for rasterization. */
+		struct ScreenTriangle
+		{
+			float EdgeA[3], EdgeB[3], EdgeC[3]; /**< Edge functions, positive inside the triangle. */
+			float DepthA, DepthB, DepthC; /**< Plane equation of the depth across the triangle. */
+			i32 MinX, MinY, MaxX, MaxY; /**< Bounds of the triangle on screen, inclusive. */
+		};
+
+		/** Single level of the depth pyramid. */
+		struct DepthLevel
+		{
+			u32 Width = 0;
+			u32 Height = 0;
+			Vector<float> Depth;
+		};
+
+		/**
+		 * Transforms the triangles of a single occluder into screen space, clips them against the near plane and appends
+		 * the ones that are on screen to 'output'.
+		 */
+		void SetupTriangles(const OccluderInstance& occluder, Vector<ScreenTriangle>& output) const;
+
+		/** Sets up a single triangle that is fully in front of the near plane, and appends it to 'output' if on screen. */
+		void SetupTriangle(const Vector4& v0, const Vector4& v1, const Vector4& v2, Vector<ScreenTriangle>& output) const;
+
+		/** Rasterizes all triangles binned into the specified tile. */
+		void RasterizeTile(u32 tileIdx);
+
+		/** Builds the levels of the depth pyramid from the rasterized depth. */
+		void BuildPyramid();
+
+		u32 mWidth;
+		u32 mHeight;
+		u32 mNumTilesX;
+		u32 mNumTilesY;
+
+		Matrix4 mViewProj;
+		Vector<DepthLevel> mLevels; /**< Level 0 is the rasterized depth buffer. */
+
+		PerWorker<Vector<ScreenTriangle>> mTriangles; /**< Set up triangles, one list per thread. */
+		Vector<Vector<const ScreenTriangle*>> mBins; /**< Triangles overlapping each tile. */
+
+		OcclusionBufferStats mStats;
+	};
+} // namespace bs
@@ -0,0 +1,44 @@
+#include "BsOcclusionBufferImpl.h"
+
+// Only compiled with AVX2 enabled on x86 targets, see Common/CMakeLists.txt
+#if BS_COMMON_AVX2
+#include <immintrin.h>
+
+namespace bs
+{
+namespace
+{
+	/** Group of 8 pixels processed together. */
+	struct Float8 { __m256 Value; };
+
+	inline Float8 operator+(Float8 lhs, Float8 rhs) { return { _mm256_add_ps(lhs.Value, rhs.Value) }; }
+	inline Float8 operator*(Float8 lhs, Float8 rhs) { return { _mm256_mul_ps(lhs.Value, rhs.Value) }; }
+} // namespace
+
+	template<>
+	struct RasterLanes<Float8>
+	{
+		static constexpr u32 WIDTH = RASTER_AVX2_WIDTH;
+
+		static Float8 Load(const float* data) { return { _mm256_loadu_ps(data) }; }
+		static void Store(float* data, Float8 value) { _mm256_storeu_ps(data, value.Value); }
+		static Float8 Set(float value) { return { _mm256_set1_ps(value) }; }
+		static Float8 Offsets() { return { _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f) }; }
+
+		static Float8 MaxIfInside(Float8 edge0, Float8 edge1, Float8 edge2, Float8 depth, Float8 current)
+		{
+			const __m256 minEdge = _mm256_min_ps(_mm256_min_ps(edge0.Value, edge1.Value), edge2.Value);
+			const __m256 inside = _mm256_cmp_ps(minEdge, _mm256_setzero_ps(), _CMP_GE_OQ);
+			const __m256 closest = _mm256_max_ps(depth.Value, current.Value);
+
+			return { _mm256_blendv_ps(current.Value, closest, inside) };
+		}
+	};
+
+	void rasterizeRowsAVX2(float* depth, u32 rowPitch, i32 startX, i32 endX, i32 minY, i32 maxY,
+		const RasterTriangle& triangle)
+	{
+		rasterizeRows<Float8>(depth, rowPitch, startX, endX, minY, maxY, triangle);
+	}
+} // namespace bs
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+// Row rasterizer used by OcclusionBuffer. Kept separate so it can be compiled both in BsOcclusionBuffer.cpp (scalar and
+// NEON) and in BsOcclusionBufferAVX2.cpp (AVX2). Only meant to be included by those two files.
+
+namespace bs
+{
+	/**
+	 * Operations on a group of pixels rasterized together. The row rasterizer is written once against this interface,
+	 * and instantiated for SIMD registers, or for plain floats on targets without SIMD support. Specializations for SIMD
+	 * registers are provided by the files using them.
+	 */
+	template<class T>
+	struct RasterLanes
+	{
+		static constexpr u32 WIDTH = 1;
+
+		static T Load(const float* data) { return *data; }
+		static void Store(float* data, T value) { *data = value; }
+		static T Set(float value) { return value; }
+
+		/** Returns offsets of the pixels in the group from the first one. */
+		static T Offsets() { return 0.0f; }
+
+		/** Returns max('depth', 'current') for pixels where all edge functions are non-negative, 'current' otherwise. */
+		static T MaxIfInside(T edge0, T edge1, T edge2, T depth, T current)
+		{
+			const bool inside = edge0 >= 0.0f && edge1 >= 0.0f && edge2 >= 0.0f;
+			return inside && depth > current ? depth : current;
+		}
+	};
+
+	/** Screen space triangle passed to the row rasterizer, see OcclusionBuffer::ScreenTriangle. */
+	struct RasterTriangle
+	{
+		const float* EdgeA;
+		const float* EdgeB;
+		const float* EdgeC;
+		float DepthA, DepthB, DepthC;
+	};
+
+	/**
+	 * Rasterizes rows ['minY', 'maxY'] of a triangle, covering pixels in range ['startX', 'endX'] of each row, processing
+	 * as many pixels at once as the lane type allows. 'startX' must be a multiple of the lane width, and the rows must
+	 * have room for whole groups of pixels up to 'endX'.
+	 */
+	template<class T>
+	void rasterizeRows(float* depth, u32 rowPitch, i32 startX, i32 endX, i32 minY, i32 maxY,
+		const RasterTriangle& triangle)
+	{
+		using L = RasterLanes<T>;
+
+		const float* edgeA = triangle.EdgeA;
+		const float* edgeB = triangle.EdgeB;
+		const float* edgeC = triangle.EdgeC;
+
+		// Evaluate at pixel centers
+		const float x = startX + 0.5f;
+		const T offsets = L::Offsets();
+
+		const T edgeStep0 = L::Set(edgeA[0] * L::WIDTH);
+		const T edgeStep1 = L::Set(edgeA[1] * L::WIDTH);
+		const T edgeStep2 = L::Set(edgeA[2] * L::WIDTH);
+		const T depthStep = L::Set(triangle.DepthA * L::WIDTH);
+
+		for(i32 y = minY; y <= maxY; y++)
+		{
+			float* row = depth + y * rowPitch;
+			const float py = y + 0.5f;
+
+			T edge0 = L::Set(edgeA[0] * x + edgeB[0] * py + edgeC[0]) + L::Set(edgeA[0]) * offsets;
+			T edge1 = L::Set(edgeA[1] * x + edgeB[1] * py + edgeC[1]) + L::Set(edgeA[1]) * offsets;
+			T edge2 = L::Set(edgeA[2] * x + edgeB[2] * py + edgeC[2]) + L::Set(edgeA[2]) * offsets;
+			T pixelDepth = L::Set(triangle.DepthA * x + triangle.DepthB * py + triangle.DepthC) +
+				L::Set(triangle.DepthA) * offsets;
+
+			for(i32 i = startX; i <= endX; i += L::WIDTH)
+			{
+				const T current = L::Load(row + i);
+				L::Store(row + i, L::MaxIfInside(edge0, edge1, edge2, pixelDepth, current));
+
+				edge0 = edge0 + edgeStep0;
+				edge1 = edge1 + edgeStep1;
+				edge2 = edge2 + edgeStep2;
+				pixelDepth = pixelDepth + depthStep;
+			}
+		}
+	}
+
+#if BS_COMMON_AVX2
+	/** Number of pixels rasterizeRowsAVX2() processes at once. */
+	static constexpr u32 RASTER_AVX2_WIDTH = 8;
+
+	/**
+	 * Version of rasterizeRows() processing 8 pixels at once using AVX2. Defined in BsOcclusionBufferAVX2.cpp. Must only
+	 * be called if CpuFeatures::HasAVX2() is true.
+	 */
+	void rasterizeRowsAVX2(float* depth, u32 rowPitch, i32 startX, i32 endX, i32 minY, i32 maxY,
+		const RasterTriangle& triangle);
+#endif
+} // namespace bs
@@ -0,0 +1,131 @@
+#include "BsOcclusionCuller.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCCamera.h"
+#include "Components/BsCRenderable.h"
+#include "Debug/BsDebug.h"
+#include <chrono>
+
+namespace bs
+{
+	OcclusionCuller::OcclusionCuller(const HSceneObject& parent, const HCamera& camera)
+		: Component(parent), mCamera(camera)
+	{
+		SetName("OcclusionCuller");
+	}
+
+	void OcclusionCuller::Update()
+	{
+		// Drop objects that were destroyed since the last update
+		for(u32 i = 0; i < (u32)mOccluders.size();)
+		{
+			if(mOccluders[i].SceneObject.IsDestroyed())
+			{
+				mOccluders[i] = mOccluders.back();
+				mOccluders.pop_back();
+			}
+			else
+				i++;
+		}
+
+		for(u32 i = 0; i < (u32)mOccludees.size();)
+		{
+			if(mOccludees[i].Renderable.IsDestroyed())
+			{
+				mOccludees[i] = mOccludees.back();
+				mOccludees.pop_back();
+			}
+			else
+				i++;
+		}
+
+		if(!mEnabled)
+			return;
+
+		mOccluderInstances.resize(mOccluders.size());
+		for(u32 i = 0; i < (u32)mOccluders.size(); i++)
+		{
+			mOccluderInstances[i].Mesh = mOccluders[i].Mesh.get();
+			mOccluderInstances[i].Transform = mOccluders[i].SceneObject->GetWorldMatrix();
+		}
+
+		const Matrix4 viewProj = mCamera->GetProjectionMatrix() * mCamera->GetViewMatrix();
+		mBuffer.Render(viewProj, mOccluderInstances);
+
+		const auto testStart = std::chrono::steady_clock::now();
+
+		mBounds.resize(mOccludees.size());
+		for(u32 i = 0; i < (u32)mOccludees.size(); i++)
+			mBounds[i] = mOccludees[i].Renderable->GetBounds().GetBox();
+
+		mBuffer.TestVisibility(mBounds, mVisible);
+
+		u32 numOccluded = 0;
+		for(u32 i = 0; i < (u32)mOccludees.size(); i++)
+		{
+			const bool occluded = mVisible[i] == 0;
+			SetOccluded(mOccludees[i], occluded);
+
+			numOccluded += occluded ? 1 : 0;
+		}
+
+		mStats.Buffer = mBuffer.GetStats();
+		mStats.NumOccludees = (u32)mOccludees.size();
+		mStats.NumOccluded = numOccluded;
+		mStats.TestTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - testStart).count();
+
+		mNumFrames++;
+		mTotalOccluded += mStats.NumOccluded;
+		mTotalOccludees += mStats.NumOccludees;
+		mTotalTime += mStats.GetTotalTime();
+	}
+
+	void OcclusionCuller::OnDestroyed()
+	{
+		SetEnabled(false);
+
+		if(mNumFrames == 0)
+			return;
+
+		BS_LOG(Info, Uncategorized, "Occlusion culling: " + toString(mTotalOccluded / (double)mNumFrames) + " of " +
+			toString(mTotalOccludees / (double)mNumFrames) + " objects culled on average, in " +
+			toString(mTotalTime / mNumFrames) + " ms per frame");
+	}
+
+	void OcclusionCuller::AddOccluder(const HSceneObject& sceneObject, const SPtr<OccluderMesh>& mesh)
+	{
+		mOccluders.push_back({ sceneObject, mesh });
+	}
+
+	void OcclusionCuller::AddOccludee(const HRenderable& renderable)
+	{
+		mOccludees.push_back({ renderable, renderable->GetLayer(), false });
+	}
+
+	void OcclusionCuller::SetEnabled(bool enabled)
+	{
+		if(mEnabled == enabled)
+			return;
+
+		mEnabled = enabled;
+		if(!mEnabled)
+		{
+			for(auto& entry : mOccludees)
+			{
+				if(!entry.Renderable.IsDestroyed())
+					SetOccluded(entry, false);
+			}
+
+			mStats = OcclusionCullStats();
+		}
+	}
+
+	void OcclusionCuller::SetOccluded(Occludee& occludee, bool occluded)
+	{
+		if(occludee.Occluded == occluded)
+			return;
+
+		// Renderables are only drawn by cameras sharing at least one of their layers, so no layers hides them from all
+		occludee.Renderable->SetLayer(occluded ? 0 : occludee.Layer);
+		occludee.Occluded = occluded;
+	}
+} // namespace bs
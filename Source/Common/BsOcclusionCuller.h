@@ -0,0 +1,110 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "BsOcclusionBuffer.h"
+
+namespace bs
+{
+	/** Counters and timings describing the last culling pass of an OcclusionCuller. */
+	struct OcclusionCullStats
+	{
+		OcclusionBufferStats Buffer; /**< Rasterization of the occluders. */
+		u32 NumOccludees = 0;
+		u32 NumOccluded = 0; /**< Occludees found to be hidden behind the occluders. */
+		float TestTime = 0.0f; /**< Time spent testing the occludees, in milliseconds. */
+
+		/** Returns the total time spent on occlusion culling, in milliseconds. */
+		float GetTotalTime() const { return Buffer.SetupTime + Buffer.RasterTime + Buffer.HiZTime + TestTime; }
+	};
+
+	/**
+	 * Component that hides renderables blocked from a camera's view by other objects, before they are submitted for
+	 * rendering. Designated occluders (large objects such as walls and stacks of boxes) are rasterized into a low
+	 * resolution depth buffer on the CPU every frame (see OcclusionBuffer), and the bounds of the registered occludees are
+	 * tested against it.
+	 *
+	 * Hidden occludees are excluded from rendering by changing their layer to zero, and get their original layer back once
+	 * visible again. The layer of a registered renderable should not be changed elsewhere, and the same renderable should
+	 * not be registered with other components controlling the layer (e.g. MultiViewCuller).
+	 *
+	 * The component should be created after the components that move the camera, so it updates after them and culls
+	 * against the camera transform of the current frame.
+	 */
+	class OcclusionCuller : public Component
+	{
+	public:
+		/**
+		 * Constructs the culler.
+		 *
+		 * @param	parent		Scene object the component is attached to.
+		 * @param	camera		Camera to cull the occludees for.
+		 */
+		OcclusionCuller(const HSceneObject& parent, const HCamera& camera);
+
+		/** Triggered once per frame. Rasterizes the occluders, tests the occludees and updates their layers. */
+		void Update() override;
+
+		/** Triggered when the component is destroyed. Restores the occludee layers and logs the average statistics. */
+		void OnDestroyed() override;
+
+		/**
+		 * Registers an occluder. The mesh is placed using the world transform of the scene object, and stops being
+		 * rasterized once the scene object is destroyed.
+		 */
+		void AddOccluder(const HSceneObject& sceneObject, const SPtr<OccluderMesh>& mesh);
+
+		/** Registers a renderable to be hidden when occluded. Destroyed renderables are unregistered automatically. */
+		void AddOccludee(const HRenderable& renderable);
+
+		/** Enables or disables culling. When disabled all the occludees are visible. */
+		void SetEnabled(bool enabled);
+
+		/** Checks is culling enabled. */
+		bool IsEnabled() const { return mEnabled; }
+
+		/** Returns the counters of the last culling pass. */
+		const OcclusionCullStats& GetStats() const { return mStats; }
+
+		/** Returns the depth buffer the occluders were rasterized into. */
+		const OcclusionBuffer& GetBuffer() const { return mBuffer; }
+
+	private:
+		/** Occluder mesh attached to a scene object. */
+		struct Occluder
+		{
+			HSceneObject SceneObject;
+			SPtr<OccluderMesh> Mesh;
+		};
+
+		/** Renderable hidden when occluded. */
+		struct Occludee
+		{
+			HRenderable Renderable;
+			u64 Layer; /**< Layer of the renderable when visible. */
+			bool Occluded;
+		};
+
+		/** Shows or hides an occludee, if its state changed. */
+		void SetOccluded(Occludee& occludee, bool occluded);
+
+		HCamera mCamera;
+		bool mEnabled = true;
+
+		Vector<Occluder> mOccluders;
+		Vector<Occludee> mOccludees;
+
+		OcclusionBuffer mBuffer;
+		Vector<OccluderInstance> mOccluderInstances;
+		Vector<AABox> mBounds;
+		Vector<u8> mVisible;
+
+		OcclusionCullStats mStats;
+		u64 mNumFrames = 0;
+		u64 mTotalOccluded = 0;
+		u64 mTotalOccludees = 0;
+		double mTotalTime = 0.0;
+	};
+
+	using HOcclusionCuller = GameObjectHandle<OcclusionCuller>;
+} // namespace bs
@@ -0,0 +1,269 @@
+#include "BsParticleMemoryPool.h"
+
+namespace bs
+{
+	/** Returns the base-2 logarithm of the smallest power of two larger or equal to 'value'. */
+	static u32 ceilLog2(u32 value)
+	{
+		u32 log2 = 0;
+		while((1ULL << log2) < value)
+			log2++;
+
+		return log2;
+	}
+
+	ParticleMemoryPool::ParticleMemoryPool(u32 minChunkSize, u32 maxChunkSize, u32 pageSize)
+		: mMinChunkSizeLog2(ceilLog2(std::max(minChunkSize, 16U))), mPageSize(pageSize)
+	{
+		const u32 maxChunkSizeLog2 = std::max(ceilLog2(maxChunkSize), mMinChunkSizeLog2);
+
+		mSizeClasses.resize(maxChunkSizeLog2 - mMinChunkSizeLog2 + 1);
+		for(u32 i = 0; i < (u32)mSizeClasses.size(); i++)
+			mSizeClasses[i].ChunkSize = 1U << (mMinChunkSizeLog2 + i);
+	}
+
+	ParticleMemoryPool::~ParticleMemoryPool()
+	{
+		BS_ASSERT(mStats.NumBorrowed == 0 && "Particle buffers are still borrowed from a pool being destroyed.");
+
+		for(auto& sizeClass : mSizeClasses)
+		{
+			for(auto& page : sizeClass.Pages)
+				bs_free_aligned16(page.Data);
+		}
+	}
+
+	u8* ParticleMemoryPool::Borrow(u32 size)
+	{
+		if(size == 0)
+			return nullptr;
+
+		Lock lock(mMutex);
+
+		const u32 sizeClassIdx = GetSizeClassIdx(size);
+		if(sizeClassIdx == (u32)-1)
+		{
+			// Too large for any size class, fall back to the heap. Still counted as pool memory, so the stats show
+			// everything the particle systems use.
+			mStats.NumOversizedAllocations++;
+			mStats.NumBorrowed++;
+			mStats.ReservedBytes += size;
+			mStats.UsedBytes += size;
+			mStats.RequestedBytes += size;
+			mStats.PeakUsedBytes = std::max(mStats.PeakUsedBytes, mStats.UsedBytes);
+
+			return (u8*)bs_alloc_aligned16(size);
+		}
+
+		SizeClass& sizeClass = mSizeClasses[sizeClassIdx];
+		if(sizeClass.FreeChunks.empty())
+			AllocatePage(sizeClass);
+
+		u8* data = sizeClass.FreeChunks.back();
+		sizeClass.FreeChunks.pop_back();
+
+		FindPage(sizeClass, data)->NumFree--;
+
+		mStats.NumBorrowed++;
+		mStats.UsedBytes += sizeClass.ChunkSize;
+		mStats.RequestedBytes += size;
+		mStats.PeakUsedBytes = std::max(mStats.PeakUsedBytes, mStats.UsedBytes);
+
+		return data;
+	}
+
+	void ParticleMemoryPool::Return(u8* data, u32 size)
+	{
+		if(data == nullptr)
+			return;
+
+		Lock lock(mMutex);
+
+		mStats.NumBorrowed--;
+
+		const u32 sizeClassIdx = GetSizeClassIdx(size);
+		if(sizeClassIdx == (u32)-1)
+		{
+			mStats.ReservedBytes -= size;
+			mStats.UsedBytes -= size;
+			mStats.RequestedBytes -= size;
+
+			bs_free_aligned16(data);
+			return;
+		}
+
+		SizeClass& sizeClass = mSizeClasses[sizeClassIdx];
+		sizeClass.FreeChunks.push_back(data);
+
+		FindPage(sizeClass, data)->NumFree++;
+
+		mStats.UsedBytes -= sizeClass.ChunkSize;
+		mStats.RequestedBytes -= size;
+	}
+
+	void ParticleMemoryPool::Reserve(u32 size, u32 count)
+	{
+		Lock lock(mMutex);
+
+		const u32 sizeClassIdx = GetSizeClassIdx(size);
+		if(sizeClassIdx == (u32)-1)
+			return;
+
+		SizeClass& sizeClass = mSizeClasses[sizeClassIdx];
+		while((u32)sizeClass.FreeChunks.size() < count)
+			AllocatePage(sizeClass);
+	}
+
+	void ParticleMemoryPool::Trim()
+	{
+		Lock lock(mMutex);
+
+		for(auto& sizeClass : mSizeClasses)
+		{
+			for(auto iter = sizeClass.Pages.begin(); iter != sizeClass.Pages.end();)
+			{
+				if(iter->NumFree != iter->NumChunks)
+				{
+					++iter;
+					continue;
+				}
+
+				// Remove all chunks belonging to the page from the free list
+				u8* pageStart = iter->Data;
+				u8* pageEnd = iter->Data + (u64)iter->NumChunks * sizeClass.ChunkSize;
+
+				auto& freeChunks = sizeClass.FreeChunks;
+				freeChunks.erase(std::remove_if(freeChunks.begin(), freeChunks.end(),
+					[pageStart, pageEnd](u8* chunk) { return chunk >= pageStart && chunk < pageEnd; }), freeChunks.end());
+
+				mStats.ReservedBytes -= (u64)iter->NumChunks * sizeClass.ChunkSize;
+				bs_free_aligned16(iter->Data);
+
+				iter = sizeClass.Pages.erase(iter);
+			}
+		}
+	}
+
+	void ParticleMemoryPool::ResetPeak()
+	{
+		Lock lock(mMutex);
+		mStats.PeakUsedBytes = mStats.UsedBytes;
+	}
+
+	ParticleMemoryPoolStats ParticleMemoryPool::GetStats() const
+	{
+		Lock lock(mMutex);
+
+		// Chunks are never merged, so the largest free range is the chunk of the largest class with a free chunk
+		ParticleMemoryPoolStats stats = mStats;
+		for(auto iter = mSizeClasses.rbegin(); iter != mSizeClasses.rend(); ++iter)
+		{
+			if(!iter->FreeChunks.empty())
+			{
+				stats.LargestFreeChunk = iter->ChunkSize;
+				break;
+			}
+		}
+
+		return stats;
+	}
+
+	u32 ParticleMemoryPool::GetChunkSize(u32 size) const
+	{
+		const u32 sizeClassIdx = GetSizeClassIdx(size);
+		if(sizeClassIdx == (u32)-1)
+			return size;
+
+		return mSizeClasses[sizeClassIdx].ChunkSize;
+	}
+
+	ParticleMemoryPool& ParticleMemoryPool::Instance()
+	{
+		static ParticleMemoryPool pool;
+		return pool;
+	}
+
+	u32 ParticleMemoryPool::GetSizeClassIdx(u32 size) const
+	{
+		const u32 sizeLog2 = ceilLog2(size);
+		if(sizeLog2 <= mMinChunkSizeLog2)
+			return 0;
+
+		const u32 sizeClassIdx = sizeLog2 - mMinChunkSizeLog2;
+		if(sizeClassIdx >= (u32)mSizeClasses.size())
+			return (u32)-1;
+
+		return sizeClassIdx;
+	}
+
+	void ParticleMemoryPool::AllocatePage(SizeClass& sizeClass)
+	{
+		const u32 numChunks = std::max(mPageSize / sizeClass.ChunkSize, 1U);
+		const u64 pageSize = (u64)numChunks * sizeClass.ChunkSize;
+
+		Page page;
+		page.Data = (u8*)bs_alloc_aligned16((size_t)pageSize);
+		page.NumChunks = numChunks;
+		page.NumFree = numChunks;
+
+		// Push in reverse so chunks are handed out in address order
+		for(u32 i = numChunks; i > 0; i--)
+			sizeClass.FreeChunks.push_back(page.Data + (u64)(i - 1) * sizeClass.ChunkSize);
+
+		// Keep the pages sorted by address, so the owning page of a chunk can be found with a binary search
+		auto iterInsert = std::upper_bound(sizeClass.Pages.begin(), sizeClass.Pages.end(), page.Data,
+			[](u8* data, const Page& entry) { return data < entry.Data; });
+		sizeClass.Pages.insert(iterInsert, page);
+
+		mStats.ReservedBytes += pageSize;
+		mStats.NumHeapAllocations++;
+	}
+
+	ParticleMemoryPool::Page* ParticleMemoryPool::FindPage(SizeClass& sizeClass, u8* data)
+	{
+		auto iterFind = std::upper_bound(sizeClass.Pages.begin(), sizeClass.Pages.end(), data,
+			[](u8* data, const Page& entry) { return data < entry.Data; });
+
+		BS_ASSERT(iterFind != sizeClass.Pages.begin());
+		return &*(iterFind - 1);
+	}
+
+	void PooledParticleBuffer::Resize(u32 size)
+	{
+		if(size == 0)
+		{
+			Release();
+			return;
+		}
+
+		// Keep the current chunk if the new size maps to the same size class
+		if(mData != nullptr && mPool->GetChunkSize(mBorrowedSize) == mPool->GetChunkSize(size))
+		{
+			mSize = size;
+			return;
+		}
+
+		u8* data = mPool->Borrow(size);
+		if(mData != nullptr)
+		{
+			memcpy(data, mData, std::min(mSize, size));
+			mPool->Return(mData, mBorrowedSize);
+		}
+
+		mData = data;
+		mSize = size;
+		mBorrowedSize = size;
+	}
+
+	void PooledParticleBuffer::Release()
+	{
+		if(mData == nullptr)
+			return;
+
+		mPool->Return(mData, mBorrowedSize);
+
+		mData = nullptr;
+		mSize = 0;
+		mBorrowedSize = 0;
+	}
+} // namespace bs
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+
+namespace bs
+{
+	/** Usage statistics reported by ParticleMemoryPool. */
+	struct ParticleMemoryPoolStats
+	{
+		/**
+		 * Total amount of memory allocated from the system for use by the pool, including the oversized requests served
+		 * directly from the heap.
+		 */
+		u64 ReservedBytes = 0;
+		u64 UsedBytes = 0; /**< Size of all chunks currently borrowed, rounded up to their size class. */
+		u64 RequestedBytes = 0; /**< Size of all chunks currently borrowed, as requested by the callers. */
+		u64 PeakUsedBytes = 0; /**< Highest value of UsedBytes since the pool was created or the peak was reset. */
+		u64 LargestFreeChunk = 0; /**< Size of the largest chunk sitting in a free list. */
+		u32 NumBorrowed = 0; /**< Number of chunks currently borrowed. */
+		u32 NumHeapAllocations = 0; /**< Number of times the pool had to allocate a new page from the system. */
+		u32 NumOversizedAllocations = 0; /**< Number of requests too large for any size class. */
+
+		/** Returns the amount of reserved memory sitting in free lists. */
+		u64 GetFreeBytes() const { return ReservedBytes - UsedBytes; }
+
+		/** Fraction of borrowed memory lost to rounding requests up to their size class. */
+		float GetInternalFragmentation() const
+		{
+			return UsedBytes > 0 ? 1.0f - (float)RequestedBytes / (float)UsedBytes : 0.0f;
+		}
+
+		/**
+		 * Fraction of free memory that can't be handed out as a single chunk, i.e. 1 - largest free chunk / free memory.
+		 * Zero when all free memory is in one chunk, approaching one as it is split into many small chunks.
+		 */
+		float GetExternalFragmentation() const
+		{
+			const u64 freeBytes = GetFreeBytes();
+			return freeBytes > 0 ? 1.0f - (float)LargestFreeChunk / (float)freeBytes : 0.0f;
+		}
+	};
+
+	/**
+	 * Memory pool shared between particle systems for storing their particle data. Memory is handed out in chunks from a
+	 * set of power-of-two size classes. Returned chunks are kept in per-class free lists and reused by the next system that
+	 * needs a chunk of the same class, so effects that are constantly spawned and destroyed don't touch the general heap
+	 * once the pool has warmed up. Memory is never returned to the system until the pool is destroyed or trimmed.
+	 *
+	 * @note	Thread safe.
+	 */
+	class ParticleMemoryPool
+	{
+	public:
+		/**
+		 * Creates a new pool.
+		 *
+		 * @param	minChunkSize	Size of the smallest size class, in bytes. Rounded up to a power of two.
+		 * @param	maxChunkSize	Size of the largest size class, in bytes. Rounded up to a power of two. Larger requests
+		 *							are allocated directly from the heap and counted in the stats.
+		 * @param	pageSize		Minimum size of the blocks allocated from the system. Pages are split into multiple
+		 *							chunks of the same size class.
+		 */
+		ParticleMemoryPool(u32 minChunkSize = 4 * 1024, u32 maxChunkSize = 4 * 1024 * 1024, u32 pageSize = 256 * 1024);
+		~ParticleMemoryPool();
+
+		ParticleMemoryPool(const ParticleMemoryPool&) = delete;
+		ParticleMemoryPool& operator=(const ParticleMemoryPool&) = delete;
+
+		/**
+		 * Borrows a chunk of at least 'size' bytes. The memory is aligned to 16 bytes and uninitialized. Must be returned
+		 * with Return() using the same size.
+		 */
+		u8* Borrow(u32 size);
+
+		/** Returns a chunk previously acquired with Borrow(). */
+		void Return(u8* data, u32 size);
+
+		/**
+		 * Allocates enough memory so that 'count' chunks of 'size' bytes can be borrowed without allocating from the
+		 * system. Useful for warming up the pool during level load.
+		 */
+		void Reserve(u32 size, u32 count);
+
+		/** Releases all pages whose chunks are all sitting in free lists back to the system. */
+		void Trim();
+
+		/** Resets the peak usage to the current usage. */
+		void ResetPeak();
+
+		/** Returns the current usage statistics. */
+		ParticleMemoryPoolStats GetStats() const;
+
+		/** Returns the size of the chunk a request of 'size' bytes would be served from. */
+		u32 GetChunkSize(u32 size) const;
+
+		/** Returns a global pool shared by all particle systems in the application. */
+		static ParticleMemoryPool& Instance();
+
+	private:
+		/** Block of memory allocated from the system, split into chunks of a single size class. */
+		struct Page
+		{
+			u8* Data;
+			u32 NumChunks;
+			u32 NumFree;
+		};
+
+		/** Free chunks and pages belonging to a single size class. */
+		struct SizeClass
+		{
+			u32 ChunkSize;
+			Vector<u8*> FreeChunks;
+			Vector<Page> Pages;
+		};
+
+		/** Returns the index of the size class that serves requests of the specified size. */
+		u32 GetSizeClassIdx(u32 size) const;
+
+		/** Allocates a new page for the provided size class and adds its chunks to the free list. */
+		void AllocatePage(SizeClass& sizeClass);
+
+		/** Finds the page the provided chunk belongs to. */
+		Page* FindPage(SizeClass& sizeClass, u8* data);
+
+		Vector<SizeClass> mSizeClasses;
+		u32 mMinChunkSizeLog2;
+		u32 mPageSize;
+
+		ParticleMemoryPoolStats mStats;
+		mutable Mutex mMutex;
+	};
+
+	/**
+	 * Owning handle for a chunk borrowed from a ParticleMemoryPool. Returns the chunk to the pool when destroyed or when
+	 * a different size is requested.
+	 */
+	class PooledParticleBuffer
+	{
+	public:
+		PooledParticleBuffer(ParticleMemoryPool& pool = ParticleMemoryPool::Instance())
+			: mPool(&pool)
+		{}
+
+		~PooledParticleBuffer() { Release(); }
+
+		PooledParticleBuffer(PooledParticleBuffer&& other) noexcept
+			: mPool(other.mPool), mData(other.mData), mSize(other.mSize), mBorrowedSize(other.mBorrowedSize)
+		{
+			other.mData = nullptr;
+			other.mSize = 0;
+			other.mBorrowedSize = 0;
+		}
+
+		PooledParticleBuffer& operator=(PooledParticleBuffer&& other) noexcept
+		{
+			if(this != &other)
+			{
+				Release();
+
+				mPool = other.mPool;
+				mData = other.mData;
+				mSize = other.mSize;
+				mBorrowedSize = other.mBorrowedSize;
+
+				other.mData = nullptr;
+				other.mSize = 0;
+				other.mBorrowedSize = 0;
+			}
+
+			return *this;
+		}
+
+		PooledParticleBuffer(const PooledParticleBuffer&) = delete;
+		PooledParticleBuffer& operator=(const PooledParticleBuffer&) = delete;
+
+		/**
+		 * Makes sure the buffer can hold at least 'size' bytes. If the current chunk is too small it is swapped for a larger
+		 * one, preserving the existing contents. Resizing to zero returns the chunk to the pool.
+		 */
+		void Resize(u32 size);
+
+		/** Returns the chunk to the pool. */
+		void Release();
+
+		/** Returns a pointer to the start of the buffer. */
+		u8* GetData() const { return mData; }
+
+		/** Returns the size the buffer was last resized to. */
+		u32 GetSize() const { return mSize; }
+
+	private:
+		ParticleMemoryPool* mPool;
+		u8* mData = nullptr;
+		u32 mSize = 0;
+		u32 mBorrowedSize = 0; /**< Size the current chunk was borrowed with, must be provided when returning it. */
+	};
+} // namespace bs
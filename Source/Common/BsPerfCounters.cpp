@@ -0,0 +1,298 @@
+#include "BsPerfCounters.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if BS_PLATFORM == BS_PLATFORM_LINUX
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace bs
+{
+	static constexpr u32 NUM_COUNTERS = (u32)PerfCounterType::Count;
+
+#if BS_PLATFORM == BS_PLATFORM_LINUX
+	/** Counter group opened for a single thread. Closed when the thread exits. */
+	struct ThreadPerfCounters
+	{
+		ThreadPerfCounters()
+		{
+			static const u64 CONFIGS[NUM_COUNTERS] =
+			{
+				PERF_COUNT_HW_CPU_CYCLES,
+				PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES,
+				PERF_COUNT_HW_BRANCH_MISSES
+			};
+
+			// All counters are opened as a single group, so they are scheduled on the CPU together and can be read with
+			// a single system call. The first counter leads the group.
+			for(u32 i = 0; i < NUM_COUNTERS; i++)
+			{
+				perf_event_attr attr;
+				memset(&attr, 0, sizeof(attr));
+				attr.size = sizeof(attr);
+				attr.type = PERF_TYPE_HARDWARE;
+				attr.config = CONFIGS[i];
+				attr.disabled = i == 0 ? 1 : 0;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED |
+					PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+				// Measure the calling thread, on any CPU
+				const int groupFd = i == 0 ? -1 : Descriptors[0];
+				Descriptors[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+
+				if(Descriptors[i] == -1)
+				{
+					// Without the leader there is no group, so nothing can be measured
+					if(i == 0)
+						return;
+
+					continue;
+				}
+
+				ioctl(Descriptors[i], PERF_EVENT_IOC_ID, &Ids[i]);
+			}
+
+			ioctl(Descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(Descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+		}
+
+		~ThreadPerfCounters()
+		{
+			for(auto& entry : Descriptors)
+			{
+				if(entry != -1)
+					close(entry);
+			}
+		}
+
+		bool Read(PerfCounterValues& output) const
+		{
+			if(Descriptors[0] == -1)
+				return false;
+
+			// Layout defined by the read format: counter count, enabled and running times, followed by a value and an
+			// ID per counter
+			u64 data[3 + NUM_COUNTERS * 2];
+			const ssize_t size = read(Descriptors[0], data, sizeof(data));
+			if(size < (ssize_t)(sizeof(u64) * 3))
+				return false;
+
+			const u64 numValues = std::min(data[0], (u64)NUM_COUNTERS);
+			const u64 timeEnabled = data[1];
+			const u64 timeRunning = data[2];
+
+			// If there are more counters requested (e.g. by other processes) than the CPU has, the kernel multiplexes
+			// them and the group only runs part of the time. Scale the values to estimate the full count.
+			const double scale = (timeRunning > 0 && timeRunning < timeEnabled) ?
+				(double)timeEnabled / (double)timeRunning : 1.0;
+
+			for(u64 i = 0; i < numValues; i++)
+			{
+				const u64 value = data[3 + i * 2];
+				const u64 id = data[3 + i * 2 + 1];
+
+				for(u32 j = 0; j < NUM_COUNTERS; j++)
+				{
+					if(Descriptors[j] != -1 && Ids[j] == id)
+					{
+						output.Values[j] = (u64)((double)value * scale);
+						break;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		int Descriptors[NUM_COUNTERS] = { -1, -1, -1, -1 };
+		u64 Ids[NUM_COUNTERS] = { };
+	};
+
+	/** Returns the counters of the calling thread, opening them if needed. */
+	static const ThreadPerfCounters& getThreadCounters()
+	{
+		static thread_local ThreadPerfCounters counters;
+		return counters;
+	}
+
+	bool PerfCounters::Read(PerfCounterValues& output)
+	{
+		return getThreadCounters().Read(output);
+	}
+
+	bool PerfCounters::IsAvailable()
+	{
+		return getThreadCounters().Descriptors[0] != -1;
+	}
+
+	bool PerfCounters::IsSupported(PerfCounterType type)
+	{
+		return getThreadCounters().Descriptors[(u32)type] != -1;
+	}
+#else
+	bool PerfCounters::Read(PerfCounterValues& output)
+	{
+		return false;
+	}
+
+	bool PerfCounters::IsAvailable()
+	{
+		return false;
+	}
+
+	bool PerfCounters::IsSupported(PerfCounterType type)
+	{
+		return false;
+	}
+#endif
+
+	const char* PerfCounters::GetName(PerfCounterType type)
+	{
+		switch(type)
+		{
+		case PerfCounterType::Cycles:
+			return "Cycles";
+		case PerfCounterType::Instructions:
+			return "Instructions";
+		case PerfCounterType::CacheMisses:
+			return "Cache misses";
+		case PerfCounterType::BranchMisses:
+			return "Branch misses";
+		default:
+			return "Unknown";
+		}
+	}
+
+	PerfProfiler::PerfProfiler()
+	{
+		const char* enabled = getenv("BS_PERF_COUNTERS");
+		mEnabled = enabled == nullptr || strcmp(enabled, "0") != 0;
+	}
+
+	void PerfProfiler::Record(const char* name, double wallTime, const PerfCounterValues* counters)
+	{
+		Lock lock(mMutex);
+
+		PerfScopeStats& stats = mScopes[name];
+		if(stats.NumCalls == 0)
+			stats.Name = name;
+
+		stats.NumCalls++;
+		stats.WallTime += wallTime;
+
+		if(counters != nullptr)
+		{
+			stats.Counters += *counters;
+			stats.HasCounters = true;
+		}
+	}
+
+	Vector<PerfScopeStats> PerfProfiler::GetStats() const
+	{
+		Lock lock(mMutex);
+
+		Vector<PerfScopeStats> output;
+		output.reserve(mScopes.size());
+
+		for(auto& entry : mScopes)
+			output.push_back(entry.second);
+
+		return output;
+	}
+
+	void PerfProfiler::Reset()
+	{
+		Lock lock(mMutex);
+		mScopes.clear();
+	}
+
+	String PerfProfiler::GetReport() const
+	{
+		const Vector<PerfScopeStats> stats = GetStats();
+
+		StringStream output;
+
+		char line[256];
+		snprintf(line, sizeof(line), "%-32s %8s %12s %14s %14s %6s %12s %12s\n", "Scope", "Calls", "Wall (us)",
+			"Cycles", "Instructions", "IPC", "Cache MPKI", "Branch MPKI");
+		output << line;
+
+		for(auto& entry : stats)
+		{
+			const double numCalls = (double)std::max(entry.NumCalls, (u64)1);
+			const double wallTimeUs = entry.WallTime / numCalls / 1000.0;
+
+			if(!entry.HasCounters)
+			{
+				snprintf(line, sizeof(line), "%-32s %8llu %12.2f %14s %14s %6s %12s %12s\n", entry.Name.c_str(),
+					(unsigned long long)entry.NumCalls, wallTimeUs, "-", "-", "-", "-", "-");
+				output << line;
+				continue;
+			}
+
+			const double cycles = (double)entry.Counters.Get(PerfCounterType::Cycles);
+			const double instructions = (double)entry.Counters.Get(PerfCounterType::Instructions);
+			const double cacheMisses = (double)entry.Counters.Get(PerfCounterType::CacheMisses);
+			const double branchMisses = (double)entry.Counters.Get(PerfCounterType::BranchMisses);
+
+			// Misses are reported per thousand instructions, which keeps them comparable as the amount of work changes
+			const double ipc = cycles > 0.0 ? instructions / cycles : 0.0;
+			const double cacheMPKI = instructions > 0.0 ? cacheMisses * 1000.0 / instructions : 0.0;
+			const double branchMPKI = instructions > 0.0 ? branchMisses * 1000.0 / instructions : 0.0;
+
+			snprintf(line, sizeof(line), "%-32s %8llu %12.2f %14.0f %14.0f %6.2f %12.2f %12.2f\n", entry.Name.c_str(),
+				(unsigned long long)entry.NumCalls, wallTimeUs, cycles / numCalls, instructions / numCalls, ipc,
+				cacheMPKI, branchMPKI);
+			output << line;
+		}
+
+		if(!stats.empty() && !PerfCounters::IsAvailable())
+			output << "Hardware counters unavailable, only wall-clock time was captured.\n";
+
+		return output.str();
+	}
+
+	PerfProfiler& PerfProfiler::Instance()
+	{
+		static PerfProfiler profiler;
+		return profiler;
+	}
+
+	PerfScope::PerfScope(const char* name)
+		: mName(name)
+	{
+		if(!PerfProfiler::Instance().IsEnabled())
+			return;
+
+		mActive = true;
+		mHasCounters = PerfCounters::Read(mStartCounters);
+
+		// Read the clock last and stop it first, so the counter reads aren't included in the wall-clock time
+		mStartTime = std::chrono::steady_clock::now();
+	}
+
+	PerfScope::~PerfScope()
+	{
+		if(!mActive)
+			return;
+
+		const auto endTime = std::chrono::steady_clock::now();
+		const double wallTime = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - mStartTime).count();
+
+		PerfCounterValues endCounters;
+		if(mHasCounters && PerfCounters::Read(endCounters))
+		{
+			const PerfCounterValues delta = endCounters - mStartCounters;
+			PerfProfiler::Instance().Record(mName, wallTime, &delta);
+		}
+		else
+			PerfProfiler::Instance().Record(mName, wallTime, nullptr);
+	}
+} // namespace bs
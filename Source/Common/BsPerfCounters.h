@@ -0,0 +1,152 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include <atomic>
+#include <chrono>
+
+namespace bs
+{
+	/** Types of hardware performance counters captured by PerfCounters. */
+	enum class PerfCounterType
+	{
+		Cycles, /**< CPU cycles spent executing the thread. */
+		Instructions, /**< Instructions retired. */
+		CacheMisses, /**< Last level cache misses. */
+		BranchMisses, /**< Mispredicted branches. */
+		Count
+	};
+
+	/** Values of all hardware performance counters at a point in time, or a difference between two points in time. */
+	struct PerfCounterValues
+	{
+		u64 Values[(u32)PerfCounterType::Count] = { };
+
+		/** Returns the value of the specified counter. */
+		u64 Get(PerfCounterType type) const { return Values[(u32)type]; }
+
+		PerfCounterValues operator-(const PerfCounterValues& rhs) const
+		{
+			PerfCounterValues output;
+			for(u32 i = 0; i < (u32)PerfCounterType::Count; i++)
+				output.Values[i] = Values[i] >= rhs.Values[i] ? Values[i] - rhs.Values[i] : 0;
+
+			return output;
+		}
+
+		PerfCounterValues& operator+=(const PerfCounterValues& rhs)
+		{
+			for(u32 i = 0; i < (u32)PerfCounterType::Count; i++)
+				Values[i] += rhs.Values[i];
+
+			return *this;
+		}
+	};
+
+	/**
+	 * Provides access to hardware performance counters of the calling thread. Counters are opened the first time a thread
+	 * reads them, and only count work done in user mode by that thread.
+	 *
+	 * Only supported on Linux, using perf_event_open. Counters are unavailable on other platforms, and when the kernel
+	 * doesn't allow access (see /proc/sys/kernel/perf_event_paranoid) or the CPU (e.g. in a virtual machine) doesn't
+	 * expose them. Individual counters the CPU doesn't support always read as zero.
+	 */
+	class PerfCounters
+	{
+	public:
+		/**
+		 * Reads the current counter values of the calling thread. Returns false if counters are unavailable, in which case
+		 * 'output' is left unchanged.
+		 */
+		static bool Read(PerfCounterValues& output);
+
+		/** Checks if the hardware counters are available on the calling thread. */
+		static bool IsAvailable();
+
+		/** Checks if the specified counter is supported on the calling thread. */
+		static bool IsSupported(PerfCounterType type);
+
+		/** Returns a human readable name of the counter. */
+		static const char* GetName(PerfCounterType type);
+	};
+
+	/** Totals accumulated for a single profiling scope. */
+	struct PerfScopeStats
+	{
+		String Name;
+		u64 NumCalls = 0;
+		double WallTime = 0.0; /**< Total wall-clock time spent in the scope, in nanoseconds. */
+		PerfCounterValues Counters; /**< Total counter values accumulated in the scope. Zero if unavailable. */
+		bool HasCounters = false; /**< True if hardware counters were captured for the scope. */
+	};
+
+	/**
+	 * Accumulates wall-clock time and hardware counters of named scopes, such as a subsystem update. Scopes are measured
+	 * with PerfScope (or BS_PERF_SCOPE), and can be nested, in which case the parent includes the cost of the child.
+	 *
+	 * Reading the counters costs a system call, so scopes should wrap units of work that take at least a few microseconds
+	 * (e.g. a subsystem update, not a single particle).
+	 */
+	class PerfProfiler
+	{
+	public:
+		/** Records a single execution of a scope. */
+		void Record(const char* name, double wallTime, const PerfCounterValues* counters);
+
+		/** Returns the accumulated statistics of all scopes, sorted by name. */
+		Vector<PerfScopeStats> GetStats() const;
+
+		/** Clears all accumulated statistics. */
+		void Reset();
+
+		/**
+		 * Returns a readable report with per-call averages of each scope: wall-clock time, cycles, instructions,
+		 * instructions per cycle, and cache and branch misses per thousand instructions.
+		 */
+		String GetReport() const;
+
+		/**
+		 * Enables or disables the capture. When disabled, scopes cost a single branch. Enabled by default, unless the
+		 * BS_PERF_COUNTERS environment variable is set to 0.
+		 */
+		void SetEnabled(bool enabled) { mEnabled.store(enabled, std::memory_order_relaxed); }
+
+		/** Checks if the capture is enabled. */
+		bool IsEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+		/** Returns the global profiler. */
+		static PerfProfiler& Instance();
+
+	private:
+		PerfProfiler();
+
+		std::atomic<bool> mEnabled;
+
+		mutable Mutex mMutex;
+		Map<String, PerfScopeStats> mScopes;
+	};
+
+	/** Measures the wall-clock time and hardware counters between its construction and destruction. */
+	class PerfScope
+	{
+	public:
+		/** Starts measuring a scope. 'name' must remain valid until the scope ends (e.g. a string literal). */
+		PerfScope(const char* name);
+		~PerfScope();
+
+		PerfScope(const PerfScope&) = delete;
+		PerfScope& operator=(const PerfScope&) = delete;
+
+	private:
+		const char* mName;
+		bool mActive = false;
+		bool mHasCounters = false;
+		std::chrono::steady_clock::time_point mStartTime;
+		PerfCounterValues mStartCounters;
+	};
+
+#define BS_PERF_SCOPE_CONCAT_INNER(a, b) a##b
+#define BS_PERF_SCOPE_CONCAT(a, b) BS_PERF_SCOPE_CONCAT_INNER(a, b)
+
+	/** Measures the remainder of the current block as a scope with the provided name, using PerfProfiler. */
+#define BS_PERF_SCOPE(name) bs::PerfScope BS_PERF_SCOPE_CONCAT(perfScope, __LINE__)(name)
+} // namespace bs
@@ -0,0 +1,81 @@
+#include "BsProfiledApplication.h"
+#include <thread>
+
+namespace bs
+{
+	void ProfiledApplication::OnStartUp()
+	{
+		Application::OnStartUp();
+
+		// Replaced by WaitForNextFrame(), see the class description
+		Application::SetFPSLimit(0);
+		mFrameStartTime = std::chrono::steady_clock::now();
+	}
+
+	void ProfiledApplication::PreUpdate()
+	{
+		// Ends the scope started at the end of the previous frame
+		mLateScope.reset();
+
+		{
+			BS_PERF_SCOPE("Frame: wait");
+			WaitForNextFrame();
+		}
+
+		Application::PreUpdate();
+
+		mSceneScope.emplace("Frame: scene and physics");
+	}
+
+	void ProfiledApplication::PostUpdate()
+	{
+		mSceneScope.reset();
+
+		{
+			BS_PERF_SCOPE("Frame: GUI update and layout");
+			Application::PostUpdate();
+		}
+
+		// Animation and particles are evaluated once this returns, followed by render submission and waiting for the core
+		// thread. The scope ends at the start of the next frame.
+		mLateScope.emplace("Frame: animation, particles, render, core sync");
+	}
+
+	void ProfiledApplication::OnShutDown()
+	{
+		mSceneScope.reset();
+		mLateScope.reset();
+
+		const String report = PerfProfiler::Instance().GetReport();
+		BS_LOG(Info, Uncategorized, "Frame phase performance counters:\n" + report);
+
+		Application::OnShutDown();
+	}
+
+	void ProfiledApplication::WaitForNextFrame()
+	{
+		using Clock = std::chrono::steady_clock;
+
+		if(mFrameRateLimit == 0)
+		{
+			mFrameStartTime = Clock::now();
+			return;
+		}
+
+		const Clock::time_point nextFrameTime = mFrameStartTime +
+			std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / mFrameRateLimit));
+
+		// Sleep while there's plenty of time left, then spin, since sleeps can overshoot by a millisecond or more
+		Clock::time_point currentTime = Clock::now();
+		while(currentTime < nextFrameTime)
+		{
+			if(nextFrameTime - currentTime >= std::chrono::milliseconds(2))
+				std::this_thread::sleep_for(nextFrameTime - currentTime - std::chrono::milliseconds(1));
+
+			currentTime = Clock::now();
+		}
+
+		// Frames that ran late start the next interval from now, instead of trying to catch up
+		mFrameStartTime = currentTime;
+	}
+} // namespace bs
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "BsApplication.h"
+#include "BsPerfCounters.h"
+#include <optional>
+
+namespace bs
+{
+	/**
+	 * Application that measures the wall-clock time and hardware counters of each phase of the frame, using PerfProfiler.
+	 * The frame is split at the update callbacks the engine provides to applications:
+	 *  - Scene and physics: component updates, fixed updates and the physics step.
+	 *  - GUI: GUI update and layout.
+	 *  - Animation, particles, render and core sync: animation evaluation, particle simulation, render submission, and
+	 *    waiting for the core thread to finish the previous frame. The engine has no callback after render submission,
+	 *    so the last two can't be told apart. With vsync enabled the wait includes presenting the previous frame.
+	 *  - Wait: time spent sleeping or spinning to keep to the frame rate limit.
+	 *
+	 * The engine's own frame rate limiter runs at the start of the frame where it can't be measured separately, so it is
+	 * disabled in favor of the limiter in this class. Use SetFrameRateLimit() instead of Application::SetFPSLimit().
+	 *
+	 * The report is logged on shut-down. Start the application with Application::StartUp<ProfiledApplication>().
+	 */
+	class ProfiledApplication : public Application
+	{
+	public:
+		ProfiledApplication(const START_UP_DESC& desc)
+			: Application(desc)
+		{}
+
+		/** Limits the number of frames per second. Zero removes the limit. Defaults to 60, same as the engine. */
+		void SetFrameRateLimit(u32 limit) { mFrameRateLimit = limit; }
+
+		/** Returns the frame rate limit set by SetFrameRateLimit(), or zero if unlimited. */
+		u32 GetFrameRateLimit() const { return mFrameRateLimit; }
+
+	protected:
+		/** Called when the engine is first started up. */
+		void OnStartUp() override;
+
+		/** Called every frame, before any other engine system. */
+		void PreUpdate() override;
+
+		/** Called every frame, after scene and physics updates, and before animation, particles and rendering. */
+		void PostUpdate() override;
+
+		/** Called when the engine is about to be shut down. */
+		void OnShutDown() override;
+
+	private:
+		/** Waits until enough time passed since the start of the previous frame to keep to the frame rate limit. */
+		void WaitForNextFrame();
+
+		std::optional<PerfScope> mSceneScope;
+		std::optional<PerfScope> mLateScope;
+
+		u32 mFrameRateLimit = 60;
+		std::chrono::steady_clock::time_point mFrameStartTime;
+	};
+} // namespace bs
@@ -0,0 +1,155 @@
+#include "BsRedrawTracker.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCCamera.h"
+#include "Input/BsInput.h"
+#include "RenderAPI/BsRenderWindow.h"
+#include "Utility/BsTime.h"
+#include "BsApplication.h"
+#include "BsProfiledApplication.h"
+
+namespace bs
+{
+	/**
+	 * Returns the frame rate limit the application currently runs with. Only ProfiledApplication reports its limit, for
+	 * other applications the engine's default of 60 is assumed.
+	 */
+	static u32 getApplicationFPSLimit()
+	{
+		if(auto profiledApp = dynamic_cast<ProfiledApplication*>(&gApplication()))
+			return profiledApp->GetFrameRateLimit();
+
+		return 60;
+	}
+
+	RedrawTracker::RedrawTracker(const HSceneObject& parent, const HCamera& camera)
+		: Component(parent), mCamera(camera)
+	{
+		SetName("RedrawTracker");
+
+		// Any input can change what is displayed (e.g. GUI hover and focus states), so all of it triggers a redraw
+		Input& input = gInput();
+		mEventConnections.push_back(input.OnButtonDown.Connect([this](const ButtonEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnButtonUp.Connect([this](const ButtonEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnCharInput.Connect([this](const TextInputEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnPointerMoved.Connect([this](const PointerEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnPointerPressed.Connect([this](const PointerEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnPointerReleased.Connect([this](const PointerEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnPointerDoubleClick.Connect([this](const PointerEvent&) { mChanged = true; }));
+		mEventConnections.push_back(input.OnInputCommand.Connect([this](InputCommandType) { mChanged = true; }));
+
+		SPtr<RenderWindow> window = gApplication().GetPrimaryWindow();
+		if(window != nullptr)
+			mEventConnections.push_back(window->OnResized.Connect([this]() { mChanged = true; }));
+	}
+
+	void RedrawTracker::Update()
+	{
+		if(!mEnabled)
+			return;
+
+		const bool transformsChanged = CheckTransforms();
+		if(mChanged || transformsChanged)
+		{
+			mIdleTime = 0.0f;
+			mChanged = false;
+		}
+		else
+			mIdleTime += gTime().GetFrameDelta();
+
+		const bool isActive = mIdleTime <= mLingerTime;
+		if(isActive || mRedrawRequested)
+		{
+			mCamera->NotifyNeedsRedraw();
+			mNumRenderedFrames++;
+		}
+		else
+			mNumSkippedFrames++;
+
+		mRedrawRequested = false;
+
+		// While idle there's no need to spin the main loop at full rate, even if a single frame was requested. It still
+		// needs to run often enough to respond to input without a noticeable delay.
+		SetFPSLimit(isActive ? mActiveFPSLimit : mIdleFPSLimit);
+	}
+
+	void RedrawTracker::OnDestroyed()
+	{
+		for(auto& connection : mEventConnections)
+			connection.Disconnect();
+
+		mEventConnections.clear();
+
+		SetEnabled(false);
+	}
+
+	void RedrawTracker::SetEnabled(bool enabled)
+	{
+		if(mEnabled == enabled)
+			return;
+
+		mEnabled = enabled;
+		mCamera->SetFlag(CameraFlag::OnDemand, enabled);
+
+		if(enabled)
+		{
+			// Restored whenever active, and once disabled
+			mActiveFPSLimit = getApplicationFPSLimit();
+			mCurrentFPSLimit = mActiveFPSLimit;
+
+			// Start by rendering, since the scene may have changed while the camera was rendering every frame
+			mChanged = true;
+			CheckTransforms();
+		}
+		else
+			SetFPSLimit(mActiveFPSLimit);
+	}
+
+	void RedrawTracker::Watch(const HSceneObject& sceneObject)
+	{
+		const Transform& tfrm = sceneObject->GetTransform();
+		mWatched.push_back({ sceneObject, tfrm.GetPosition(), tfrm.GetRotation(), tfrm.GetScale() });
+	}
+
+	bool RedrawTracker::CheckTransforms()
+	{
+		bool changed = false;
+		for(auto iter = mWatched.begin(); iter != mWatched.end();)
+		{
+			// Destroying a visible object is a change as well
+			if(iter->SceneObject.IsDestroyed())
+			{
+				iter = mWatched.erase(iter);
+				changed = true;
+				continue;
+			}
+
+			const Transform& tfrm = iter->SceneObject->GetTransform();
+			if(tfrm.GetPosition() != iter->Position || tfrm.GetRotation() != iter->Rotation ||
+				tfrm.GetScale() != iter->Scale)
+			{
+				iter->Position = tfrm.GetPosition();
+				iter->Rotation = tfrm.GetRotation();
+				iter->Scale = tfrm.GetScale();
+				changed = true;
+			}
+
+			++iter;
+		}
+
+		return changed;
+	}
+
+	void RedrawTracker::SetFPSLimit(u32 limit)
+	{
+		if(mCurrentFPSLimit == limit)
+			return;
+
+		// ProfiledApplication replaces the engine's frame rate limiter with its own
+		if(auto profiledApp = dynamic_cast<ProfiledApplication*>(&gApplication()))
+			profiledApp->SetFrameRateLimit(limit);
+		else
+			gApplication().SetFPSLimit(limit);
+
+		mCurrentFPSLimit = limit;
+	}
+} // namespace bs
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "Math/BsVector3.h"
+#include "Math/BsQuaternion.h"
+
+namespace bs
+{
+	/**
+	 * Component that puts a camera in render-on-demand mode, for scenes that are mostly static. The camera is only
+	 * rendered and presented on frames where something visible might have changed, and the main loop is throttled while
+	 * nothing does.
+	 *
+	 * Changes are detected from user input, from window resizes and from transform changes of watched scene objects.
+	 * Anything else that changes the output (animations, GUI content updated from code) should call NotifyChanged().
+	 * After a change the camera keeps rendering for a short linger time, so effects that settle over a few frames (e.g.
+	 * GUI hover states) are fully displayed before going idle. One-off changes that are complete in a single frame
+	 * (e.g. a label showing a new value) should call RequestRedraw() instead, which renders one frame without lingering.
+	 */
+	class RedrawTracker : public Component
+	{
+	public:
+		/**
+		 * Constructs the tracker.
+		 *
+		 * @param	parent		Scene object the component is attached to.
+		 * @param	camera		Camera to render on demand.
+		 */
+		RedrawTracker(const HSceneObject& parent, const HCamera& camera);
+
+		/** Triggered once per frame. Checks for changes and requests a redraw of the camera if there were any. */
+		void Update() override;
+
+		/** Triggered when the component is destroyed. Disconnects from input events and restores the frame rate. */
+		void OnDestroyed() override;
+
+		/**
+		 * Enables or disables render-on-demand. When disabled the camera renders every frame, and the frame rate isn't
+		 * throttled.
+		 */
+		void SetEnabled(bool enabled);
+
+		/** Checks is render-on-demand enabled. */
+		bool IsEnabled() const { return mEnabled; }
+
+		/** Marks the scene as changed, rendering the camera on the next frame and for the linger time after. */
+		void NotifyChanged() { mChanged = true; }
+
+		/** Renders the camera on the next frame only, without lingering or raising the frame rate limit. */
+		void RequestRedraw() { mRedrawRequested = true; }
+
+		/** Registers a scene object whose transform changes should trigger a redraw. */
+		void Watch(const HSceneObject& sceneObject);
+
+		/** Sets the frame rate limit applied while idle. Input is only polled at this rate, so keep it interactive. */
+		void SetIdleFPSLimit(u32 limit) { mIdleFPSLimit = limit; }
+
+		/** Sets the time to keep rendering after the last change, in seconds. */
+		void SetLingerTime(float seconds) { mLingerTime = seconds; }
+
+		/** Returns the number of frames the camera was rendered on. */
+		u64 GetNumRenderedFrames() const { return mNumRenderedFrames; }
+
+		/** Returns the number of frames that were skipped since nothing changed. */
+		u64 GetNumSkippedFrames() const { return mNumSkippedFrames; }
+
+		static constexpr u32 DEFAULT_IDLE_FPS_LIMIT = 30;
+		static constexpr float DEFAULT_LINGER_TIME = 0.25f;
+
+	private:
+		/** Scene object whose transform is compared against its value on the previous frame. */
+		struct WatchedObject
+		{
+			HSceneObject SceneObject;
+			Vector3 Position;
+			Quaternion Rotation;
+			Vector3 Scale;
+		};
+
+		/** Checks if any of the watched objects moved since the last frame, and records their current transforms. */
+		bool CheckTransforms();
+
+		/** Sets the frame rate limit of the application, if different from the current one. */
+		void SetFPSLimit(u32 limit);
+
+		HCamera mCamera;
+		Vector<WatchedObject> mWatched;
+		Vector<HEvent> mEventConnections;
+
+		bool mEnabled = false;
+		bool mChanged = true;
+		bool mRedrawRequested = false;
+		float mIdleTime = 0.0f; /**< Time since the last change, in seconds. */
+		u32 mIdleFPSLimit = DEFAULT_IDLE_FPS_LIMIT;
+
+		u32 mActiveFPSLimit = 0; /**< Limit of the application when enabled, restored once active. 0 for unlimited. */
+		u32 mCurrentFPSLimit = 0;
+		float mLingerTime = DEFAULT_LINGER_TIME;
+
+		u64 mNumRenderedFrames = 0;
+		u64 mNumSkippedFrames = 0;
+	};
+
+	using HRedrawTracker = GameObjectHandle<RedrawTracker>;
+} // namespace bs
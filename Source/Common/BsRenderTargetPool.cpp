@@ -0,0 +1,91 @@
+#include "BsRenderTargetPool.h"
+#include "RenderAPI/BsRenderTexture.h"
+#include "Image/BsTexture.h"
+#include "Image/BsPixelUtil.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		SPtr<RenderTexture> RenderTargetPool::Acquire(const PooledRenderTargetDesc& desc)
+		{
+			for(auto& entry : mEntries)
+			{
+				if(entry.InUse || !(entry.Desc == desc))
+					continue;
+
+				entry.InUse = true;
+
+				mStats.NumReused++;
+				mStats.NumInUse++;
+				mStats.NumFree--;
+				mStats.InUseBytes += entry.Size;
+				mStats.FreeBytes -= entry.Size;
+
+				return entry.RenderTarget;
+			}
+
+			TEXTURE_DESC colorDesc;
+			colorDesc.Width = desc.Width;
+			colorDesc.Height = desc.Height;
+			colorDesc.Format = desc.ColorFormat;
+			colorDesc.Usage = TU_RENDERTARGET;
+
+			RENDER_TEXTURE_DESC rtDesc;
+			rtDesc.ColorSurfaces[0].Texture = Texture::Create(colorDesc);
+
+			u64 size = PixelUtil::GetMemorySize(desc.Width, desc.Height, 1, desc.ColorFormat);
+			if(desc.DepthFormat != PF_UNKNOWN)
+			{
+				TEXTURE_DESC depthDesc;
+				depthDesc.Width = desc.Width;
+				depthDesc.Height = desc.Height;
+				depthDesc.Format = desc.DepthFormat;
+				depthDesc.Usage = TU_DEPTHSTENCIL;
+
+				rtDesc.DepthStencilSurface.Texture = Texture::Create(depthDesc);
+				size += PixelUtil::GetMemorySize(desc.Width, desc.Height, 1, desc.DepthFormat);
+			}
+
+			Entry entry;
+			entry.RenderTarget = RenderTexture::Create(rtDesc);
+			entry.Desc = desc;
+			entry.Size = size;
+			entry.InUse = true;
+
+			mEntries.push_back(entry);
+
+			mStats.NumCreated++;
+			mStats.NumInUse++;
+			mStats.InUseBytes += size;
+
+			return entry.RenderTarget;
+		}
+
+		void RenderTargetPool::Release(const SPtr<RenderTexture>& renderTarget)
+		{
+			for(auto& entry : mEntries)
+			{
+				if(!entry.InUse || entry.RenderTarget != renderTarget)
+					continue;
+
+				entry.InUse = false;
+
+				mStats.NumInUse--;
+				mStats.NumFree++;
+				mStats.InUseBytes -= entry.Size;
+				mStats.FreeBytes += entry.Size;
+				break;
+			}
+		}
+
+		void RenderTargetPool::Trim()
+		{
+			mEntries.erase(std::remove_if(mEntries.begin(), mEntries.end(),
+				[](const Entry& entry) { return !entry.InUse; }), mEntries.end());
+
+			mStats.NumFree = 0;
+			mStats.FreeBytes = 0;
+		}
+	} // namespace ct
+} // namespace bs
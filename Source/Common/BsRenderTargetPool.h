@@ -0,0 +1,72 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Image/BsPixelData.h"
+
+namespace bs
+{
+	namespace ct
+	{
+		/** Properties of a render target requested from a RenderTargetPool. */
+		struct PooledRenderTargetDesc
+		{
+			u32 Width = 0;
+			u32 Height = 0;
+			PixelFormat ColorFormat = PF_RGBA8;
+			PixelFormat DepthFormat = PF_D32; /**< PF_UNKNOWN if the target has no depth attachment. */
+
+			bool operator==(const PooledRenderTargetDesc& other) const
+			{
+				return Width == other.Width && Height == other.Height && ColorFormat == other.ColorFormat &&
+					DepthFormat == other.DepthFormat;
+			}
+		};
+
+		/** Usage statistics reported by RenderTargetPool. */
+		struct RenderTargetPoolStats
+		{
+			u32 NumCreated = 0; /**< Render targets created from the driver since the pool was created. */
+			u32 NumReused = 0; /**< Requests served by a previously released render target. */
+			u32 NumInUse = 0;
+			u32 NumFree = 0;
+			u64 InUseBytes = 0; /**< Estimated memory used by the acquired render targets. */
+			u64 FreeBytes = 0; /**< Estimated memory held by the released render targets, waiting to be reused. */
+		};
+
+		/**
+		 * Keeps released render targets around and hands them out again to later requests with the same properties,
+		 * instead of allocating new textures from the driver every time. Render targets are large, and allocating them
+		 * in the middle of a frame (e.g. when a resolution changes or an effect is toggled) causes hitches.
+		 *
+		 * Must only be used on the core thread.
+		 */
+		class RenderTargetPool
+		{
+		public:
+			/** Returns a render target with the requested properties, reusing a released one if possible. */
+			SPtr<RenderTexture> Acquire(const PooledRenderTargetDesc& desc);
+
+			/** Returns a render target acquired from the pool, so it can be handed out again. */
+			void Release(const SPtr<RenderTexture>& renderTarget);
+
+			/** Destroys all the released render targets. */
+			void Trim();
+
+			/** Returns the current usage statistics. */
+			const RenderTargetPoolStats& GetStats() const { return mStats; }
+
+		private:
+			/** Render target owned by the pool. */
+			struct Entry
+			{
+				SPtr<RenderTexture> RenderTarget;
+				PooledRenderTargetDesc Desc;
+				u64 Size;
+				bool InUse;
+			};
+
+			Vector<Entry> mEntries;
+			RenderTargetPoolStats mStats;
+		};
+	} // namespace ct
+} // namespace bs
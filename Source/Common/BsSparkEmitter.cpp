@@ -0,0 +1,335 @@
+#include "BsSparkEmitter.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCRenderable.h"
+#include "Material/BsMaterial.h"
+#include "Mesh/BsMesh.h"
+#include "Mesh/BsMeshData.h"
+#include "RenderAPI/BsVertexDataDesc.h"
+#include "Utility/BsTime.h"
+#include "Math/BsAABox.h"
+#include "BsJobs.h"
+
+namespace bs
+{
+	/** Smallest number of particles the attribute buffers are allocated for. */
+	static constexpr u32 MIN_CAPACITY = 64;
+
+	/** Number of sparks processed by a single chunk of the parallel loops. */
+	static constexpr u32 SPARKS_PER_CHUNK = 256;
+
+	SparkEmitter::SparkEmitter(const HSceneObject& parent, const HMaterial& material,
+		const SparkEmitterSettings& settings)
+		: Component(parent), mSettings(settings), mMaterial(material)
+	{
+		SetName("SparkEmitter");
+
+		// Cube of unit size, scaled by the size of the spark when written out. Each face has its own four vertices, whose
+		// normal points from the cube center towards the face center.
+		writeBoxVertices(AABox(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f)),
+			(u8*)&mCubeVertices[0].Position, (u8*)&mCubeVertices[0].UV, sizeof(CubeVertex));
+
+		for(u32 i = 0; i < BOX_NUM_VERTICES; i += 4)
+		{
+			const Vector3 faceCenter = (mCubeVertices[i].Position + mCubeVertices[i + 1].Position +
+				mCubeVertices[i + 2].Position + mCubeVertices[i + 3].Position) * 0.25f;
+
+			const Vector3 normal = Vector3::Normalize(faceCenter);
+			const Vector3 tangent = Vector3::Normalize(mCubeVertices[i + 1].Position - mCubeVertices[i].Position);
+
+			for(u32 j = 0; j < 4; j++)
+			{
+				mCubeVertices[i + j].Normal = normal;
+				mCubeVertices[i + j].Tangent = Vector4(tangent.X, tangent.Y, tangent.Z, 1.0f);
+			}
+		}
+	}
+
+	void SparkEmitter::OnInitialized()
+	{
+		if(!mSettings.SizeOverLifetime.GetKeyFrames().empty())
+			mSizeTable.Bake(mSettings.SizeOverLifetime);
+
+		if(!mSettings.ColorOverLifetime.GetKeys().empty())
+		{
+			mColorTable.Bake(mSettings.ColorOverLifetime);
+			mMaterial->SetTexture("gEmissiveMaskTex", CurveLookupTextures::Create(mColorTable));
+		}
+
+		const u32 numVertices = mSettings.MaxParticles * BOX_NUM_VERTICES;
+		const u32 numIndices = mSettings.MaxParticles * BOX_NUM_INDICES;
+
+		mIndices.resize(numIndices);
+		for(u32 i = 0; i < mSettings.MaxParticles; i++)
+		{
+			u32* indices = &mIndices[i * BOX_NUM_INDICES];
+			writeBoxIndices(indices);
+
+			for(u32 j = 0; j < BOX_NUM_INDICES; j++)
+				indices[j] += i * BOX_NUM_VERTICES;
+		}
+
+		SPtr<VertexDataDesc> vertexDesc = VertexDataDesc::Create();
+		vertexDesc->AddVertElem(VET_FLOAT3, VES_POSITION);
+		vertexDesc->AddVertElem(VET_FLOAT3, VES_NORMAL);
+		vertexDesc->AddVertElem(VET_FLOAT4, VES_TANGENT);
+		vertexDesc->AddVertElem(VET_FLOAT2, VES_TEXCOORD);
+
+		// The mesh is sized for the maximum number of sparks, with the unused cubes collapsed into degenerate triangles
+		MESH_DESC meshDesc;
+		meshDesc.NumVertices = numVertices;
+		meshDesc.NumIndices = numIndices;
+		meshDesc.VertexDesc = vertexDesc;
+		meshDesc.IndexType = IT_32BIT;
+		meshDesc.Usage = MU_DYNAMIC;
+
+		mMesh = Mesh::Create(meshDesc);
+
+		// Sparks are simulated in world space, so they're rendered from a separate object with an identity transform
+		mRenderSO = SceneObject::Create("Sparks");
+
+		HRenderable renderable = mRenderSO->AddComponent<CRenderable>();
+		renderable->SetMesh(mMesh);
+		renderable->SetMaterial(mMaterial);
+	}
+
+	void SparkEmitter::Update()
+	{
+		if(!mAutoUpdate)
+			return;
+
+		const float dt = gTime().GetFrameDelta();
+
+		Spawn(dt);
+		Simulate(dt);
+		WriteVertices();
+		UploadMesh();
+	}
+
+	void SparkEmitter::OnDestroyed()
+	{
+		for(auto& attribute : mAttributes)
+			attribute.Release();
+
+		mNumParticles = 0;
+		mCapacity = 0;
+
+		if(mRenderSO && !mRenderSO.IsDestroyed())
+			mRenderSO->Destroy();
+	}
+
+	void SparkEmitter::Spawn(float dt)
+	{
+		const float startTime = mTime;
+		mTime += dt;
+
+		const float numToSpawn = mSpawnRemainder + mSettings.EmissionRate * dt;
+		u32 count = (u32)numToSpawn;
+		mSpawnRemainder = numToSpawn - (float)count;
+
+		count = std::min(count, mSettings.MaxParticles - mNumParticles);
+		if(count == 0)
+			return;
+
+		Reserve(mNumParticles + count);
+
+		mSampler.SampleCone(mSettings.Shape, count, mSpawnBatch, startTime, mTime);
+
+		mSpawnLifetimes.resize(count);
+		mSampler.GetRandom().FillRange(mSpawnLifetimes.data(), count, mSettings.Lifetime * 0.5f, mSettings.Lifetime);
+
+		const Transform& tfrm = SO()->GetTransform();
+		const Matrix4 worldMatrix = SO()->GetWorldMatrix();
+		const Quaternion rotation = tfrm.GetRotation();
+
+		float* posX = GetAttribute(ATTR_POSITION_X);
+		float* posY = GetAttribute(ATTR_POSITION_Y);
+		float* posZ = GetAttribute(ATTR_POSITION_Z);
+		float* velX = GetAttribute(ATTR_VELOCITY_X);
+		float* velY = GetAttribute(ATTR_VELOCITY_Y);
+		float* velZ = GetAttribute(ATTR_VELOCITY_Z);
+		float* age = GetAttribute(ATTR_AGE);
+		float* lifetime = GetAttribute(ATTR_LIFETIME);
+
+		for(u32 i = 0; i < count; i++)
+		{
+			const u32 idx = mNumParticles + i;
+
+			const Vector3 position = worldMatrix.MultiplyAffine(mSpawnBatch.GetPosition(i));
+			const Vector3 velocity = rotation.Rotate(mSpawnBatch.GetDirection(i)) * mSettings.Speed;
+
+			posX[idx] = position.X;
+			posY[idx] = position.Y;
+			posZ[idx] = position.Z;
+			velX[idx] = velocity.X;
+			velY[idx] = velocity.Y;
+			velZ[idx] = velocity.Z;
+			age[idx] = 0.0f;
+			lifetime[idx] = mSpawnLifetimes[i];
+		}
+
+		mNumParticles += count;
+	}
+
+	void SparkEmitter::Simulate(float dt)
+	{
+		float* posX = GetAttribute(ATTR_POSITION_X);
+		float* posY = GetAttribute(ATTR_POSITION_Y);
+		float* posZ = GetAttribute(ATTR_POSITION_Z);
+		float* velX = GetAttribute(ATTR_VELOCITY_X);
+		float* velY = GetAttribute(ATTR_VELOCITY_Y);
+		float* velZ = GetAttribute(ATTR_VELOCITY_Z);
+		float* age = GetAttribute(ATTR_AGE);
+		float* lifetime = GetAttribute(ATTR_LIFETIME);
+
+		const float gravity = mSettings.Gravity * dt;
+		const float ground = mSettings.GroundHeight;
+		const float bounciness = mSettings.Bounciness;
+
+		// Sparks are independent, so chunks of them are integrated in parallel. Written using selects instead of branches,
+		// so the compiler can vectorize the loop.
+		Jobs::ParallelFor(0, mNumParticles, SPARKS_PER_CHUNK, [=](u32 begin, u32 end)
+		{
+			for(u32 i = begin; i < end; i++)
+			{
+				velY[i] -= gravity;
+
+				posX[i] += velX[i] * dt;
+				posY[i] += velY[i] * dt;
+				posZ[i] += velZ[i] * dt;
+
+				// Reflect sparks that went through the ground back above it, losing some of their speed
+				const bool below = posY[i] < ground;
+				posY[i] = below ? ground + (ground - posY[i]) * bounciness : posY[i];
+				velY[i] = below ? -velY[i] * bounciness : velY[i];
+				velX[i] = below ? velX[i] * bounciness : velX[i];
+				velZ[i] = below ? velZ[i] * bounciness : velZ[i];
+
+				age[i] += dt;
+			}
+		});
+
+		// Remove expired sparks by moving the last spark in their place
+		for(u32 i = 0; i < mNumParticles;)
+		{
+			if(age[i] < lifetime[i])
+			{
+				i++;
+				continue;
+			}
+
+			const u32 last = mNumParticles - 1;
+			posX[i] = posX[last];
+			posY[i] = posY[last];
+			posZ[i] = posZ[last];
+			velX[i] = velX[last];
+			velY[i] = velY[last];
+			velZ[i] = velZ[last];
+			age[i] = age[last];
+			lifetime[i] = lifetime[last];
+
+			mNumParticles--;
+		}
+	}
+
+	void SparkEmitter::WriteVertices()
+	{
+		// The previous mesh data may still be in use by the core thread, so every upload gets a new one
+		mMeshData = mMesh->AllocBuffer();
+
+		const u32 stride = mMeshData->GetVertexDesc()->GetVertexStride();
+		u8* const positionData = mMeshData->GetElementData(VES_POSITION);
+		u8* const normalData = mMeshData->GetElementData(VES_NORMAL);
+		u8* const tangentData = mMeshData->GetElementData(VES_TANGENT);
+		u8* const uvData = mMeshData->GetElementData(VES_TEXCOORD);
+
+		const float* posX = GetAttribute(ATTR_POSITION_X);
+		const float* posY = GetAttribute(ATTR_POSITION_Y);
+		const float* posZ = GetAttribute(ATTR_POSITION_Z);
+		const float* age = GetAttribute(ATTR_AGE);
+		const float* lifetime = GetAttribute(ATTR_LIFETIME);
+
+		// Evaluate the curves over the lifetime for all sparks at once
+		mNormalizedAges.resize(mNumParticles);
+		for(u32 i = 0; i < mNumParticles; i++)
+			mNormalizedAges[i] = age[i] / lifetime[i];
+
+		mSizes.resize(mNumParticles);
+		if(mSizeTable.IsBaked())
+		{
+			mSizeTable.Evaluate(mNormalizedAges.data(), mSizes.data(), mNumParticles);
+
+			for(auto& size : mSizes)
+				size *= mSettings.Size;
+		}
+		else
+			std::fill(mSizes.begin(), mSizes.end(), mSettings.Size);
+
+		// Every spark writes its own range of vertices, so chunks of sparks are written out in parallel
+		const bool hasColor = mColorTable.IsBaked();
+		Jobs::ParallelFor(0, mNumParticles, SPARKS_PER_CHUNK, [&](u32 begin, u32 end)
+		{
+			const u32 offset = begin * BOX_NUM_VERTICES * stride;
+			u8* positions = positionData + offset;
+			u8* normals = normalData + offset;
+			u8* tangents = tangentData + offset;
+			u8* uvs = uvData + offset;
+
+			for(u32 i = begin; i < end; i++)
+			{
+				const Vector3 center(posX[i], posY[i], posZ[i]);
+				const Vector2 colorUV(mNormalizedAges[i], 0.5f);
+
+				for(u32 j = 0; j < BOX_NUM_VERTICES; j++)
+				{
+					const CubeVertex& vertex = mCubeVertices[j];
+					const Vector3 position = center + vertex.Position * mSizes[i];
+					const Vector2& uv = hasColor ? colorUV : vertex.UV;
+
+					memcpy(positions, &position, sizeof(position));
+					memcpy(normals, &vertex.Normal, sizeof(vertex.Normal));
+					memcpy(tangents, &vertex.Tangent, sizeof(vertex.Tangent));
+					memcpy(uvs, &uv, sizeof(uv));
+
+					positions += stride;
+					normals += stride;
+					tangents += stride;
+					uvs += stride;
+				}
+			}
+		});
+
+		// Collapse the unused cubes into a single point
+		const u32 numUsedVertices = mNumParticles * BOX_NUM_VERTICES;
+		const u32 numVertices = mMeshData->GetNumVertices();
+		memset(mMeshData->GetStreamData(0) + numUsedVertices * stride, 0, (numVertices - numUsedVertices) * stride);
+
+		memcpy(mMeshData->GetIndices32(), mIndices.data(), mIndices.size() * sizeof(u32));
+	}
+
+	void SparkEmitter::UploadMesh()
+	{
+		if(!mMeshData)
+			return;
+
+		mMesh->WriteData(mMeshData, true);
+		mMeshData = nullptr;
+	}
+
+	void SparkEmitter::Reserve(u32 count)
+	{
+		if(count <= mCapacity)
+			return;
+
+		// Grow geometrically so a steadily increasing number of sparks doesn't swap chunks every frame
+		u32 capacity = std::max(mCapacity, MIN_CAPACITY);
+		while(capacity < count)
+			capacity *= 2;
+
+		capacity = std::min(capacity, std::max(mSettings.MaxParticles, count));
+
+		for(auto& attribute : mAttributes)
+			attribute.Resize(capacity * sizeof(float));
+
+		mCapacity = capacity;
+	}
+} // namespace bs
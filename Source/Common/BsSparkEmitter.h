@@ -0,0 +1,156 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Scene/BsComponent.h"
+#include "Math/BsVector2.h"
+#include "Math/BsVector4.h"
+#include "BsEmitterShapeSampler.h"
+#include "BsParticleMemoryPool.h"
+#include "BsCurveLookupTable.h"
+#include "BsBoxGeometry.h"
+
+namespace bs
+{
+	/** Properties of the sparks emitted by a SparkEmitter. */
+	struct SparkEmitterSettings
+	{
+		PARTICLE_CONE_SHAPE_DESC Shape; /**< Shape the sparks spawn from, in the local space of the scene object. */
+		float EmissionRate = 200.0f; /**< Number of sparks spawned per second. */
+		float Speed = 4.0f; /**< Initial speed of the sparks, in meters per second. */
+		float Lifetime = 1.5f; /**< Longest time a spark stays alive, in seconds. */
+		float Size = 0.04f; /**< Length of the edges of the cubes representing the sparks, in meters. */
+		float Gravity = 9.81f;
+		float Bounciness = 0.4f; /**< Fraction of the vertical speed kept when bouncing off the ground. */
+		float GroundHeight = 0.0f; /**< Height of the ground plane the sparks bounce off, in world space. */
+		u32 MaxParticles = 1024; /**< Sparks that would be spawned while this many are alive are dropped. */
+
+		/** Scale applied to Size over the lifetime of a spark, evaluated with the normalized age. Ignored if empty. */
+		TAnimationCurve<float> SizeOverLifetime;
+
+		/**
+		 * Tint over the lifetime of a spark, evaluated with the normalized age. Baked into a texture that is assigned to
+		 * the material as its emissive mask, and looked up using the horizontal texture coordinate. Ignored if empty.
+		 */
+		ColorGradient ColorOverLifetime;
+	};
+
+	/**
+	 * Component that simulates sparks on the CPU and renders them as small cubes in a single dynamic mesh. Sparks are
+	 * spawned in batches using EmitterShapeSampler, fall under gravity and bounce off a ground plane.
+	 *
+	 * Particle attributes are stored as a structure of arrays, in buffers borrowed from the global ParticleMemoryPool. The
+	 * buffers grow as more sparks are alive and go back to the pool when the component is destroyed, so emitters that are
+	 * constantly created and destroyed reuse the same memory instead of going through the general heap.
+	 *
+	 * Curves over the lifetime of the sparks are baked into lookup tables when the component is initialized, and evaluated
+	 * for all the sparks at once every frame.
+	 *
+	 * Every frame the component calls Spawn(), Simulate(), WriteVertices() and UploadMesh() in that order. Simulate() and
+	 * WriteVertices() split the sparks between threads using Jobs::ParallelFor(). If automatic updates are disabled the
+	 * stages can be called from elsewhere instead, e.g. as tasks of a FrameTaskGraph. Only UploadMesh() must be called
+	 * from the main thread.
+	 */
+	class SparkEmitter : public Component
+	{
+	public:
+		/**
+		 * Constructs the emitter.
+		 *
+		 * @param	parent		Scene object the component is attached to. Determines where and in which direction the
+		 *						sparks are emitted.
+		 * @param	material	Material used for rendering the sparks. Must accept positions, normals, tangents and
+		 *						texture coordinates.
+		 * @param	settings	Properties of the emitted sparks.
+		 */
+		SparkEmitter(const HSceneObject& parent, const HMaterial& material,
+			const SparkEmitterSettings& settings = SparkEmitterSettings());
+
+		/** Triggered when the component is initialized. Creates the mesh and the renderable displaying the sparks. */
+		void OnInitialized() override;
+
+		/** Triggered once per frame. Advances the simulation by the frame delta and updates the mesh. */
+		void Update() override;
+
+		/** Triggered when the component is destroyed. Returns the particle buffers to the pool. */
+		void OnDestroyed() override;
+
+		/** Spawns the sparks emitted during the last 'dt' seconds. */
+		void Spawn(float dt);
+
+		/** Advances all live sparks by 'dt' seconds and removes the ones that expired. */
+		void Simulate(float dt);
+
+		/** Writes the vertices of all live sparks into the mesh data to upload. */
+		void WriteVertices();
+
+		/** Uploads the mesh data written by WriteVertices() to the GPU. */
+		void UploadMesh();
+
+		/** Returns the number of sparks currently alive. */
+		u32 GetNumParticles() const { return mNumParticles; }
+
+		/**
+		 * Determines if Update() advances the emitter. When disabled, the caller is responsible for calling all the stages
+		 * every frame. Enabled by default.
+		 */
+		void SetAutoUpdate(bool enabled) { mAutoUpdate = enabled; }
+
+	private:
+		/** Per-particle attributes, each stored in its own buffer. */
+		enum Attribute
+		{
+			ATTR_POSITION_X,
+			ATTR_POSITION_Y,
+			ATTR_POSITION_Z,
+			ATTR_VELOCITY_X,
+			ATTR_VELOCITY_Y,
+			ATTR_VELOCITY_Z,
+			ATTR_AGE,
+			ATTR_LIFETIME,
+			ATTR_COUNT
+		};
+
+		/** Returns the buffer holding the values of the specified attribute. */
+		float* GetAttribute(u32 attribute) const { return (float*)mAttributes[attribute].GetData(); }
+
+		/** Makes sure the attribute buffers can hold at least 'count' particles, preserving the existing values. */
+		void Reserve(u32 count);
+
+		SparkEmitterSettings mSettings;
+		HMaterial mMaterial;
+
+		EmitterShapeSampler mSampler;
+		ParticleSpawnBatch mSpawnBatch;
+		Vector<float> mSpawnLifetimes;
+
+		CurveLookupTable mSizeTable;
+		ColorGradientLookupTable mColorTable;
+		Vector<float> mNormalizedAges;
+		Vector<float> mSizes;
+		float mSpawnRemainder = 0.0f;
+		float mTime = 0.0f; /**< Time since the emitter was created, in seconds. */
+		bool mAutoUpdate = true;
+
+		PooledParticleBuffer mAttributes[ATTR_COUNT];
+		u32 mNumParticles = 0;
+		u32 mCapacity = 0;
+
+		HSceneObject mRenderSO;
+		HMesh mMesh;
+		SPtr<MeshData> mMeshData;
+
+		/** Vertex of the cube representing a spark, with the position relative to the cube center. */
+		struct CubeVertex
+		{
+			Vector3 Position;
+			Vector3 Normal;
+			Vector4 Tangent;
+			Vector2 UV;
+		};
+
+		CubeVertex mCubeVertices[BOX_NUM_VERTICES];
+		Vector<u32> mIndices;
+	};
+
+	using HSparkEmitter = GameObjectHandle<SparkEmitter>;
+} // namespace bs
@@ -0,0 +1,264 @@
+#include "BsStaticBatcher.h"
+#include "Scene/BsSceneObject.h"
+#include "Components/BsCRenderable.h"
+#include "Material/BsMaterial.h"
+#include "Mesh/BsMesh.h"
+#include "Mesh/BsMeshData.h"
+#include "RenderAPI/BsVertexDataDesc.h"
+#include "CoreThread/BsCoreThread.h"
+#include "Math/BsAABox.h"
+#include "Math/BsVector2.h"
+#include "Math/BsVector4.h"
+#include "Math/BsMatrix4.h"
+
+namespace bs
+{
+	/**
+	 * Checks if the vertices have the element in the provided format, in the first stream. Optional elements may be
+	 * missing.
+	 */
+	static bool hasElementOfType(const VertexDataDesc& desc, VertexElementSemantic semantic, VertexElementType type,
+		bool optional)
+	{
+		const VertexElement* element = desc.GetElement(semantic);
+		if(element == nullptr)
+			return optional;
+
+		return element->GetType() == type && element->GetStreamIdx() == 0;
+	}
+
+	StaticBatcher::StaticBatcher(float chunkSize)
+		: mChunkSize(chunkSize)
+	{}
+
+	void StaticBatcher::Add(const HRenderable& renderable)
+	{
+		mRenderables.push_back(renderable);
+	}
+
+	Vector<HRenderable> StaticBatcher::Build(const String& name)
+	{
+		mStats = StaticBatchStats();
+
+		// Group the sub-meshes by material, layer and chunk. Ordered, so the batches are created in the same order
+		// every time.
+		Map<BatchKey, Batch> batches;
+		Vector<HRenderable> merged;
+		for(auto& renderable : mRenderables)
+		{
+			if(renderable.IsDestroyed())
+				continue;
+
+			HMesh mesh = renderable->GetMesh();
+			if(!mesh.IsLoaded())
+			{
+				mStats.NumSkipped++;
+				continue;
+			}
+
+			// Only triangle lists can be appended to each other
+			const MeshProperties& meshProps = mesh->GetProperties();
+			bool mergeable = true;
+			for(u32 i = 0; i < meshProps.GetNumSubMeshes(); i++)
+				mergeable &= meshProps.GetSubMesh(i).DrawOp == DOT_TRIANGLE_LIST;
+
+			// Meshes are read back once, no matter how many renderables use them
+			SPtr<MeshData>& meshData = mMeshData[mesh.Get()];
+			if(mergeable && !meshData)
+			{
+				meshData = mesh->GetCachedData();
+				if(!meshData)
+				{
+					// The read is queued on the core thread, so submit the queue and wait for it to finish
+					meshData = mesh->AllocBuffer();
+					mesh->ReadData(meshData);
+					gCoreThread().SubmitAll(true);
+				}
+			}
+
+			if(mergeable)
+			{
+				const VertexDataDesc& desc = *meshData->GetVertexDesc();
+				mergeable = hasElementOfType(desc, VES_POSITION, VET_FLOAT3, false) &&
+					hasElementOfType(desc, VES_NORMAL, VET_FLOAT3, true) &&
+					hasElementOfType(desc, VES_TANGENT, VET_FLOAT4, true) &&
+					hasElementOfType(desc, VES_TEXCOORD, VET_FLOAT2, true);
+			}
+
+			if(!mergeable)
+			{
+				mStats.NumSkipped++;
+				continue;
+			}
+
+			const Vector3 center = renderable->GetBounds().GetBox().GetCenter();
+			const i32 chunkX = Math::FloorToInt(center.X / mChunkSize);
+			const i32 chunkY = Math::FloorToInt(center.Y / mChunkSize);
+			const i32 chunkZ = Math::FloorToInt(center.Z / mChunkSize);
+
+			for(u32 i = 0; i < meshProps.GetNumSubMeshes(); i++)
+			{
+				// Sub-meshes without a material aren't drawn
+				HMaterial material = renderable->GetMaterial(i);
+				if(!material.IsLoaded())
+					continue;
+
+				Batch& batch = batches[BatchKey(material.Get(), renderable->GetLayer(), chunkX, chunkY, chunkZ)];
+				batch.Material = material;
+				batch.Layer = renderable->GetLayer();
+				batch.Entries.push_back({ renderable, i });
+			}
+
+			merged.push_back(renderable);
+		}
+
+		Vector<HRenderable> output;
+		if(!batches.empty())
+		{
+			HSceneObject root = SceneObject::Create(name);
+			for(auto& entry : batches)
+			{
+				const Batch& batch = entry.second;
+
+				// Vertices are stored relative to the center of the batch, to keep their precision
+				AABox bounds = batch.Entries[0].Renderable->GetBounds().GetBox();
+				for(auto& batchEntry : batch.Entries)
+					bounds.Merge(batchEntry.Renderable->GetBounds().GetBox());
+
+				const Vector3 origin = bounds.GetCenter();
+
+				HSceneObject batchSO = SceneObject::Create(name + " " + toString(mStats.NumBatches));
+				batchSO->SetParent(root);
+				batchSO->SetPosition(origin);
+
+				HRenderable renderable = batchSO->AddComponent<CRenderable>();
+				renderable->SetMesh(BuildMesh(batch, origin));
+				renderable->SetMaterial(batch.Material);
+				renderable->SetLayer(batch.Layer);
+
+				output.push_back(renderable);
+				mStats.NumBatches++;
+			}
+		}
+
+		for(auto& renderable : merged)
+			renderable->Destroy();
+
+		mStats.NumRenderables = (u32)merged.size();
+
+		mRenderables.clear();
+		mMeshData.clear();
+
+		return output;
+	}
+
+	HMesh StaticBatcher::BuildMesh(const Batch& batch, const Vector3& origin)
+	{
+		Vector<Vector3> positions;
+		Vector<Vector3> normals;
+		Vector<Vector4> tangents;
+		Vector<Vector2> uvs;
+		Vector<u32> indices;
+		Vector<u32> remap;
+
+		for(auto& entry : batch.Entries)
+		{
+			const HMesh& mesh = entry.Renderable->GetMesh();
+			const SubMesh& subMesh = mesh->GetProperties().GetSubMesh(entry.SubMeshIdx);
+			const MeshData& meshData = *mMeshData[mesh.Get()];
+
+			const VertexDataDesc& desc = *meshData.GetVertexDesc();
+			const u32 stride = desc.GetVertexStride();
+			const u8* srcPositions = meshData.GetElementData(VES_POSITION);
+			const u8* srcNormals = desc.HasElement(VES_NORMAL) ? meshData.GetElementData(VES_NORMAL) : nullptr;
+			const u8* srcTangents = desc.HasElement(VES_TANGENT) ? meshData.GetElementData(VES_TANGENT) : nullptr;
+			const u8* srcUVs = desc.HasElement(VES_TEXCOORD) ? meshData.GetElementData(VES_TEXCOORD) : nullptr;
+
+			// Normals need the inverse transpose to stay perpendicular to non-uniformly scaled surfaces, and mirroring
+			// transforms flip the triangles inside out unless their winding is reversed
+			const Matrix4 worldMatrix = entry.Renderable->SO()->GetWorldMatrix();
+			const Matrix4 normalMatrix = worldMatrix.InverseAffine().Transpose();
+			const bool mirrored = worldMatrix.Determinant3x3() < 0.0f;
+
+			// Only copy the vertices referenced by the sub-mesh, once each
+			remap.assign(meshData.GetNumVertices(), (u32)-1);
+			const u32 firstIndex = (u32)indices.size();
+			for(u32 i = 0; i < subMesh.IndexCount; i++)
+			{
+				const u32 indexIdx = subMesh.IndexOffset + i;
+				const u32 vertexIdx = meshData.GetIndexType() == IT_32BIT ? meshData.GetIndices32()[indexIdx]
+					: meshData.GetIndices16()[indexIdx];
+
+				if(remap[vertexIdx] == (u32)-1)
+				{
+					remap[vertexIdx] = (u32)positions.size();
+
+					Vector3 position;
+					memcpy(&position, srcPositions + vertexIdx * stride, sizeof(position));
+					positions.push_back(worldMatrix.MultiplyAffine(position) - origin);
+
+					Vector3 normal = Vector3::UNIT_Y;
+					if(srcNormals)
+						memcpy(&normal, srcNormals + vertexIdx * stride, sizeof(normal));
+
+					normals.push_back(Vector3::Normalize(normalMatrix.MultiplyDirection(normal)));
+
+					Vector4 tangent(1.0f, 0.0f, 0.0f, 1.0f);
+					if(srcTangents)
+						memcpy(&tangent, srcTangents + vertexIdx * stride, sizeof(tangent));
+
+					const Vector3 tangentDir = Vector3::Normalize(
+						worldMatrix.MultiplyDirection(Vector3(tangent.X, tangent.Y, tangent.Z)));
+					const float handedness = mirrored ? -tangent.W : tangent.W;
+					tangents.push_back(Vector4(tangentDir.X, tangentDir.Y, tangentDir.Z, handedness));
+
+					Vector2 uv = Vector2::ZERO;
+					if(srcUVs)
+						memcpy(&uv, srcUVs + vertexIdx * stride, sizeof(uv));
+
+					uvs.push_back(uv);
+				}
+
+				indices.push_back(remap[vertexIdx]);
+			}
+
+			if(mirrored)
+			{
+				for(u32 i = firstIndex; i + 2 < (u32)indices.size(); i += 3)
+					std::swap(indices[i + 1], indices[i + 2]);
+			}
+		}
+
+		SPtr<VertexDataDesc> vertexDesc = VertexDataDesc::Create();
+		vertexDesc->AddVertElem(VET_FLOAT3, VES_POSITION);
+		vertexDesc->AddVertElem(VET_FLOAT3, VES_NORMAL);
+		vertexDesc->AddVertElem(VET_FLOAT4, VES_TANGENT);
+		vertexDesc->AddVertElem(VET_FLOAT2, VES_TEXCOORD);
+
+		const u32 numVertices = (u32)positions.size();
+		const u32 numIndices = (u32)indices.size();
+
+		// Most batches of static scenery fit 16-bit indices, halving the size of the index buffer
+		const IndexType indexType = numVertices > 0xFFFF ? IT_32BIT : IT_16BIT;
+
+		SPtr<MeshData> meshData = MeshData::Create(numVertices, numIndices, vertexDesc, indexType);
+		meshData->SetVertexData(VES_POSITION, positions.data(), numVertices * sizeof(Vector3));
+		meshData->SetVertexData(VES_NORMAL, normals.data(), numVertices * sizeof(Vector3));
+		meshData->SetVertexData(VES_TANGENT, tangents.data(), numVertices * sizeof(Vector4));
+		meshData->SetVertexData(VES_TEXCOORD, uvs.data(), numVertices * sizeof(Vector2));
+
+		if(indexType == IT_32BIT)
+			memcpy(meshData->GetIndices32(), indices.data(), numIndices * sizeof(u32));
+		else
+		{
+			u16* dstIndices = meshData->GetIndices16();
+			for(u32 i = 0; i < numIndices; i++)
+				dstIndices[i] = (u16)indices[i];
+		}
+
+		mStats.NumVertices += numVertices;
+		mStats.NumIndices += numIndices;
+
+		return Mesh::Create(meshData);
+	}
+} // namespace bs
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsVector3.h"
+
+namespace bs
+{
+	/** Counters describing the result of a StaticBatcher::Build() call. */
+	struct StaticBatchStats
+	{
+		u32 NumRenderables = 0; /**< Renderables merged into batches. */
+		u32 NumSkipped = 0; /**< Renderables left as they were, because their meshes can't be merged. */
+		u32 NumBatches = 0; /**< Renderables created for the batches, each drawn with a single draw call. */
+		u32 NumVertices = 0;
+		u32 NumIndices = 0;
+	};
+
+	/**
+	 * Merges the meshes of static renderables into a small number of combined meshes, once while the scene is being set up.
+	 *
+	 * Sub-meshes sharing a material and a layer are transformed into world space and appended into shared vertex and
+	 * index buffers. Batches are additionally split into cubic chunks of the world, by the center of each renderable's
+	 * bounds, so the renderer can still cull the parts of the scenery that aren't visible. Every batch is then drawn with
+	 * a single draw call instead of one per renderable.
+	 *
+	 * The merged renderable components are destroyed, while their scene objects and other components (e.g. colliders)
+	 * are kept. Renderables must not move or change their mesh or materials once added, and only triangle list meshes
+	 * with 32-bit float positions, normals, tangents and texture coordinates can be merged.
+	 */
+	class StaticBatcher
+	{
+	public:
+		/**
+		 * Creates an empty batcher.
+		 *
+		 * @param	chunkSize	Size of the world space chunks the batches are split into, along each axis.
+		 */
+		StaticBatcher(float chunkSize = DEFAULT_CHUNK_SIZE);
+
+		/** Queues a renderable to be merged by the next Build() call. */
+		void Add(const HRenderable& renderable);
+
+		/**
+		 * Merges all the queued renderables and clears the queue. Renderables whose meshes can't be merged are left
+		 * unchanged.
+		 *
+		 * @param	name	Name of the scene object created as the parent of all the batches.
+		 * @return			Renderables drawing the batches.
+		 */
+		Vector<HRenderable> Build(const String& name = "StaticBatch");
+
+		/** Returns the counters of the last Build() call. */
+		const StaticBatchStats& GetStats() const { return mStats; }
+
+		/** Default size of the chunks the batches are split into, in world units. */
+		static constexpr float DEFAULT_CHUNK_SIZE = 32.0f;
+
+	private:
+		/** Material, layer and chunk of a batch, ordering the batches. */
+		using BatchKey = std::tuple<const Material*, u64, i32, i32, i32>;
+
+		/** Sub-mesh of a renderable, merged into a batch. */
+		struct BatchEntry
+		{
+			HRenderable Renderable;
+			u32 SubMeshIdx;
+		};
+
+		/** Sub-meshes merged into a single mesh. */
+		struct Batch
+		{
+			HMaterial Material;
+			u64 Layer;
+			Vector<BatchEntry> Entries;
+		};
+
+		/** Merges the entries of a batch into a mesh, positioned relative to the provided origin. */
+		HMesh BuildMesh(const Batch& batch, const Vector3& origin);
+
+		float mChunkSize;
+		Vector<HRenderable> mRenderables;
+		UnorderedMap<const Mesh*, SPtr<MeshData>> mMeshData;
+		StaticBatchStats mStats;
+	};
+} // namespace bs
@@ -0,0 +1,100 @@
+#include "BsTextLayoutCache.h"
+#include "Text/BsFont.h"
+#include "Text/BsTextData.h"
+#include "2D/BsTextSprite.h"
+#include "String/BsUnicode.h"
+#include <algorithm>
+
+namespace bs
+{
+	/** Mixes the hash of 'value' into 'seed'. */
+	template<class T>
+	static void hashCombine(size_t& seed, const T& value)
+	{
+		seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	size_t TextLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const
+	{
+		size_t hash = 0;
+		hashCombine(hash, key.Text);
+		hashCombine(hash, key.FontUUID);
+		hashCombine(hash, key.FontSize);
+		hashCombine(hash, key.WrapWidth);
+
+		return hash;
+	}
+
+	TextLayoutCache::TextLayoutCache(u32 capacity)
+		: mCapacity(std::max(capacity, 1U))
+	{}
+
+	const TextLayout& TextLayoutCache::Get(const String& text, const HFont& font, u32 fontSize, u32 wrapWidth)
+	{
+		LayoutKey key;
+		key.Text = text;
+		key.FontUUID = font.GetUUID();
+		key.FontSize = fontSize;
+		key.WrapWidth = wrapWidth;
+
+		auto iterFind = mLookup.find(key);
+		if(iterFind != mLookup.end())
+		{
+			// Move to the front, marking the entry as most recently used
+			mEntries.splice(mEntries.begin(), mEntries, iterFind->second);
+
+			mStats.NumHits++;
+			return iterFind->second->Layout;
+		}
+
+		mStats.NumMisses++;
+
+		if(mLookup.size() >= mCapacity)
+		{
+			mLookup.erase(mEntries.back().Key);
+			mEntries.pop_back();
+
+			mStats.NumEvictions++;
+		}
+
+		mEntries.push_front({ key, CreateLayout(text, font, fontSize, wrapWidth) });
+		mLookup[std::move(key)] = mEntries.begin();
+
+		return mEntries.front().Layout;
+	}
+
+	void TextLayoutCache::Clear()
+	{
+		mEntries.clear();
+		mLookup.clear();
+	}
+
+	TextLayout TextLayoutCache::CreateLayout(const String& text, const HFont& font, u32 fontSize, u32 wrapWidth)
+	{
+		const bool wordWrap = wrapWidth > 0;
+		TextData<> textData(UTF8::ToUTF32(text), font, fontSize, wrapWidth, 0, wordWrap);
+
+		TextLayout layout;
+		layout.Width = textData.GetWidth();
+		layout.Height = textData.GetHeight();
+
+		const u32 numPages = textData.GetNumPages();
+		layout.Pages.resize(numPages);
+
+		for(u32 i = 0; i < numPages; i++)
+		{
+			TextLayoutPage& page = layout.Pages[i];
+			page.Texture = textData.GetTextureForPage(i);
+			page.NumQuads = textData.GetNumQuadsForPage(i);
+
+			page.Positions.resize(page.NumQuads * 4);
+			page.UVs.resize(page.NumQuads * 4);
+			page.Indices.resize(page.NumQuads * 6);
+
+			TextSprite::GenTextQuads(i, textData, layout.Width, layout.Height, THA_Left, TVA_Top, SA_TopLeft,
+				page.Positions.data(), page.UVs.data(), page.Indices.data(), page.NumQuads);
+		}
+
+		return layout;
+	}
+} // namespace bs
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsVector2.h"
+#include "Utility/BsUUID.h"
+
+namespace bs
+{
+	/** Glyph quads of a laid out string that use a single font page texture. */
+	struct TextLayoutPage
+	{
+		HTexture Texture; /**< Font page texture the glyphs are sampled from. */
+		u32 NumQuads = 0;
+		Vector<Vector2> Positions; /**< Four vertex positions per quad, relative to the top left corner of the text. */
+		Vector<Vector2> UVs; /**< Four texture coordinates per quad. */
+		Vector<u32> Indices; /**< Six indices per quad, forming two triangles. */
+	};
+
+	/** Result of laying out a string, ready to be rendered as a set of textured quads. */
+	struct TextLayout
+	{
+		u32 Width = 0; /**< Width of the laid out text, in pixels. */
+		u32 Height = 0; /**< Height of the laid out text, in pixels. */
+		Vector<TextLayoutPage> Pages;
+	};
+
+	/** Counters describing how effective the text layout cache is. */
+	struct TextLayoutCacheStats
+	{
+		u64 NumHits = 0;
+		u64 NumMisses = 0;
+		u64 NumEvictions = 0;
+
+		/** Returns the fraction of lookups that were served from the cache, in range [0, 1]. */
+		float GetHitRate() const
+		{
+			const u64 numLookups = NumHits + NumMisses;
+			return numLookups > 0 ? NumHits / (float)numLookups : 0.0f;
+		}
+	};
+
+	/**
+	 * Caches the results of text layout (breaking text into lines and positioning the glyphs), keyed by the string, font,
+	 * font size and wrap width. Laying out text that was laid out recently with the same parameters is a lookup, rather
+	 * than a walk over every character. Least recently used layouts are evicted once the cache is full.
+	 */
+	class TextLayoutCache
+	{
+	public:
+		/** @param	capacity	Maximum number of layouts to keep in the cache. */
+		TextLayoutCache(u32 capacity = DEFAULT_CAPACITY);
+
+		/**
+		 * Returns the layout of the provided text, laying it out if it isn't in the cache.
+		 *
+		 * @param	text		Text to lay out, in UTF-8.
+		 * @param	font		Font to render the text with.
+		 * @param	fontSize	Size of the font, in points.
+		 * @param	wrapWidth	Width at which lines are wrapped, in pixels. 0 disables wrapping.
+		 * @return				Layout of the text. Valid until the next call to Get() or Clear().
+		 */
+		const TextLayout& Get(const String& text, const HFont& font, u32 fontSize, u32 wrapWidth = 0);
+
+		/** Removes all layouts from the cache. Counters are not reset. */
+		void Clear();
+
+		/** Returns the number of layouts in the cache. */
+		u32 GetNumEntries() const { return (u32)mLookup.size(); }
+
+		/** Returns the hit and miss counters. */
+		const TextLayoutCacheStats& GetStats() const { return mStats; }
+
+		/** Lays out the text without consulting the cache. Parameters are the same as for Get(). */
+		static TextLayout CreateLayout(const String& text, const HFont& font, u32 fontSize, u32 wrapWidth = 0);
+
+		static constexpr u32 DEFAULT_CAPACITY = 1024;
+
+	private:
+		/** Parameters the layout depends on. */
+		struct LayoutKey
+		{
+			String Text;
+			UUID FontUUID;
+			u32 FontSize;
+			u32 WrapWidth;
+
+			bool operator==(const LayoutKey& rhs) const
+			{
+				return FontSize == rhs.FontSize && WrapWidth == rhs.WrapWidth && FontUUID == rhs.FontUUID &&
+					Text == rhs.Text;
+			}
+		};
+
+		/** Hashes the key, for the lookup table. */
+		struct LayoutKeyHash
+		{
+			size_t operator()(const LayoutKey& key) const;
+		};
+
+		/** Cached layout, along with the key it is stored under. */
+		struct Entry
+		{
+			LayoutKey Key;
+			TextLayout Layout;
+		};
+
+		u32 mCapacity;
+		List<Entry> mEntries; /**< Most recently used entries at the front. */
+		UnorderedMap<LayoutKey, List<Entry>::iterator, LayoutKeyHash> mLookup;
+		TextLayoutCacheStats mStats;
+	};
+} // namespace bs
@@ -0,0 +1,238 @@
+#include "BsTransformKernels.h"
+#include "BsTransformKernelsImpl.h"
+#include "BsCpuFeatures.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define BS_TRANSFORM_KERNELS_NEON 1
+#else
+#	define BS_TRANSFORM_KERNELS_NEON 0
+#endif
+
+namespace bs
+{
+#if BS_TRANSFORM_KERNELS_NEON
+namespace
+{
+	/** Group of 4 floats processed together. */
+	struct TransformFloat4 { float32x4_t Value; };
+
+	inline TransformFloat4 operator+(TransformFloat4 lhs, TransformFloat4 rhs)
+	{
+		return { vaddq_f32(lhs.Value, rhs.Value) };
+	}
+
+	inline TransformFloat4 operator-(TransformFloat4 lhs, TransformFloat4 rhs)
+	{
+		return { vsubq_f32(lhs.Value, rhs.Value) };
+	}
+
+	inline TransformFloat4 operator*(TransformFloat4 lhs, TransformFloat4 rhs)
+	{
+		return { vmulq_f32(lhs.Value, rhs.Value) };
+	}
+} // namespace
+
+	template<>
+	struct TransformLanes<TransformFloat4>
+	{
+		static constexpr u32 WIDTH = 4;
+
+		static TransformFloat4 Load(const float* data) { return { vld1q_f32(data) }; }
+		static void Store(float* data, TransformFloat4 value) { vst1q_f32(data, value.Value); }
+		static TransformFloat4 Set(float value) { return { vdupq_n_f32(value) }; }
+		static TransformFloat4 Abs(TransformFloat4 value) { return { vabsq_f32(value.Value) }; }
+	};
+#endif
+
+	/**
+	 * Runs a kernel over 'count' elements. Whole groups of elements are processed using AVX2 if the CPU supports it, or
+	 * NEON on ARM targets. The remaining elements, or all of them if no SIMD instruction set is available, are processed
+	 * with scalar code.
+	 */
+	template<class Kernel>
+	static void runKernel(const Kernel& kernel, u32 count)
+	{
+		u32 idx = 0;
+
+#if BS_COMMON_AVX2
+		if(CpuFeatures::HasAVX2())
+			idx = runTransformKernelAVX2(kernel, 0, count);
+#elif BS_TRANSFORM_KERNELS_NEON
+		idx = kernel.template Run<TransformFloat4>(0, count);
+#endif
+
+		kernel.template Run<float>(idx, count);
+	}
+
+	void Vector3SoA::Resize(u32 count)
+	{
+		X.resize(count);
+		Y.resize(count);
+		Z.resize(count);
+	}
+
+	void QuaternionSoA::Resize(u32 count)
+	{
+		W.resize(count);
+		X.resize(count);
+		Y.resize(count);
+		Z.resize(count);
+	}
+
+	void Matrix4SoA::Resize(u32 count)
+	{
+		for(auto& entry : Elements)
+			entry.resize(count);
+	}
+
+	void Matrix4SoA::Set(u32 idx, const Matrix4& value)
+	{
+		for(u32 row = 0; row < 4; row++)
+		{
+			for(u32 column = 0; column < 4; column++)
+				Elements[row * 4 + column][idx] = value[row][column];
+		}
+	}
+
+	Matrix4 Matrix4SoA::Get(u32 idx) const
+	{
+		Matrix4 output;
+		for(u32 row = 0; row < 4; row++)
+		{
+			for(u32 column = 0; column < 4; column++)
+				output[row][column] = Elements[row * 4 + column][idx];
+		}
+
+		return output;
+	}
+
+	void TransformKernels::ComposeTRS(const Vector3SoA& translations, const QuaternionSoA& rotations,
+		const Vector3SoA& scales, Matrix4SoA& output, u32 count)
+	{
+		ComposeTRSKernel kernel;
+		kernel.Translations[0] = translations.X.data();
+		kernel.Translations[1] = translations.Y.data();
+		kernel.Translations[2] = translations.Z.data();
+		kernel.Rotations[0] = rotations.W.data();
+		kernel.Rotations[1] = rotations.X.data();
+		kernel.Rotations[2] = rotations.Y.data();
+		kernel.Rotations[3] = rotations.Z.data();
+		kernel.Scales[0] = scales.X.data();
+		kernel.Scales[1] = scales.Y.data();
+		kernel.Scales[2] = scales.Z.data();
+
+		for(u32 i = 0; i < 16; i++)
+			kernel.Output[i] = output.Elements[i].data();
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::Multiply(const Matrix4& lhs, const Matrix4SoA& rhs, Matrix4SoA& output, u32 count)
+	{
+		MultiplyKernel kernel;
+		for(u32 row = 0; row < 4; row++)
+		{
+			for(u32 column = 0; column < 4; column++)
+				kernel.Left[row * 4 + column] = lhs[row][column];
+		}
+
+		for(u32 i = 0; i < 16; i++)
+		{
+			kernel.Right[i] = rhs.Elements[i].data();
+			kernel.Output[i] = output.Elements[i].data();
+		}
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::Multiply(const Matrix4SoA& lhs, const Matrix4SoA& rhs, Matrix4SoA& output, u32 count)
+	{
+		MultiplyBatchKernel kernel;
+		for(u32 i = 0; i < 16; i++)
+		{
+			kernel.Left[i] = lhs.Elements[i].data();
+			kernel.Right[i] = rhs.Elements[i].data();
+			kernel.Output[i] = output.Elements[i].data();
+		}
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::Rotate(const Quaternion& rotation, const Vector3SoA& input, Vector3SoA& output, u32 count)
+	{
+		RotateKernel kernel;
+		kernel.Rotation[0] = rotation.W;
+		kernel.Rotation[1] = rotation.X;
+		kernel.Rotation[2] = rotation.Y;
+		kernel.Rotation[3] = rotation.Z;
+		kernel.Input[0] = input.X.data();
+		kernel.Input[1] = input.Y.data();
+		kernel.Input[2] = input.Z.data();
+		kernel.Output[0] = output.X.data();
+		kernel.Output[1] = output.Y.data();
+		kernel.Output[2] = output.Z.data();
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::Rotate(const QuaternionSoA& rotations, const Vector3SoA& input, Vector3SoA& output, u32 count)
+	{
+		RotateBatchKernel kernel;
+		kernel.Rotations[0] = rotations.W.data();
+		kernel.Rotations[1] = rotations.X.data();
+		kernel.Rotations[2] = rotations.Y.data();
+		kernel.Rotations[3] = rotations.Z.data();
+		kernel.Input[0] = input.X.data();
+		kernel.Input[1] = input.Y.data();
+		kernel.Input[2] = input.Z.data();
+		kernel.Output[0] = output.X.data();
+		kernel.Output[1] = output.Y.data();
+		kernel.Output[2] = output.Z.data();
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::TransformPoints(const Matrix4& transform, const Vector3SoA& input, Vector3SoA& output,
+		u32 count)
+	{
+		TransformPointsKernel kernel;
+		for(u32 row = 0; row < 3; row++)
+		{
+			for(u32 column = 0; column < 4; column++)
+				kernel.Transform[row * 4 + column] = transform[row][column];
+		}
+
+		kernel.Input[0] = input.X.data();
+		kernel.Input[1] = input.Y.data();
+		kernel.Input[2] = input.Z.data();
+		kernel.Output[0] = output.X.data();
+		kernel.Output[1] = output.Y.data();
+		kernel.Output[2] = output.Z.data();
+
+		runKernel(kernel, count);
+	}
+
+	void TransformKernels::TransformAABB(const Matrix4SoA& transforms, const Vector3SoA& minimums,
+		const Vector3SoA& maximums, Vector3SoA& outMinimums, Vector3SoA& outMaximums, u32 count)
+	{
+		TransformAABBKernel kernel;
+		for(u32 i = 0; i < 12; i++)
+			kernel.Transforms[i] = transforms.Elements[i].data();
+
+		kernel.Minimums[0] = minimums.X.data();
+		kernel.Minimums[1] = minimums.Y.data();
+		kernel.Minimums[2] = minimums.Z.data();
+		kernel.Maximums[0] = maximums.X.data();
+		kernel.Maximums[1] = maximums.Y.data();
+		kernel.Maximums[2] = maximums.Z.data();
+		kernel.OutMinimums[0] = outMinimums.X.data();
+		kernel.OutMinimums[1] = outMinimums.Y.data();
+		kernel.OutMinimums[2] = outMinimums.Z.data();
+		kernel.OutMaximums[0] = outMaximums.X.data();
+		kernel.OutMaximums[1] = outMaximums.Y.data();
+		kernel.OutMaximums[2] = outMaximums.Z.data();
+
+		runKernel(kernel, count);
+	}
+} // namespace bs
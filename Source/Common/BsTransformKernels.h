@@ -0,0 +1,112 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include "Math/BsVector3.h"
+#include "Math/BsQuaternion.h"
+#include "Math/BsMatrix4.h"
+
+namespace bs
+{
+	/** Batch of 3D vectors, stored as a structure of arrays. */
+	struct Vector3SoA
+	{
+		Vector<float> X;
+		Vector<float> Y;
+		Vector<float> Z;
+
+		/** Changes the number of vectors in the batch. */
+		void Resize(u32 count);
+
+		/** Returns the number of vectors in the batch. */
+		u32 GetCount() const { return (u32)X.size(); }
+
+		/** Assigns the vector at the specified index. */
+		void Set(u32 idx, const Vector3& value) { X[idx] = value.X; Y[idx] = value.Y; Z[idx] = value.Z; }
+
+		/** Returns the vector at the specified index. */
+		Vector3 Get(u32 idx) const { return Vector3(X[idx], Y[idx], Z[idx]); }
+	};
+
+	/** Batch of quaternions, stored as a structure of arrays. */
+	struct QuaternionSoA
+	{
+		Vector<float> W;
+		Vector<float> X;
+		Vector<float> Y;
+		Vector<float> Z;
+
+		/** Changes the number of quaternions in the batch. */
+		void Resize(u32 count);
+
+		/** Returns the number of quaternions in the batch. */
+		u32 GetCount() const { return (u32)W.size(); }
+
+		/** Assigns the quaternion at the specified index. */
+		void Set(u32 idx, const Quaternion& value) { W[idx] = value.W; X[idx] = value.X; Y[idx] = value.Y; Z[idx] = value.Z; }
+
+		/** Returns the quaternion at the specified index. */
+		Quaternion Get(u32 idx) const { return Quaternion(W[idx], X[idx], Y[idx], Z[idx]); }
+	};
+
+	/**
+	 * Batch of 4x4 matrices, stored as a structure of arrays. Element at row 'r' and column 'c' of every matrix is stored
+	 * in array 'r * 4 + c'.
+	 */
+	struct Matrix4SoA
+	{
+		Vector<float> Elements[16];
+
+		/** Changes the number of matrices in the batch. */
+		void Resize(u32 count);
+
+		/** Returns the number of matrices in the batch. */
+		u32 GetCount() const { return (u32)Elements[0].size(); }
+
+		/** Assigns the matrix at the specified index. */
+		void Set(u32 idx, const Matrix4& value);
+
+		/** Returns the matrix at the specified index. */
+		Matrix4 Get(u32 idx) const;
+	};
+
+	/**
+	 * Transform math operating on batches of values stored as structures of arrays. Each operation processes 8 values at
+	 * once using AVX2 if the CPU supports it (checked at runtime), or 4 using NEON, and falls back to scalar code on other
+	 * targets and for the remaining values.
+	 * Results match the equivalent Matrix4 and Quaternion methods, up to floating point rounding.
+	 *
+	 * Outputs must be large enough to hold the results, and must not overlap with the inputs unless noted otherwise.
+	 */
+	class TransformKernels
+	{
+	public:
+		/**
+		 * Builds a transform matrix from translation, rotation and scale, for each element of the batch. Equivalent to
+		 * Matrix4::TRS(). Rotations are expected to be normalized.
+		 */
+		static void ComposeTRS(const Vector3SoA& translations, const QuaternionSoA& rotations, const Vector3SoA& scales,
+			Matrix4SoA& output, u32 count);
+
+		/** Multiplies a single matrix with every matrix in the batch (lhs * rhs[i]), e.g. a view-projection matrix. */
+		static void Multiply(const Matrix4& lhs, const Matrix4SoA& rhs, Matrix4SoA& output, u32 count);
+
+		/** Multiplies matrices of two batches, element by element (lhs[i] * rhs[i]). */
+		static void Multiply(const Matrix4SoA& lhs, const Matrix4SoA& rhs, Matrix4SoA& output, u32 count);
+
+		/** Rotates every vector in the batch by the same quaternion. Output may be the same as the input. */
+		static void Rotate(const Quaternion& rotation, const Vector3SoA& input, Vector3SoA& output, u32 count);
+
+		/** Rotates vectors by quaternions of the other batch, element by element. Output may be the same as the input. */
+		static void Rotate(const QuaternionSoA& rotations, const Vector3SoA& input, Vector3SoA& output, u32 count);
+
+		/** Transforms points by an affine matrix, equivalent to Matrix4::MultiplyAffine(). Output may be the input. */
+		static void TransformPoints(const Matrix4& transform, const Vector3SoA& input, Vector3SoA& output, u32 count);
+
+		/**
+		 * Transforms axis aligned boxes by affine matrices, element by element, and outputs the axis aligned boxes
+		 * enclosing the results. Equivalent to AABox::TransformAffine(). Outputs may be the same as the inputs.
+		 */
+		static void TransformAABB(const Matrix4SoA& transforms, const Vector3SoA& minimums, const Vector3SoA& maximums,
+			Vector3SoA& outMinimums, Vector3SoA& outMaximums, u32 count);
+	};
+} // namespace bs
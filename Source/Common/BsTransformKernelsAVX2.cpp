@@ -0,0 +1,44 @@
+#include "BsTransformKernelsImpl.h"
+
+// Only compiled with AVX2 enabled on x86 targets, see Common/CMakeLists.txt
+#if BS_COMMON_AVX2
+#include <immintrin.h>
+
+namespace bs
+{
+namespace
+{
+	/** Group of 8 floats processed together. */
+	struct Float8 { __m256 Value; };
+
+	inline Float8 operator+(Float8 lhs, Float8 rhs) { return { _mm256_add_ps(lhs.Value, rhs.Value) }; }
+	inline Float8 operator-(Float8 lhs, Float8 rhs) { return { _mm256_sub_ps(lhs.Value, rhs.Value) }; }
+	inline Float8 operator*(Float8 lhs, Float8 rhs) { return { _mm256_mul_ps(lhs.Value, rhs.Value) }; }
+} // namespace
+
+	template<>
+	struct TransformLanes<Float8>
+	{
+		static constexpr u32 WIDTH = 8;
+
+		static Float8 Load(const float* data) { return { _mm256_loadu_ps(data) }; }
+		static void Store(float* data, Float8 value) { _mm256_storeu_ps(data, value.Value); }
+		static Float8 Set(float value) { return { _mm256_set1_ps(value) }; }
+		static Float8 Abs(Float8 value) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value.Value) }; }
+	};
+
+	template<class Kernel>
+	u32 runTransformKernelAVX2(const Kernel& kernel, u32 begin, u32 end)
+	{
+		return kernel.template Run<Float8>(begin, end);
+	}
+
+	template u32 runTransformKernelAVX2(const ComposeTRSKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const MultiplyKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const MultiplyBatchKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const RotateKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const RotateBatchKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const TransformPointsKernel&, u32, u32);
+	template u32 runTransformKernelAVX2(const TransformAABBKernel&, u32, u32);
+} // namespace bs
+#endif
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "BsPrerequisites.h"
+#include <cmath>
+
+// Kernels used by TransformKernels. Kept separate so they can be compiled both in BsTransformKernels.cpp (scalar and
+// NEON) and in BsTransformKernelsAVX2.cpp (AVX2). Only meant to be included by those two files.
+
+namespace bs
+{
+	/**
+	 * Operations on a group of values processed together. Kernels are written once against this interface, and then
+	 * instantiated both for SIMD registers and for plain floats (handling the values that don't fill a whole register).
+	 * Specializations for SIMD registers are provided by the files using them.
+	 */
+	template<class T>
+	struct TransformLanes
+	{
+		static constexpr u32 WIDTH = 1;
+
+		static T Load(const float* data) { return *data; }
+		static void Store(float* data, T value) { *data = value; }
+		static T Set(float value) { return value; }
+		static T Abs(T value) { return std::abs(value); }
+	};
+
+	/**
+	 * Kernels process the elements in range ['begin', 'end') in whole groups of the lane width, and return the index they
+	 * stopped at. Inputs and outputs are raw arrays, so the AVX2 versions don't instantiate any container code.
+	 */
+
+	/** See TransformKernels::ComposeTRS(). */
+	struct ComposeTRSKernel
+	{
+		const float* Translations[3];
+		const float* Rotations[4]; /**< W, X, Y, Z */
+		const float* Scales[3];
+		float* Output[16];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			const T one = L::Set(1.0f);
+			const T zero = L::Set(0.0f);
+			const T two = L::Set(2.0f);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T qw = L::Load(Rotations[0] + i);
+				const T qx = L::Load(Rotations[1] + i);
+				const T qy = L::Load(Rotations[2] + i);
+				const T qz = L::Load(Rotations[3] + i);
+
+				// Same formulation as Quaternion::ToRotationMatrix()
+				const T tx = qx * two;
+				const T ty = qy * two;
+				const T tz = qz * two;
+				const T twx = tx * qw;
+				const T twy = ty * qw;
+				const T twz = tz * qw;
+				const T txx = tx * qx;
+				const T txy = ty * qx;
+				const T txz = tz * qx;
+				const T tyy = ty * qy;
+				const T tyz = tz * qy;
+				const T tzz = tz * qz;
+
+				const T sx = L::Load(Scales[0] + i);
+				const T sy = L::Load(Scales[1] + i);
+				const T sz = L::Load(Scales[2] + i);
+
+				L::Store(Output[0] + i, (one - (tyy + tzz)) * sx);
+				L::Store(Output[1] + i, (txy - twz) * sy);
+				L::Store(Output[2] + i, (txz + twy) * sz);
+				L::Store(Output[3] + i, L::Load(Translations[0] + i));
+
+				L::Store(Output[4] + i, (txy + twz) * sx);
+				L::Store(Output[5] + i, (one - (txx + tzz)) * sy);
+				L::Store(Output[6] + i, (tyz - twx) * sz);
+				L::Store(Output[7] + i, L::Load(Translations[1] + i));
+
+				L::Store(Output[8] + i, (txz - twy) * sx);
+				L::Store(Output[9] + i, (tyz + twx) * sy);
+				L::Store(Output[10] + i, (one - (txx + tyy)) * sz);
+				L::Store(Output[11] + i, L::Load(Translations[2] + i));
+
+				L::Store(Output[12] + i, zero);
+				L::Store(Output[13] + i, zero);
+				L::Store(Output[14] + i, zero);
+				L::Store(Output[15] + i, one);
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::Multiply(const Matrix4&, const Matrix4SoA&, Matrix4SoA&, u32). */
+	struct MultiplyKernel
+	{
+		float Left[16]; /**< Row major. */
+		const float* Right[16];
+		float* Output[16];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			T left[16];
+			for(u32 j = 0; j < 16; j++)
+				left[j] = L::Set(Left[j]);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				T right[16];
+				for(u32 j = 0; j < 16; j++)
+					right[j] = L::Load(Right[j] + i);
+
+				for(u32 row = 0; row < 4; row++)
+				{
+					for(u32 column = 0; column < 4; column++)
+					{
+						const T value =
+							left[row * 4 + 0] * right[0 * 4 + column] +
+							left[row * 4 + 1] * right[1 * 4 + column] +
+							left[row * 4 + 2] * right[2 * 4 + column] +
+							left[row * 4 + 3] * right[3 * 4 + column];
+
+						L::Store(Output[row * 4 + column] + i, value);
+					}
+				}
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::Multiply(const Matrix4SoA&, const Matrix4SoA&, Matrix4SoA&, u32). */
+	struct MultiplyBatchKernel
+	{
+		const float* Left[16];
+		const float* Right[16];
+		float* Output[16];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				T left[16];
+				T right[16];
+				for(u32 j = 0; j < 16; j++)
+				{
+					left[j] = L::Load(Left[j] + i);
+					right[j] = L::Load(Right[j] + i);
+				}
+
+				for(u32 row = 0; row < 4; row++)
+				{
+					for(u32 column = 0; column < 4; column++)
+					{
+						const T value =
+							left[row * 4 + 0] * right[0 * 4 + column] +
+							left[row * 4 + 1] * right[1 * 4 + column] +
+							left[row * 4 + 2] * right[2 * 4 + column] +
+							left[row * 4 + 3] * right[3 * 4 + column];
+
+						L::Store(Output[row * 4 + column] + i, value);
+					}
+				}
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::Rotate(const Quaternion&, const Vector3SoA&, Vector3SoA&, u32). */
+	struct RotateKernel
+	{
+		float Rotation[4]; /**< W, X, Y, Z */
+		const float* Input[3];
+		float* Output[3];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			const T qw = L::Set(Rotation[0]);
+			const T qx = L::Set(Rotation[1]);
+			const T qy = L::Set(Rotation[2]);
+			const T qz = L::Set(Rotation[3]);
+			const T two = L::Set(2.0f);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T vx = L::Load(Input[0] + i);
+				const T vy = L::Load(Input[1] + i);
+				const T vz = L::Load(Input[2] + i);
+
+				// v' = v + w * t + cross(q, t), where t = 2 * cross(q, v)
+				const T tx = (qy * vz - qz * vy) * two;
+				const T ty = (qz * vx - qx * vz) * two;
+				const T tz = (qx * vy - qy * vx) * two;
+
+				L::Store(Output[0] + i, vx + qw * tx + (qy * tz - qz * ty));
+				L::Store(Output[1] + i, vy + qw * ty + (qz * tx - qx * tz));
+				L::Store(Output[2] + i, vz + qw * tz + (qx * ty - qy * tx));
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::Rotate(const QuaternionSoA&, const Vector3SoA&, Vector3SoA&, u32). */
+	struct RotateBatchKernel
+	{
+		const float* Rotations[4]; /**< W, X, Y, Z */
+		const float* Input[3];
+		float* Output[3];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			const T two = L::Set(2.0f);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T qw = L::Load(Rotations[0] + i);
+				const T qx = L::Load(Rotations[1] + i);
+				const T qy = L::Load(Rotations[2] + i);
+				const T qz = L::Load(Rotations[3] + i);
+
+				const T vx = L::Load(Input[0] + i);
+				const T vy = L::Load(Input[1] + i);
+				const T vz = L::Load(Input[2] + i);
+
+				const T tx = (qy * vz - qz * vy) * two;
+				const T ty = (qz * vx - qx * vz) * two;
+				const T tz = (qx * vy - qy * vx) * two;
+
+				L::Store(Output[0] + i, vx + qw * tx + (qy * tz - qz * ty));
+				L::Store(Output[1] + i, vy + qw * ty + (qz * tx - qx * tz));
+				L::Store(Output[2] + i, vz + qw * tz + (qx * ty - qy * tx));
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::TransformPoints(). */
+	struct TransformPointsKernel
+	{
+		float Transform[12]; /**< Top three rows, row major. */
+		const float* Input[3];
+		float* Output[3];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			T m[12];
+			for(u32 j = 0; j < 12; j++)
+				m[j] = L::Set(Transform[j]);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T x = L::Load(Input[0] + i);
+				const T y = L::Load(Input[1] + i);
+				const T z = L::Load(Input[2] + i);
+
+				L::Store(Output[0] + i, m[0] * x + m[1] * y + m[2] * z + m[3]);
+				L::Store(Output[1] + i, m[4] * x + m[5] * y + m[6] * z + m[7]);
+				L::Store(Output[2] + i, m[8] * x + m[9] * y + m[10] * z + m[11]);
+			}
+
+			return i;
+		}
+	};
+
+	/** See TransformKernels::TransformAABB(). */
+	struct TransformAABBKernel
+	{
+		const float* Transforms[12]; /**< Top three rows, row major. */
+		const float* Minimums[3];
+		const float* Maximums[3];
+		float* OutMinimums[3];
+		float* OutMaximums[3];
+
+		template<class T>
+		u32 Run(u32 begin, u32 end) const
+		{
+			using L = TransformLanes<T>;
+
+			const T half = L::Set(0.5f);
+
+			u32 i = begin;
+			for(; i + L::WIDTH <= end; i += L::WIDTH)
+			{
+				const T minX = L::Load(Minimums[0] + i);
+				const T minY = L::Load(Minimums[1] + i);
+				const T minZ = L::Load(Minimums[2] + i);
+				const T maxX = L::Load(Maximums[0] + i);
+				const T maxY = L::Load(Maximums[1] + i);
+				const T maxZ = L::Load(Maximums[2] + i);
+
+				const T centerX = (minX + maxX) * half;
+				const T centerY = (minY + maxY) * half;
+				const T centerZ = (minZ + maxZ) * half;
+				const T extentX = (maxX - minX) * half;
+				const T extentY = (maxY - minY) * half;
+				const T extentZ = (maxZ - minZ) * half;
+
+				T row[12];
+				for(u32 j = 0; j < 12; j++)
+					row[j] = L::Load(Transforms[j] + i);
+
+				// Transform the center, and project the extents onto the world axes (using the absolute rotation/scale)
+				const T newCenterX = row[0] * centerX + row[1] * centerY + row[2] * centerZ + row[3];
+				const T newCenterY = row[4] * centerX + row[5] * centerY + row[6] * centerZ + row[7];
+				const T newCenterZ = row[8] * centerX + row[9] * centerY + row[10] * centerZ + row[11];
+
+				const T newExtentX = L::Abs(row[0]) * extentX + L::Abs(row[1]) * extentY + L::Abs(row[2]) * extentZ;
+				const T newExtentY = L::Abs(row[4]) * extentX + L::Abs(row[5]) * extentY + L::Abs(row[6]) * extentZ;
+				const T newExtentZ = L::Abs(row[8]) * extentX + L::Abs(row[9]) * extentY + L::Abs(row[10]) * extentZ;
+
+				L::Store(OutMinimums[0] + i, newCenterX - newExtentX);
+				L::Store(OutMinimums[1] + i, newCenterY - newExtentY);
+				L::Store(OutMinimums[2] + i, newCenterZ - newExtentZ);
+				L::Store(OutMaximums[0] + i, newCenterX + newExtentX);
+				L::Store(OutMaximums[1] + i, newCenterY + newExtentY);
+				L::Store(OutMaximums[2] + i, newCenterZ + newExtentZ);
+			}
+
+			return i;
+		}
+	};
+
+#if BS_COMMON_AVX2
+	/**
+	 * Runs the kernel over as many whole groups of 8 elements as fit in ['begin', 'end') using AVX2, and returns the index
+	 * it stopped at. Defined in BsTransformKernelsAVX2.cpp. Must only be called if CpuFeatures::HasAVX2() is true.
+	 */
+	template<class Kernel>
+	u32 runTransformKernelAVX2(const Kernel& kernel, u32 begin, u32 end);
+#endif
+} // namespace bs
@@ -4,6 +4,37 @@ set(BS_COMMON_INC_NOFILTER
 	"BsObjectRotator.h"
 	"BsFPSWalker.h"
 	"BsFPSCamera.h"
+	"BsCurveEvaluator.h"
+	"BsCurveLookupTable.h"
+	"BsBatchedRandom.h"
+	"BsEmitterShapeSampler.h"
+	"BsParticleMemoryPool.h"
+	"BsSparkEmitter.h"
+	"BsFrameTaskGraph.h"
+	"BsJobs.h"
+	"BsCoroutine.h"
+	"BsTransformKernels.h"
+	"BsTransformKernelsImpl.h"
+	"BsCpuFeatures.h"
+	"BsBoxGeometry.h"
+	"BsBenchmarkScenario.h"
+	"BsPerfCounters.h"
+	"BsProfiledApplication.h"
+	"BsAsyncLog.h"
+	"BsRedrawTracker.h"
+	"BsCPUUsage.h"
+	"BsCachedGUIPanel.h"
+	"BsGUISpatialGrid.h"
+	"BsTextLayoutCache.h"
+	"BsMultiViewCuller.h"
+	"BsOcclusionBuffer.h"
+	"BsOcclusionBufferImpl.h"
+	"BsOcclusionCuller.h"
+	"BsGpuInstanceCuller.h"
+	"BsStaticBatcher.h"
+	"BsGeometryPool.h"
+	"BsGpuMemoryHeap.h"
+	"BsRenderTargetPool.h"
 )
 
 set(BS_COMMON_SRC_NOFILTER
@@ -11,9 +42,46 @@ set(BS_COMMON_SRC_NOFILTER
 	"BsObjectRotator.cpp"
 	"BsFPSWalker.cpp"
 	"BsFPSCamera.cpp"
+	"BsCurveEvaluator.cpp"
+	"BsCurveLookupTable.cpp"
+	"BsBatchedRandom.cpp"
+	"BsEmitterShapeSampler.cpp"
+	"BsParticleMemoryPool.cpp"
+	"BsSparkEmitter.cpp"
+	"BsFrameTaskGraph.cpp"
+	"BsJobs.cpp"
+	"BsTransformKernels.cpp"
+	"BsCpuFeatures.cpp"
+	"BsBoxGeometry.cpp"
+	"BsBenchmarkScenario.cpp"
+	"BsPerfCounters.cpp"
+	"BsProfiledApplication.cpp"
+	"BsAsyncLog.cpp"
+	"BsRedrawTracker.cpp"
+	"BsCPUUsage.cpp"
+	"BsCachedGUIPanel.cpp"
+	"BsGUISpatialGrid.cpp"
+	"BsTextLayoutCache.cpp"
+	"BsMultiViewCuller.cpp"
+	"BsOcclusionBuffer.cpp"
+	"BsOcclusionCuller.cpp"
+	"BsGpuInstanceCuller.cpp"
+	"BsStaticBatcher.cpp"
+	"BsGeometryPool.cpp"
+	"BsGpuMemoryHeap.cpp"
+	"BsRenderTargetPool.cpp"
+)
+
+# Compiled with AVX2 enabled on x86 targets, see CMakeLists.txt
+set(BS_COMMON_SRC_AVX2
+	"BsTransformKernelsAVX2.cpp"
+	"BsOcclusionBufferAVX2.cpp"
+	"BsBatchedRandomAVX2.cpp"
+	"BsCurveLookupTableAVX2.cpp"
 )
 
 set(BS_COMMON_SRC
 	${BS_COMMON_INC_NOFILTER}
 	${BS_COMMON_SRC_NOFILTER}
+	${BS_COMMON_SRC_AVX2}
 )
\ No newline at end of file
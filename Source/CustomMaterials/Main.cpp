@@ -11,6 +11,7 @@
 #include "GUI/BsGUIPanel.h"
 #include "GUI/BsGUILayoutY.h"
 #include "GUI/BsGUILabel.h"
+#include "GUI/BsGUIContent.h"
 #include "RenderAPI/BsRenderAPI.h"
 #include "RenderAPI/BsRenderWindow.h"
 #include "Scene/BsSceneObject.h"
@@ -21,6 +22,7 @@
 #include "BsCameraFlyer.h"
 #include "BsObjectRotator.h"
 #include "BsExampleFramework.h"
+#include "BsBenchmarkScenario.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example renders an object using a variety of custom materials, showing you how you can customize the rendering of
@@ -125,6 +127,8 @@ namespace bs
 
 	HRenderable gRenderable;
 	HGUIWidget gGUI;
+	GUILabel* gCurrentMaterialLabel = nullptr;
+	Vector<HString> gMaterialStrings;
 	u32 gMaterialIdx = 0;
 
 	/** Set up the 3D object used by the example, and the camera to view the world through. */
@@ -215,37 +219,50 @@ namespace bs
 		gGUI = guiSO->AddComponent<CGUIWidget>(sceneCamera);
 	}
 
-	/** Sets up or rebuilds any GUI elements used by the example. */
+	/**
+	 * Sets up the GUI elements used by the example on the first call. Later calls only update the label displaying the
+	 * current material, rather than rebuilding all the elements.
+	 */
 	void updateGUI()
 	{
-		GUIPanel* mainPanel = gGUI->GetPanel();
-
-		// Clear any existing elements, in case this is not the first time we're calling this function
-		mainPanel->Clear();
-
-		// Set up strings to display
-		String materialNameLookup[] = {
-			"Standard",
-			"Vertex wobble (Deferred)",
-			"Surface noise (Deferred)",
-			"Lambert BRDF (Deferred)",
-			"Surface noise & Lambert BRDF (Forward)"
-		};
+		// Set up strings to display. The string for each material is built once, on the first call.
+		if(gMaterialStrings.empty())
+		{
+			String materialNameLookup[] = {
+				"Standard",
+				"Vertex wobble (Deferred)",
+				"Surface noise (Deferred)",
+				"Lambert BRDF (Deferred)",
+				"Surface noise & Lambert BRDF (Forward)"
+			};
+
+			for(auto& materialName : materialNameLookup)
+			{
+				HString currentMaterialString("Current material: {0}");
+				currentMaterialString.SetParameter(0, materialName);
+
+				gMaterialStrings.push_back(currentMaterialString);
+			}
+		}
 
-		HString toggleString("Press Q to toggle between materials");
-		HString currentMaterialString("Current material: {0}");
+		if(gCurrentMaterialLabel == nullptr)
+		{
+			GUIPanel* mainPanel = gGUI->GetPanel();
+
+			HString toggleString("Press Q to toggle between materials");
 
-		currentMaterialString.SetParameter(0, materialNameLookup[gMaterialIdx]);
+			// Create a vertical GUI layout to align the two labels one below each other
+			GUILayoutY* vertLayout = GUILayoutY::Create();
 
-		// Create a vertical GUI layout to align the two labels one below each other
-		GUILayoutY* vertLayout = GUILayoutY::Create();
+			// Create a couple of GUI labels displaying the two strings we created above
+			vertLayout->AddNewElement<GUILabel>(toggleString);
+			gCurrentMaterialLabel = vertLayout->AddNewElement<GUILabel>(gMaterialStrings[gMaterialIdx]);
 
-		// Create a couple of GUI labels displaying the two strings we created above
-		vertLayout->AddNewElement<GUILabel>(toggleString);
-		vertLayout->AddNewElement<GUILabel>(currentMaterialString);
+			// Register the layout with the main GUI panel, placing the layout in top left corner of the screen by default
+			mainPanel->AddElement(vertLayout);
+		}
 
-		// Register the layout with the main GUI panel, placing the layout in top left corner of the screen by default
-		mainPanel->AddElement(vertLayout);
+		gCurrentMaterialLabel->SetContent(GUIContent(gMaterialStrings[gMaterialIdx]));
 	}
 
 	/** Switches the material used for rendering the renderable object. */
@@ -349,10 +366,16 @@ int main()
 	// Sets up any GUI elements used by the example.
 	updateGUI();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
 
+	// The strings reference the engine's string tables, so they must be released before the engine shuts down
+	gMaterialStrings.clear();
+
 	// When done, clean up
 	Application::ShutDown();
 
@@ -21,6 +21,7 @@
 #include "BsExampleFramework.h"
 #include "BsFPSWalker.h"
 #include "BsFPSCamera.h"
+#include "BsBenchmarkScenario.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example sets up a simple environment consisting of a floor and cube, and a decal projecting on both surfaces. The
@@ -247,6 +248,9 @@ int main()
 	// Set up the scene with an object to render and a camera
 	setUpScene();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
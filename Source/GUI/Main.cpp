@@ -19,6 +19,12 @@
 #include "RenderAPI/BsRenderWindow.h"
 #include "Scene/BsSceneObject.h"
 #include "BsExampleFramework.h"
+#include "BsBenchmarkScenario.h"
+#include "BsProfiledApplication.h"
+#include "BsAsyncLog.h"
+#include "BsRedrawTracker.h"
+#include "BsCPUUsage.h"
+#include "BsCachedGUIPanel.h"
 #include "Image/BsSpriteTexture.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -30,12 +36,51 @@
 // style and apply it to a GUI element. It follows to demonstrate the concept of layouts that automatically position
 // and size elements, as well as scroll areas. Finally, it demonstrates a more complex example of creating a custom style,
 // by creating a button with custom textures and font.
+//
+// Since the UI is static, the camera renders on demand: frames are only rendered and presented when input or some other
+// change could have affected the output, and the main loop is throttled while idle. A toggle allows switching between
+// on-demand and continuous rendering, and a label displays the CPU usage of the process so the two can be compared. The
+// static layout sections are additionally cached in textures, and only re-rendered when the user interacts with them.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace bs
 {
 	u32 windowResWidth = 1280;
 	u32 windowResHeight = 720;
 
+	HRedrawTracker gRedrawTracker;
+	GUILabel* gCPUUsageLabel = nullptr;
+
+	// Set up a helper component that displays the CPU usage of the process, along with the number of frames that were
+	// rendered and skipped. This allows the cost of continuous rendering to be compared to rendering on demand.
+	class CPUUsageDisplay : public Component
+	{
+	public:
+		CPUUsageDisplay(const HSceneObject& parent)
+			: Component(parent)
+		{}
+
+		void Update() override
+		{
+			// Refresh the label twice per second
+			if(!mMeter.Update())
+				return;
+
+			HString statsString("CPU usage: {0}%, frames rendered: {1}, skipped: {2}");
+			statsString.SetParameter(0, toString((u32)mMeter.GetUsage()));
+			statsString.SetParameter(1, toString(gRedrawTracker->GetNumRenderedFrames()));
+			statsString.SetParameter(2, toString(gRedrawTracker->GetNumSkippedFrames()));
+
+			gCPUUsageLabel->SetContent(GUIContent(statsString));
+
+			// The label was changed from code rather than through input, so the tracker needs to be told to redraw. The
+			// change is complete in a single frame, so there's no need to keep rendering after it.
+			gRedrawTracker->RequestRedraw();
+		}
+
+	private:
+		CPUUsageMeter mMeter;
+	};
+
 	/** Set up the GUI elements and the camera. */
 	void setUpGUI()
 	{
@@ -68,6 +113,12 @@ namespace bs
 		renderSettings->OverlayOnly = true;
 		sceneCamera->SetRenderSettings(renderSettings);
 
+		// Nothing in the scene moves on its own, so only render the camera when input (or a change made from code) could
+		// have affected what is displayed. When running as a benchmark render continuously, so frame times remain
+		// comparable.
+		gRedrawTracker = sceneCameraSO->AddComponent<RedrawTracker>(sceneCamera);
+		gRedrawTracker->SetEnabled(!BenchmarkScenario::IsRequested());
+
 		/************************************************************************/
 		/* 									GUI		                     		*/
 		/************************************************************************/
@@ -84,8 +135,9 @@ namespace bs
 		GUIButton* button = mainPanel->AddNewElement<GUIButton>(HString("Click me!"));
 		button->OnClick.Connect([]()
 								{
-			// Log a message when the user clicks the button
-			BS_LOG(Info, Uncategorized, "Button clicked!"); });
+			// Log a message when the user clicks the button. Messages are formatted and written to the log on a
+			// background thread, so callbacks never wait on log output.
+			BS_ASYNC_LOG(Info, Uncategorized, "Button clicked!"); });
 
 		button->SetPosition(10, 50);
 		button->SetSize(100, 30);
@@ -97,11 +149,11 @@ namespace bs
 			// Log a message when the user toggles the button
 			if(enabled)
 			{
-				BS_LOG(Info, Uncategorized, "Toggle turned on");
+				BS_ASYNC_LOG(Info, Uncategorized, "Toggle turned on");
 			}
 			else
 			{
-				BS_LOG(Info, Uncategorized, "Toggle turned off");
+				BS_ASYNC_LOG(Info, Uncategorized, "Toggle turned off");
 			} });
 
 		toggle->SetPosition(10, 90);
@@ -115,7 +167,7 @@ namespace bs
 		inputBox->OnValueChanged.Connect([](const String& value)
 										 {
 			// Log a message when the user enters new text in the input box
-			BS_LOG(Info, Uncategorized, "User entered: \"" + value + "\""); });
+			BS_ASYNC_LOG(Info, Uncategorized, "User entered: \"{0}\"", value); });
 
 		inputBox->SetText("Type in me...");
 		inputBox->SetPosition(10, 115);
@@ -133,7 +185,7 @@ namespace bs
 		listBox->OnSelectionToggled.Connect([listBoxElements](u32 idx, bool enabled)
 											{
 												// Log a message when the user selects a new element
-												BS_LOG(Info, Uncategorized, "User selected element: \"" + listBoxElements[idx].GetValue() + "\"");
+												BS_ASYNC_LOG(Info, Uncategorized, "User selected element: \"{0}\"", listBoxElements[idx].GetValue());
 											});
 
 		listBox->SetPosition(10, 140);
@@ -174,9 +226,16 @@ namespace bs
 		basicControlsLbl->SetPosition(10, 10);
 
 		///////////////////////////  vertical layout /////////////////////////
+		// The layout sections below never change on their own, so rather than re-batching and drawing their elements
+		// every frame, render them into a cached texture that is displayed as a single quad. The texture is only
+		// re-rendered when the pointer interacts with them. Elements are positioned relative to the cached area.
+		HSceneObject vertLayoutSO = SceneObject::Create("VerticalLayoutCache");
+		HCachedGUIPanel vertLayoutCache = vertLayoutSO->AddComponent<CachedGUIPanel>(gui, Rect2I(300, 10, 200, 280), gray);
+		GUIPanel* vertLayoutPanel = vertLayoutCache->GetPanel();
+
 		// Use a vertical layout to automatically position GUI elements. This is unlike above where we position and
 		// sized all elements manually.
-		GUILayoutY* vertLayout = mainPanel->AddNewElement<GUILayoutY>();
+		GUILayoutY* vertLayout = vertLayoutPanel->AddNewElement<GUILayoutY>();
 
 		// Add five buttons to the layout
 		for(u32 i = 0; i < 5; i++)
@@ -190,17 +249,23 @@ namespace bs
 		// Add a flexible space ensuring all the elements get pushed to the top of the layout
 		vertLayout->AddNewElement<GUIFlexibleSpace>();
 
-		// Position the layout relative to the main panel, and limit width to 100 pixels
-		vertLayout->SetPosition(350, 50);
+		// Position the layout relative to the cached panel, and limit width to 100 pixels
+		vertLayout->SetPosition(50, 40);
 		vertLayout->SetWidth(100);
 
 		// Add a header
-		GUILabel* vertLayoutLbl = mainPanel->AddNewElement<GUILabel>(HString("Vertical layout"), "HeaderLabelStyle");
-		vertLayoutLbl->SetPosition(300, 10);
+		GUILabel* vertLayoutLbl = vertLayoutPanel->AddNewElement<GUILabel>(HString("Vertical layout"), "HeaderLabelStyle");
+		vertLayoutLbl->SetPosition(0, 0);
 
 		////////////////////////// Horizontal layout ///////////////////////
+		// Cached the same way as the vertical layout, spanning the width of the window
+		HSceneObject horzLayoutSO = SceneObject::Create("HorizontalLayoutCache");
+		HCachedGUIPanel horzLayoutCache = horzLayoutSO->AddComponent<CachedGUIPanel>(gui,
+			Rect2I(0, 300, (i32)windowResWidth, 70), gray);
+		GUIPanel* horzLayoutPanel = horzLayoutCache->GetPanel();
+
 		// Use a horizontal layout to automatically position GUI elements
-		GUILayoutX* horzLayout = mainPanel->AddNewElement<GUILayoutX>();
+		GUILayoutX* horzLayout = horzLayoutPanel->AddNewElement<GUILayoutX>();
 		horzLayout->AddNewElement<GUIFlexibleSpace>();
 
 		// Add vive buttons to the layout
@@ -210,13 +275,13 @@ namespace bs
 			horzLayout->AddNewElement<GUIFlexibleSpace>();
 		}
 
-		// Position the layout relative to the main panel, and limit the height to 30 pixels
-		horzLayout->SetPosition(0, 340);
+		// Position the layout relative to the cached panel, and limit the height to 30 pixels
+		horzLayout->SetPosition(0, 40);
 		horzLayout->SetHeight(30);
 
 		// Add a header
-		GUILabel* horzLayoutLbl = mainPanel->AddNewElement<GUILabel>(HString("Horizontal layout"), "HeaderLabelStyle");
-		horzLayoutLbl->SetPosition(10, 300);
+		GUILabel* horzLayoutLbl = horzLayoutPanel->AddNewElement<GUILabel>(HString("Horizontal layout"), "HeaderLabelStyle");
+		horzLayoutLbl->SetPosition(10, 0);
 
 		//////////////////////////// Scroll area ///////////////////////
 		// Container GUI element that allows scrolling if the number of elements inside the area are larger than the visible
@@ -273,6 +338,29 @@ namespace bs
 		// Add a header
 		GUILabel* customButtonLbl = mainPanel->AddNewElement<GUILabel>(HString("Custom button"), "HeaderLabelStyle");
 		customButtonLbl->SetPosition(800, 10);
+
+		///////////////////////////// Render on demand ///////////////////
+		// Toggle switching between rendering on demand and rendering every frame
+		GUIToggle* onDemandToggle = mainPanel->AddNewElement<GUIToggle>(HString(""));
+		if(gRedrawTracker->IsEnabled())
+			onDemandToggle->ToggleOn();
+
+		onDemandToggle->OnToggled.Connect([](bool enabled) { gRedrawTracker->SetEnabled(enabled); });
+		onDemandToggle->SetPosition(10, 420);
+
+		GUILabel* onDemandLabel = mainPanel->AddNewElement<GUILabel>(HString("Render on demand"));
+		onDemandLabel->SetPosition(30, 422);
+
+		// Label displaying the CPU usage, updated by the helper component
+		gCPUUsageLabel = mainPanel->AddNewElement<GUILabel>(HString("Measuring CPU usage..."));
+		gCPUUsageLabel->SetPosition(10, 445);
+		gCPUUsageLabel->SetWidth(500);
+
+		guiSO->AddComponent<CPUUsageDisplay>();
+
+		// Add a header
+		GUILabel* onDemandHeaderLbl = mainPanel->AddNewElement<GUILabel>(HString("Render on demand"), "HeaderLabelStyle");
+		onDemandHeaderLbl->SetPosition(10, 385);
 	}
 } // namespace bs
 
@@ -291,9 +379,13 @@ int main()
 {
 	using namespace bs;
 
-	// Initializes the application and creates a window with the specified properties
+	// Initializes the application and creates a window with the specified properties. The application measures the
+	// time and hardware counters of each phase of the frame, and logs them on exit.
 	VideoMode videoMode(windowResWidth, windowResHeight);
-	Application::StartUp(videoMode, "Example", false);
+	Application::StartUp<ProfiledApplication>(videoMode, "Example", false);
+
+	// Start the asynchronous log sink used by the GUI callbacks
+	AsyncLog::StartUp();
 
 	// Load a resource manifest so previously saved Fonts can find their child Texture resources
 	ExampleFramework::LoadResourceManifest();
@@ -304,11 +396,15 @@ int main()
 	// Save the manifest, in case we did any asset importing during the setup stage
 	ExampleFramework::SaveResourceManifest();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
 
-	// When done, clean up
+	// When done, clean up. Stopping the log sink forwards any messages still buffered.
+	AsyncLog::ShutDown();
 	Application::ShutDown();
 
 	return 0;
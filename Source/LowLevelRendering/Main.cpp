@@ -15,8 +15,22 @@
 #include "Math/BsQuaternion.h"
 #include "Utility/BsTime.h"
 #include "Renderer/BsRendererUtility.h"
+#include "Debug/BsDebug.h"
 #include "BsEngineConfig.h"
 
+// Example includes
+#include "BsBoxGeometry.h"
+#include "BsBenchmarkScenario.h"
+#include "BsGeometryPool.h"
+#include "BsRenderTargetPool.h"
+
+#if BS_EXAMPLE_GPU_CULLING
+#	include "RenderAPI/BsGpuBuffer.h"
+#	include "Math/BsRandom.h"
+#	include "BsGpuInstanceCuller.h"
+#	include "BsGpuMemoryHeap.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example uses the low-level rendering API to render a textured cube mesh. This is opposed to using scene objects
 // and components, in which case objects are rendered automatically based on their transform and other properties.
@@ -32,6 +46,21 @@
 // The example first sets up necessary resources, like GPU programs, pipeline state, vertex & index buffers. Then every
 // frame it binds the necessary rendering resources and executes the draw call.
 //
+// Rather than creating a vertex & index buffer for the box, the mesh is stored in a GeometryPool, which sub-allocates
+// all meshes sharing a vertex layout from a few large buffers and picks 16-bit indices for meshes small enough to use
+// them. Meshes from the same pool can then be drawn one after another without binding new buffers.
+//
+// The box is rendered into a render surface matching the window size, which is then copied to the window. Surfaces are
+// requested from a RenderTargetPool, so when the window is resized back to an earlier size its old surface is reused.
+//
+// When built with BS_EXAMPLE_GPU_CULLING (the LowLevelRenderingGpuCulling target), the example instead renders a city of
+// 100k boxes of random heights, using a single instanced draw call. Before the draw the GpuInstanceCuller tests every box
+// against the view frustum, and against a hierarchical depth buffer built from the depth of the previous frame, entirely
+// in compute programs. Only the boxes that pass are drawn, and the number of visible boxes is logged periodically. The
+// position and scale of the boxes are stored in a GpuMemoryHeap, which sub-allocates buffer memory from large blocks
+// instead of creating a buffer per allocation. The vertex program reads them from the block at the offset of the
+// allocation.
+//
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace bs
 {
@@ -43,7 +72,7 @@ namespace bs
 	namespace ct
 	{
 		void setup(const SPtr<RenderWindow>& renderWindow);
-		void render();
+		void render(float time);
 		void shutdown();
 	} // namespace ct
 
@@ -89,8 +118,9 @@ namespace bs
 		// Called every frame, before any other engine system (optionally use postUpdate())
 		void PreUpdate() override
 		{
-			// Queue the method for execution on the core thread
-			gCoreThread().QueueCommand(&ct::render);
+			// Queue the method for execution on the core thread. The current time is sent along, since gTime() belongs to
+			// this thread and must not be read from the core thread.
+			gCoreThread().QueueCommand(std::bind(&ct::render, gTime().GetTime()));
 
 			// Call the default version of this method to handle normal functionality
 			Application::PreUpdate();
@@ -120,6 +150,9 @@ int main()
 	// We provide the initial resolution of the window, its title and fullscreen state.
 	Application::StartUp<MyApplication>(videoMode, "bsf Example App", false);
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
@@ -135,11 +168,17 @@ namespace bs
 	namespace ct
 	{
 		// Declarations for some helper methods we'll use during setup
-		void writeBoxVertices(const AABox& box, u8* positions, u8* uvs, u32 stride);
-		void writeBoxIndices(u32* indices);
 		const char* getVertexProgSource();
 		const char* getFragmentProgSource();
-		Matrix4 createWorldViewProjectionMatrix();
+		Matrix4 createWorldViewProjectionMatrix(float time);
+
+#if BS_EXAMPLE_GPU_CULLING
+		const char* getInstancedVertexProgSource();
+		const char* getInstancedFragmentProgSource();
+		Matrix4 createCityViewProjectionMatrix(float time);
+		void createCity(GpuMemoryHeap& heap, const GpuHeapAllocation& instanceAllocation,
+			Vector<GpuInstanceBounds>& bounds);
+#endif
 
 		// Fields where we'll store the resources required during calls to render(). These are initialized in setup()
 		// and cleaned up in shutDown()
@@ -147,10 +186,12 @@ namespace bs
 		SPtr<Texture> gSurfaceTex;
 		SPtr<SamplerState> gSurfaceSampler;
 		SPtr<GpuParams> gGpuParams;
-		SPtr<VertexDeclaration> gVertexDecl;
-		SPtr<VertexBuffer> gVertexBuffer;
-		SPtr<IndexBuffer> gIndexBuffer;
+		SPtr<GeometryPool> gGeometryPool;
+		GeometryAllocation gBoxGeometry;
+		SPtr<GpuParamBlockBuffer> gUniformBuffer;
+		SPtr<RenderTargetPool> gRenderTargetPool;
 		SPtr<RenderTexture> gRenderTarget;
+		PooledRenderTargetDesc gRenderTargetDesc;
 		SPtr<RenderWindow> gRenderWindow;
 		bool gUseHLSL = true;
 		bool gUseVKSL = false;
@@ -158,11 +199,40 @@ namespace bs
 		const u32 NUM_VERTICES = 24;
 		const u32 NUM_INDICES = 36;
 
+#if BS_EXAMPLE_GPU_CULLING
+		// Storage buffers and compute programs require a newer GLSL version than the base example
+		const char* GLSL_LANGUAGE = "glsl";
+
+		// The city is a grid of boxes, one per city block
+		const u32 CITY_COLUMNS = 400;
+		const u32 CITY_ROWS = 250;
+		const u32 NUM_INSTANCES = CITY_COLUMNS * CITY_ROWS;
+		const float CITY_BLOCK_SIZE = 12.0f;
+
+		SPtr<GpuInstanceCuller> gInstanceCuller;
+		SPtr<GpuMemoryHeap> gBufferHeap;
+		GpuHeapAllocation gInstanceAllocation;
+		float gLastStatsTime = 0.0f;
+
+		// Per-instance data read by the instanced vertex program, as two GpuMemoryHeap::ALIGNMENT byte elements
+		struct InstanceData
+		{
+			Vector4 Position; // Center of the box, W unused
+			Vector4 Scale; // Scale applied to the box mesh, W unused
+		};
+#else
+		const char* GLSL_LANGUAGE = "glsl4_1";
+#endif
+
 		// Structure that will hold uniform block variables for the GPU programs
 		struct UniformBlock
 		{
 			Matrix4 GMatWvp; // World view projection matrix
 			Color GTint; // Tint to apply on top of the texture
+#if BS_EXAMPLE_GPU_CULLING
+			u32 GInstanceOffset; // Index of the first element of the instance data in its heap block
+			u32 Padding[3];
+#endif
 		};
 
 		// Initializes any resources required for rendering
@@ -176,40 +246,57 @@ namespace bs
 			gRenderWindow = renderWindow;
 
 			// Create a vertex GPU program
+#if BS_EXAMPLE_GPU_CULLING
+			const char* vertProgSrc = getInstancedVertexProgSource();
+#else
 			const char* vertProgSrc = getVertexProgSource();
+#endif
 
 			GPU_PROGRAM_DESC vertProgDesc;
 			vertProgDesc.Type = GPT_VERTEX_PROGRAM;
 			vertProgDesc.EntryPoint = "main";
 			vertProgDesc.Language = gUseHLSL ? "hlsl" : gUseVKSL ? "vksl"
-																 : "glsl4_1";
+																 : GLSL_LANGUAGE;
 			vertProgDesc.Source = vertProgSrc;
 
 			SPtr<GpuProgram> vertProg = GpuProgram::Create(vertProgDesc);
 
 			// Create a fragment GPU program
+#if BS_EXAMPLE_GPU_CULLING
+			const char* fragProgSrc = getInstancedFragmentProgSource();
+#else
 			const char* fragProgSrc = getFragmentProgSource();
+#endif
 
 			GPU_PROGRAM_DESC fragProgDesc;
 			fragProgDesc.Type = GPT_FRAGMENT_PROGRAM;
 			fragProgDesc.EntryPoint = "main";
 			fragProgDesc.Language = gUseHLSL ? "hlsl" : gUseVKSL ? "vksl"
-																 : "glsl4_1";
+																 : GLSL_LANGUAGE;
 			fragProgDesc.Source = fragProgSrc;
 
 			SPtr<GpuProgram> fragProg = GpuProgram::Create(fragProgDesc);
 
 			// Create a graphics pipeline state
 			BLEND_STATE_DESC blendDesc;
+			DEPTH_STENCIL_STATE_DESC depthStencilDesc;
+
+#if BS_EXAMPLE_GPU_CULLING
+			// The city is opaque, and its depth is needed for occlusion culling
+			blendDesc.RenderTargetDesc[0].BlendEnable = false;
+
+			depthStencilDesc.DepthWriteEnable = true;
+			depthStencilDesc.DepthReadEnable = true;
+#else
 			blendDesc.RenderTargetDesc[0].BlendEnable = true;
 			blendDesc.RenderTargetDesc[0].RenderTargetWriteMask = 0b0111; // RGB, don't write to alpha
 			blendDesc.RenderTargetDesc[0].BlendOp = BO_ADD;
 			blendDesc.RenderTargetDesc[0].SrcBlend = BF_SOURCE_ALPHA;
 			blendDesc.RenderTargetDesc[0].DstBlend = BF_INV_SOURCE_ALPHA;
 
-			DEPTH_STENCIL_STATE_DESC depthStencilDesc;
 			depthStencilDesc.DepthWriteEnable = false;
 			depthStencilDesc.DepthReadEnable = false;
+#endif
 
 			PIPELINE_STATE_DESC pipelineDesc;
 			pipelineDesc.BlendState = BlendState::Create(blendDesc);
@@ -227,36 +314,24 @@ namespace bs
 			vertexDesc->AddVertElem(VET_FLOAT3, VES_POSITION);
 			vertexDesc->AddVertElem(VET_FLOAT2, VES_TEXCOORD);
 
-			gVertexDecl = VertexDeclaration::Create(vertexDesc);
+			// Create a pool holding the meshes using this vertex layout, in vertex & index buffers shared between them
+			gGeometryPool = bs_shared_ptr_new<GeometryPool>(vertexDesc);
 
-			// Create & fill the vertex buffer for a box mesh
+			// Write the vertices & indices of a box mesh
 			u32 vertexStride = vertexDesc->GetVertexStride();
 
-			VERTEX_BUFFER_DESC vbDesc;
-			vbDesc.NumVerts = NUM_VERTICES;
-			vbDesc.VertexSize = vertexStride;
-
-			gVertexBuffer = VertexBuffer::Create(vbDesc);
-
-			u8* vbData = (u8*)gVertexBuffer->Lock(0, vertexStride * NUM_VERTICES, GBL_WRITE_ONLY_DISCARD);
-			u8* positions = vbData + vertexDesc->GetElementOffsetFromStream(VES_POSITION);
-			u8* uvs = vbData + vertexDesc->GetElementOffsetFromStream(VES_TEXCOORD);
+			Vector<u8> vertices(vertexStride * NUM_VERTICES);
+			u8* positions = vertices.data() + vertexDesc->GetElementOffsetFromStream(VES_POSITION);
+			u8* uvs = vertices.data() + vertexDesc->GetElementOffsetFromStream(VES_TEXCOORD);
 
 			AABox box(Vector3::ONE * -10.0f, Vector3::ONE * 10.0f);
 			writeBoxVertices(box, positions, uvs, vertexStride);
 
-			gVertexBuffer->Unlock();
+			u32 indices[NUM_INDICES];
+			writeBoxIndices(indices);
 
-			// Create & fill the index buffer for a box mesh
-			INDEX_BUFFER_DESC ibDesc;
-			ibDesc.NumIndices = NUM_INDICES;
-			ibDesc.IndexType = IT_32BIT;
-
-			gIndexBuffer = IndexBuffer::Create(ibDesc);
-			u32* ibData = (u32*)gIndexBuffer->Lock(0, NUM_INDICES * sizeof(u32), GBL_WRITE_ONLY_DISCARD);
-			writeBoxIndices(ibData);
-
-			gIndexBuffer->Unlock();
+			// Store the box in the pool. It only has 24 vertices, so the pool stores its indices as 16-bit.
+			gBoxGeometry = gGeometryPool->Allocate(vertices.data(), NUM_VERTICES, indices, NUM_INDICES);
 
 			// Create a simple 2x2 checkerboard texture to map to the object we're about to render
 			SPtr<PixelData> pixelData = PixelData::Create(2, 2, 1, PF_RGBA8);
@@ -274,47 +349,94 @@ namespace bs
 
 			gSurfaceSampler = SamplerState::Create(samplerDesc);
 
-			// Create a color attachment texture for the render surface
-			TEXTURE_DESC colorAttDesc;
-			colorAttDesc.Width = windowResWidth;
-			colorAttDesc.Height = windowResHeight;
-			colorAttDesc.Format = PF_RGBA8;
-			colorAttDesc.Usage = TU_RENDERTARGET;
-
-			SPtr<Texture> colorAtt = Texture::Create(colorAttDesc);
+			// Create the render surface, with a color and a depth attachment. Render targets are requested from a pool,
+			// which hands out previously released targets of the same size and format instead of allocating new ones.
+			// The surface is requested again whenever the window is resized (see render()).
+			gRenderTargetDesc.Width = windowResWidth;
+			gRenderTargetDesc.Height = windowResHeight;
+			gRenderTargetDesc.ColorFormat = PF_RGBA8;
+			gRenderTargetDesc.DepthFormat = PF_D32;
+
+			gRenderTargetPool = bs_shared_ptr_new<RenderTargetPool>();
+			gRenderTarget = gRenderTargetPool->Acquire(gRenderTargetDesc);
+
+			// Create a uniform block buffer for holding the uniform variables. It is created once and rewritten every
+			// frame, rather than allocated anew from the driver every frame.
+			gUniformBuffer = GpuParamBlockBuffer::Create(sizeof(UniformBlock));
+
+#if BS_EXAMPLE_GPU_CULLING
+			// Allocate the position and scale of every box from a heap, rather than creating a buffer for them. The
+			// data is never freed while the example runs, so the size-class strategy is used.
+			gBufferHeap = bs_shared_ptr_new<GpuMemoryHeap>(GpuHeapStrategy::SizeClass);
+			gInstanceAllocation = gBufferHeap->Allocate(NUM_INSTANCES * sizeof(InstanceData));
+
+			// Fill the instance data, and upload the bounds to the culler once, since the city never changes
+			Vector<GpuInstanceBounds> bounds;
+			createCity(*gBufferHeap, gInstanceAllocation, bounds);
+
+			gInstanceCuller = bs_shared_ptr_new<GpuInstanceCuller>(NUM_INSTANCES, NUM_INDICES, windowResWidth,
+				windowResHeight);
+			gInstanceCuller->SetBounds(bounds);
+
+			// The vertex program reads the boxes through the list of visible instances output by the culler, and their
+			// data from the heap block holding the instance allocation
+			const GpuHeapLocation instanceLocation = gBufferHeap->GetLocation(gInstanceAllocation);
+			gGpuParams->SetBuffer(GPT_VERTEX_PROGRAM, "gInstances", instanceLocation.Buffer);
+			gGpuParams->SetBuffer(GPT_VERTEX_PROGRAM, "gVisibleInstances", gInstanceCuller->GetVisibleInstances());
+			gGpuParams->SetBuffer(GPT_VERTEX_PROGRAM, "gDrawArgs", gInstanceCuller->GetDrawArguments());
+#endif
+		}
 
-			// Create a depth attachment texture for the render surface
-			TEXTURE_DESC depthAttDesc;
-			depthAttDesc.Width = windowResWidth;
-			depthAttDesc.Height = windowResHeight;
-			depthAttDesc.Format = PF_D32;
-			depthAttDesc.Usage = TU_DEPTHSTENCIL;
+		// Render the box, called every frame
+		void render(float time)
+		{
+#if !BS_EXAMPLE_GPU_CULLING
+			// Match the render surface to the size of the window. The old surface goes back to the pool, so resizing back
+			// to a previous size (e.g. restoring a maximized window) reuses it rather than allocating a new one. The GPU
+			// culling build keeps its surface at the size the hierarchical depth was created for, and stretches it instead.
+			const RenderTargetProperties& windowProps = gRenderWindow->GetProperties();
+			if(windowProps.Width > 0 && windowProps.Height > 0 &&
+				(windowProps.Width != gRenderTargetDesc.Width || windowProps.Height != gRenderTargetDesc.Height))
+			{
+				gRenderTargetPool->Release(gRenderTarget);
 
-			SPtr<Texture> depthAtt = Texture::Create(depthAttDesc);
+				gRenderTargetDesc.Width = windowProps.Width;
+				gRenderTargetDesc.Height = windowProps.Height;
+				gRenderTarget = gRenderTargetPool->Acquire(gRenderTargetDesc);
 
-			// Create the render surface
-			RENDER_TEXTURE_DESC desc;
-			desc.ColorSurfaces[0].Texture = colorAtt;
-			desc.DepthStencilSurface.Texture = depthAtt;
+				// Resizing by dragging the window edge goes through many sizes, so don't keep every one of them around
+				const RenderTargetPoolStats& poolStats = gRenderTargetPool->GetStats();
+				if(poolStats.FreeBytes > poolStats.InUseBytes * 2)
+					gRenderTargetPool->Trim();
 
-			gRenderTarget = RenderTexture::Create(desc);
-		}
+				BS_LOG(Info, Uncategorized, "Render surface resized to {0}x{1} ({2} created, {3} reused from the pool)",
+					gRenderTargetDesc.Width, gRenderTargetDesc.Height, poolStats.NumCreated, poolStats.NumReused);
+			}
+#endif
 
-		// Render the box, called every frame
-		void render()
-		{
 			// Fill out the uniform block variables
 			UniformBlock uniformBlock;
-			uniformBlock.GMatWvp = createWorldViewProjectionMatrix();
+#if BS_EXAMPLE_GPU_CULLING
+			Matrix4 viewProj = createCityViewProjectionMatrix(time);
+
+			// GLSL uses column major matrices, so transpose
+			uniformBlock.GMatWvp = gUseHLSL ? viewProj : viewProj.Transpose();
+			uniformBlock.GTint = Color::White;
+
+			// The vertex program addresses the heap block in ALIGNMENT byte elements
+			const GpuHeapLocation instanceLocation = gBufferHeap->GetLocation(gInstanceAllocation);
+			uniformBlock.GInstanceOffset = instanceLocation.Offset / GpuMemoryHeap::ALIGNMENT;
+#else
+			uniformBlock.GMatWvp = createWorldViewProjectionMatrix(time);
 			uniformBlock.GTint = Color(1.0f, 1.0f, 1.0f, 0.5f);
+#endif
 
-			// Create a uniform block buffer for holding the uniform variables
-			SPtr<GpuParamBlockBuffer> uniformBuffer = GpuParamBlockBuffer::Create(sizeof(UniformBlock));
-			uniformBuffer->Write(0, &uniformBlock, sizeof(uniformBlock));
+			// Update the uniform block buffer
+			gUniformBuffer->Write(0, &uniformBlock, sizeof(uniformBlock));
 
 			// Assign the uniform buffer & texture
-			gGpuParams->SetParamBlockBuffer(GPT_FRAGMENT_PROGRAM, "Params", uniformBuffer);
-			gGpuParams->SetParamBlockBuffer(GPT_VERTEX_PROGRAM, "Params", uniformBuffer);
+			gGpuParams->SetParamBlockBuffer(GPT_FRAGMENT_PROGRAM, "Params", gUniformBuffer);
+			gGpuParams->SetParamBlockBuffer(GPT_VERTEX_PROGRAM, "Params", gUniformBuffer);
 
 			gGpuParams->SetTexture(GPT_FRAGMENT_PROGRAM, "gMainTexture", gSurfaceTex);
 
@@ -330,6 +452,11 @@ namespace bs
 			// Get the primary render API access point
 			RenderAPI& rapi = RenderAPI::Instance();
 
+#if BS_EXAMPLE_GPU_CULLING
+			// Find the visible boxes before drawing them. This runs on the GPU, so there is no need to wait for it.
+			gInstanceCuller->Cull(viewProj, cmds);
+#endif
+
 			// Bind render surface & clear it
 			rapi.SetRenderTarget(gRenderTarget, 0, RT_NONE, cmds);
 			rapi.ClearRenderTarget(FBT_COLOR | FBT_DEPTH, Color::Blue, 1, 0, 0xFF, cmds);
@@ -337,21 +464,37 @@ namespace bs
 			// Bind the pipeline state
 			rapi.SetGraphicsPipeline(gPipelineState, cmds);
 
-			// Set the vertex & index buffers, as well as vertex declaration and draw type
-			rapi.SetVertexBuffers(0, &gVertexBuffer, 1, cmds);
-			rapi.SetIndexBuffer(gIndexBuffer, cmds);
-			rapi.SetVertexDeclaration(gVertexDecl, cmds);
-			rapi.SetDrawOperation(DOT_TRIANGLE_LIST, cmds);
-
 			// Bind the GPU program parameters (i.e. resource descriptors)
 			rapi.SetGpuParams(gGpuParams, cmds);
 
-			// Draw
-			rapi.DrawIndexed(0, NUM_INDICES, 0, NUM_VERTICES, 1, cmds);
+			// Draw. The pool binds the shared vertex & index buffers, as well as the vertex declaration and draw type, and
+			// draws the range of the buffers holding the box.
+#if BS_EXAMPLE_GPU_CULLING
+			// Without indirect draws the instance count can't come from the culler, so all the instances are drawn and the
+			// vertex program discards the ones past the visible count
+			gGeometryPool->Draw(gBoxGeometry, gInstanceCuller->GetNumInstances(), cmds);
+
+			// Unbind the render surface so its depth can be read, and build the hierarchical depth for the next frame
+			rapi.SetRenderTarget(nullptr, 0, RT_NONE, cmds);
+			gInstanceCuller->BuildHiZ(gRenderTarget->GetDepthStencilTexture(), cmds);
+#else
+			gGeometryPool->Draw(gBoxGeometry, 1, cmds);
+#endif
 
 			// Submit the command buffer
 			rapi.SubmitCommandBuffer(cmds);
 
+#if BS_EXAMPLE_GPU_CULLING
+			// Reading the count back waits for the GPU, so only do it every few seconds
+			if(time - gLastStatsTime > 2.0f)
+			{
+				BS_LOG(Info, Uncategorized, "GPU culling: " + toString(gInstanceCuller->ReadVisibleCount()) + " of " +
+					toString(gInstanceCuller->GetNumInstances()) + " boxes visible");
+
+				gLastStatsTime = time;
+			}
+#endif
+
 			// Blit the image from the render texture, to the render window
 			rapi.SetRenderTarget(gRenderWindow);
 
@@ -372,73 +515,27 @@ namespace bs
 			gPipelineState = nullptr;
 			gSurfaceTex = nullptr;
 			gGpuParams = nullptr;
-			gVertexDecl = nullptr;
-			gVertexBuffer = nullptr;
-			gIndexBuffer = nullptr;
+			gGeometryPool = nullptr;
+			gBoxGeometry = GeometryAllocation();
+			gUniformBuffer = nullptr;
+
+			gRenderTargetPool->Release(gRenderTarget);
+			gRenderTargetPool = nullptr;
 			gRenderTarget = nullptr;
 			gRenderWindow = nullptr;
 			gSurfaceSampler = nullptr;
+
+#if BS_EXAMPLE_GPU_CULLING
+			gInstanceCuller = nullptr;
+
+			gBufferHeap->Free(gInstanceAllocation);
+			gBufferHeap = nullptr;
+#endif
 		}
 
 		/////////////////////////////////////////////////////////////////////////////////////
 		//////////////////////////////////HELPER METHODS/////////////////////////////////////
 		/////////////////////////////////////////////////////////////////////////////////////
-		void writeBoxVertices(const AABox& box, UINT8* positions, UINT8* uvs, u32 stride)
-		{
-			AABox::Corner vertOrder[] = {
-				AABox::NEAR_LEFT_BOTTOM, AABox::NEAR_RIGHT_BOTTOM, AABox::NEAR_RIGHT_TOP, AABox::NEAR_LEFT_TOP,
-				AABox::FAR_RIGHT_BOTTOM, AABox::FAR_LEFT_BOTTOM, AABox::FAR_LEFT_TOP, AABox::FAR_RIGHT_TOP,
-				AABox::FAR_LEFT_BOTTOM, AABox::NEAR_LEFT_BOTTOM, AABox::NEAR_LEFT_TOP, AABox::FAR_LEFT_TOP,
-				AABox::NEAR_RIGHT_BOTTOM, AABox::FAR_RIGHT_BOTTOM, AABox::FAR_RIGHT_TOP, AABox::NEAR_RIGHT_TOP,
-				AABox::FAR_LEFT_TOP, AABox::NEAR_LEFT_TOP, AABox::NEAR_RIGHT_TOP, AABox::FAR_RIGHT_TOP,
-				AABox::FAR_LEFT_BOTTOM, AABox::FAR_RIGHT_BOTTOM, AABox::NEAR_RIGHT_BOTTOM, AABox::NEAR_LEFT_BOTTOM
-			};
-
-			for(auto& entry : vertOrder)
-			{
-				Vector3 pos = box.GetCorner(entry);
-				memcpy(positions, &pos, sizeof(pos));
-
-				positions += stride;
-			}
-
-			for(u32 i = 0; i < 6; i++)
-			{
-				Vector2 uv;
-
-				uv = Vector2(0.0f, 1.0f);
-				memcpy(uvs, &uv, sizeof(uv));
-				uvs += stride;
-
-				uv = Vector2(1.0f, 1.0f);
-				memcpy(uvs, &uv, sizeof(uv));
-				uvs += stride;
-
-				uv = Vector2(1.0f, 0.0f);
-				memcpy(uvs, &uv, sizeof(uv));
-				uvs += stride;
-
-				uv = Vector2(0.0f, 0.0f);
-				memcpy(uvs, &uv, sizeof(uv));
-				uvs += stride;
-			}
-		}
-
-		void writeBoxIndices(u32* indices)
-		{
-			for(u32 face = 0; face < 6; face++)
-			{
-				u32 faceVertOffset = face * 4;
-
-				indices[face * 6 + 0] = faceVertOffset + 2;
-				indices[face * 6 + 1] = faceVertOffset + 1;
-				indices[face * 6 + 2] = faceVertOffset + 0;
-				indices[face * 6 + 3] = faceVertOffset + 0;
-				indices[face * 6 + 4] = faceVertOffset + 3;
-				indices[face * 6 + 5] = faceVertOffset + 2;
-			}
-		}
-
 		const char* getVertexProgSource()
 		{
 			if(gUseHLSL)
@@ -591,7 +688,7 @@ void main()
 			}
 		}
 
-		Matrix4 createWorldViewProjectionMatrix()
+		Matrix4 createWorldViewProjectionMatrix(float time)
 		{
 			Matrix4 proj = Matrix4::ProjectionPerspective(Degree(75.0f), 16.0f / 9.0f, 0.05f, 1000.0f);
 			bs::RenderAPI::ConvertProjectionMatrix(proj, proj);
@@ -604,7 +701,7 @@ void main()
 
 			Matrix4 view = Matrix4::View(cameraPos, cameraRot);
 
-			Quaternion rotation(Vector3::UNIT_Y, Degree(gTime().GetTime() * 90.0f));
+			Quaternion rotation(Vector3::UNIT_Y, Degree(time * 90.0f));
 			Matrix4 world = Matrix4::TRS(Vector3::ZERO, rotation, Vector3::ONE);
 
 			Matrix4 viewProj = proj * view * world;
@@ -615,5 +712,313 @@ void main()
 
 			return viewProj;
 		}
+
+#if BS_EXAMPLE_GPU_CULLING
+		const char* getInstancedVertexProgSource()
+		{
+			if(gUseHLSL)
+			{
+				static const char* src = R"(
+cbuffer Params
+{
+	float4x4 gMatWVP;
+	float4 gTint;
+	uint gInstanceOffset;
+}
+
+// Heap block holding the position and scale of each instance, one after another, starting at gInstanceOffset
+StructuredBuffer<float4> gInstances;
+StructuredBuffer<uint> gVisibleInstances;
+StructuredBuffer<uint> gDrawArgs;
+
+void main(
+	in float3 inPos : POSITION,
+	in float2 uv : TEXCOORD0,
+	in uint instanceId : SV_InstanceID,
+	out float4 oPosition : SV_Position,
+	out float2 oUv : TEXCOORD0,
+	out float4 oColor : COLOR0)
+{
+	// All vertices of the instances past the visible count are moved to the same position, so their triangles are
+	// degenerate and discarded before rasterization
+	if(instanceId >= gDrawArgs[1])
+	{
+		oPosition = float4(2.0f, 2.0f, 2.0f, 1.0f);
+		oUv = 0.0f;
+		oColor = 0.0f;
+		return;
+	}
+
+	uint instanceIdx = gVisibleInstances[instanceId];
+	float4 position = gInstances[gInstanceOffset + instanceIdx * 2];
+	float4 scale = gInstances[gInstanceOffset + instanceIdx * 2 + 1];
+
+	float3 worldPos = inPos * scale.xyz + position.xyz;
+	oPosition = mul(gMatWVP, float4(worldPos, 1));
+	oUv = uv;
+
+	// Give every box a slightly different shade
+	oColor = float4(frac(instanceIdx * float3(0.618034f, 0.381966f, 0.754878f)) * 0.5f + 0.5f, 1.0f);
+}
+)";
+
+				return src;
+			}
+			else if(gUseVKSL)
+			{
+				static const char* src = R"(
+layout (binding = 0, std140) uniform Params
+{
+	mat4 gMatWVP;
+	vec4 gTint;
+	uint gInstanceOffset;
+};
+
+// Heap block holding the position and scale of each instance, one after another, starting at gInstanceOffset
+layout (binding = 1, std430) readonly buffer gInstances
+{
+	vec4 gInstancesData[];
+};
+
+layout (binding = 2, std430) readonly buffer gVisibleInstances
+{
+	uint gVisibleInstancesData[];
+};
+
+layout (binding = 3, std430) readonly buffer gDrawArgs
+{
+	uint gDrawArgsData[];
+};
+
+layout (location = 0) in vec3 bs_position;
+layout (location = 1) in vec2 bs_texcoord0;
+
+layout (location = 0) out vec2 texcoord0;
+layout (location = 1) out vec4 color;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	// All vertices of the instances past the visible count are moved to the same position, so their triangles are
+	// degenerate and discarded before rasterization
+	uint instanceId = uint(gl_InstanceIndex);
+	if(instanceId >= gDrawArgsData[1])
+	{
+		gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+		texcoord0 = vec2(0.0f);
+		color = vec4(0.0f);
+		return;
+	}
+
+	uint instanceIdx = gVisibleInstancesData[instanceId];
+	vec4 position = gInstancesData[gInstanceOffset + instanceIdx * 2];
+	vec4 scale = gInstancesData[gInstanceOffset + instanceIdx * 2 + 1];
+
+	vec3 worldPos = bs_position * scale.xyz + position.xyz;
+	gl_Position = gMatWVP * vec4(worldPos, 1);
+	texcoord0 = bs_texcoord0;
+
+	// Give every box a slightly different shade
+	color = vec4(fract(float(instanceIdx) * vec3(0.618034f, 0.381966f, 0.754878f)) * 0.5f + 0.5f, 1.0f);
+}
+)";
+
+				return src;
+			}
+			else
+			{
+				static const char* src = R"(
+layout (std140) uniform Params
+{
+	mat4 gMatWVP;
+	vec4 gTint;
+	uint gInstanceOffset;
+};
+
+// Heap block holding the position and scale of each instance, one after another, starting at gInstanceOffset
+layout (std430) readonly buffer gInstances
+{
+	vec4 gInstancesData[];
+};
+
+layout (std430) readonly buffer gVisibleInstances
+{
+	uint gVisibleInstancesData[];
+};
+
+layout (std430) readonly buffer gDrawArgs
+{
+	uint gDrawArgsData[];
+};
+
+in vec3 bs_position;
+in vec2 bs_texcoord0;
+
+out vec2 texcoord0;
+out vec4 color;
+
+out gl_PerVertex
+{
+	vec4 gl_Position;
+};
+
+void main()
+{
+	// All vertices of the instances past the visible count are moved to the same position, so their triangles are
+	// degenerate and discarded before rasterization
+	uint instanceId = uint(gl_InstanceID);
+	if(instanceId >= gDrawArgsData[1])
+	{
+		gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+		texcoord0 = vec2(0.0f);
+		color = vec4(0.0f);
+		return;
+	}
+
+	uint instanceIdx = gVisibleInstancesData[instanceId];
+	vec4 position = gInstancesData[gInstanceOffset + instanceIdx * 2];
+	vec4 scale = gInstancesData[gInstanceOffset + instanceIdx * 2 + 1];
+
+	vec3 worldPos = bs_position * scale.xyz + position.xyz;
+	gl_Position = gMatWVP * vec4(worldPos, 1);
+	texcoord0 = bs_texcoord0;
+
+	// Give every box a slightly different shade
+	color = vec4(fract(float(instanceIdx) * vec3(0.618034f, 0.381966f, 0.754878f)) * 0.5f + 0.5f, 1.0f);
+}
+)";
+				return src;
+			}
+		}
+
+		const char* getInstancedFragmentProgSource()
+		{
+			if(gUseHLSL)
+			{
+				static const char* src = R"(
+cbuffer Params
+{
+	float4x4 gMatWVP;
+	float4 gTint;
+	uint gInstanceOffset;
+}
+
+SamplerState gMainTexSamp : register(s0);
+Texture2D gMainTexture : register(t0);
+
+float4 main(in float4 inPos : SV_Position, float2 uv : TEXCOORD0, float4 color : COLOR0) : SV_Target
+{
+	return gMainTexture.Sample(gMainTexSamp, uv) * color * gTint;
+}
+)";
+
+				return src;
+			}
+			else if(gUseVKSL)
+			{
+				static const char* src = R"(
+layout (binding = 0, std140) uniform Params
+{
+	mat4 gMatWVP;
+	vec4 gTint;
+	uint gInstanceOffset;
+};
+
+layout (binding = 4) uniform sampler2D gMainTexture;
+
+layout (location = 0) in vec2 texcoord0;
+layout (location = 1) in vec4 color;
+layout (location = 0) out vec4 fragColor;
+
+void main()
+{
+	fragColor = texture(gMainTexture, texcoord0.st) * color * gTint;
+}
+)";
+
+				return src;
+			}
+			else
+			{
+				static const char* src = R"(
+layout (std140) uniform Params
+{
+	mat4 gMatWVP;
+	vec4 gTint;
+	uint gInstanceOffset;
+};
+
+uniform sampler2D gMainTexture;
+
+in vec2 texcoord0;
+in vec4 color;
+out vec4 fragColor;
+
+void main()
+{
+	fragColor = texture(gMainTexture, texcoord0.st) * color * gTint;
+}
+)";
+				return src;
+			}
+		}
+
+		Matrix4 createCityViewProjectionMatrix(float time)
+		{
+			Matrix4 proj = Matrix4::ProjectionPerspective(Degree(75.0f), 16.0f / 9.0f, 1.0f, 3000.0f);
+			bs::RenderAPI::ConvertProjectionMatrix(proj, proj);
+
+			// Circle the city center at street level, where most of the city is hidden behind the nearby boxes
+			Radian angle(time * 0.1f);
+			Vector3 cameraPos = Vector3(Math::Cos(angle) * 300.0f, 20.0f, Math::Sin(angle) * 300.0f);
+			Vector3 lookDir = Vector3::Normalize(Vector3(0.0f, 10.0f, 0.0f) - cameraPos);
+
+			Quaternion cameraRot(BsIdentity);
+			cameraRot.LookRotation(lookDir);
+
+			Matrix4 view = Matrix4::View(cameraPos, cameraRot);
+
+			// Not transposed, since the culler expects the engine's matrix layout
+			return proj * view;
+		}
+
+		void createCity(GpuMemoryHeap& heap, const GpuHeapAllocation& instanceAllocation,
+			Vector<GpuInstanceBounds>& bounds)
+		{
+			// The box mesh is 20 units wide, so scale it down to leave a street between the neighbouring boxes
+			const float footprint = CITY_BLOCK_SIZE * 0.7f;
+			const float meshSize = 20.0f;
+
+			Vector<InstanceData> instances(NUM_INSTANCES);
+			bounds.resize(NUM_INSTANCES);
+
+			Random random(1234);
+			for(u32 row = 0; row < CITY_ROWS; row++)
+			{
+				for(u32 column = 0; column < CITY_COLUMNS; column++)
+				{
+					const float height = random.GetRange(5.0f, 80.0f);
+					const Vector3 size(footprint, height, footprint);
+					const Vector3 center(
+						(column - CITY_COLUMNS * 0.5f) * CITY_BLOCK_SIZE,
+						height * 0.5f,
+						(row - CITY_ROWS * 0.5f) * CITY_BLOCK_SIZE);
+
+					const u32 idx = row * CITY_COLUMNS + column;
+					instances[idx].Position = Vector4(center.X, center.Y, center.Z, 0.0f);
+					instances[idx].Scale = Vector4(size.X / meshSize, size.Y / meshSize, size.Z / meshSize, 0.0f);
+
+					bounds[idx].Center = instances[idx].Position;
+					bounds[idx].Extents = Vector4(size.X * 0.5f, size.Y * 0.5f, size.Z * 0.5f, 0.0f);
+				}
+			}
+
+			heap.Write(instanceAllocation, instances.data(), NUM_INSTANCES * sizeof(InstanceData));
+		}
+#endif
 	} // namespace ct
 } // namespace bs
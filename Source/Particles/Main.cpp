@@ -10,6 +10,10 @@
 #include "Components/BsCPlaneCollider.h"
 #include "Components/BsCCharacterController.h"
 #include "Components/BsCParticleSystem.h"
+#include "GUI/BsCGUIWidget.h"
+#include "GUI/BsGUIPanel.h"
+#include "GUI/BsGUILayoutY.h"
+#include "GUI/BsGUILabel.h"
 #include "Image/BsSpriteTexture.h"
 #include "Particles/BsParticleSystem.h"
 #include "Particles/BsParticleEmitter.h"
@@ -25,21 +29,32 @@
 #include "BsExampleFramework.h"
 #include "BsFPSWalker.h"
 #include "BsFPSCamera.h"
+#include "BsBenchmarkScenario.h"
+#include "BsProfiledApplication.h"
+#include "BsSparkEmitter.h"
+#include "BsCurveEvaluator.h"
+#include "BsFrameTaskGraph.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// This example sets up an environment with three particle systems:
+// This example sets up an environment with four particle systems:
 // - Smoke effect using traditional billboard particles
 // - 3D particles with support for world collisions and lighting
-// - GPU particle simulation with a vector field
+// - GPU particle simulation with a vector field and collisions against the scene depth buffer
+// - Sparks simulated on the CPU by a custom component, with particle data allocated from a shared memory pool
 //
 // It also sets up necessary physical objects for collision, as well as the character collider and necessary components
 // for walking around the environment.
 //
 // The example first loads necessary resources, including textures and materials. Then it set up the scene, consisting of a
 // floor and a skybox. Character controller is created next, as well as the camera. Components for moving the character
-// controller and the camera are attached to allow the user to control the character. Finally it sets up three separate
+// controller and the camera are attached to allow the user to control the character. Finally it sets up four separate
 // particle systems, their creation wrapped in their own creation methods. Finally the cursor is hidden and quit on Esc
 // key press hooked up.
+//
+// The CPU work of the sparks and of the light orbiting the 3D particles runs through a frame task graph, which executes
+// independent tasks concurrently on the engine's task scheduler and can record a trace of each frame.
+//
+// The average frame time is displayed, along with the number of sparks and the memory they borrowed from the pool.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace bs
 {
@@ -49,7 +64,8 @@ namespace bs
 	u32 windowResHeight = 720;
 
 	// Set up a helper component that makes the object its attached to orbit a point. This is used by the 3D particle
-	// system for moving its light.
+	// system for moving its light. The orbit is advanced by a task of the frame task graph (see ParticleFrameTasks below),
+	// which may run on any thread, so the new position is only applied to the scene object later, on the main thread.
 	class LightOrbit : public Component
 	{
 	public:
@@ -60,23 +76,158 @@ namespace bs
 		void OnInitialized() override
 		{
 			mCenter = SO()->GetTransform().GetPosition();
+			mPosition = mCenter;
 		}
 
-		void Update() override
+		/** Moves the orbiting object forward by 'dt' seconds. */
+		void Advance(float dt)
 		{
-			Vector3 position = mCenter + mRadius * Vector3(Math::Cos(mAngle), 0.0f, Math::Sin(mAngle));
-
-			mAngle += Degree(gTime().GetFrameDelta() * 90.0f);
+			mPosition = mCenter + mRadius * Vector3(Math::Cos(mAngle), 0.0f, Math::Sin(mAngle));
+			mAngle += Degree(dt * 90.0f);
+		}
 
-			SO()->SetWorldPosition(position);
+		/** Applies the position calculated by Advance() to the scene object. */
+		void Apply()
+		{
+			SO()->SetWorldPosition(mPosition);
 		}
 
 	private:
 		Degree mAngle = Degree(0.0f);
 		Vector3 mCenter;
+		Vector3 mPosition;
 		float mRadius;
 	};
 
+	using HLightOrbit = GameObjectHandle<LightOrbit>;
+
+	// Set up a helper component that moves the object it's attached to along a looping keyframed path. This is used for
+	// moving the spark emitter. The path is sampled every frame with steadily increasing time, so it's evaluated using a
+	// curve evaluator that continues from the last keyframe segment instead of searching for it every time.
+	class PathAnimator : public Component
+	{
+	public:
+		PathAnimator(const HSceneObject& parent, const TAnimationCurve<Vector3>& path)
+			: Component(parent), mPath(path)
+		{}
+
+		void Update() override
+		{
+			mTime += gTime().GetFrameDelta();
+
+			SO()->SetWorldPosition(mPath.Evaluate(mTime, true));
+		}
+
+	private:
+		Vector3CurveEvaluator mPath;
+		float mTime = 0.0f;
+	};
+
+	HSparkEmitter gSparkEmitter;
+	HLightOrbit gLightOrbit;
+	GUILabel* gStatsLabel = nullptr;
+
+	// Set up a helper component that runs the CPU side work of the sparks and the orbiting light through a frame task
+	// graph. The spark stages depend on each other and run in order, while the light orbit runs concurrently with them.
+	// Scene objects and meshes may only be modified from the main thread, so the results are applied once the whole graph
+	// finishes. The execution of the graph can be recorded into a trace viewable in chrome://tracing or Perfetto.
+	class ParticleFrameTasks : public Component
+	{
+	public:
+		ParticleFrameTasks(const HSceneObject& parent)
+			: Component(parent)
+		{
+			SetName("ParticleFrameTasks");
+
+			using TaskId = FrameTaskGraph::TaskId;
+			TaskId spawnTask = mGraph.AddTask("Sparks: spawn", [this]() { gSparkEmitter->Spawn(mFrameDelta); });
+			TaskId simulateTask = mGraph.AddTask("Sparks: simulate",
+				[this]() { gSparkEmitter->Simulate(mFrameDelta); }, { spawnTask });
+			mGraph.AddTask("Sparks: write vertices", []() { gSparkEmitter->WriteVertices(); }, { simulateTask });
+
+			mGraph.AddTask("Light orbit", [this]() { gLightOrbit->Advance(mFrameDelta); });
+		}
+
+		void OnInitialized() override
+		{
+			// The stages of the emitter are called by the graph instead
+			gSparkEmitter->SetAutoUpdate(false);
+		}
+
+		void Update() override
+		{
+			mFrameDelta = gTime().GetFrameDelta();
+			mGraph.Execute();
+
+			gSparkEmitter->UploadMesh();
+			gLightOrbit->Apply();
+		}
+
+		/**
+		 * Starts recording the execution of the graph, or stops recording and saves the trace to the working directory if
+		 * already recording.
+		 */
+		void ToggleTrace()
+		{
+			mIsTracing = !mIsTracing;
+			mGraph.SetTraceEnabled(mIsTracing);
+
+			if(!mIsTracing)
+			{
+				mGraph.SaveTrace("ParticlesFrameTrace.json");
+				mGraph.ClearTrace();
+			}
+		}
+
+	private:
+		FrameTaskGraph mGraph;
+		float mFrameDelta = 0.0f;
+		bool mIsTracing = false;
+	};
+
+	using HParticleFrameTasks = GameObjectHandle<ParticleFrameTasks>;
+
+	// Set up a helper component that displays the average frame time, along with the number of sparks and the particle
+	// memory pool usage.
+	class ParticleStatsDisplay : public Component
+	{
+	public:
+		ParticleStatsDisplay(const HSceneObject& parent)
+			: Component(parent)
+		{}
+
+		void Update() override
+		{
+			mAccumulatedTime += gTime().GetFrameDelta();
+			mNumFrames++;
+
+			// Refresh the label once per second, displaying the average frame time over that period
+			if(mAccumulatedTime < 1.0f)
+				return;
+
+			float frameTimeMs = (mAccumulatedTime / (float)mNumFrames) * 1000.0f;
+
+			// Report how much memory the CPU simulated sparks borrowed from the particle memory pool
+			const ParticleMemoryPoolStats poolStats = ParticleMemoryPool::Instance().GetStats();
+			const u32 numSparks = gSparkEmitter ? gSparkEmitter->GetNumParticles() : 0;
+
+			HString statsString("Frame time: {0} ms, sparks: {1}, particle pool: {2} KB used, {3} KB reserved");
+			statsString.SetParameter(0, toString(frameTimeMs));
+			statsString.SetParameter(1, toString(numSparks));
+			statsString.SetParameter(2, toString(poolStats.UsedBytes / 1024));
+			statsString.SetParameter(3, toString(poolStats.ReservedBytes / 1024));
+
+			gStatsLabel->SetContent(GUIContent(statsString));
+
+			mAccumulatedTime = 0.0f;
+			mNumFrames = 0;
+		}
+
+	private:
+		float mAccumulatedTime = 0.0f;
+		u32 mNumFrames = 0;
+	};
+
 	/** Container for all assets used by the particles systems in this example. */
 	struct ParticleSystemAssets
 	{
@@ -92,6 +243,9 @@ namespace bs
 		// GPU particle system assets
 		HMaterial LitParticleEmissiveMat;
 		HVectorField VectorField;
+
+		// Spark assets
+		HMaterial SparkMat;
 	};
 
 	/** Load the assets used by the particle systems. */
@@ -142,12 +296,19 @@ namespace bs
 		//// Import a sphere mesh used for the 3D particles and the light sphere
 		assets.SphereMesh = gBuiltinResources().GetMesh(BuiltinMesh::Sphere);
 
+		// Spark assets
+		//// Create an emissive material for the sparks, bright enough to trigger bloom. The spark emitter assigns its own
+		//// emissive mask, tinting the sparks over their lifetime.
+		assets.SparkMat = Material::Create(standardShader);
+		assets.SparkMat->SetColor("gEmissiveColor", Color::White * 10.0f);
+
 		return assets;
 	}
 
 	void setupGPUParticleEffect(const Vector3& pos, const ParticleSystemAssets& assets);
 	void setup3DParticleEffect(const Vector3& pos, const ParticleSystemAssets& assets);
 	void setupSmokeEffect(const Vector3& pos, const ParticleSystemAssets& assets);
+	void setupSparksEffect(const Vector3& pos, const ParticleSystemAssets& assets);
 
 	/** Set up the scene used by the example, and the camera to view the world through. */
 	void setUpScene()
@@ -279,6 +440,11 @@ namespace bs
 		setup3DParticleEffect(Vector3(-5.0f, 1.0f, 0.0f), assets);
 		setupGPUParticleEffect(Vector3(0.0f, 1.0f, 0.0f), assets);
 		setupSmokeEffect(Vector3(5.0f, 0.0f, 0.0f), assets);
+		setupSparksEffect(Vector3(2.5f, 2.0f, 0.0f), assets);
+
+		// Drive the CPU work of the sparks and the orbiting light through a task graph
+		HSceneObject frameTasksSO = SceneObject::Create("Frame tasks");
+		HParticleFrameTasks frameTasks = frameTasksSO->AddComponent<ParticleFrameTasks>();
 
 		/************************************************************************/
 		/* 									CURSOR                       		*/
@@ -292,14 +458,49 @@ namespace bs
 		/* 									INPUT                       		*/
 		/************************************************************************/
 
-		// Hook up Esc key to quit
+		// Hook up T key to record a trace of the frame tasks, and Esc key to quit
 		gInput().OnButtonUp.Connect([=](const ButtonEvent& ev)
 									{
-			if(ev.ButtonCode == BC_ESCAPE)
+			if(ev.ButtonCode == BC_T)
+			{
+				// Start recording, or save the recorded trace
+				frameTasks->ToggleTrace();
+			}
+			else if(ev.ButtonCode == BC_ESCAPE)
 			{
 				// Quit the application when Escape key is pressed
 				gApplication().QuitRequested();
 			} });
+
+		/************************************************************************/
+		/* 									GUI		                     		*/
+		/************************************************************************/
+
+		// Display GUI elements indicating to the user which input keys are available, and the frame time
+
+		// Add a GUIWidget component we will use for rendering the GUI
+		HSceneObject guiSO = SceneObject::Create("GUI");
+		HGUIWidget gui = guiSO->AddComponent<CGUIWidget>(sceneCamera);
+
+		// Grab the main panel onto which to attach the GUI elements to
+		GUIPanel* mainPanel = gui->GetPanel();
+
+		// Create a vertical GUI layout to align the labels one below each other
+		GUILayoutY* vertLayout = GUILayoutY::Create();
+
+		// Create the GUI labels displaying the available input commands and the frame time statistics
+		HString traceString(u8"Press T to start recording a trace of the frame tasks, and again to save it");
+		HString quitString(u8"Press the Escape key to quit");
+
+		vertLayout->AddNewElement<GUILabel>(traceString);
+		vertLayout->AddNewElement<GUILabel>(quitString);
+		gStatsLabel = vertLayout->AddNewElement<GUILabel>(HString(u8"Measuring frame time..."));
+
+		// Register the layout with the main GUI panel, placing the layout in top left corner of the screen by default
+		mainPanel->AddElement(vertLayout);
+
+		// Add the component that updates the frame time statistics
+		guiSO->AddComponent<ParticleStatsDisplay>();
 	}
 
 	/**
@@ -537,12 +738,86 @@ namespace bs
 		lightSphere->SetMaterial(assets.LightMat);
 
 		//// Add a component that orbits the light at 1m of its original position
-		lightSO->AddComponent<LightOrbit>(1.0f);
+		gLightOrbit = lightSO->AddComponent<LightOrbit>(1.0f);
+	}
+
+	/**
+	 * Sets up sparks simulated on the CPU by the SparkEmitter component. The sparks shoot upwards out of a narrow cone
+	 * that is swept around over time, fall back down and bounce off the floor. The emitter itself moves along a keyframed
+	 * path. Their attributes are stored in buffers borrowed from the global particle
+	 * memory pool, whose usage is displayed in the stats label.
+	 */
+	void setupSparksEffect(const Vector3& pos, const ParticleSystemAssets& assets)
+	{
+		// Create the emitter scene object and rotate it so the cone (pointing along Z) points upwards
+		HSceneObject sparksSO = SceneObject::Create("Sparks emitter");
+		sparksSO->SetPosition(pos);
+		sparksSO->SetRotation(Quaternion(Vector3::UNIT_X, Degree(-90.0f)));
+
+		SparkEmitterSettings settings;
+
+		// Emit from a small disc, spreading the sparks within 25 degrees of the cone axis
+		settings.Shape.Type = ParticleEmitterConeType::Base;
+		settings.Shape.Radius = 0.05f;
+		settings.Shape.Angle = Degree(25.0f);
+
+		// Sweep around the cone once every two seconds instead of picking a random point on the arc, so the sparks spray
+		// out in a spiral
+		settings.Shape.Mode.Type = ParticleEmissionModeType::Loop;
+		settings.Shape.Mode.Speed = 0.5f;
+
+		settings.EmissionRate = 300.0f;
+		settings.Speed = 5.0f;
+		settings.Lifetime = 2.0f;
+
+		// Bounce off the floor plane
+		settings.GroundHeight = 0.0f;
+
+		// Shrink the sparks towards the end of their lifetime. The curve is baked into a lookup table by the emitter.
+		settings.SizeOverLifetime = TAnimationCurve<float>(
+			{
+				TKeyframe<float>{ 1.0f, 0.0f, 0.0f, 0.0f },
+				TKeyframe<float>{ 1.0f, 0.0f, -2.0f, 0.5f },
+				TKeyframe<float>{ 0.0f, -2.0f, 0.0f, 1.0f },
+			});
+
+		// Cool down from a yellowish white to a dark red
+		settings.ColorOverLifetime = ColorGradient(
+			{ ColorGradientKey(Color(1.0f, 0.9f, 0.6f, 1.0f), 0.0f),
+			  ColorGradientKey(Color(1.0f, 0.4f, 0.05f, 1.0f), 0.3f),
+			  ColorGradientKey(Color(0.2f, 0.02f, 0.0f, 1.0f), 1.0f) });
+
+		gSparkEmitter = sparksSO->AddComponent<SparkEmitter>(assets.SparkMat, settings);
+
+		// Move the emitter around a closed path, passing through each point every two seconds. Tangents are chosen so
+		// the emitter moves smoothly through the points (Catmull-Rom spline).
+		const Vector3 pathPoints[] = {
+			Vector3(0.0f, 0.0f, 0.0f),
+			Vector3(1.0f, 0.5f, -1.0f),
+			Vector3(0.0f, 1.0f, -2.0f),
+			Vector3(-1.0f, 0.5f, -1.0f)
+		};
+
+		constexpr u32 numPoints = sizeof(pathPoints) / sizeof(pathPoints[0]);
+		constexpr float pointInterval = 2.0f;
+
+		Vector<TKeyframe<Vector3>> pathKeys;
+		for(u32 i = 0; i <= numPoints; i++)
+		{
+			const Vector3& prev = pathPoints[(i + numPoints - 1) % numPoints];
+			const Vector3& next = pathPoints[(i + 1) % numPoints];
+			const Vector3 tangent = (next - prev) / (2.0f * pointInterval);
+
+			pathKeys.push_back(TKeyframe<Vector3>{ pos + pathPoints[i % numPoints], tangent, tangent, i * pointInterval });
+		}
+
+		sparksSO->AddComponent<PathAnimator>(TAnimationCurve<Vector3>(pathKeys));
 	}
 
 	/**
 	 * Sets up a particle system that uses the GPU particle simulation. Particles are spawned on a surface of a sphere and
-	 * a vector field is used for evolving the particles during their lifetime.
+	 * a vector field is used for evolving the particles during their lifetime. Particles collide with the scene by testing
+	 * against the depth buffer.
 	 */
 	void setupGPUParticleEffect(const Vector3& pos, const ParticleSystemAssets& assets)
 	{
@@ -617,6 +892,20 @@ namespace bs
 		// Setting this to zero ensures the vector field only applies forces, not velocities, to the particles
 		gpuSimSettings.VectorField.Tightness = 0.0f;
 
+		// Enable collisions with the scene. Unlike the plane collisions used by the 3D particle system, these are performed
+		// in the simulation compute pass by testing the particles against the scene depth and normal buffers. This means
+		// particles collide with anything visible on screen at a constant cost, without any CPU physics queries.
+		gpuSimSettings.DepthCollision.Enabled = true;
+
+		// Keep half of the velocity along the collision normal when bouncing
+		gpuSimSettings.DepthCollision.Restitution = 0.5f;
+
+		// Lose some of the velocity perpendicular to the collision normal on every bounce
+		gpuSimSettings.DepthCollision.Dampening = 0.5f;
+
+		// Use the visible particle size for collisions
+		gpuSimSettings.DepthCollision.RadiusScale = 1.0f;
+
 		// And actually apply the GPU simulation settings
 		particleSystem->SetGpuSimulationSettings(gpuSimSettings);
 	}
@@ -637,9 +926,10 @@ int main()
 {
 	using namespace bs;
 
-	// Initializes the application and creates a window with the specified properties
+	// Initializes the application and creates a window with the specified properties. The application measures the
+	// time and hardware counters of each phase of the frame, and logs them on exit.
 	VideoMode videoMode(windowResWidth, windowResHeight);
-	Application::StartUp(videoMode, "Example", false);
+	Application::StartUp<ProfiledApplication>(videoMode, "Example", false);
 
 	// Registers a default set of input controls
 	ExampleFramework::SetupInputConfig();
@@ -647,6 +937,9 @@ int main()
 	// Set up the scene with an object to render and a camera
 	setUpScene();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
@@ -9,18 +9,27 @@
 #include "RenderAPI/BsRenderAPI.h"
 #include "RenderAPI/BsRenderWindow.h"
 #include "Scene/BsSceneObject.h"
+#include "GUI/BsCGUIWidget.h"
+#include "GUI/BsGUIPanel.h"
+#include "GUI/BsGUILayoutY.h"
+#include "GUI/BsGUILabel.h"
+#include "Utility/BsTime.h"
 
 // Example includes
 #include "BsObjectRotator.h"
 #include "BsExampleFramework.h"
+#include "BsCoroutine.h"
+#include "BsBenchmarkScenario.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example renders an object using the standard built-in physically based material.
 //
-// The example first loads necessary resources, including a mesh and textures to use for rendering. Then it creates a
-// material using the standard PBR shader. It then proceeds to register the relevant keys used for controling the camera
-// and the rendered object. Finally it sets up the 3D scene using the mesh, textures, material and sets up a camera, along
-// with CameraFlyer and ObjectRotator components that allow the user to fly around the scene and rotate the 3D model.
+// The example first registers the relevant keys used for controling the camera and the rendered object, and sets up a
+// camera along with a loading indicator. The rest of the setup runs as a coroutine, started on a CoroutineScheduler
+// component. The coroutine issues asynchronous loads for a mesh and textures to use for rendering, and suspends until
+// they all finish, while the main loop keeps running and the loading indicator keeps animating. Once loaded it creates a
+// material using the standard PBR shader, and sets up the 3D scene using the mesh, textures and material, along with an
+// ObjectRotator component that allows the user to rotate the 3D model.
 //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace bs
@@ -40,19 +49,37 @@ namespace bs
 		HMaterial ExampleMaterial;
 	};
 
-	/** Load the resources we'll be using throughout the example. */
-	Assets loadAssets()
+	/**
+	 * Load the resources we'll be using throughout the example. All loads are started at once and processed in parallel,
+	 * with the coroutine suspending until they finish.
+	 */
+	CoroutineTask<Assets> loadAssets()
 	{
 		Assets assets;
 
-		// Load a 3D model
-		assets.ExampleModel = ExampleFramework::LoadMesh(ExampleMesh::Cerberus);
+		// Start loading a 3D model
+		assets.ExampleModel = ExampleFramework::LoadMeshAsync(ExampleMesh::Cerberus);
 
-		// Load PBR textures for the 3D model
-		assets.ExampleAlbedoTex = ExampleFramework::LoadTexture(ExampleTexture::CerberusAlbedo);
-		assets.ExampleNormalsTex = ExampleFramework::LoadTexture(ExampleTexture::CerberusNormal, false);
-		assets.ExampleRoughnessTex = ExampleFramework::LoadTexture(ExampleTexture::CerberusRoughness, false);
-		assets.ExampleMetalnessTex = ExampleFramework::LoadTexture(ExampleTexture::CerberusMetalness, false);
+		// Start loading PBR textures for the 3D model
+		assets.ExampleAlbedoTex = ExampleFramework::LoadTextureAsync(ExampleTexture::CerberusAlbedo);
+		assets.ExampleNormalsTex = ExampleFramework::LoadTextureAsync(ExampleTexture::CerberusNormal, false);
+		assets.ExampleRoughnessTex = ExampleFramework::LoadTextureAsync(ExampleTexture::CerberusRoughness, false);
+		assets.ExampleMetalnessTex = ExampleFramework::LoadTextureAsync(ExampleTexture::CerberusMetalness, false);
+
+		// Start loading an environment map
+		assets.ExampleSkyCubemap = ExampleFramework::LoadTextureAsync(ExampleTexture::EnvironmentPaperMill, false, true, true);
+
+		// Wait until everything is loaded. The main loop keeps running in the meantime.
+		Vector<HResource> pendingResources = {
+			assets.ExampleModel,
+			assets.ExampleAlbedoTex,
+			assets.ExampleNormalsTex,
+			assets.ExampleRoughnessTex,
+			assets.ExampleMetalnessTex,
+			assets.ExampleSkyCubemap
+		};
+
+		co_await WaitForLoadAll(pendingResources);
 
 		// Create a material using the default physically based shader, and apply the PBR textures we just loaded
 		HShader shader = gBuiltinResources().GetBuiltinShader(BuiltinShader::Standard);
@@ -63,13 +90,10 @@ namespace bs
 		assets.ExampleMaterial->SetTexture("gRoughnessTex", assets.ExampleRoughnessTex);
 		assets.ExampleMaterial->SetTexture("gMetalnessTex", assets.ExampleMetalnessTex);
 
-		// Load an environment map
-		assets.ExampleSkyCubemap = ExampleFramework::LoadTexture(ExampleTexture::EnvironmentPaperMill, false, true, true);
-
-		return assets;
+		co_return assets;
 	}
 
-	/** Set up the 3D object used by the example, and the camera to view the world through. */
+	/** Set up the 3D object used by the example. */
 	void setUp3DScene(const Assets& assets)
 	{
 		/************************************************************************/
@@ -102,11 +126,11 @@ namespace bs
 
 		HSkybox skybox = skyboxSO->AddComponent<CSkybox>();
 		skybox->SetTexture(assets.ExampleSkyCubemap);
+	}
 
-		/************************************************************************/
-		/* 									CAMERA	                     		*/
-		/************************************************************************/
-
+	/** Set up the camera to view the world through. */
+	HCamera setUpCamera()
+	{
 		// In order something to render on screen we need at least one camera.
 
 		// Like before, we create a new scene object at (0, 0, 0).
@@ -134,6 +158,60 @@ namespace bs
 		// Position and orient the camera scene object
 		sceneCameraSO->SetPosition(Vector3(0.2f, 0.05f, 1.4f));
 		sceneCameraSO->LookAt(Vector3(0.2f, 0.05f, 0.0f));
+
+		return sceneCamera;
+	}
+
+	// Set up a helper component that animates a label while the example is loading
+	class LoadingIndicator : public Component
+	{
+	public:
+		LoadingIndicator(const HSceneObject& parent, GUILabel* label)
+			: Component(parent), mLabel(label)
+		{}
+
+		void Update() override
+		{
+			mElapsed += gTime().GetFrameDelta();
+
+			// Add a dot every quarter of a second, cycling through zero to three dots
+			const u32 numDots = (u32)(mElapsed * 4.0f) % 4;
+			mLabel->SetContent(GUIContent(HString(String("Loading") + String(numDots, '.'))));
+		}
+
+	private:
+		GUILabel* mLabel;
+		float mElapsed = 0.0f;
+	};
+
+	/** Set up a loading indicator, displayed while the assets are being loaded. */
+	HSceneObject setUpLoadingIndicator(const HCamera& camera)
+	{
+		// Add a GUIWidget component we will use for rendering the GUI
+		HSceneObject loadingSO = SceneObject::Create("Loading");
+		HGUIWidget gui = loadingSO->AddComponent<CGUIWidget>(camera);
+
+		// Create a label in the top left corner of the screen, and a component that animates it
+		GUILayoutY* vertLayout = gui->GetPanel()->AddNewElement<GUILayoutY>();
+		GUILabel* loadingLabel = vertLayout->AddNewElement<GUILabel>(HString("Loading"));
+
+		loadingSO->AddComponent<LoadingIndicator>(loadingLabel);
+
+		return loadingSO;
+	}
+
+	/**
+	 * Loads the assets and sets up the 3D scene, without blocking the main loop. Removes the loading indicator once done.
+	 */
+	CoroutineTask<> setUpScene(HSceneObject loadingSO)
+	{
+		// Load a model and textures, create materials
+		Assets assets = co_await loadAssets();
+
+		// Set up the scene with an object to render
+		setUp3DScene(assets);
+
+		loadingSO->Destroy();
 	}
 } // namespace bs
 
@@ -159,11 +237,17 @@ int main()
 	// Registers a default set of input controls
 	ExampleFramework::SetupInputConfig();
 
-	// Load a model and textures, create materials
-	Assets assets = loadAssets();
+	// Set up a camera, and a loading indicator to display until the scene is ready
+	HCamera sceneCamera = setUpCamera();
+	HSceneObject loadingSO = setUpLoadingIndicator(sceneCamera);
+
+	// Load the assets and set up the scene in a coroutine, which runs alongside the main loop
+	HSceneObject setupSO = SceneObject::Create("Setup");
+	HCoroutineScheduler scheduler = setupSO->AddComponent<CoroutineScheduler>();
+	scheduler->Start(setUpScene(loadingSO));
 
-	// Set up the scene with an object to render and a camera
-	setUp3DScene(assets);
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
 
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
@@ -15,17 +15,25 @@
 #include "GUI/BsGUIPanel.h"
 #include "GUI/BsGUILayoutY.h"
 #include "GUI/BsGUILabel.h"
+#include "GUI/BsGUIContent.h"
 #include "Physics/BsPhysicsMaterial.h"
 #include "RenderAPI/BsRenderAPI.h"
 #include "RenderAPI/BsRenderWindow.h"
 #include "Scene/BsSceneObject.h"
 #include "Platform/BsCursor.h"
 #include "Input/BsInput.h"
+#include "Utility/BsTime.h"
+#include "Debug/BsDebug.h"
 
 // Example includes
 #include "BsExampleFramework.h"
 #include "BsFPSWalker.h"
 #include "BsFPSCamera.h"
+#include "BsBenchmarkScenario.h"
+#include "BsProfiledApplication.h"
+#include "BsMultiViewCuller.h"
+#include "BsOcclusionCuller.h"
+#include "BsStaticBatcher.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example sets up a physical environment in which the user can walk around using the character controller component,
@@ -37,6 +45,19 @@
 // next, as well as the camera. Components for moving the character controller and the camera are attached to allow the
 // user to control the character. Finally an input callback is hooked up that shoots spheres when user presses the left
 // mouse button.
+//
+// The boxes are also registered as occluders with the OcclusionCuller component, which rasterizes them into a small depth
+// buffer on the CPU every frame, and hides objects fully behind them before they are submitted for rendering. The number
+// of culled objects and the time spent culling are displayed on screen.
+//
+// The floor and a wall of static boxes surrounding the play area never move, so their renderables are merged by the
+// StaticBatcher into a few combined meshes during set-up, drawn with one draw call each. The wall boxes keep their scene
+// objects, which still place their occluders, so the wall hides the objects behind it.
+//
+// When built with BS_EXAMPLE_SPLIT_SCREEN (the PhysicsSplitScreen target), the window is split between the player's view
+// and an overview camera, with a rear-view mirror overlaid on the player's view. The objects are culled against all three
+// cameras in a single pass by the MultiViewCuller component. The renderer still culls each camera, but only tests the
+// objects the shared pass found in its view.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace bs
 {
@@ -45,6 +66,97 @@ namespace bs
 	u32 windowResWidth = 1280;
 	u32 windowResHeight = 720;
 
+#if BS_EXAMPLE_SPLIT_SCREEN
+	HMultiViewCuller gMultiViewCuller;
+#else
+	HOcclusionCuller gOcclusionCuller;
+	GUILabel* gOcclusionStatsLabel = nullptr;
+#endif
+
+	/** Renderables created before the culler, along with their occluder meshes, registered once the culler is created. */
+	Vector<std::pair<HRenderable, SPtr<OccluderMesh>>> gPendingCulledRenderables;
+
+	/**
+	 * Registers a renderable to be culled by the multi-view culler in the split-screen variant of the example, or by the
+	 * occlusion culler otherwise. If an occluder mesh is provided, the renderable also hides the objects behind it.
+	 */
+	void registerForCulling(const HRenderable& renderable, const SPtr<OccluderMesh>& occluder = nullptr)
+	{
+#if BS_EXAMPLE_SPLIT_SCREEN
+		if(gMultiViewCuller)
+		{
+			gMultiViewCuller->AddRenderable(renderable);
+			return;
+		}
+#else
+		if(gOcclusionCuller)
+		{
+			gOcclusionCuller->AddOccludee(renderable);
+
+			if(occluder)
+				gOcclusionCuller->AddOccluder(renderable->SO(), occluder);
+
+			return;
+		}
+#endif
+
+		gPendingCulledRenderables.push_back(std::make_pair(renderable, occluder));
+	}
+
+	/** Scene objects without a renderable of their own that hide the objects behind them, registered with the culler. */
+	Vector<std::pair<HSceneObject, SPtr<OccluderMesh>>> gPendingOccluders;
+
+	/**
+	 * Registers a scene object that hides the objects behind it, without being culled itself (e.g. because it is drawn
+	 * as a part of a static batch). Only used by the occlusion culler, the multi-view culler has no occluders.
+	 */
+	void registerOccluder(const HSceneObject& sceneObject, const SPtr<OccluderMesh>& occluder)
+	{
+#if !BS_EXAMPLE_SPLIT_SCREEN
+		if(gOcclusionCuller)
+		{
+			gOcclusionCuller->AddOccluder(sceneObject, occluder);
+			return;
+		}
+
+		gPendingOccluders.push_back(std::make_pair(sceneObject, occluder));
+#endif
+	}
+
+#if !BS_EXAMPLE_SPLIT_SCREEN
+	/** Displays the statistics of the occlusion culler. */
+	class OcclusionStatsDisplay : public Component
+	{
+	public:
+		OcclusionStatsDisplay(const HSceneObject& parent)
+			: Component(parent)
+		{}
+
+		void Update() override
+		{
+			// Refresh the label twice per second, so the numbers are readable
+			mTimeSinceRefresh += gTime().GetFrameDelta();
+			if(mTimeSinceRefresh < 0.5f)
+				return;
+
+			mTimeSinceRefresh = 0.0f;
+
+			const OcclusionCullStats& stats = gOcclusionCuller->GetStats();
+
+			HString statsString("Occlusion culled {0} of {1} objects, {2} triangles rasterized, {3} ms");
+			statsString.SetParameter(0, toString(stats.NumOccluded));
+			statsString.SetParameter(1, toString(stats.NumOccludees));
+			statsString.SetParameter(2, toString(stats.Buffer.NumRasterizedTriangles));
+			statsString.SetParameter(3, toString(stats.GetTotalTime(), 2));
+
+			gOcclusionStatsLabel->SetContent(GUIContent(statsString));
+		}
+
+	private:
+		float mTimeSinceRefresh = 0.0f;
+	};
+#endif
+
 	/** Set up the scene used by the example, and the camera to view the world through. */
 	void setUpScene()
 	{
@@ -78,6 +190,9 @@ namespace bs
 		HMesh planeMesh = gBuiltinResources().GetMesh(BuiltinMesh::Quad);
 		HMesh sphereMesh = gBuiltinResources().GetMesh(BuiltinMesh::Sphere);
 
+		// Boxes hide whatever is behind them, so their bounds are used as occluders
+		SPtr<OccluderMesh> boxOccluder = OccluderMesh::CreateBox(boxMesh->GetProperties().GetBounds().GetBox());
+
 		// Create a physics material we'll use for the box geometry, as well as the floor. The material has high
 		// static and dynamic friction, with low restitution (low bounciness). Simulates a harder, rough, solid surface.
 		HPhysicsMaterial boxPhysicsMaterial = PhysicsMaterial::Create(1.0f, 1.0f, 0.0f);
@@ -119,6 +234,7 @@ namespace bs
 				HRenderable boxRenderable = entry->AddComponent<CRenderable>();
 				boxRenderable->SetMesh(boxMesh);
 				boxRenderable->SetMaterial(boxMaterial);
+				registerForCulling(boxRenderable, boxOccluder);
 
 				// Add a plane collider that represent's the physical geometry of the box
 				HBoxCollider boxCollider = entry->AddComponent<CBoxCollider>();
@@ -157,6 +273,49 @@ namespace bs
 		createBoxStack(Vector3(6.0f, 0.0f, 3.0f), Quaternion(Degree(0.0f), Degree(-45.0f), Degree(0.0f)));
 		createBoxStack(Vector3(-6.0f, 0.0f, 3.0f), Quaternion(Degree(0.0f), Degree(45.0f), Degree(0.0f)));
 
+		/************************************************************************/
+		/* 									SCENERY                    		*/
+		/************************************************************************/
+
+		// Surround the play area with a low wall of boxes. Unlike the box stacks these never move, so together with the
+		// floor their renderables are merged into a few combined meshes, drawing the static scenery with a handful of
+		// draw calls instead of one per object.
+		StaticBatcher staticBatcher;
+		staticBatcher.Add(floorRenderable);
+
+		constexpr u32 WALL_BOXES_PER_SIDE = 40;
+		const float wallHalfLength = WALL_BOXES_PER_SIDE * 0.5f;
+		for(u32 side = 0; side < 4; side++)
+		{
+			const Quaternion sideRotation(Vector3::UNIT_Y, Degree(side * 90.0f));
+			for(u32 i = 0; i < WALL_BOXES_PER_SIDE; i++)
+			{
+				HSceneObject wallSO = SceneObject::Create("Wall");
+				wallSO->SetPosition(sideRotation.Rotate(Vector3(i - wallHalfLength + 0.5f, 0.5f, -wallHalfLength)));
+
+				HRenderable wallRenderable = wallSO->AddComponent<CRenderable>();
+				wallRenderable->SetMesh(boxMesh);
+				wallRenderable->SetMaterial(boxMaterial);
+				staticBatcher.Add(wallRenderable);
+
+				// Static collider without a rigidbody, so the wall stops the spheres and boxes without being pushed
+				HBoxCollider wallCollider = wallSO->AddComponent<CBoxCollider>();
+				wallCollider->SetMaterial(boxPhysicsMaterial);
+
+				// The scene object outlives its merged renderable, so it still places the occluder of the box
+				registerOccluder(wallSO, boxOccluder);
+			}
+		}
+
+		// Merged renderables are destroyed, so only the batches are culled. A batch can hold the boxes of two sides of the
+		// wall, so its bounds would hide objects inside the play area, and the boxes are used as occluders instead.
+		for(auto& renderable : staticBatcher.Build("StaticScenery"))
+			registerForCulling(renderable);
+
+		const StaticBatchStats& batchStats = staticBatcher.GetStats();
+		BS_LOG(Info, Uncategorized, "Static batching: merged " + toString(batchStats.NumRenderables) +
+			" renderables into " + toString(batchStats.NumBatches) + " batches");
+
 		/************************************************************************/
 		/* 									CHARACTER                    		*/
 		/************************************************************************/
@@ -200,8 +359,14 @@ namespace bs
 		// Set farthest distance that is visible. Anything above that is clipped.
 		sceneCamera->SetFarClipDistance(1000);
 
+#if BS_EXAMPLE_SPLIT_SCREEN
+		// The player's view only covers the left half of the window
+		sceneCamera->GetViewport()->SetArea(Rect2(0.0f, 0.0f, 0.5f, 1.0f));
+		sceneCamera->SetAspectRatio((windowResWidth * 0.5f) / (float)windowResHeight);
+#else
 		// Set aspect ratio depending on the current resolution
 		sceneCamera->SetAspectRatio(windowResWidth / (float)windowResHeight);
+#endif
 
 		// Add a component that allows the camera to be rotated using the mouse
 		HFPSCamera fpsCamera = sceneCameraSO->AddComponent<FPSCamera>();
@@ -213,6 +378,41 @@ namespace bs
 		sceneCameraSO->SetParent(characterSO);
 		sceneCameraSO->SetPosition(Vector3(0.0f, 1.8f * 0.5f - 0.1f, 0.0f));
 
+#if BS_EXAMPLE_SPLIT_SCREEN
+		/************************************************************************/
+		/* 							SPLIT SCREEN CAMERAS                   		*/
+		/************************************************************************/
+
+		// Overview camera, looking at the scene from above and covering the right half of the window
+		HSceneObject overviewCameraSO = SceneObject::Create("OverviewCamera");
+
+		HCamera overviewCamera = overviewCameraSO->AddComponent<CCamera>();
+		overviewCamera->GetViewport()->SetTarget(window);
+		overviewCamera->GetViewport()->SetArea(Rect2(0.5f, 0.0f, 0.5f, 1.0f));
+		overviewCamera->SetNearClipDistance(0.005f);
+		overviewCamera->SetFarClipDistance(1000);
+		overviewCamera->SetAspectRatio((windowResWidth * 0.5f) / (float)windowResHeight);
+
+		overviewCameraSO->SetPosition(Vector3(0.0f, 15.0f, 20.0f));
+		overviewCameraSO->LookAt(Vector3(0.0f, 0.0f, 2.0f));
+
+		// Rear-view mirror, following the character and overlaid at the top of the player's view. Cameras with lower
+		// priority render later, so the mirror is drawn on top.
+		HSceneObject mirrorCameraSO = SceneObject::Create("MirrorCamera");
+
+		HCamera mirrorCamera = mirrorCameraSO->AddComponent<CCamera>();
+		mirrorCamera->GetViewport()->SetTarget(window);
+		mirrorCamera->GetViewport()->SetArea(Rect2(0.175f, 0.02f, 0.15f, 0.15f));
+		mirrorCamera->SetPriority(-1);
+		mirrorCamera->SetNearClipDistance(0.005f);
+		mirrorCamera->SetFarClipDistance(1000);
+		mirrorCamera->SetAspectRatio(1.0f * windowResWidth / (float)windowResHeight);
+
+		mirrorCameraSO->SetParent(characterSO);
+		mirrorCameraSO->SetPosition(Vector3(0.0f, 1.8f * 0.5f - 0.1f, 0.0f));
+		mirrorCameraSO->SetRotation(Quaternion(Vector3::UNIT_Y, Degree(180.0f)));
+#endif
+
 		/************************************************************************/
 		/* 									SKYBOX                       		*/
 		/************************************************************************/
@@ -249,6 +449,7 @@ namespace bs
 				HRenderable sphereRenderable = sphereSO->AddComponent<CRenderable>();
 				sphereRenderable->SetMesh(sphereMesh);
 				sphereRenderable->SetMaterial(sphereMaterial);
+				registerForCulling(sphereRenderable);
 
 				// Create a spherical collider, represting physical geometry
 				HSphereCollider sphereCollider = sphereSO->AddComponent<CSphereCollider>();
@@ -302,8 +503,46 @@ namespace bs
 		vertLayout->AddNewElement<GUILabel>(shootString);
 		vertLayout->AddNewElement<GUILabel>(quitString);
 
+#if !BS_EXAMPLE_SPLIT_SCREEN
+		gOcclusionStatsLabel = vertLayout->AddNewElement<GUILabel>(HString(u8"Occlusion culling"));
+		guiSO->AddComponent<OcclusionStatsDisplay>();
+#endif
+
 		// Register the layout with the main GUI panel, placing the layout in top left corner of the screen by default
 		mainPanel->AddElement(vertLayout);
+
+#if BS_EXAMPLE_SPLIT_SCREEN
+		/************************************************************************/
+		/* 							MULTI-VIEW CULLING                   		*/
+		/************************************************************************/
+
+		// Cull all the objects against the three cameras at once. The culler is created last, so it runs after the
+		// components moving the cameras, and culls against their positions in the current frame.
+		HSceneObject cullerSO = SceneObject::Create("MultiViewCuller");
+		gMultiViewCuller = cullerSO->AddComponent<MultiViewCuller>();
+		gMultiViewCuller->AddView(sceneCamera);
+		gMultiViewCuller->AddView(overviewCamera);
+		gMultiViewCuller->AddView(mirrorCamera);
+
+#else
+		/************************************************************************/
+		/* 							OCCLUSION CULLING                   		*/
+		/************************************************************************/
+
+		// Hide the objects behind the boxes. Like the stats display, the culler is created after the components moving
+		// the camera, so it culls against the camera position in the current frame.
+		HSceneObject cullerSO = SceneObject::Create("OcclusionCuller");
+		gOcclusionCuller = cullerSO->AddComponent<OcclusionCuller>(sceneCamera);
+#endif
+
+		for(auto& entry : gPendingCulledRenderables)
+			registerForCulling(entry.first, entry.second);
+
+		for(auto& entry : gPendingOccluders)
+			registerOccluder(entry.first, entry.second);
+
+		gPendingCulledRenderables.clear();
+		gPendingOccluders.clear();
 	}
 } // namespace bs
 
@@ -322,9 +561,10 @@ int main()
 {
 	using namespace bs;
 
-	// Initializes the application and creates a window with the specified properties
+	// Initializes the application and creates a window with the specified properties. The application measures the
+	// time and hardware counters of each phase of the frame, and logs them on exit.
 	VideoMode videoMode(windowResWidth, windowResHeight);
-	Application::StartUp(videoMode, "Example", false);
+	Application::StartUp<ProfiledApplication>(videoMode, "Example", false);
 
 	// Registers a default set of input controls
 	ExampleFramework::SetupInputConfig();
@@ -332,6 +572,9 @@ int main()
 	// Set up the scene with an object to render and a camera
 	setUpScene();
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();
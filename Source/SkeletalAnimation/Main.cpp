@@ -14,6 +14,8 @@
 // Example includes
 #include "BsCameraFlyer.h"
 #include "BsExampleFramework.h"
+#include "BsBenchmarkScenario.h"
+#include "BsProfiledApplication.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This example demonstrates how to animate a 3D model using skeletal animation. Aside from animation this example is
@@ -190,9 +192,10 @@ int main()
 {
 	using namespace bs;
 
-	// Initializes the application and creates a window with the specified properties
+	// Initializes the application and creates a window with the specified properties. The application measures the
+	// time and hardware counters of each phase of the frame, and logs them on exit.
 	VideoMode videoMode(windowResWidth, windowResHeight);
-	Application::StartUp(videoMode, "Example", false);
+	Application::StartUp<ProfiledApplication>(videoMode, "Example", false);
 
 	// Registers a default set of input controls
 	ExampleFramework::SetupInputConfig();
@@ -203,6 +206,9 @@ int main()
 	// Set up the scene with an object to render and a camera
 	setUp3DScene(assets);
 
+	// Run as a non-interactive benchmark instead, if launched by bsfExamplesBench
+	BenchmarkScenario::StartFromEnvironment();
+
 	// Runs the main loop that does most of the work. This method will exit when user closes the main
 	// window or exits in some other way.
 	Application::Instance().RunMainLoop();